@@ -42,6 +42,7 @@ import os
 import shutil
 import filecmp
 import argparse
+import re
 
 import sys
 px4_tools_dir = os.path.dirname(os.path.abspath(__file__))
@@ -78,6 +79,7 @@ msg_template_map = {'msg.h.template': '@NAME@.h'}
 srv_template_map = {}
 incl_default = ['std_msgs:./msg/std_msgs']
 package = 'px4'
+topics_header = 'uORBTopics.h'
 
 
 def convert_file(filename, outputdir, templatedir, includepath):
@@ -94,7 +96,73 @@ def convert_file(filename, outputdir, templatedir, includepath):
                                                  srv_template_map)
 
 
-def convert_dir(inputdir, outputdir, templatedir):
+def get_topics(filename):
+        """
+        Returns the topic names defined by a .msg file: the file name, or the
+        names listed in a '# TOPICS' line if there is one
+        """
+        topics = []
+        with open(filename, 'r') as f:
+                for line in f:
+                        match = re.match(r'^#\s*TOPICS\s+(.*)$', line.strip())
+                        if match:
+                                topics.extend(match.group(1).split())
+        if not topics:
+                topics.append(os.path.splitext(os.path.basename(filename))[0])
+        return topics
+
+
+def generate_topics_header(inputdir, outputdir):
+        """
+        Writes the header with the topic ids, which are assigned densely in
+        the alphabetical order of all topic names in inputdir
+        """
+        topics = []
+        for f in os.listdir(inputdir):
+                fn = os.path.join(inputdir, f)
+                if f.startswith(".") or not f.endswith(".msg") or not os.path.isfile(fn):
+                        continue
+                topics.extend(get_topics(fn))
+        topics = sorted(set(topics))
+
+        lines = ['/* Auto-generated by px_generate_uorb_topic_headers.py from {0} */'.format(inputdir),
+                 '',
+                 '#pragma once',
+                 '',
+                 '/**',
+                 ' * Number of topics known at compile time.',
+                 ' */',
+                 '#define ORB_TOPICS_COUNT {0}'.format(len(topics)),
+                 '',
+                 '/**',
+                 ' * Dense topic ids, in the alphabetical order of the topic names.',
+                 ' */',
+                 'enum orb_topic_id {']
+        for i, topic in enumerate(topics):
+                lines.append('\tORB_TOPIC_ID_{0} = {1},'.format(topic, i))
+        lines += ['};',
+                  '',
+                  '/**',
+                  ' * Markers of the topics with an id, see ORB_TOPIC_ID() in uORB.h.',
+                  ' */']
+        for topic in topics:
+                lines.append('#define ORB_TOPIC_LISTED_{0} ~, ORB_TOPIC_ID_{0}'.format(topic))
+        lines += ['',
+                  '/**',
+                  ' * Topic names indexed by topic id, to initialise a string array.',
+                  ' */',
+                  '#define ORB_TOPIC_NAMES \\']
+        for topic in topics:
+                lines.append('\t"{0}", \\'.format(topic))
+        lines.append('')
+
+        if not os.path.isdir(outputdir):
+                os.makedirs(outputdir)
+        with open(os.path.join(outputdir, topics_header), 'w') as f:
+                f.write('\n'.join(lines) + '\n')
+
+
+def convert_dir(inputdir, outputdir, templatedir, topic_ids=False):
         """
         Converts all .msg files in inputdir to uORB header files
         """
@@ -138,6 +206,9 @@ def convert_dir(inputdir, outputdir, templatedir):
                              templatedir,
                              includepath)
 
+        if topic_ids:
+                generate_topics_header(inputdir, outputdir)
+
         return True
 
 
@@ -175,13 +246,14 @@ def copy_changed(inputdir, outputdir, prefix='', quiet=False):
                             print("{0}: unchanged".format(f))
 
 
-def convert_dir_save(inputdir, outputdir, templatedir, temporarydir, prefix, quiet=False):
+def convert_dir_save(inputdir, outputdir, templatedir, temporarydir, prefix, quiet=False,
+                     topic_ids=False):
         """
         Converts all .msg files in inputdir to uORB header files
         Unchanged existing files are not overwritten.
         """
         # Create new headers in temporary output directory
-        convert_dir(inputdir, temporarydir, templatedir)
+        convert_dir(inputdir, temporarydir, templatedir, topic_ids)
         # Copy changed headers from temporary dir to output dir
         copy_changed(temporarydir, outputdir, prefix, quiet)
 
@@ -204,6 +276,9 @@ if __name__ == "__main__":
         parser.add_argument('-q', dest='quiet', default=False, action='store_true',
                             help='string added as prefix to the output file '
                             ' name when converting directories')
+        parser.add_argument('-i', dest='topic_ids', default=False, action='store_true',
+                            help='also generate {0} with the topic ids when '
+                            'converting directories'.format(topics_header))
         args = parser.parse_args()
 
         if args.file is not None:
@@ -220,4 +295,5 @@ if __name__ == "__main__":
                     args.templatedir,
                     args.temporarydir,
                     args.prefix,
-                    args.quiet)
+                    args.quiet,
+                    args.topic_ids)
@@ -0,0 +1,109 @@
+#!/bin/bash
+#
+# Run the headless SITL scenarios against a posix_sitl build.
+#
+# usage: sitl_scenarios.sh [-j jobs] build_path [scenario ...]
+#
+# Every scenario is appended to rcS_scenario and runs in a fresh mainapp
+# with its own rootfs. sim_scenario finish ends each run, its exit status
+# tells whether all expectations were met. The scenarios share nothing,
+# up to jobs of them (default: the number of CPUs) run at the same time.
+
+jobs=`nproc`
+
+if [ "$1" == "-j" ]
+then
+	jobs=$2
+	shift 2
+fi
+
+build_path=$1
+shift
+curr_dir=`pwd`
+scenario_dir=$curr_dir/posix-configs/SITL/scenarios
+
+if [ "$build_path" == "" ]
+then
+	echo usage: sitl_scenarios.sh [-j jobs] build_path [scenario ...]
+	exit 1
+fi
+
+scenarios="$@"
+
+if [ "$scenarios" == "" ]
+then
+	scenarios=`ls $scenario_dir`
+fi
+
+# run time limit in wall clock seconds for one scenario, the simulated time runs unthrottled
+timeout_s=${SCENARIO_TIMEOUT:-60}
+
+run_scenario()
+{
+	scenario=$1
+	run_dir=$build_path/src/firmware/posix/scenarios/$scenario
+	rm -rf $run_dir
+	mkdir -p $run_dir/rootfs/fs/microsd
+	mkdir -p $run_dir/rootfs/eeprom
+	touch $run_dir/rootfs/eeprom/parameters
+
+	cat posix-configs/SITL/init/rcS_scenario $scenario_dir/$scenario > $run_dir/rcS
+	echo "sim_scenario finish" >> $run_dir/rcS
+
+	start=`date +%s%N`
+	(cd $run_dir && timeout $timeout_s $build_path/src/firmware/posix/mainapp rcS < /dev/null > output.txt 2>&1)
+	echo $? > $run_dir/result
+	end=`date +%s%N`
+	echo $(((end - start) / 1000000)) > $run_dir/wall_time_ms
+}
+
+# milliseconds as seconds with one decimal
+format_ms()
+{
+	printf "%d.%d s" $(($1 / 1000)) $((($1 % 1000) / 100))
+}
+
+suite_start=`date +%s%N`
+running=0
+
+for scenario in $scenarios
+do
+	if [ $running -ge $jobs ]
+	then
+		wait -n
+		running=$((running - 1))
+	fi
+
+	run_scenario $scenario &
+	running=$((running + 1))
+done
+
+wait
+suite_end=`date +%s%N`
+
+passed=0
+failed=""
+
+for scenario in $scenarios
+do
+	run_dir=$build_path/src/firmware/posix/scenarios/$scenario
+	result=`cat $run_dir/result`
+
+	echo "scenario $scenario (`format_ms $(cat $run_dir/wall_time_ms)`)"
+	grep -E " ok: |FAIL|PASSED" $run_dir/output.txt
+
+	if [ "$result" == "0" ]
+	then
+		passed=$((passed + 1))
+	else
+		failed="$failed $scenario"
+	fi
+done
+
+echo "$passed scenarios passed, suite wall time `format_ms $(((suite_end - suite_start) / 1000000))` with $jobs jobs"
+
+if [ "$failed" != "" ]
+then
+	echo "failed:$failed"
+	exit 1
+fi
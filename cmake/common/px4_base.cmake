@@ -342,10 +342,12 @@ function(px4_generate_messages)
 	foreach(msg ${msg_list})
 		list(APPEND msg_files_out ${msg_out_path}/${msg}.h)
 	endforeach()
+	list(APPEND msg_files_out ${msg_out_path}/uORBTopics.h)
 	add_custom_command(OUTPUT ${msg_files_out}
 		COMMAND ${PYTHON_EXECUTABLE} 
 			Tools/px_generate_uorb_topic_headers.py
 			${QUIET}
+			-i
 			-d msg
 			-o ${msg_out_path} 
 			-e msg/templates/uorb
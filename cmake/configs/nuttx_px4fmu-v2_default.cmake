@@ -95,6 +95,7 @@ set(config_module_list
 	# Logging
 	#
 	modules/sdlog2
+	modules/latency_monitor
 
 	#
 	# Library modules
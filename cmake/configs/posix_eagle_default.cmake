@@ -13,6 +13,8 @@ set(config_module_list
 	systemcmds/param
 	systemcmds/mixer
 	systemcmds/ver
+	systemcmds/perf
+	systemcmds/trace
 
 	modules/mavlink
 
@@ -29,6 +31,7 @@ set(config_module_list
 	modules/sensors
 	modules/dataman
 	modules/sdlog2
+	modules/latency_monitor
 	modules/simulator
 	modules/commander
 	modules/controllib
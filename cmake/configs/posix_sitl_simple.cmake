@@ -24,7 +24,12 @@ set(config_module_list
 	systemcmds/esc_calib
 	systemcmds/reboot
 	systemcmds/topic_listener
+	systemcmds/perf
+	systemcmds/trace
+	systemcmds/top
 	modules/uORB
+	modules/muorb/shm
+	modules/muorb/udp
 	modules/param
 	modules/systemlib
 	modules/systemlib/mixer
@@ -36,6 +41,7 @@ set(config_module_list
 	modules/ekf_att_pos_estimator
 	modules/position_estimator_inav
 	modules/navigator
+	modules/sim_scenario
 	modules/mc_pos_control
 	modules/mc_att_control
 	modules/mc_pos_control_multiplatform
@@ -45,6 +51,7 @@ set(config_module_list
 	modules/fw_pos_control_l1
 	modules/dataman
 	modules/sdlog2
+	modules/latency_monitor
 	modules/commander
 	modules/controllib
 	lib/mathlib
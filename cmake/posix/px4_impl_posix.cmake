@@ -186,6 +186,11 @@ else()
                 )
 endif()
 
+	# several simulated vehicles in one process, see src/platforms/px4_vehicle.h
+	if (config_max_vehicles)
+		list(APPEND added_definitions -DPX4_MAX_VEHICLES=${config_max_vehicles})
+	endif()
+
         set(added_exe_linker_flags
 		-lpthread
 		)
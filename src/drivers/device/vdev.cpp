@@ -38,6 +38,7 @@
  */
 
 #include "px4_posix.h"
+#include "px4_vehicle.h"
 #include "vdev.h"
 #include "drivers/drv_device.h"
 
@@ -53,8 +54,9 @@ int px4_errno;
 struct px4_dev_t {
 	char *name;
 	void *cdev;
+	int vehicle;	/**< every vehicle has its own device names */
 
-	px4_dev_t(const char *n, void *c) : cdev(c)
+	px4_dev_t(const char *n, void *c) : cdev(c), vehicle(px4_vehicle_id())
 	{
 		name = strdup(n);
 	}
@@ -65,9 +67,16 @@ private:
 	px4_dev_t() {}
 };
 
-#define PX4_MAX_DEV 500
+#define PX4_MAX_DEV (500 * PX4_MAX_VEHICLES)
 static px4_dev_t *devmap[PX4_MAX_DEV];
 
+/* a device of the calling thread's vehicle, or any of them if name is null */
+static inline bool dev_match(int i, const char *name)
+{
+	return devmap[i] && devmap[i]->vehicle == px4_vehicle_id() &&
+	       (name == nullptr || strcmp(devmap[i]->name, name) == 0);
+}
+
 /*
  * The standard NuttX operation dispatch table can't call C++ member functions
  * directly, so we have to bounce them through this dispatch table.
@@ -143,7 +152,7 @@ VDev::register_driver(const char *name, void *data)
 	// Make sure the device does not already exist
 	// FIXME - convert this to a map for efficiency
 	for (int i = 0; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && (strcmp(devmap[i]->name, name) == 0)) {
+		if (dev_match(i, name)) {
 			return -EEXIST;
 		}
 	}
@@ -175,7 +184,7 @@ VDev::unregister_driver(const char *name)
 	}
 
 	for (int i = 0; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && (strcmp(name, devmap[i]->name) == 0)) {
+		if (dev_match(i, name)) {
 			delete devmap[i];
 			devmap[i] = NULL;
 			PX4_DEBUG("Unregistered DEV %s", name);
@@ -195,7 +204,7 @@ VDev::unregister_class_devname(const char *class_devname, unsigned class_instanc
 	snprintf(name, sizeof(name), "%s%u", class_devname, class_instance);
 
 	for (int i = 0; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && strcmp(devmap[i]->name, name) == 0) {
+		if (dev_match(i, name)) {
 			delete devmap[i];
 			PX4_DEBUG("Unregistered class DEV %s", name);
 			devmap[i] = NULL;
@@ -441,7 +450,12 @@ VDev::poll_notify_one(px4_pollfd_struct_t *fds, pollevent_t events)
 	/* if the state is now interesting, wake the waiter if it's still asleep */
 	/* XXX semcount check here is a vile hack; counting semphores should not be abused as cvars */
 	if ((fds->revents != 0) && (value <= 0)) {
+#ifndef __PX4_QURT
+		/* counts the wakeup for the lockstep of the simulated time */
+		px4_sim_sem_post(fds->sem);
+#else
 		px4_sem_post(fds->sem);
+#endif
 	}
 }
 
@@ -501,7 +515,7 @@ VDev *VDev::getDev(const char *path)
 		//if (devmap[i]) {
 		//	printf("%s %s\n", devmap[i]->name, path);
 		//}
-		if (devmap[i] && (strcmp(devmap[i]->name, path) == 0)) {
+		if (dev_match(i, path)) {
 			return (VDev *)(devmap[i]->cdev);
 		}
 	}
@@ -515,7 +529,7 @@ void VDev::showDevices()
 	PX4_INFO("Devices:");
 
 	for (; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && strncmp(devmap[i]->name, "/dev/", 5) == 0) {
+		if (dev_match(i, nullptr) && strncmp(devmap[i]->name, "/dev/", 5) == 0) {
 			PX4_INFO("   %s", devmap[i]->name);
 		}
 	}
@@ -527,7 +541,7 @@ void VDev::showTopics()
 	PX4_INFO("Devices:");
 
 	for (; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && strncmp(devmap[i]->name, "/obj/", 5) == 0) {
+		if (dev_match(i, nullptr) && strncmp(devmap[i]->name, "/obj/", 5) == 0) {
 			PX4_INFO("   %s", devmap[i]->name);
 		}
 	}
@@ -539,7 +553,7 @@ void VDev::showFiles()
 	PX4_INFO("Files:");
 
 	for (; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && strncmp(devmap[i]->name, "/obj/", 5) != 0 &&
+		if (dev_match(i, nullptr) && strncmp(devmap[i]->name, "/obj/", 5) != 0 &&
 		    strncmp(devmap[i]->name, "/dev/", 5) != 0) {
 			PX4_INFO("   %s", devmap[i]->name);
 		}
@@ -549,7 +563,7 @@ void VDev::showFiles()
 const char *VDev::topicList(unsigned int *next)
 {
 	for (; *next < PX4_MAX_DEV; (*next)++)
-		if (devmap[*next] && strncmp(devmap[(*next)]->name, "/obj/", 5) == 0) {
+		if (dev_match(*next, nullptr) && strncmp(devmap[(*next)]->name, "/obj/", 5) == 0) {
 			return devmap[(*next)++]->name;
 		}
 
@@ -559,7 +573,7 @@ const char *VDev::topicList(unsigned int *next)
 const char *VDev::devList(unsigned int *next)
 {
 	for (; *next < PX4_MAX_DEV; (*next)++)
-		if (devmap[*next] && strncmp(devmap[(*next)]->name, "/dev/", 5) == 0) {
+		if (dev_match(*next, nullptr) && strncmp(devmap[(*next)]->name, "/dev/", 5) == 0) {
 			return devmap[(*next)++]->name;
 		}
 
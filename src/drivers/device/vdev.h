@@ -321,6 +321,16 @@ public:
 	virtual int	ioctl(file_t *filep, int cmd, unsigned long arg);
 
 	static VDev *getDev(const char *path);
+
+	/**
+	 * Open a file descriptor on a device without looking up its path.
+	 *
+	 * @param dev		The device to open.
+	 * @param flags		The open flags, as for px4_open.
+	 * @return		The file descriptor, or -1 with px4_errno set.
+	 */
+	static int openDev(VDev *dev, int flags);
+
 	static void showFiles(void);
 	static void showDevices(void);
 	static void showTopics(void);
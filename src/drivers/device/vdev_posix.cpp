@@ -40,10 +40,13 @@
 #include <px4_log.h>
 #include <px4_posix.h>
 #include <px4_time.h>
+#include <px4_trace.h>
+#include <px4_vehicle.h>
 #include "device.h"
 #include "vfile.h"
 
 #include <hrt_work.h>
+#include <drivers/drv_hrt.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -63,7 +66,7 @@ extern "C" {
 		PX4_DEBUG("timer_handler: Timer expired");
 	}
 
-#define PX4_MAX_FD 200
+#define PX4_MAX_FD (200 * PX4_MAX_VEHICLES)
 	static device::file_t *filemap[PX4_MAX_FD] = {};
 
 	int px4_errno;
@@ -97,8 +100,6 @@ extern "C" {
 	{
 		PX4_DEBUG("px4_open");
 		VDev *dev = VDev::getDev(path);
-		int ret = 0;
-		int i;
 		mode_t mode;
 
 		if (!dev && (flags & (PX4_F_WRONLY | PX4_F_CREAT)) != 0 &&
@@ -114,38 +115,12 @@ extern "C" {
 			dev = VFile::createFile(path, mode);
 		}
 
-		if (dev) {
-
-			pthread_mutex_lock(&filemutex);
-
-			for (i = 0; i < PX4_MAX_FD; ++i) {
-				if (filemap[i] == 0) {
-					filemap[i] = new device::file_t(flags, dev, i);
-					break;
-				}
-			}
-
-			pthread_mutex_unlock(&filemutex);
-
-			if (i < PX4_MAX_FD) {
-				ret = dev->open(filemap[i]);
-
-			} else {
-				PX4_WARN("exceeded maximum number of file descriptors!");
-				ret = -ENOENT;
-			}
-
-		} else {
-			ret = -EINVAL;
-		}
-
-		if (ret < 0) {
-			px4_errno = -ret;
+		if (!dev) {
+			px4_errno = EINVAL;
 			return -1;
 		}
 
-		PX4_DEBUG("px4_open fd = %d", filemap[i]->fd);
-		return filemap[i]->fd;
+		return VDev::openDev(dev, flags);
 	}
 
 	int px4_close(int fd)
@@ -238,6 +213,35 @@ extern "C" {
 		return ret;
 	}
 
+	// wait for a poll event or the timeout in ms, forever if it is negative
+	static void poll_wait(px4_sem_t *sem, int timeout)
+	{
+#ifndef __PX4_QURT
+
+		if (hrt_simulated_time_enabled()) {
+			// a deadline in the simulated time, which lets the clock wait for this thread
+			px4_sim_sem_wait(sem, (timeout > 0) ? hrt_absolute_time() + 1000 * (hrt_abstime)timeout : UINT64_MAX);
+			return;
+		}
+
+#endif
+
+		if (timeout > 0) {
+			// Use a work queue task
+			work_s _hpwork;
+
+			hrt_work_queue(&_hpwork, (worker_t)&timer_cb, (void *)sem, 1000 * timeout);
+			px4_sem_wait(sem);
+
+			// Make sure timer thread is killed before sem goes
+			// out of scope
+			hrt_work_cancel(&_hpwork);
+
+		} else {
+			px4_sem_wait(sem);
+		}
+	}
+
 	int px4_poll(px4_pollfd_struct_t *fds, nfds_t nfds, int timeout)
 	{
 		px4_sem_t sem;
@@ -268,19 +272,8 @@ extern "C" {
 		}
 
 		if (ret >= 0) {
-			if (timeout > 0) {
-				// Use a work queue task
-				work_s _hpwork;
-
-				hrt_work_queue(&_hpwork, (worker_t)&timer_cb, (void *)&sem, 1000 * timeout);
-				px4_sem_wait(&sem);
-
-				// Make sure timer thread is killed before sem goes
-				// out of scope
-				hrt_work_cancel(&_hpwork);
-
-			} else if (timeout < 0) {
-				px4_sem_wait(&sem);
+			if (timeout != 0) {
+				poll_wait(&sem, timeout);
 			}
 
 			// For each fd
@@ -306,6 +299,10 @@ extern "C" {
 
 		px4_sem_destroy(&sem);
 
+		if (timeout != 0) {
+			px4_trace_instant(PX4_TRACE_POLL, "px4_poll", count);
+		}
+
 		return count;
 	}
 
@@ -352,3 +349,43 @@ extern "C" {
 
 }
 
+
+int VDev::openDev(VDev *dev, int flags)
+{
+	int ret;
+	int i;
+
+	pthread_mutex_lock(&filemutex);
+
+	for (i = 0; i < PX4_MAX_FD; ++i) {
+		if (filemap[i] == 0) {
+			filemap[i] = new device::file_t(flags, dev, i);
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&filemutex);
+
+	if (i < PX4_MAX_FD) {
+		ret = dev->open(filemap[i]);
+
+		if (ret < 0) {
+			pthread_mutex_lock(&filemutex);
+			delete filemap[i];
+			filemap[i] = nullptr;
+			pthread_mutex_unlock(&filemutex);
+		}
+
+	} else {
+		PX4_WARN("exceeded maximum number of file descriptors!");
+		ret = -ENOENT;
+	}
+
+	if (ret < 0) {
+		px4_errno = -ret;
+		return -1;
+	}
+
+	PX4_DEBUG("px4_open fd = %d", i);
+	return i;
+}
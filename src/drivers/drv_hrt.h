@@ -76,6 +76,9 @@ typedef struct hrt_call {
 	hrt_abstime		period;
 	hrt_callout		callout;
 	void			*arg;
+#ifdef __PX4_POSIX
+	int			vehicle;	/* vehicle to run the callout for */
+#endif
 } *hrt_call_t;
 
 /*
@@ -163,4 +166,61 @@ __EXPORT extern void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay);
  */
 __EXPORT extern void	hrt_init(void);
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+/*
+ * Switch hrt_absolute_time() to a simulated clock continuing from the current time.
+ *
+ * From then on time only advances with hrt_advance_simulated_time() or
+ * hrt_set_simulated_time(), so a simulation can run faster or slower than real
+ * time. HRT callouts, the work queues, px4_poll() timeouts and px4_usleep()
+ * follow the simulated clock, plain usleep() and semaphore timeouts do not.
+ */
+__EXPORT extern void	hrt_start_simulated_time(void);
+
+/*
+ * Advance the simulated clock by delta microseconds.
+ */
+__EXPORT extern void	hrt_advance_simulated_time(hrt_abstime delta);
+
+/*
+ * Set the simulated clock, time never goes backwards.
+ */
+__EXPORT extern void	hrt_set_simulated_time(hrt_abstime now);
+
+/*
+ * Return true if hrt_absolute_time() is simulated.
+ */
+__EXPORT extern bool	hrt_simulated_time_enabled(void);
+
+/*
+ * Return the simulated time, valid once it is enabled.
+ */
+__EXPORT extern hrt_abstime	hrt_simulated_time(void);
+
+/*
+ * Sleep until the given absolute time.
+ *
+ * Returns -1 if woken early by hrt_wake_sleepers() in simulated time, like a
+ * signal interrupts usleep(), 0 otherwise.
+ */
+__EXPORT extern int	hrt_sleep_until(hrt_abstime deadline);
+
+/*
+ * Wake up all threads waiting in hrt_sleep_until() in simulated time.
+ */
+__EXPORT extern void	hrt_wake_sleepers(void);
+
+/*
+ * Wait until every thread woken by the simulated clock or by a px4_poll() event
+ * waits in simulated time again, for at most timeout_us of wall clock time.
+ *
+ * Lets the task advancing the simulated clock run in lockstep with the tasks
+ * it wakes. Returns -1 on timeout, the threads still busy are then no longer
+ * waited for.
+ */
+__EXPORT extern int	hrt_wait_sleepers(unsigned timeout_us);
+
+#endif
+
 __END_DECLS
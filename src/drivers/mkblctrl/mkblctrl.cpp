@@ -541,6 +541,7 @@ MK::task_main()
 					/* do mixing */
 					outputs.noutputs = _mixers->mix(&outputs.output[0], _num_outputs, NULL);
 					outputs.timestamp = hrt_absolute_time();
+					outputs.timestamp_sample = _controls.timestamp_sample;
 
 					/* iterate actuators */
 					for (unsigned int i = 0; i < _num_outputs; i++) {
@@ -51,6 +51,7 @@
 #include <px4_config.h>
 #include <px4_tasks.h>
 #include <px4_time.h>
+#include <px4_vehicle.h>
 #include <px4_common.h>
 
 #include <sys/types.h>
@@ -169,7 +170,7 @@ private:
 namespace
 {
 
-PWMSim	*g_pwm_sim;
+px4::VehicleInstance<PWMSim> g_pwm_sim;
 
 } // namespace
 
@@ -477,6 +478,7 @@ PWMSim::task_main()
 			actuator_outputs_s outputs;
 			num_outputs = _mixers->mix(&outputs.output[0], num_outputs, NULL);
 			outputs.timestamp = hrt_absolute_time();
+			outputs.timestamp_sample = _controls[0].timestamp_sample;
 
 			/* disable unused ports by setting their output to NaN */
 			for (size_t i = 0; i < sizeof(outputs.output) / sizeof(outputs.output[0]); i++) {
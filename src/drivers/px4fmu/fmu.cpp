@@ -572,6 +572,7 @@ PX4FMU::publish_pwm_outputs(uint16_t *values, size_t numvalues)
 	actuator_outputs_s outputs;
 	outputs.noutputs = numvalues;
 	outputs.timestamp = hrt_absolute_time();
+	outputs.timestamp_sample = _controls[0].timestamp_sample;
 
 	for (size_t i = 0; i < _max_actuators; ++i) {
 		outputs.output[i] = i < numvalues ? (float)values[i] : 0;
@@ -294,6 +294,7 @@ private:
 	orb_advert_t 		_to_mixer_status; 	///< mixer status flags
 
 	actuator_outputs_s	_outputs;		///< mixed outputs
+	hrt_abstime		_controls_timestamp_sample;	///< sensor sample of the last attitude controls sent to IO
 	servorail_status_s	_servorail_status;	///< servorail status
 
 	bool			_primary_pwm_device;	///< true if we are the default PWM output
@@ -525,6 +526,7 @@ PX4IO::PX4IO(device::Device *interface) :
 	_to_safety(nullptr),
 	_to_mixer_status(nullptr),
 	_outputs{},
+	_controls_timestamp_sample(0),
 	_servorail_status{},
 	_primary_pwm_device(false),
 	_lockdown_override(false),
@@ -1224,6 +1226,7 @@ PX4IO::io_set_control_state(unsigned group)
 			if (changed) {
 				orb_copy(ORB_ID(actuator_controls_0), _t_actuator_controls_0, &controls);
 				perf_set(_perf_sample_latency, hrt_elapsed_time(&controls.timestamp_sample));
+				_controls_timestamp_sample = controls.timestamp_sample;
 			}
 		}
 		break;
@@ -1848,6 +1851,7 @@ PX4IO::io_publish_pwm_outputs()
 	multirotor_motor_limits_s motor_limits;
 
 	outputs.timestamp = hrt_absolute_time();
+	outputs.timestamp_sample = _controls_timestamp_sample;
 
 	/* get servo values from IO */
 	uint16_t ctl[_max_actuators];
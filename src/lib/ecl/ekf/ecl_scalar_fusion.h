@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ecl_scalar_fusion.h
+ *
+ * Sequential fusion of scalar measurements with a sparse observation row.
+ *
+ * The observation Jacobian H of a scalar measurement usually has only a
+ * handful of non-zero entries. P*H' is formed from those entries alone
+ * and the covariance is corrected with the Joseph form
+ *
+ *   P = (I - K*H) * P * (I - K*H)' + K*R*K'
+ *     = P - K*(P*H')' - (P*H')*K' + (H*P*H' + R)*K*K'
+ *
+ * which stays symmetric and valid for any gain, including gains where
+ * selected states have been inhibited by zeroing their entries.
+ * The update is a symmetric rank-2 correction, so no dense K*H or
+ * K*H*P products are needed and the cost is O(N * nnz) for P*H' plus
+ * O(N^2) for the correction itself.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+template <size_t N, size_t MAX_NNZ = 8>
+class ECL_ScalarFusion
+{
+public:
+	ECL_ScalarFusion() :
+		_nnz(0),
+		_index{},
+		_value{},
+		_PHT{},
+		_innov_var(0.0f)
+	{}
+
+	/**
+	 * Clear the observation row.
+	 */
+	void reset() { _nnz = 0; }
+
+	/**
+	 * Add a non-zero entry of the observation row.
+	 *
+	 * @param state	state index
+	 * @param h	partial derivative of the measurement w.r.t. the state
+	 * @return	false if the row is full
+	 */
+	bool add(unsigned state, float h)
+	{
+		if (_nnz >= MAX_NNZ || state >= N) {
+			return false;
+		}
+
+		_index[_nnz] = state;
+		_value[_nnz] = h;
+		_nnz++;
+		return true;
+	}
+
+	/**
+	 * @return number of non-zero entries of the observation row
+	 */
+	unsigned nnz() const { return _nnz; }
+
+	/**
+	 * Compute P*H' and the innovation variance H*P*H' + R.
+	 *
+	 * P is symmetric, so P*H' is accumulated from the rows of the
+	 * observed states, at O(N * nnz) cost.
+	 *
+	 * @param P	covariance, N x N, row-major
+	 * @param R	measurement variance
+	 * @return	innovation variance
+	 */
+	float innovationVariance(const float *P, float R)
+	{
+		for (size_t i = 0; i < N; i++) {
+			_PHT[i] = 0.0f;
+		}
+
+		for (unsigned k = 0; k < _nnz; k++) {
+			const float *row = &P[_index[k] * N];
+			const float h = _value[k];
+
+			for (size_t i = 0; i < N; i++) {
+				_PHT[i] += h * row[i];
+			}
+		}
+
+		float HPHT = 0.0f;
+
+		for (unsigned k = 0; k < _nnz; k++) {
+			HPHT += _value[k] * _PHT[_index[k]];
+		}
+
+		_innov_var = HPHT + R;
+		return _innov_var;
+	}
+
+	/**
+	 * @return P*H' from the last call to innovationVariance()
+	 */
+	const float *PHT() const { return _PHT; }
+
+	/**
+	 * Compute the optimal Kalman gain K = P*H' / (H*P*H' + R).
+	 */
+	void gain(float *K) const
+	{
+		const float S_I = 1.0f / _innov_var;
+
+		for (size_t i = 0; i < N; i++) {
+			K[i] = _PHT[i] * S_I;
+		}
+	}
+
+	/**
+	 * Correct the covariance with the Joseph form for the given gain.
+	 *
+	 * Must follow innovationVariance() on the same P. Each row is a
+	 * contiguous multiply-add over the state vector which the compiler
+	 * can vectorise; the result is symmetric up to rounding.
+	 *
+	 * @param P	covariance, N x N, row-major
+	 * @param K	Kalman gain, entries may be zeroed to inhibit states
+	 */
+	void updateCovariance(float *P, const float *K) const
+	{
+		for (size_t i = 0; i < N; i++) {
+			const float a = _innov_var * K[i] - _PHT[i];
+			const float k = K[i];
+			float *row = &P[i * N];
+
+			for (size_t j = 0; j < N; j++) {
+				row[j] += a * K[j] - k * _PHT[j];
+			}
+		}
+	}
+
+private:
+	unsigned _nnz;
+	uint8_t _index[MAX_NNZ];
+	float _value[MAX_NNZ];
+	float _PHT[N];		///< P * H'
+	float _innov_var;	///< H * P * H' + R
+};
@@ -60,9 +60,32 @@
  * formulas according to: http://mathworld.wolfram.com/AzimuthalEquidistantProjection.html
  */
 
-static struct map_projection_reference_s mp_ref = {0.0, 0.0, 0.0, 0.0, false, 0};
+static struct map_projection_reference_s mp_ref = {0.0, 0.0, 0.0, 0.0, false, 0, 0.0, 0.0, 0.0f, 0.0f, 0.0f, 0.0f};
 static struct globallocal_converter_reference_s gl_ref = {0.0f, false};
 
+/*
+ * Close to the reference the projection is replaced by its second order expansion
+ * in a = lat - lat_0 and b = lon - lon_0 (radians):
+ *   x = R (a + sin(lat_0) cos(lat_0) b^2 / 2)
+ *   y = R (cos(lat_0) b - sin(lat_0) a b)
+ * The third order terms are below 0.24 d^3 / (R^2 cos^2(lat_0)) at a distance d, those of
+ * the inverse below 0.36 d^3 / (R^2 cos^2(lat_0)). The expansion is used as long as this
+ * stays below MAP_PROJECTION_FAST_MAX_ERROR, about 10 km at the equator.
+ */
+#define FAST_RANGE_CUBE_GAIN ((float)MAP_PROJECTION_FAST_MAX_ERROR / 0.36f * \
+			      (float)CONSTANTS_RADIUS_OF_EARTH * (float)CONSTANTS_RADIUS_OF_EARTH)
+
+static inline float fast_range_sq(float cos_lat)
+{
+	return powf(FAST_RANGE_CUBE_GAIN * cos_lat * cos_lat, 2.0f / 3.0f);
+}
+
+/* offset in degrees, wrapped to the shorter way around */
+static inline double wrap_d_lon(double d_lon)
+{
+	return (d_lon > 180.0) ? d_lon - 360.0 : ((d_lon < -180.0) ? d_lon + 360.0 : d_lon);
+}
+
 __EXPORT bool map_projection_global_initialized()
 {
 	return map_projection_initialized(&mp_ref);
@@ -103,6 +126,13 @@ __EXPORT int map_projection_init_timestamped(struct map_projection_reference_s *
 	ref->sin_lat = sin(ref->lat_rad);
 	ref->cos_lat = cos(ref->lat_rad);
 
+	ref->lat_deg = lat_0;
+	ref->lon_deg = lon_0;
+	ref->fast_sin_lat = ref->sin_lat;
+	ref->fast_cos_lat = ref->cos_lat;
+	ref->fast_tan_lat = ref->sin_lat / ref->cos_lat;
+	ref->fast_range_sq = fast_range_sq(ref->fast_cos_lat);
+
 	ref->timestamp = timestamp;
 	ref->init_done = true;
 
@@ -198,6 +228,101 @@ __EXPORT int map_projection_reproject(const struct map_projection_reference_s *r
 	return 0;
 }
 
+__EXPORT int map_projection_project_fast(const struct map_projection_reference_s *ref, double lat, double lon,
+		float *x, float *y)
+{
+	if (!map_projection_initialized(ref)) {
+		return -1;
+	}
+
+	/* only the offsets need double precision */
+	float a = (float)(lat - ref->lat_deg) * M_DEG_TO_RAD_F;
+	float b = (float)wrap_d_lon(lon - ref->lon_deg) * M_DEG_TO_RAD_F;
+	float n = a * CONSTANTS_RADIUS_OF_EARTH;
+	float e = b * ref->fast_cos_lat * CONSTANTS_RADIUS_OF_EARTH;
+
+	if (n * n + e * e >= ref->fast_range_sq) {
+		return map_projection_project(ref, lat, lon, x, y);
+	}
+
+	*x = n + 0.5f * ref->fast_sin_lat * b * e;
+	*y = e - ref->fast_sin_lat * a * b * CONSTANTS_RADIUS_OF_EARTH;
+
+	return 0;
+}
+
+__EXPORT int map_projection_reproject_fast(const struct map_projection_reference_s *ref, float x, float y,
+		double *lat, double *lon)
+{
+	if (!map_projection_initialized(ref)) {
+		return -1;
+	}
+
+	if (x * x + y * y >= ref->fast_range_sq) {
+		return map_projection_reproject(ref, x, y, lat, lon);
+	}
+
+	/* inverse of the expansion in map_projection_project_fast */
+	float a = x / CONSTANTS_RADIUS_OF_EARTH;
+	float b = y / (CONSTANTS_RADIUS_OF_EARTH * ref->fast_cos_lat);
+
+	*lat = ref->lat_deg + (double)((a - 0.5f * ref->fast_sin_lat * ref->fast_cos_lat * b * b) * M_RAD_TO_DEG_F);
+	*lon = wrap_d_lon(ref->lon_deg + (double)(b * (1.0f + ref->fast_tan_lat * a) * M_RAD_TO_DEG_F));
+
+	return 0;
+}
+
+__EXPORT int map_projection_project_batch(const struct map_projection_reference_s *ref, const double *lat,
+		const double *lon, float *x, float *y, unsigned n)
+{
+	if (!map_projection_initialized(ref)) {
+		return -1;
+	}
+
+	const double *__restrict lat_in = lat;
+	const double *__restrict lon_in = lon;
+	float *__restrict x_out = x;
+	float *__restrict y_out = y;
+
+	const double lat_0 = ref->lat_deg;
+	const double lon_0 = ref->lon_deg;
+	const float sin_lat = ref->fast_sin_lat;
+	const float cos_lat = ref->fast_cos_lat;
+	const float range_sq = ref->fast_range_sq;
+	int far = 0;
+
+	/* branch free, so that the compiler can vectorize it */
+	for (unsigned i = 0; i < n; i++) {
+		float a = (float)(lat_in[i] - lat_0) * M_DEG_TO_RAD_F;
+		float b = (float)wrap_d_lon(lon_in[i] - lon_0) * M_DEG_TO_RAD_F;
+		float north = a * CONSTANTS_RADIUS_OF_EARTH;
+		float east = b * cos_lat * CONSTANTS_RADIUS_OF_EARTH;
+
+		far |= (north * north + east * east >= range_sq);
+
+		x_out[i] = north + 0.5f * sin_lat * b * east;
+		y_out[i] = east - sin_lat * a * b * CONSTANTS_RADIUS_OF_EARTH;
+	}
+
+	if (!far) {
+		return 0;
+	}
+
+	/* project the points out of range of the expansion again */
+	for (unsigned i = 0; i < n; i++) {
+		float a = (float)(lat_in[i] - lat_0) * M_DEG_TO_RAD_F;
+		float b = (float)wrap_d_lon(lon_in[i] - lon_0) * M_DEG_TO_RAD_F;
+		float north = a * CONSTANTS_RADIUS_OF_EARTH;
+		float east = b * cos_lat * CONSTANTS_RADIUS_OF_EARTH;
+
+		if (north * north + east * east >= range_sq) {
+			map_projection_project(ref, lat_in[i], lon_in[i], &x_out[i], &y_out[i]);
+		}
+	}
+
+	return 0;
+}
+
 __EXPORT int map_projection_global_getref(double *lat_0, double *lon_0)
 {
 	if (!map_projection_global_initialized()) {
@@ -316,6 +441,61 @@ __EXPORT float get_bearing_to_next_waypoint(double lat_now, double lon_now, doub
 	return theta;
 }
 
+/**
+ * Projects the next waypoint into the plane around the current position with the
+ * expansion used by map_projection_project_fast.
+ * @return false if the waypoint is too far away for the expansion
+ */
+static bool project_next_waypoint_fast(double lat_now, double lon_now, double lat_next, double lon_next,
+				       float *x, float *y)
+{
+	float lat_now_rad = (float)lat_now * M_DEG_TO_RAD_F;
+	float sin_lat = sinf(lat_now_rad);
+	float cos_lat = cosf(lat_now_rad);
+
+	float a = (float)(lat_next - lat_now) * M_DEG_TO_RAD_F;
+	float b = (float)wrap_d_lon(lon_next - lon_now) * M_DEG_TO_RAD_F;
+	float n = a * CONSTANTS_RADIUS_OF_EARTH;
+	float e = b * cos_lat * CONSTANTS_RADIUS_OF_EARTH;
+
+	/* same bound as fast_range_sq(), without the cube root */
+	float r_sq = n * n + e * e;
+	float range_cube = FAST_RANGE_CUBE_GAIN * cos_lat * cos_lat;
+
+	if (r_sq * r_sq * r_sq >= range_cube * range_cube) {
+		return false;
+	}
+
+	*x = n + 0.5f * sin_lat * b * e;
+	*y = e - sin_lat * a * b * CONSTANTS_RADIUS_OF_EARTH;
+
+	return true;
+}
+
+__EXPORT float get_distance_to_next_waypoint_fast(double lat_now, double lon_now, double lat_next, double lon_next)
+{
+	float x, y;
+
+	/* the projection is equidistant, the distance from its center is exact */
+	if (project_next_waypoint_fast(lat_now, lon_now, lat_next, lon_next, &x, &y)) {
+		return sqrtf(x * x + y * y);
+	}
+
+	return get_distance_to_next_waypoint(lat_now, lon_now, lat_next, lon_next);
+}
+
+__EXPORT float get_bearing_to_next_waypoint_fast(double lat_now, double lon_now, double lat_next, double lon_next)
+{
+	float x, y;
+
+	/* and so is the azimuth */
+	if (project_next_waypoint_fast(lat_now, lon_now, lat_next, lon_next, &x, &y)) {
+		return atan2f(y, x);
+	}
+
+	return get_bearing_to_next_waypoint(lat_now, lon_now, lat_next, lon_next);
+}
+
 __EXPORT void get_vector_to_next_waypoint(double lat_now, double lon_now, double lat_next, double lon_next, float *v_n,
 		float *v_e)
 {
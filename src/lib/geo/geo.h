@@ -57,6 +57,8 @@ __BEGIN_DECLS
 #define CONSTANTS_ABSOLUTE_NULL_CELSIUS			-273.15f		/* °C			*/
 #define CONSTANTS_RADIUS_OF_EARTH			6371000			/* meters (m)		*/
 
+#define MAP_PROJECTION_FAST_MAX_ERROR			0.01f			/* meters (m)		*/
+
 // XXX remove
 struct crosstrack_error_s {
 	bool past_end;		// Flag indicating we are past the end of the line/arc segment
@@ -72,6 +74,14 @@ struct map_projection_reference_s {
 	double cos_lat;
 	bool init_done;
 	uint64_t timestamp;
+
+	/* terms of the short range expansion used by the _fast functions */
+	double lat_deg;
+	double lon_deg;
+	float fast_sin_lat;
+	float fast_cos_lat;
+	float fast_tan_lat;
+	float fast_range_sq;	/**< squared distance (m^2) up to which the expansion is accurate */
 };
 
 struct globallocal_converter_reference_s {
@@ -195,6 +205,45 @@ __EXPORT int map_projection_global_reproject(float x, float y, double *lat, doub
 __EXPORT int map_projection_reproject(const struct map_projection_reference_s *ref, float x, float y, double *lat,
 				      double *lon);
 
+/**
+ * Same as map_projection_project, but uses a second order expansion around the
+ * reference for points close to it. The error stays below
+ * MAP_PROJECTION_FAST_MAX_ERROR, points further away are projected exactly.
+ *
+ * @param x north
+ * @param y east
+ * @param lat in degrees (47.1234567°, not 471234567°)
+ * @param lon in degrees (8.1234567°, not 81234567°)
+ * @return 0 if map_projection_init was called before, -1 else
+ */
+__EXPORT int map_projection_project_fast(const struct map_projection_reference_s *ref, double lat, double lon,
+		float *x, float *y);
+
+/**
+ * Same as map_projection_reproject, with the error bounded like map_projection_project_fast.
+ *
+ * @param x north
+ * @param y east
+ * @param lat in degrees (47.1234567°, not 471234567°)
+ * @param lon in degrees (8.1234567°, not 81234567°)
+ * @return 0 if map_projection_init was called before, -1 else
+ */
+__EXPORT int map_projection_reproject_fast(const struct map_projection_reference_s *ref, float x, float y,
+		double *lat, double *lon);
+
+/**
+ * Projects n points with map_projection_project_fast. The coordinates are passed
+ * as separate arrays so the expansion runs as one vectorizable loop.
+ *
+ * @param lat n latitudes in degrees
+ * @param lon n longitudes in degrees
+ * @param x n north positions
+ * @param y n east positions
+ * @return 0 if map_projection_init was called before, -1 else
+ */
+__EXPORT int map_projection_project_batch(const struct map_projection_reference_s *ref, const double *lat,
+		const double *lon, float *x, float *y, unsigned n);
+
 /**
  * Get reference position of the global map projection
  */
@@ -246,6 +295,19 @@ __EXPORT float get_distance_to_next_waypoint(double lat_now, double lon_now, dou
  */
 __EXPORT float get_bearing_to_next_waypoint(double lat_now, double lon_now, double lat_next, double lon_next);
 
+/**
+ * Same as get_distance_to_next_waypoint, but uses the expansion of
+ * map_projection_project_fast around the current position while the waypoint
+ * is close enough. The error stays below MAP_PROJECTION_FAST_MAX_ERROR.
+ */
+__EXPORT float get_distance_to_next_waypoint_fast(double lat_now, double lon_now, double lat_next, double lon_next);
+
+/**
+ * Same as get_bearing_to_next_waypoint, with the error bounded like
+ * get_distance_to_next_waypoint_fast.
+ */
+__EXPORT float get_bearing_to_next_waypoint_fast(double lat_now, double lon_now, double lat_next, double lon_next);
+
 __EXPORT void get_vector_to_next_waypoint(double lat_now, double lon_now, double lat_next, double lon_next, float *v_n,
 		float *v_e);
 
@@ -0,0 +1,382 @@
+#!/usr/bin/env python
+############################################################################
+#
+#   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name PX4 nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+#
+# Generate the magnetic field lookup tables of geo_mag_declination.c from the
+# World Magnetic Model.
+#
+#   generate_mag_tables.py [--epoch 2016.0] [--cof WMM.COF] > geo_magnetic_tables.h
+#   generate_mag_tables.py --check
+#
+# --check compares the bilinear interpolation of the tables with the model at
+# random positions instead.
+#
+
+# for python2.7 compatibility
+from __future__ import division, print_function
+
+import argparse
+import math
+import random
+
+SAMPLING_RES = 5
+SAMPLING_MIN_LAT = -90
+SAMPLING_MAX_LAT = 90
+SAMPLING_MIN_LON = -180
+SAMPLING_MAX_LON = 180
+
+# table units, see geo_mag_declination.c
+ANGLE_SCALE = 100.0	# 0.01 degrees
+STRENGTH_SCALE = 0.1	# 10 nT
+
+# WMM2015, valid 2015.0 - 2020.0: n, m, g, h (nT), g_dot, h_dot (nT/year)
+WMM_EPOCH = 2015.0
+WMM_COEFFICIENTS = """
+ 1  0  -29438.5       0.0       10.7        0.0
+ 1  1   -1501.1    4796.2       17.9      -26.8
+ 2  0   -2445.3       0.0       -8.6        0.0
+ 2  1    3012.5   -2845.6       -3.3      -27.1
+ 2  2    1676.6    -642.0        2.4      -13.3
+ 3  0    1351.1       0.0        3.1        0.0
+ 3  1   -2352.3    -115.3       -6.2        8.4
+ 3  2    1225.6     245.0       -0.4       -0.4
+ 3  3     581.9    -538.3      -10.4        2.3
+ 4  0     907.2       0.0       -0.4        0.0
+ 4  1     813.7     283.4        0.8       -0.6
+ 4  2     120.3    -188.6       -9.2        5.3
+ 4  3    -335.0     180.9        4.0        3.0
+ 4  4      70.3    -329.5       -4.2       -5.3
+ 5  0    -232.6       0.0       -0.2        0.0
+ 5  1     360.1      47.4        0.1        0.4
+ 5  2     192.4     196.9       -1.4        1.6
+ 5  3    -141.0    -119.4        0.0       -1.1
+ 5  4    -157.4      16.1        1.3        3.3
+ 5  5       4.3     100.1        3.8        0.1
+ 6  0      69.5       0.0       -0.5        0.0
+ 6  1      67.4     -20.7       -0.2        0.0
+ 6  2      72.8      33.2       -0.6       -2.2
+ 6  3    -129.8      58.8        2.4       -0.7
+ 6  4     -29.0     -66.5       -1.1        0.1
+ 6  5      13.2       7.3        0.3        1.0
+ 6  6     -70.9      62.5        1.5        1.3
+ 7  0      81.6       0.0        0.2        0.0
+ 7  1     -76.1     -54.1       -0.2        0.7
+ 7  2      -6.8     -19.4       -0.4        0.5
+ 7  3      51.9       5.6        1.3       -0.2
+ 7  4      15.0      24.4        0.2       -0.1
+ 7  5       9.3       3.3       -0.4       -0.7
+ 7  6      -2.8     -27.5       -0.9        0.1
+ 7  7       6.7      -2.3        0.3        0.1
+ 8  0      24.0       0.0        0.0        0.0
+ 8  1       8.6      10.2        0.1       -0.3
+ 8  2     -16.9     -18.1       -0.5        0.3
+ 8  3      -3.2      13.2        0.5        0.3
+ 8  4     -20.6     -14.6       -0.2        0.6
+ 8  5      13.3      16.2        0.4       -0.1
+ 8  6      11.7       5.7        0.2       -0.2
+ 8  7     -16.0      -9.1       -0.4        0.3
+ 8  8      -2.0       2.2        0.3        0.0
+ 9  0       5.4       0.0        0.0        0.0
+ 9  1       8.8     -21.6       -0.1       -0.2
+ 9  2       3.1      10.8       -0.1       -0.1
+ 9  3      -3.1      11.7        0.4       -0.2
+ 9  4       0.6      -6.8       -0.5        0.1
+ 9  5     -13.3      -6.9       -0.2        0.1
+ 9  6      -0.1       7.8        0.1        0.0
+ 9  7       8.7       1.0        0.0       -0.2
+ 9  8      -9.1      -3.9       -0.2        0.4
+ 9  9     -10.5       8.5       -0.1        0.3
+10  0      -1.9       0.0        0.0        0.0
+10  1      -6.5       3.3        0.0        0.1
+10  2       0.2      -0.3       -0.1       -0.1
+10  3       0.6       4.6        0.3        0.0
+10  4      -0.6       4.4       -0.1        0.0
+10  5       1.7      -7.9       -0.1       -0.2
+10  6      -0.7      -0.6       -0.1        0.1
+10  7       2.1      -4.1        0.0       -0.1
+10  8       2.3      -2.8       -0.2       -0.2
+10  9      -1.8      -1.1       -0.1        0.1
+10 10      -3.6      -8.7       -0.2       -0.1
+11  0       3.1       0.0        0.0        0.0
+11  1      -1.5      -0.1        0.0        0.0
+11  2      -2.3       2.1       -0.1        0.1
+11  3       2.1      -0.7        0.1        0.0
+11  4      -0.9      -1.1        0.0        0.1
+11  5       0.6       0.7        0.0        0.0
+11  6      -0.7      -0.2        0.0        0.0
+11  7       0.2      -2.1        0.0        0.1
+11  8       1.7      -1.5        0.0        0.0
+11  9      -0.2      -2.5        0.0       -0.1
+11 10       0.4      -2.0       -0.1       -0.1
+11 11       3.5      -2.3       -0.1       -0.1
+12  0      -2.0       0.0        0.1        0.0
+12  1      -0.3      -1.0        0.0        0.0
+12  2       0.4       0.5        0.0        0.0
+12  3       1.3       1.8        0.1       -0.1
+12  4      -0.9      -2.2       -0.1        0.0
+12  5       0.9       0.3        0.0        0.0
+12  6       0.1       0.7        0.1        0.0
+12  7       0.5      -0.1        0.0        0.0
+12  8      -0.4       0.3        0.0        0.0
+12  9      -0.4       0.2        0.0        0.0
+12 10       0.2      -0.9        0.0        0.0
+12 11      -0.9      -0.2        0.0        0.0
+12 12       0.0       0.7        0.0        0.0
+"""
+
+
+class MagneticModel(object):
+    """Spherical harmonic synthesis as described in the WMM technical report"""
+
+    WGS84_A = 6378.137
+    WGS84_F = 1.0 / 298.257223563
+    REFERENCE_RADIUS = 6371.2
+
+    def __init__(self, text, model_epoch, epoch):
+        self.g = {}
+        self.h = {}
+        self.degree = 0
+
+        for line in text.splitlines():
+            fields = line.split()
+
+            # skip the header and trailer lines of WMM.COF
+            if len(fields) != 6:
+                continue
+
+            n, m = int(fields[0]), int(fields[1])
+            g, h, g_dot, h_dot = [float(f) for f in fields[2:]]
+            self.g[n, m] = g + (epoch - model_epoch) * g_dot
+            self.h[n, m] = h + (epoch - model_epoch) * h_dot
+            self.degree = max(self.degree, n)
+
+        # Schmidt semi-normalisation
+        self.schmidt = {(0, 0): 1.0}
+
+        for n in range(1, self.degree + 1):
+            self.schmidt[n, 0] = self.schmidt[n - 1, 0] * (2 * n - 1) / n
+
+            for m in range(1, n + 1):
+                self.schmidt[n, m] = self.schmidt[n, m - 1] * math.sqrt(
+                    (n - m + 1) * (2.0 if m == 1 else 1.0) / (n + m))
+
+    def field(self, lat, lon):
+        """declination, inclination (degrees) and strength (nT) at sea level"""
+        # geocentric position of the point on the ellipsoid
+        e2 = self.WGS84_F * (2.0 - self.WGS84_F)
+        lat_rad = math.radians(lat)
+        rc = self.WGS84_A / math.sqrt(1.0 - e2 * math.sin(lat_rad) ** 2)
+        p = rc * math.cos(lat_rad)
+        z = rc * (1.0 - e2) * math.sin(lat_rad)
+        r = math.hypot(p, z)
+        lat_c = math.asin(z / r)
+
+        # Legendre functions of cos(colatitude) and their derivatives by colatitude
+        sin_c = math.sin(lat_c)
+        cos_c = math.cos(lat_c)
+        P = {(0, 0): 1.0}
+        dP = {(0, 0): 0.0}
+
+        for n in range(1, self.degree + 1):
+            for m in range(0, n + 1):
+                if n == m:
+                    P[n, m] = cos_c * P[n - 1, m - 1]
+                    dP[n, m] = cos_c * dP[n - 1, m - 1] + sin_c * P[n - 1, m - 1]
+
+                elif n == 1:
+                    P[n, m] = sin_c * P[n - 1, m]
+                    dP[n, m] = sin_c * dP[n - 1, m] - cos_c * P[n - 1, m]
+
+                else:
+                    k = float((n - 1) ** 2 - m ** 2) / ((2 * n - 1) * (2 * n - 3))
+                    P[n, m] = sin_c * P[n - 1, m] - k * P.get((n - 2, m), 0.0)
+                    dP[n, m] = sin_c * dP[n - 1, m] - cos_c * P[n - 1, m] - k * dP.get((n - 2, m), 0.0)
+
+        lon_rad = math.radians(lon)
+        north = 0.0
+        east = 0.0
+        down = 0.0
+
+        for n in range(1, self.degree + 1):
+            ratio = (self.REFERENCE_RADIUS / r) ** (n + 2)
+
+            for m in range(0, n + 1):
+                g = self.g[n, m] * self.schmidt[n, m]
+                h = self.h[n, m] * self.schmidt[n, m]
+                cos_m = math.cos(m * lon_rad)
+                sin_m = math.sin(m * lon_rad)
+
+                north += ratio * (g * cos_m + h * sin_m) * dP[n, m]
+                east += ratio * m * (g * sin_m - h * cos_m) * P[n, m]
+                down -= ratio * (n + 1) * (g * cos_m + h * sin_m) * P[n, m]
+
+        east /= cos_c
+
+        # back to the ellipsoid normal
+        d_lat = lat_c - lat_rad
+        north, down = (north * math.cos(d_lat) - down * math.sin(d_lat),
+                       north * math.sin(d_lat) + down * math.cos(d_lat))
+
+        horizontal = math.hypot(north, east)
+        return (math.degrees(math.atan2(east, north)),
+                math.degrees(math.atan2(down, horizontal)),
+                math.sqrt(horizontal ** 2 + down ** 2))
+
+
+def grid_lat(i):
+    # the declination is not defined at the poles, use the value just beside them
+    lat = SAMPLING_MIN_LAT + i * SAMPLING_RES
+    return max(min(lat, 89.99), -89.99)
+
+
+def grid_lon(j):
+    return SAMPLING_MIN_LON + j * SAMPLING_RES
+
+
+def tables(model):
+    rows = (SAMPLING_MAX_LAT - SAMPLING_MIN_LAT) // SAMPLING_RES + 1
+    cols = (SAMPLING_MAX_LON - SAMPLING_MIN_LON) // SAMPLING_RES + 1
+    declination = []
+    inclination = []
+    strength = []
+
+    for i in range(rows):
+        fields = [model.field(grid_lat(i), grid_lon(j)) for j in range(cols)]
+        declination.append([int(round(f[0] * ANGLE_SCALE)) for f in fields])
+        inclination.append([int(round(f[1] * ANGLE_SCALE)) for f in fields])
+        strength.append([int(round(f[2] * STRENGTH_SCALE)) for f in fields])
+
+    return declination, inclination, strength
+
+
+def print_table(name, table):
+    print("static const int16_t {}[{}][{}] = {{".format(name, len(table), len(table[0])))
+
+    for row in table:
+        print("\t{{ {} }},".format(", ".join(str(v) for v in row)))
+
+    print("};\n")
+
+
+def interpolate(table, lat, lon, wrap=None):
+    """same bilinear interpolation as geo_mag_declination.c"""
+    i = min(int((lat - SAMPLING_MIN_LAT) / SAMPLING_RES), len(table) - 2)
+    j = min(int((lon - SAMPLING_MIN_LON) / SAMPLING_RES), len(table[0]) - 2)
+    u = (lat - SAMPLING_MIN_LAT) / SAMPLING_RES - i
+    v = (lon - SAMPLING_MIN_LON) / SAMPLING_RES - j
+    sw = table[i][j]
+    corners = [table[i][j + 1] - sw, table[i + 1][j] - sw, table[i + 1][j + 1] - sw]
+
+    # angles are interpolated the short way around
+    if wrap:
+        corners = [c - wrap * round(c / wrap) for c in corners]
+
+    south = v * corners[0]
+    north = corners[1] + v * (corners[2] - corners[1])
+    return sw + south + u * (north - south)
+
+
+def check(model, declination, inclination, strength, max_lat):
+    random.seed(1)
+    samples = 20000
+    worst = [0.0, 0.0, 0.0]
+    squares = [0.0, 0.0, 0.0]
+
+    for _ in range(samples):
+        lat = random.uniform(-max_lat, max_lat)
+        lon = random.uniform(SAMPLING_MIN_LON, SAMPLING_MAX_LON)
+        exact = model.field(lat, lon)
+        errors = [abs((interpolate(declination, lat, lon, 360.0 * ANGLE_SCALE) / ANGLE_SCALE - exact[0] + 180.0) % 360.0 - 180.0),
+                  abs(interpolate(inclination, lat, lon) / ANGLE_SCALE - exact[1]),
+                  abs(interpolate(strength, lat, lon) / STRENGTH_SCALE - exact[2])]
+
+        for k in range(3):
+            worst[k] = max(worst[k], errors[k])
+            squares[k] += errors[k] ** 2
+
+    print("|lat| < {:2}: declination max {:.2f} rms {:.2f} deg, inclination max {:.2f} rms {:.2f} deg, "
+          "strength max {:.0f} rms {:.0f} nT".format(max_lat, worst[0], math.sqrt(squares[0] / samples),
+                                                    worst[1], math.sqrt(squares[1] / samples),
+                                                    worst[2], math.sqrt(squares[2] / samples)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the magnetic field lookup tables")
+    parser.add_argument("--epoch", type=float, default=2016.0, help="decimal year of the tables")
+    parser.add_argument("--cof", help="coefficient file in WMM.COF format, WMM2015 if not given")
+    parser.add_argument("--check", action="store_true", help="print the interpolation error instead")
+    args = parser.parse_args()
+
+    if args.cof:
+        with open(args.cof) as f:
+            text = f.read()
+
+        model_epoch = float(text.split()[0])
+
+    else:
+        text = WMM_COEFFICIENTS
+        model_epoch = WMM_EPOCH
+
+    model = MagneticModel(text, model_epoch, args.epoch)
+    declination, inclination, strength = tables(model)
+
+    if args.check:
+        for max_lat in (60, 80, 89):
+            check(model, declination, inclination, strength, max_lat)
+
+        return
+
+    print("/*")
+    print("* This file is automatically generated by generate_mag_tables.py - do not edit.")
+    print("*")
+    print("* World Magnetic Model at sea level, epoch {:.1f}".format(args.epoch))
+    print("*/")
+    print("")
+    print("#pragma once")
+    print("")
+    print("#define SAMPLING_RES\t\t{}".format(SAMPLING_RES))
+    print("#define SAMPLING_MIN_LAT\t{}".format(SAMPLING_MIN_LAT))
+    print("#define SAMPLING_MAX_LAT\t{}".format(SAMPLING_MAX_LAT))
+    print("#define SAMPLING_MIN_LON\t{}".format(SAMPLING_MIN_LON))
+    print("#define SAMPLING_MAX_LON\t{}".format(SAMPLING_MAX_LON))
+    print("")
+    print("/* declination and inclination in 0.01 degrees */")
+    print_table("declination_table", declination)
+    print_table("inclination_table", inclination)
+    print("/* strength in 10 nT */")
+    print_table("strength_table", strength)
+
+
+if __name__ == "__main__":
+    main()
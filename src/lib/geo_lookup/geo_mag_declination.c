@@ -34,98 +34,161 @@
 /**
 * @file geo_mag_declination.c
 *
-* Calculation / lookup table for earth magnetic field declination.
+* Calculation / lookup table for earth magnetic field declination,
+* inclination and strength.
 *
-* Lookup table from Scott Ferguson <scottfromscott@gmail.com>
-*
-* XXX Lookup table currently too coarse in resolution (only full degrees)
-* and lat/lon res - needs extension medium term.
+* The tables in geo_magnetic_tables.h are generated from the World Magnetic
+* Model by generate_mag_tables.py.
 *
 */
 
 #include <geo/geo.h>
+#include <math.h>
 
-/** set this always to the sampling in degrees for the table below */
-#define SAMPLING_RES		10.0f
-#define SAMPLING_MIN_LAT	-60.0f
-#define SAMPLING_MAX_LAT	60.0f
-#define SAMPLING_MIN_LON	-180.0f
-#define SAMPLING_MAX_LON	180.0f
+#include "geo_magnetic_tables.h"
 
-static const int8_t declination_table[13][37] = \
-{
-	{ 46, 45, 44, 42, 41, 40, 38, 36, 33, 28, 23, 16, 10, 4, -1, -5, -9, -14, -19, -26, -33, -40, -48, -55, -61, -66, -71, -74, -75, -72, -61, -25, 22, 40, 45, 47, 46 },
-	{ 30, 30, 30, 30, 29, 29, 29, 29, 27, 24, 18, 11, 3, -3, -9, -12, -15, -17, -21, -26, -32, -39, -45, -51, -55, -57, -56, -53, -44, -31, -14, 0, 13, 21, 26, 29, 30 },
-	{ 21, 22, 22, 22, 22, 22, 22, 22, 21, 18, 13, 5, -3, -11, -17, -20, -21, -22, -23, -25, -29, -35, -40, -44, -45, -44, -40, -32, -22, -12, -3, 3, 9, 14, 18, 20, 21 },
-	{ 16, 17, 17, 17, 17, 17, 16, 16, 16, 13, 8, 0, -9, -16, -21, -24, -25, -25, -23, -20, -21, -24, -28, -31, -31, -29, -24, -17, -9, -3, 0, 4, 7, 10, 13, 15, 16 },
-	{ 12, 13, 13, 13, 13, 13, 12, 12, 11, 9, 3, -4, -12, -19, -23, -24, -24, -22, -17, -12, -9, -10, -13, -17, -18, -16, -13, -8, -3, 0, 1, 3, 6, 8, 10, 12, 12 },
-	{ 10, 10, 10, 10, 10, 10, 10, 9, 9, 6, 0, -6, -14, -20, -22, -22, -19, -15, -10, -6, -2, -2, -4, -7, -8, -8, -7, -4, 0, 1, 1, 2, 4, 6, 8, 10, 10 },
-	{ 9, 9, 9, 9, 9, 9, 8, 8, 7, 4, -1, -8, -15, -19, -20, -18, -14, -9, -5, -2, 0, 1, 0, -2, -3, -4, -3, -2, 0, 0, 0, 1, 3, 5, 7, 8, 9 },
-	{ 8, 8, 8, 9, 9, 9, 8, 8, 6, 2, -3, -9, -15, -18, -17, -14, -10, -6, -2, 0, 1, 2, 2, 0, -1, -1, -2, -1, 0, 0, 0, 0, 1, 3, 5, 7, 8 },
-	{ 8, 9, 9, 10, 10, 10, 10, 8, 5, 0, -5, -11, -15, -16, -15, -12, -8, -4, -1, 0, 2, 3, 2, 1, 0, 0, 0, 0, 0, -1, -2, -2, -1, 0, 3, 6, 8 },
-	{ 6, 9, 10, 11, 12, 12, 11, 9, 5, 0, -7, -12, -15, -15, -13, -10, -7, -3, 0, 1, 2, 3, 3, 3, 2, 1, 0, 0, -1, -3, -4, -5, -5, -2, 0, 3, 6 },
-	{ 5, 8, 11, 13, 15, 15, 14, 11, 5, -1, -9, -14, -17, -16, -14, -11, -7, -3, 0, 1, 3, 4, 5, 5, 5, 4, 3, 1, -1, -4, -7, -8, -8, -6, -2, 1, 5 },
-	{ 4, 8, 12, 15, 17, 18, 16, 12, 5, -3, -12, -18, -20, -19, -16, -13, -8, -4, -1, 1, 4, 6, 8, 9, 9, 9, 7, 3, -1, -6, -10, -12, -11, -9, -5, 0, 4 },
-	{ 3, 9, 14, 17, 20, 21, 19, 14, 4, -8, -19, -25, -26, -25, -21, -17, -12, -7, -2, 1, 5, 9, 13, 15, 16, 16, 13, 7, 0, -7, -12, -15, -14, -11, -6, -1, 3 },
-};
-
-static float get_lookup_table_val(unsigned lat, unsigned lon);
+#define LAT_CELLS	((SAMPLING_MAX_LAT - SAMPLING_MIN_LAT) / SAMPLING_RES)
+#define LON_CELLS	((SAMPLING_MAX_LON - SAMPLING_MIN_LON) / SAMPLING_RES)
 
-__EXPORT float get_mag_declination(float lat, float lon)
+/* table units */
+#define ANGLE_SCALE	0.01f		/* degrees */
+#define STRENGTH_SCALE	0.0001f		/* Gauss */
+#define FULL_TURN	(360.0f / ANGLE_SCALE)
+
+typedef int16_t table_t[LAT_CELLS + 1][LON_CELLS + 1];
+
+static bool valid_position(float lat, float lon)
 {
 	/*
 	 * If the values exceed valid ranges, return zero as default
 	 * as we have no way of knowing what the closest real value
 	 * would be.
 	 */
-	if (lat < -90.0f || lat > 90.0f ||
-	    lon < -180.0f || lon > 180.0f) {
-		return 0.0f;
+	return lat >= -90.0f && lat <= 90.0f && lon >= -180.0f && lon <= 180.0f;
+}
+
+/* cell of the tables containing the position and the position inside it */
+static void get_cell(float lat, float lon, unsigned *lat_index, unsigned *lon_index, float *u, float *v)
+{
+	float x = fminf(fmaxf((lat - SAMPLING_MIN_LAT) / SAMPLING_RES, 0.0f), (float)LAT_CELLS);
+	float y = fminf(fmaxf((lon - SAMPLING_MIN_LON) / SAMPLING_RES, 0.0f), (float)LON_CELLS);
+
+	/* the upper bounds belong to the last cell */
+	*lat_index = (unsigned)fminf(x, LAT_CELLS - 1);
+	*lon_index = (unsigned)fminf(y, LON_CELLS - 1);
+	*u = x - *lat_index;
+	*v = y - *lon_index;
+}
+
+/*
+ * Bilinear interpolation of one cell as c[0] + c[1] u + c[2] v + c[3] u v,
+ * angles are interpolated the short way around.
+ */
+static void get_coefficients(const table_t table, unsigned lat_index, unsigned lon_index, float scale, bool angle,
+			     float c[4])
+{
+	float sw = table[lat_index][lon_index];
+	float nw = table[lat_index + 1][lon_index] - sw;
+	float se = table[lat_index][lon_index + 1] - sw;
+	float ne = table[lat_index + 1][lon_index + 1] - sw;
+
+	if (angle) {
+		nw -= FULL_TURN * roundf(nw / FULL_TURN);
+		se -= FULL_TURN * roundf(se / FULL_TURN);
+		ne -= FULL_TURN * roundf(ne / FULL_TURN);
 	}
 
-	/* round down to nearest sampling resolution */
-	int min_lat = (int)(lat / SAMPLING_RES) * SAMPLING_RES;
-	int min_lon = (int)(lon / SAMPLING_RES) * SAMPLING_RES;
+	c[0] = sw * scale;
+	c[1] = nw * scale;
+	c[2] = se * scale;
+	c[3] = (ne - nw - se) * scale;
+}
 
-	/* for the rare case of hitting the bounds exactly
-	 * the rounding logic wouldn't fit, so enforce it.
-	 */
+static float interpolate(const float c[4], float u, float v)
+{
+	return c[0] + u * c[1] + v * (c[2] + u * c[3]);
+}
+
+static float wrap_180(float angle)
+{
+	return angle - 360.0f * roundf(angle / 360.0f);
+}
 
-	/* limit to table bounds - required for maxima even when table spans full globe range */
-	if (lat <= SAMPLING_MIN_LAT) {
-		min_lat = SAMPLING_MIN_LAT;
+static float lookup(const table_t table, float lat, float lon, float scale, bool angle)
+{
+	unsigned lat_index, lon_index;
+	float u, v, c[4];
+
+	get_cell(lat, lon, &lat_index, &lon_index, &u, &v);
+	get_coefficients(table, lat_index, lon_index, scale, angle, c);
+
+	return interpolate(c, u, v);
+}
+
+__EXPORT float get_mag_declination(float lat, float lon)
+{
+	if (!valid_position(lat, lon)) {
+		return 0.0f;
 	}
 
-	if (lat >= SAMPLING_MAX_LAT) {
-		min_lat = (int)(lat / SAMPLING_RES) * SAMPLING_RES - SAMPLING_RES;
+	return wrap_180(lookup(declination_table, lat, lon, ANGLE_SCALE, true));
+}
+
+__EXPORT float get_mag_inclination(float lat, float lon)
+{
+	if (!valid_position(lat, lon)) {
+		return 0.0f;
 	}
 
-	if (lon <= SAMPLING_MIN_LON) {
-		min_lon = SAMPLING_MIN_LON;
+	return lookup(inclination_table, lat, lon, ANGLE_SCALE, false);
+}
+
+__EXPORT float get_mag_strength(float lat, float lon)
+{
+	if (!valid_position(lat, lon)) {
+		return 0.0f;
 	}
 
-	if (lon >= SAMPLING_MAX_LON) {
-		min_lon = (int)(lon / SAMPLING_RES) * SAMPLING_RES - SAMPLING_RES;
+	return lookup(strength_table, lat, lon, STRENGTH_SCALE, false);
+}
+
+__EXPORT void geo_mag_cache_init(struct geo_mag_cache_s *cache)
+{
+	cache->lat_index = -1;
+	cache->lon_index = -1;
+}
+
+__EXPORT int get_mag_field_cached(struct geo_mag_cache_s *cache, float lat, float lon, float *declination,
+				  float *inclination, float *strength)
+{
+	if (!valid_position(lat, lon)) {
+		return -1;
 	}
 
-	/* find index of nearest low sampling point */
-	unsigned min_lat_index = (-(SAMPLING_MIN_LAT) + min_lat)  / SAMPLING_RES;
-	unsigned min_lon_index = (-(SAMPLING_MIN_LON) + min_lon) / SAMPLING_RES;
+	unsigned lat_index, lon_index;
+	float u, v;
+
+	get_cell(lat, lon, &lat_index, &lon_index, &u, &v);
+
+	if ((int)lat_index != cache->lat_index || (int)lon_index != cache->lon_index) {
+		get_coefficients(declination_table, lat_index, lon_index, ANGLE_SCALE, true, cache->declination);
+		get_coefficients(inclination_table, lat_index, lon_index, ANGLE_SCALE, false, cache->inclination);
+		get_coefficients(strength_table, lat_index, lon_index, STRENGTH_SCALE, false, cache->strength);
+		cache->lat_index = lat_index;
+		cache->lon_index = lon_index;
+	}
 
-	float declination_sw = get_lookup_table_val(min_lat_index, min_lon_index);
-	float declination_se = get_lookup_table_val(min_lat_index, min_lon_index + 1);
-	float declination_ne = get_lookup_table_val(min_lat_index + 1, min_lon_index + 1);
-	float declination_nw = get_lookup_table_val(min_lat_index + 1, min_lon_index);
+	if (declination != NULL) {
+		*declination = wrap_180(interpolate(cache->declination, u, v));
+	}
 
-	/* perform bilinear interpolation on the four grid corners */
+	if (inclination != NULL) {
+		*inclination = interpolate(cache->inclination, u, v);
+	}
 
-	float declination_min = ((lon - min_lon) / SAMPLING_RES) * (declination_se - declination_sw) + declination_sw;
-	float declination_max = ((lon - min_lon) / SAMPLING_RES) * (declination_ne - declination_nw) + declination_nw;
+	if (strength != NULL) {
+		*strength = interpolate(cache->strength, u, v);
+	}
 
-	return ((lat - min_lat) / SAMPLING_RES) * (declination_max - declination_min) + declination_min;
+	return 0;
 }
-
-float get_lookup_table_val(unsigned lat_index, unsigned lon_index)
-{
-	return declination_table[lat_index][lon_index];
-}
\ No newline at end of file
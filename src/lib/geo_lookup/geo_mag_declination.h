@@ -34,7 +34,8 @@
 /**
 * @file geo_mag_declination.h
 *
-* Calculation / lookup table for earth magnetic field declination.
+* Calculation / lookup table for earth magnetic field declination,
+* inclination and strength.
 *
 */
 
@@ -42,6 +43,56 @@
 
 __BEGIN_DECLS
 
+/**
+ * Interpolation coefficients of the table cell of the last lookup,
+ * see get_mag_field_cached().
+ */
+struct geo_mag_cache_s {
+	int lat_index;
+	int lon_index;
+	float declination[4];
+	float inclination[4];
+	float strength[4];
+};
+
+/**
+ * Magnetic declination in degrees, positive east.
+ *
+ * @param lat in degrees (47.1234567°, not 471234567°)
+ * @param lon in degrees (8.1234567°, not 81234567°)
+ * @return declination, 0 for invalid positions
+ */
 __EXPORT float get_mag_declination(float lat, float lon);
 
+/**
+ * Magnetic inclination in degrees, positive down.
+ *
+ * @return inclination, 0 for invalid positions
+ */
+__EXPORT float get_mag_inclination(float lat, float lon);
+
+/**
+ * Magnetic field strength in Gauss.
+ *
+ * @return strength, 0 for invalid positions
+ */
+__EXPORT float get_mag_strength(float lat, float lon);
+
+/**
+ * Invalidate the cache, required before its first use.
+ */
+__EXPORT void geo_mag_cache_init(struct geo_mag_cache_s *cache);
+
+/**
+ * Same as the functions above, but keeps the table cell of the last position
+ * in the cache. Repeated queries from the same cell only evaluate its interpolation.
+ *
+ * @param declination in degrees, may be NULL
+ * @param inclination in degrees, may be NULL
+ * @param strength in Gauss, may be NULL
+ * @return 0 on success, -1 for invalid positions
+ */
+__EXPORT int get_mag_field_cached(struct geo_mag_cache_s *cache, float lat, float lon, float *declination,
+				  float *inclination, float *strength);
+
 __END_DECLS
@@ -0,0 +1,136 @@
+/*
+* This file is automatically generated by generate_mag_tables.py - do not edit.
+*
+* World Magnetic Model at sea level, epoch 2016.0
+*/
+
+#pragma once
+
+#define SAMPLING_RES		5
+#define SAMPLING_MIN_LAT	-90
+#define SAMPLING_MAX_LAT	90
+#define SAMPLING_MIN_LON	-180
+#define SAMPLING_MAX_LON	180
+
+/* declination and inclination in 0.01 degrees */
+static const int16_t declination_table[37][73] = {
+	{ 14979, 14479, 13979, 13479, 12979, 12479, 11979, 11479, 10979, 10479, 9979, 9479, 8979, 8479, 7979, 7479, 6979, 6479, 5979, 5479, 4979, 4479, 3980, 3480, 2980, 2480, 1980, 1480, 980, 481, -19, -519, -1019, -1519, -2019, -2518, -3018, -3518, -4018, -4518, -5018, -5518, -6018, -6518, -7018, -7518, -8018, -8518, -9018, -9518, -10018, -10518, -11018, -11518, -12018, -12518, -13018, -13518, -14019, -14519, -15019, -15519, -16019, -16519, -17019, -17520, 17980, 17480, 16980, 16480, 15980, 15479, 14979 },
+	{ 14240, 13674, 13115, 12566, 12025, 11493, 10971, 10457, 9952, 9455, 8966, 8484, 8009, 7540, 7077, 6619, 6165, 5716, 5271, 4829, 4390, 3954, 3519, 3086, 2655, 2224, 1794, 1364, 934, 503, 71, -362, -797, -1234, -1673, -2115, -2560, -3008, -3459, -3914, -4373, -4836, -5304, -5776, -6252, -6733, -7220, -7712, -8209, -8712, -9221, -9736, -10258, -10787, -11322, -11865, -12415, -12971, -13535, -14106, -14683, -15266, -15853, -16445, -17040, -17637, 17765, 17168, 16574, 15982, 15395, 14814, 14240 },
+	{ 13024, 12392, 11790, 11216, 10668, 10145, 9644, 9163, 8699, 8250, 7813, 7388, 6972, 6563, 6161, 5764, 5371, 4982, 4596, 4212, 3831, 3452, 3074, 2698, 2323, 1949, 1576, 1202, 828, 452, 74, -306, -690, -1078, -1470, -1868, -2272, -2681, -3097, -3518, -3946, -4379, -4819, -5265, -5716, -6174, -6637, -7108, -7585, -8070, -8564, -9067, -9581, -10107, -10647, -11203, -11776, -12369, -12983, -13620, -14280, -14965, -15672, -16399, -17144, -17901, 17337, 16576, 15825, 15089, 14374, 13685, 13024 },
+	{ 11086, 10469, 9911, 9403, 8937, 8505, 8101, 7719, 7354, 7002, 6660, 6324, 5993, 5664, 5335, 5005, 4674, 4341, 4006, 3670, 3333, 2996, 2659, 2323, 1989, 1657, 1326, 997, 668, 338, 7, -327, -667, -1012, -1366, -1727, -2098, -2479, -2868, -3266, -3673, -4086, -4506, -4931, -5361, -5795, -6233, -6674, -7120, -7571, -8029, -8494, -8970, -9459, -9964, -10492, -11046, -11634, -12264, -12944, -13685, -14496, -15384, -16351, -17387, 17528, 16429, 15353, 14333, 13392, 12539, 11773, 11086 },
+	{ 8554, 8131, 7759, 7425, 7123, 6843, 6582, 6334, 6095, 5860, 5627, 5392, 5153, 4906, 4651, 4386, 4110, 3824, 3528, 3225, 2915, 2602, 2286, 1971, 1659, 1351, 1048, 751, 458, 168, -122, -414, -712, -1017, -1334, -1664, -2007, -2364, -2735, -3118, -3510, -3910, -4316, -4725, -5135, -5545, -5954, -6361, -6766, -7169, -7572, -7976, -8384, -8799, -9225, -9669, -10138, -10645, -11204, -11842, -12594, -13516, -14687, -16195, 17940, 15892, 13992, 12450, 11265, 10353, 9633, 9047, 8554 },
+	{ 6270, 6084, 5908, 5744, 5588, 5442, 5302, 5167, 5034, 4902, 4765, 4620, 4465, 4294, 4106, 3899, 3672, 3424, 3157, 2874, 2577, 2270, 1957, 1645, 1335, 1034, 743, 464, 197, -61, -314, -565, -820, -1085, -1364, -1661, -1978, -2315, -2670, -3041, -3424, -3814, -4208, -4602, -4993, -5377, -5752, -6117, -6472, -6815, -7148, -7471, -7784, -8088, -8387, -8680, -8972, -9265, -9567, -9888, -10251, -10717, -11496, -14133, 10978, 8659, 7936, 7511, 7191, 6923, 6687, 6470, 6270 },
+	{ 4717, 4661, 4597, 4527, 4456, 4386, 4319, 4254, 4191, 4128, 4061, 3987, 3899, 3794, 3665, 3510, 3326, 3111, 2866, 2595, 2300, 1987, 1662, 1335, 1012, 700, 406, 132, -121, -354, -572, -782, -993, -1213, -1450, -1710, -1996, -2310, -2648, -3007, -3381, -3762, -4144, -4522, -4891, -5245, -5582, -5900, -6197, -6470, -6720, -6943, -7138, -7302, -7429, -7510, -7530, -7467, -7276, -6879, -6115, -4687, -2292, 476, 2446, 3553, 4156, 4487, 4663, 4746, 4770, 4756, 4717 },
+	{ 3726, 3726, 3710, 3684, 3652, 3619, 3586, 3556, 3530, 3506, 3483, 3456, 3418, 3363, 3284, 3175, 3030, 2846, 2621, 2357, 2058, 1731, 1384, 1029, 678, 342, 31, -249, -496, -710, -898, -1068, -1232, -1401, -1588, -1802, -2049, -2331, -2647, -2989, -3350, -3719, -4088, -4447, -4790, -5111, -5405, -5670, -5902, -6098, -6254, -6367, -6430, -6434, -6367, -6210, -5936, -5510, -4888, -4027, -2919, -1639, -352, 777, 1671, 2338, 2819, 3160, 3395, 3551, 3649, 3703, 3726 },
+	{ 3062, 3084, 3090, 3083, 3070, 3052, 3034, 3018, 3007, 3000, 2998, 2997, 2990, 2971, 2931, 2860, 2750, 2594, 2388, 2131, 1826, 1480, 1105, 716, 329, -39, -375, -668, -915, -1117, -1280, -1414, -1532, -1647, -1776, -1932, -2126, -2364, -2644, -2961, -3301, -3653, -4003, -4339, -4652, -4936, -5183, -5390, -5552, -5665, -5723, -5721, -5650, -5498, -5252, -4896, -4418, -3810, -3085, -2275, -1431, -610, 141, 797, 1350, 1803, 2167, 2451, 2669, 2829, 2942, 3017, 3062 },
+	{ 2582, 2613, 2628, 2632, 2628, 2618, 2607, 2595, 2587, 2583, 2586, 2593, 2601, 2602, 2587, 2545, 2464, 2333, 2145, 1895, 1584, 1220, 817, 392, -30, -429, -787, -1092, -1340, -1532, -1676, -1783, -1864, -1932, -2003, -2093, -2218, -2392, -2618, -2892, -3202, -3528, -3852, -4160, -4439, -4680, -4876, -5022, -5112, -5142, -5105, -4996, -4807, -4530, -4159, -3694, -3148, -2544, -1916, -1295, -707, -165, 324, 760, 1144, 1477, 1762, 1998, 2190, 2340, 2451, 2530, 2582 },
+	{ 2211, 2245, 2264, 2274, 2277, 2273, 2265, 2255, 2245, 2238, 2236, 2240, 2248, 2255, 2252, 2227, 2167, 2057, 1884, 1641, 1326, 947, 520, 68, -381, -800, -1170, -1476, -1718, -1899, -2029, -2119, -2178, -2214, -2237, -2261, -2305, -2393, -2539, -2748, -3006, -3293, -3585, -3860, -4103, -4301, -4448, -4535, -4558, -4514, -4397, -4206, -3936, -3587, -3164, -2683, -2170, -1656, -1167, -718, -311, 57, 394, 703, 987, 1245, 1474, 1674, 1843, 1979, 2083, 2159, 2211 },
+	{ 1913, 1945, 1966, 1979, 1986, 1988, 1984, 1975, 1963, 1951, 1942, 1937, 1937, 1939, 1938, 1920, 1871, 1774, 1612, 1374, 1058, 670, 228, -240, -700, -1124, -1490, -1785, -2012, -2179, -2296, -2375, -2421, -2436, -2422, -2384, -2342, -2324, -2363, -2475, -2659, -2891, -3143, -3387, -3599, -3765, -3874, -3918, -3893, -3798, -3633, -3399, -3098, -2735, -2323, -1885, -1448, -1041, -677, -360, -81, 173, 412, 641, 859, 1066, 1256, 1427, 1575, 1698, 1794, 1864, 1913 },
+	{ 1668, 1696, 1716, 1730, 1740, 1746, 1747, 1740, 1728, 1712, 1695, 1680, 1670, 1664, 1658, 1640, 1595, 1503, 1347, 1111, 794, 401, -45, -514, -972, -1385, -1733, -2009, -2214, -2360, -2460, -2524, -2553, -2544, -2491, -2392, -2263, -2136, -2052, -2047, -2133, -2297, -2506, -2725, -2924, -3078, -3174, -3201, -3159, -3049, -2876, -2643, -2356, -2023, -1658, -1284, -930, -616, -353, -134, 55, 230, 402, 577, 752, 923, 1085, 1233, 1364, 1475, 1561, 1625, 1668 },
+	{ 1467, 1489, 1505, 1517, 1529, 1538, 1542, 1539, 1528, 1510, 1489, 1467, 1448, 1434, 1421, 1400, 1353, 1261, 1104, 868, 549, 157, -285, -745, -1186, -1579, -1902, -2152, -2331, -2451, -2524, -2558, -2554, -2505, -2402, -2243, -2039, -1820, -1632, -1519, -1507, -1594, -1755, -1954, -2151, -2315, -2422, -2463, -2435, -2343, -2194, -1994, -1750, -1466, -1159, -850, -567, -328, -141, 6, 129, 249, 377, 515, 661, 807, 948, 1079, 1197, 1296, 1374, 1430, 1467 },
+	{ 1304, 1320, 1329, 1338, 1348, 1358, 1365, 1364, 1356, 1339, 1315, 1290, 1266, 1247, 1230, 1204, 1153, 1057, 895, 655, 335, -53, -485, -927, -1345, -1710, -2005, -2225, -2373, -2459, -2493, -2482, -2427, -2324, -2167, -1957, -1706, -1440, -1198, -1020, -934, -951, -1059, -1228, -1419, -1594, -1723, -1790, -1793, -1736, -1628, -1475, -1281, -1052, -801, -549, -322, -141, -9, 85, 162, 243, 340, 455, 582, 712, 838, 957, 1064, 1155, 1226, 1275, 1304 },
+	{ 1176, 1184, 1186, 1189, 1196, 1205, 1212, 1214, 1208, 1193, 1170, 1145, 1121, 1101, 1081, 1051, 994, 890, 721, 475, 155, -226, -643, -1063, -1452, -1787, -2050, -2238, -2350, -2394, -2379, -2311, -2198, -2040, -1841, -1604, -1343, -1077, -831, -634, -511, -477, -534, -664, -834, -1007, -1149, -1239, -1271, -1251, -1184, -1078, -933, -755, -553, -348, -166, -28, 64, 121, 165, 219, 296, 395, 510, 630, 747, 858, 959, 1045, 1111, 1154, 1176 },
+	{ 1080, 1081, 1076, 1072, 1074, 1080, 1087, 1091, 1086, 1073, 1053, 1030, 1008, 988, 968, 934, 870, 756, 577, 326, 7, -365, -763, -1157, -1517, -1820, -2050, -2202, -2274, -2272, -2204, -2081, -1915, -1716, -1494, -1257, -1014, -775, -555, -369, -235, -173, -189, -279, -420, -578, -719, -820, -873, -881, -849, -781, -680, -544, -385, -220, -75, 31, 93, 123, 144, 180, 243, 333, 441, 555, 668, 775, 874, 959, 1023, 1063, 1080 },
+	{ 1010, 1007, 995, 985, 982, 985, 992, 997, 994, 984, 966, 945, 925, 907, 885, 845, 771, 646, 457, 201, -115, -475, -853, -1220, -1550, -1820, -2016, -2130, -2161, -2114, -1999, -1831, -1628, -1406, -1179, -956, -743, -542, -356, -192, -64, 12, 22, -36, -147, -284, -415, -518, -581, -607, -599, -563, -495, -397, -274, -144, -31, 48, 87, 98, 104, 127, 181, 264, 368, 480, 593, 701, 802, 889, 955, 995, 1010 },
+	{ 961, 956, 941, 927, 920, 922, 929, 936, 936, 928, 913, 894, 875, 855, 827, 778, 692, 553, 353, 93, -220, -566, -922, -1262, -1560, -1796, -1956, -2032, -2025, -1940, -1791, -1594, -1371, -1141, -920, -717, -533, -367, -213, -74, 44, 123, 149, 115, 28, -89, -207, -305, -371, -407, -415, -400, -360, -292, -202, -103, -18, 38, 58, 54, 47, 61, 107, 185, 286, 398, 512, 625, 732, 826, 899, 944, 961 },
+	{ 925, 924, 910, 895, 887, 890, 899, 909, 914, 909, 896, 878, 856, 831, 793, 730, 627, 472, 260, -6, -314, -646, -980, -1291, -1556, -1758, -1881, -1921, -1880, -1767, -1597, -1387, -1158, -930, -719, -534, -374, -235, -108, 11, 115, 193, 227, 208, 140, 41, -65, -156, -221, -260, -278, -278, -258, -215, -153, -84, -25, 8, 10, -7, -24, -19, 19, 91, 189, 301, 420, 540, 656, 761, 845, 900, 925 },
+	{ 893, 903, 897, 886, 882, 888, 902, 917, 928, 927, 916, 896, 870, 834, 782, 701, 577, 403, 176, -97, -402, -721, -1032, -1314, -1546, -1710, -1797, -1805, -1737, -1606, -1426, -1214, -989, -769, -568, -397, -254, -134, -27, 75, 167, 240, 278, 269, 215, 130, 35, -48, -110, -150, -173, -182, -176, -154, -117, -76, -43, -33, -48, -79, -107, -113, -84, -19, 74, 186, 309, 437, 565, 684, 783, 854, 893 },
+	{ 856, 885, 893, 894, 898, 912, 934, 957, 974, 978, 969, 947, 913, 865, 794, 690, 542, 345, 100, -183, -487, -795, -1085, -1337, -1534, -1661, -1713, -1692, -1604, -1463, -1281, -1075, -859, -648, -457, -296, -164, -56, 39, 127, 209, 277, 315, 313, 270, 197, 113, 37, -21, -60, -85, -101, -106, -101, -87, -71, -64, -78, -112, -159, -201, -219, -202, -147, -61, 50, 177, 313, 453, 588, 706, 797, 856 },
+	{ 807, 861, 892, 912, 932, 958, 990, 1023, 1047, 1056, 1049, 1024, 982, 918, 827, 698, 523, 300, 35, -262, -570, -870, -1141, -1365, -1527, -1618, -1638, -1592, -1489, -1343, -1165, -967, -761, -561, -378, -222, -95, 7, 93, 172, 247, 309, 347, 350, 317, 255, 181, 113, 60, 22, -4, -24, -39, -49, -56, -65, -85, -123, -179, -245, -302, -335, -332, -290, -211, -104, 25, 169, 321, 472, 609, 723, 807 },
+	{ 742, 826, 887, 934, 976, 1020, 1066, 1108, 1140, 1154, 1148, 1120, 1068, 989, 877, 722, 520, 269, -21, -334, -650, -946, -1202, -1400, -1531, -1590, -1582, -1515, -1401, -1252, -1079, -889, -693, -500, -323, -170, -44, 56, 139, 214, 282, 340, 379, 388, 365, 316, 254, 195, 146, 110, 82, 57, 33, 8, -20, -55, -103, -168, -248, -335, -411, -461, -473, -443, -374, -270, -140, 10, 172, 337, 493, 631, 742 },
+	{ 663, 779, 874, 953, 1024, 1090, 1152, 1206, 1245, 1264, 1258, 1227, 1166, 1072, 938, 758, 527, 248, -68, -403, -730, -1027, -1271, -1449, -1553, -1586, -1554, -1471, -1348, -1197, -1026, -843, -653, -465, -290, -137, -9, 93, 178, 251, 318, 375, 415, 432, 421, 388, 341, 293, 250, 215, 184, 152, 116, 74, 24, -39, -117, -212, -319, -429, -526, -593, -621, -603, -542, -442, -311, -156, 14, 190, 363, 523, 663 },
+	{ 576, 724, 854, 968, 1070, 1162, 1243, 1310, 1357, 1380, 1375, 1339, 1269, 1160, 1006, 801, 541, 231, -114, -473, -816, -1117, -1354, -1516, -1601, -1613, -1564, -1468, -1337, -1183, -1012, -830, -642, -456, -281, -124, 9, 118, 208, 286, 354, 414, 461, 489, 495, 480, 452, 418, 383, 348, 312, 270, 219, 156, 78, -16, -127, -255, -393, -529, -647, -731, -772, -765, -709, -612, -480, -322, -145, 42, 230, 410, 576 },
+	{ 491, 668, 831, 979, 1112, 1230, 1332, 1413, 1470, 1499, 1495, 1455, 1376, 1252, 1077, 845, 554, 211, -168, -554, -916, -1224, -1459, -1611, -1682, -1680, -1618, -1512, -1374, -1214, -1039, -854, -664, -476, -297, -133, 9, 129, 230, 317, 395, 464, 523, 567, 593, 602, 595, 577, 552, 518, 475, 419, 347, 257, 147, 17, -134, -299, -471, -634, -773, -874, -925, -924, -872, -775, -641, -477, -293, -97, 104, 302, 491 },
+	{ 419, 621, 811, 989, 1150, 1294, 1417, 1515, 1584, 1619, 1618, 1576, 1489, 1349, 1151, 888, 561, 178, -240, -659, -1044, -1363, -1598, -1744, -1805, -1793, -1723, -1608, -1462, -1294, -1112, -920, -724, -529, -341, -167, -11, 125, 243, 348, 442, 528, 606, 672, 723, 759, 777, 779, 764, 732, 681, 608, 511, 387, 237, 62, -134, -343, -552, -745, -906, -1020, -1078, -1080, -1027, -927, -787, -617, -424, -218, -5, 209, 419 },
+	{ 366, 588, 802, 1003, 1189, 1355, 1498, 1614, 1697, 1744, 1749, 1706, 1611, 1454, 1228, 928, 555, 121, -346, -805, -1217, -1550, -1788, -1930, -1983, -1963, -1884, -1761, -1606, -1429, -1236, -1033, -825, -618, -417, -228, -53, 106, 249, 380, 500, 613, 717, 812, 893, 958, 1004, 1028, 1027, 998, 939, 847, 720, 556, 357, 128, -123, -384, -636, -861, -1042, -1167, -1230, -1230, -1172, -1065, -916, -737, -535, -317, -91, 138, 366 },
+	{ 332, 572, 804, 1025, 1231, 1418, 1581, 1715, 1815, 1875, 1889, 1848, 1745, 1569, 1309, 960, 525, 23, -509, -1020, -1466, -1813, -2053, -2188, -2232, -2201, -2111, -1977, -1810, -1619, -1411, -1193, -970, -746, -526, -314, -113, 76, 252, 417, 574, 722, 862, 991, 1107, 1205, 1281, 1329, 1345, 1323, 1259, 1149, 989, 780, 523, 228, -90, -412, -715, -977, -1179, -1313, -1376, -1371, -1305, -1188, -1029, -838, -624, -394, -155, 89, 332 },
+	{ 315, 570, 818, 1056, 1280, 1485, 1667, 1821, 1939, 2015, 2040, 2003, 1891, 1690, 1386, 970, 448, -151, -772, -1349, -1831, -2190, -2423, -2543, -2569, -2520, -2412, -2259, -2074, -1864, -1637, -1398, -1153, -906, -660, -418, -184, 41, 258, 466, 666, 857, 1039, 1209, 1365, 1500, 1609, 1687, 1726, 1718, 1656, 1533, 1344, 1085, 763, 390, -11, -411, -776, -1081, -1308, -1452, -1514, -1501, -1425, -1297, -1126, -923, -696, -454, -201, 57, 315 },
+	{ 306, 575, 839, 1093, 1334, 1558, 1758, 1931, 2068, 2160, 2195, 2160, 2036, 1799, 1429, 912, 260, -479, -1217, -1868, -2376, -2726, -2933, -3019, -3010, -2927, -2788, -2606, -2393, -2156, -1902, -1636, -1362, -1085, -806, -529, -256, 12, 274, 529, 777, 1016, 1245, 1461, 1660, 1838, 1987, 2102, 2174, 2193, 2148, 2027, 1820, 1521, 1132, 668, 164, -334, -782, -1146, -1408, -1567, -1632, -1615, -1530, -1391, -1210, -995, -757, -503, -237, 34, 306 },
+	{ 298, 581, 859, 1129, 1386, 1627, 1845, 2035, 2187, 2291, 2331, 2287, 2131, 1828, 1344, 657, -204, -1138, -2004, -2694, -3174, -3465, -3601, -3618, -3548, -3410, -3223, -2999, -2746, -2472, -2183, -1882, -1574, -1260, -945, -628, -313, -1, 307, 610, 907, 1195, 1472, 1736, 1983, 2208, 2406, 2570, 2690, 2755, 2752, 2665, 2474, 2165, 1729, 1178, 553, -79, -647, -1102, -1425, -1620, -1702, -1692, -1607, -1464, -1277, -1055, -809, -545, -269, 13, 298 },
+	{ 289, 581, 870, 1151, 1419, 1671, 1900, 2097, 2252, 2348, 2365, 2270, 2019, 1552, 813, -206, -1385, -2496, -3358, -3929, -4252, -4390, -4394, -4301, -4140, -3927, -3676, -3396, -3095, -2777, -2446, -2106, -1759, -1408, -1053, -698, -342, 11, 362, 709, 1050, 1384, 1708, 2020, 2317, 2596, 2851, 3076, 3263, 3402, 3478, 3474, 3366, 3126, 2728, 2158, 1439, 645, -113, -743, -1202, -1491, -1635, -1664, -1604, -1477, -1298, -1081, -836, -570, -291, -3, 289 },
+	{ 311, 594, 874, 1145, 1403, 1639, 1843, 2002, 2096, 2096, 1955, 1602, 940, -125, -1548, -3020, -4181, -4926, -5330, -5497, -5504, -5402, -5225, -4993, -4722, -4421, -4098, -3756, -3402, -3037, -2663, -2284, -1899, -1512, -1122, -732, -341, 48, 436, 821, 1201, 1576, 1944, 2303, 2651, 2987, 3305, 3604, 3876, 4115, 4312, 4453, 4520, 4489, 4327, 3992, 3445, 2676, 1746, 796, -21, -622, -1006, -1210, -1274, -1235, -1121, -951, -741, -502, -242, 31, 311 },
+	{ 893, 977, 1053, 1092, 1058, 890, 486, -329, -1792, -3881, -5879, -7183, -7865, -8158, -8221, -8141, -7970, -7736, -7459, -7149, -6815, -6462, -6094, -5715, -5326, -4930, -4526, -4118, -3706, -3290, -2871, -2450, -2028, -1604, -1180, -755, -331, 92, 515, 935, 1354, 1770, 2182, 2591, 2995, 3393, 3785, 4169, 4543, 4905, 5254, 5585, 5896, 6180, 6431, 6640, 6793, 6873, 6856, 6708, 6387, 5853, 5089, 4146, 3163, 2298, 1644, 1205, 945, 820, 790, 823, 893 },
+	{ 17540, -17959, -17459, -16958, -16458, -15958, -15457, -14957, -14457, -13956, -13456, -12956, -12456, -11955, -11455, -10955, -10455, -9955, -9455, -8955, -8455, -7955, -7455, -6955, -6455, -5955, -5455, -4955, -4455, -3956, -3456, -2956, -2456, -1957, -1457, -957, -458, 42, 542, 1041, 1541, 2040, 2540, 3040, 3539, 4039, 4539, 5039, 5538, 6038, 6538, 7038, 7538, 8037, 8537, 9037, 9537, 10037, 10537, 11037, 11537, 12038, 12538, 13038, 13538, 14038, 14539, 15039, 15539, 16039, 16540, 17040, 17540 },
+};
+
+static const int16_t inclination_table[37][73] = {
+	{ -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7223, -7223, -7223, -7223, -7223, -7223, -7223, -7223, -7223, -7223, -7223, -7223, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7224, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225, -7225 },
+	{ -7555, -7541, -7525, -7506, -7485, -7462, -7437, -7411, -7383, -7355, -7326, -7296, -7266, -7236, -7206, -7176, -7147, -7119, -7091, -7065, -7040, -7016, -6994, -6974, -6956, -6939, -6924, -6911, -6900, -6891, -6884, -6880, -6877, -6877, -6878, -6883, -6889, -6897, -6908, -6921, -6937, -6954, -6973, -6995, -7018, -7043, -7070, -7098, -7128, -7158, -7190, -7222, -7254, -7286, -7318, -7349, -7380, -7409, -7437, -7463, -7487, -7509, -7528, -7545, -7558, -7569, -7577, -7581, -7582, -7580, -7575, -7566, -7555 },
+	{ -7852, -7816, -7776, -7732, -7685, -7634, -7581, -7526, -7469, -7411, -7353, -7294, -7235, -7176, -7118, -7062, -7007, -6955, -6905, -6858, -6814, -6773, -6736, -6702, -6672, -6645, -6622, -6602, -6586, -6573, -6563, -6556, -6552, -6551, -6554, -6560, -6570, -6583, -6600, -6622, -6648, -6678, -6712, -6751, -6794, -6841, -6891, -6946, -7003, -7064, -7127, -7191, -7257, -7324, -7391, -7457, -7521, -7584, -7644, -7701, -7753, -7800, -7841, -7875, -7903, -7923, -7935, -7939, -7936, -7925, -7907, -7882, -7852 },
+	{ -8061, -7996, -7927, -7856, -7781, -7705, -7626, -7546, -7465, -7382, -7298, -7214, -7130, -7047, -6964, -6884, -6807, -6733, -6663, -6599, -6541, -6488, -6442, -6402, -6369, -6341, -6318, -6300, -6287, -6276, -6269, -6265, -6263, -6264, -6267, -6274, -6285, -6301, -6321, -6347, -6379, -6417, -6463, -6515, -6574, -6641, -6713, -6792, -6876, -6965, -7058, -7155, -7254, -7354, -7456, -7557, -7658, -7756, -7850, -7940, -8023, -8099, -8164, -8217, -8256, -8280, -8287, -8279, -8256, -8220, -8175, -8121, -8061 },
+	{ -8114, -8023, -7931, -7840, -7748, -7656, -7563, -7468, -7371, -7273, -7172, -7070, -6967, -6863, -6759, -6657, -6559, -6465, -6377, -6298, -6227, -6167, -6118, -6079, -6050, -6030, -6019, -6013, -6013, -6015, -6019, -6024, -6029, -6034, -6040, -6048, -6058, -6072, -6091, -6117, -6151, -6194, -6246, -6309, -6382, -6464, -6556, -6656, -6764, -6879, -6999, -7124, -7253, -7385, -7518, -7652, -7785, -7917, -8046, -8170, -8288, -8397, -8493, -8568, -8613, -8621, -8593, -8537, -8464, -8381, -8294, -8204, -8114 },
+	{ -7994, -7893, -7793, -7696, -7599, -7503, -7406, -7307, -7205, -7101, -6992, -6880, -6763, -6644, -6523, -6402, -6284, -6170, -6065, -5970, -5890, -5824, -5775, -5743, -5728, -5727, -5738, -5757, -5782, -5808, -5834, -5857, -5875, -5889, -5899, -5906, -5912, -5921, -5934, -5955, -5985, -6026, -6080, -6148, -6230, -6325, -6432, -6550, -6678, -6814, -6957, -7105, -7258, -7414, -7571, -7730, -7888, -8046, -8201, -8354, -8504, -8650, -8791, -8919, -8913, -8792, -8668, -8547, -8429, -8315, -8205, -8098, -7994 },
+	{ -7763, -7662, -7564, -7467, -7372, -7277, -7182, -7085, -6986, -6882, -6772, -6656, -6533, -6404, -6270, -6134, -5998, -5866, -5744, -5635, -5544, -5475, -5431, -5412, -5418, -5446, -5491, -5548, -5610, -5674, -5732, -5782, -5822, -5849, -5865, -5873, -5873, -5871, -5872, -5878, -5896, -5927, -5976, -6042, -6127, -6228, -6346, -6477, -6620, -6772, -6931, -7096, -7264, -7434, -7605, -7775, -7942, -8106, -8265, -8414, -8549, -8659, -8720, -8708, -8637, -8536, -8425, -8310, -8196, -8084, -7974, -7867, -7763 },
+	{ -7479, -7381, -7284, -7190, -7097, -7005, -6913, -6820, -6724, -6623, -6517, -6402, -6279, -6146, -6006, -5859, -5709, -5563, -5425, -5302, -5203, -5132, -5096, -5096, -5130, -5196, -5285, -5390, -5502, -5612, -5713, -5800, -5868, -5917, -5945, -5955, -5949, -5934, -5915, -5899, -5894, -5905, -5937, -5993, -6072, -6174, -6296, -6435, -6587, -6749, -6917, -7089, -7262, -7434, -7604, -7768, -7923, -8066, -8191, -8293, -8363, -8394, -8386, -8343, -8275, -8190, -8096, -7995, -7891, -7787, -7683, -7580, -7479 },
+	{ -7165, -7068, -6973, -6880, -6787, -6696, -6605, -6514, -6420, -6324, -6221, -6112, -5992, -5862, -5720, -5569, -5412, -5254, -5104, -4970, -4864, -4794, -4768, -4790, -4859, -4969, -5109, -5269, -5434, -5596, -5745, -5874, -5979, -6058, -6107, -6129, -6124, -6099, -6060, -6016, -5979, -5959, -5963, -5997, -6062, -6156, -6275, -6414, -6569, -6733, -6902, -7072, -7239, -7401, -7554, -7694, -7817, -7918, -7994, -8041, -8060, -8052, -8021, -7971, -7906, -7830, -7745, -7655, -7560, -7462, -7363, -7263, -7165 },
+	{ -6821, -6725, -6630, -6535, -6442, -6349, -6256, -6163, -6070, -5975, -5876, -5771, -5657, -5533, -5396, -5247, -5087, -4923, -4764, -4621, -4509, -4441, -4428, -4476, -4583, -4739, -4932, -5145, -5364, -5575, -5771, -5944, -6092, -6209, -6292, -6340, -6351, -6328, -6278, -6210, -6139, -6081, -6047, -6048, -6086, -6161, -6268, -6399, -6547, -6706, -6867, -7025, -7177, -7317, -7441, -7545, -7626, -7681, -7710, -7717, -7705, -7677, -7636, -7585, -7524, -7455, -7378, -7295, -7205, -7112, -7016, -6919, -6821 },
+	{ -6438, -6341, -6244, -6148, -6052, -5955, -5857, -5760, -5663, -5566, -5467, -5366, -5258, -5141, -5011, -4867, -4708, -4542, -4376, -4225, -4108, -4043, -4045, -4120, -4266, -4471, -4715, -4979, -5245, -5502, -5739, -5955, -6144, -6305, -6433, -6520, -6564, -6562, -6517, -6438, -6342, -6246, -6169, -6127, -6127, -6170, -6253, -6365, -6498, -6641, -6785, -6924, -7051, -7162, -7252, -7317, -7356, -7370, -7363, -7341, -7309, -7270, -7226, -7176, -7119, -7056, -6985, -6906, -6820, -6729, -6634, -6536, -6438 },
+	{ -6002, -5902, -5802, -5703, -5603, -5501, -5397, -5293, -5189, -5087, -4985, -4883, -4779, -4668, -4544, -4405, -4248, -4078, -3905, -3748, -3627, -3566, -3584, -3690, -3878, -4132, -4428, -4741, -5052, -5349, -5625, -5878, -6107, -6311, -6482, -6614, -6699, -6729, -6705, -6632, -6523, -6399, -6282, -6194, -6147, -6149, -6196, -6279, -6386, -6505, -6625, -6738, -6839, -6920, -6976, -7006, -7009, -6990, -6955, -6913, -6868, -6824, -6780, -6732, -6679, -6620, -6552, -6475, -6390, -6299, -6202, -6102, -6002 },
+	{ -5495, -5391, -5288, -5185, -5080, -4973, -4863, -4751, -4638, -4528, -4420, -4315, -4210, -4101, -3980, -3842, -3683, -3507, -3326, -3160, -3037, -2983, -3022, -3161, -3396, -3702, -4051, -4416, -4774, -5112, -5425, -5713, -5975, -6213, -6419, -6587, -6705, -6766, -6765, -6706, -6598, -6459, -6312, -6182, -6090, -6047, -6052, -6099, -6173, -6263, -6356, -6444, -6518, -6573, -6604, -6605, -6581, -6536, -6480, -6424, -6372, -6326, -6284, -6240, -6190, -6132, -6065, -5988, -5902, -5807, -5706, -5601, -5495 },
+	{ -4903, -4792, -4684, -4577, -4469, -4357, -4240, -4121, -4000, -3881, -3766, -3655, -3546, -3434, -3310, -3168, -3001, -2815, -2624, -2450, -2326, -2283, -2347, -2525, -2807, -3169, -3576, -3997, -4406, -4790, -5141, -5461, -5749, -6008, -6233, -6417, -6551, -6627, -6640, -6590, -6485, -6339, -6175, -6016, -5887, -5804, -5771, -5783, -5826, -5888, -5956, -6021, -6076, -6113, -6125, -6107, -6062, -5998, -5928, -5862, -5807, -5763, -5724, -5685, -5638, -5580, -5512, -5432, -5341, -5240, -5130, -5017, -4903 },
+	{ -4212, -4092, -3977, -3865, -3753, -3638, -3517, -3392, -3265, -3138, -3016, -2898, -2784, -2666, -2535, -2382, -2203, -2004, -1801, -1623, -1503, -1476, -1567, -1783, -2114, -2530, -2995, -3475, -3941, -4374, -4766, -5114, -5419, -5684, -5908, -6088, -6217, -6289, -6300, -6250, -6144, -5994, -5819, -5641, -5488, -5377, -5316, -5301, -5320, -5360, -5409, -5459, -5502, -5529, -5530, -5501, -5443, -5366, -5285, -5214, -5160, -5121, -5089, -5054, -5010, -4952, -4880, -4795, -4696, -4585, -4464, -4338, -4212 },
+	{ -3415, -3282, -3158, -3041, -2927, -2810, -2687, -2559, -2428, -2297, -2170, -2048, -1928, -1803, -1662, -1496, -1304, -1093, -883, -706, -597, -589, -706, -956, -1326, -1788, -2307, -2843, -3365, -3848, -4278, -4649, -4961, -5219, -5426, -5584, -5691, -5745, -5745, -5688, -5577, -5421, -5237, -5047, -4878, -4750, -4673, -4642, -4646, -4672, -4709, -4751, -4788, -4812, -4810, -4776, -4711, -4627, -4540, -4468, -4418, -4388, -4365, -4338, -4296, -4237, -4161, -4069, -3960, -3835, -3698, -3556, -3415 },
+	{ -2514, -2366, -2232, -2110, -1994, -1877, -1756, -1629, -1498, -1367, -1240, -1116, -993, -862, -713, -537, -335, -119, 88, 255, 348, 335, 197, -75, -469, -962, -1519, -2100, -2668, -3192, -3652, -4038, -4348, -4589, -4769, -4894, -4971, -5002, -4985, -4919, -4802, -4640, -4447, -4247, -4067, -3930, -3844, -3806, -3803, -3822, -3853, -3891, -3929, -3954, -3955, -3923, -3857, -3771, -3684, -3615, -3574, -3555, -3545, -3527, -3490, -3432, -3351, -3251, -3130, -2991, -2836, -2673, -2514 },
+	{ -1529, -1366, -1222, -1096, -980, -867, -750, -628, -501, -374, -250, -130, -8, 125, 278, 457, 658, 868, 1062, 1209, 1281, 1249, 1098, 819, 420, -81, -652, -1255, -1849, -2397, -2873, -3262, -3562, -3779, -3927, -4018, -4064, -4071, -4038, -3963, -3841, -3674, -3475, -3267, -3080, -2937, -2847, -2807, -2802, -2819, -2848, -2886, -2925, -2956, -2963, -2936, -2875, -2793, -2712, -2652, -2623, -2620, -2625, -2619, -2591, -2535, -2454, -2347, -2217, -2062, -1889, -1707, -1529 },
+	{ -500, -324, -173, -45, 69, 176, 285, 400, 519, 638, 756, 871, 988, 1118, 1267, 1440, 1630, 1822, 1992, 2113, 2161, 2114, 1958, 1685, 1300, 815, 257, -337, -926, -1472, -1942, -2320, -2602, -2794, -2910, -2969, -2986, -2971, -2925, -2843, -2719, -2551, -2350, -2140, -1950, -1805, -1716, -1677, -1673, -1689, -1717, -1754, -1796, -1831, -1845, -1826, -1775, -1703, -1634, -1589, -1577, -1591, -1613, -1623, -1607, -1560, -1482, -1375, -1240, -1076, -890, -693, -500 },
+	{ 523, 704, 858, 986, 1094, 1194, 1294, 1399, 1508, 1620, 1730, 1838, 1951, 2074, 2215, 2374, 2544, 2709, 2849, 2941, 2965, 2905, 2750, 2493, 2136, 1688, 1171, 617, 65, -447, -889, -1240, -1496, -1661, -1749, -1780, -1773, -1740, -1684, -1599, -1476, -1313, -1118, -914, -729, -589, -504, -468, -465, -480, -507, -542, -582, -618, -637, -628, -589, -533, -482, -455, -461, -494, -535, -563, -564, -531, -465, -365, -233, -69, 120, 323, 523 },
+	{ 1487, 1665, 1817, 1941, 2044, 2136, 2226, 2322, 2423, 2527, 2631, 2735, 2842, 2958, 3088, 3230, 3376, 3512, 3620, 3682, 3684, 3614, 3463, 3227, 2905, 2507, 2050, 1562, 1076, 624, 233, -77, -300, -437, -501, -510, -485, -439, -376, -291, -176, -25, 155, 344, 514, 643, 720, 753, 755, 740, 716, 686, 651, 618, 598, 600, 625, 663, 694, 701, 677, 626, 568, 521, 500, 513, 560, 643, 761, 913, 1095, 1291, 1487 },
+	{ 2356, 2524, 2668, 2786, 2883, 2969, 3052, 3140, 3234, 3333, 3433, 3535, 3639, 3750, 3870, 3995, 4118, 4226, 4305, 4341, 4324, 4245, 4099, 3884, 3601, 3258, 2871, 2463, 2057, 1681, 1356, 1097, 912, 802, 758, 763, 800, 854, 920, 1000, 1105, 1238, 1396, 1560, 1708, 1821, 1889, 1917, 1918, 1905, 1885, 1861, 1833, 1807, 1790, 1788, 1801, 1822, 1834, 1823, 1782, 1718, 1645, 1580, 1538, 1527, 1550, 1609, 1704, 1835, 1996, 2175, 2356 },
+	{ 3116, 3267, 3400, 3510, 3602, 3684, 3763, 3846, 3936, 4032, 4131, 4233, 4337, 4444, 4556, 4668, 4772, 4858, 4913, 4928, 4895, 4809, 4669, 4474, 4228, 3939, 3622, 3293, 2971, 2674, 2416, 2211, 2066, 1981, 1952, 1967, 2008, 2065, 2129, 2204, 2296, 2409, 2540, 2676, 2799, 2893, 2951, 2975, 2976, 2965, 2950, 2932, 2913, 2895, 2883, 2879, 2885, 2892, 2888, 2862, 2809, 2735, 2650, 2571, 2510, 2476, 2473, 2504, 2571, 2673, 2805, 2957, 3116 },
+	{ 3772, 3901, 4019, 4121, 4209, 4288, 4366, 4448, 4537, 4632, 4732, 4835, 4940, 5047, 5154, 5256, 5346, 5416, 5454, 5454, 5410, 5320, 5186, 5009, 4796, 4556, 4301, 4043, 3796, 3569, 3375, 3219, 3109, 3047, 3029, 3048, 3090, 3145, 3206, 3274, 3353, 3446, 3551, 3660, 3758, 3834, 3882, 3903, 3906, 3899, 3888, 3877, 3866, 3856, 3849, 3847, 3847, 3844, 3828, 3791, 3731, 3649, 3557, 3467, 3390, 3335, 3308, 3312, 3350, 3420, 3520, 3641, 3772 },
+	{ 4342, 4447, 4547, 4639, 4722, 4801, 4880, 4964, 5055, 5152, 5254, 5359, 5466, 5572, 5676, 5772, 5854, 5912, 5940, 5930, 5880, 5789, 5661, 5501, 5317, 5118, 4914, 4714, 4527, 4358, 4214, 4100, 4020, 3976, 3967, 3987, 4026, 4077, 4134, 4194, 4261, 4336, 4419, 4503, 4579, 4640, 4680, 4700, 4705, 4704, 4699, 4695, 4691, 4688, 4687, 4686, 4684, 4674, 4650, 4606, 4539, 4454, 4357, 4259, 4171, 4100, 4053, 4034, 4044, 4084, 4151, 4240, 4342 },
+	{ 4846, 4927, 5010, 5091, 5170, 5250, 5331, 5419, 5513, 5613, 5718, 5825, 5933, 6039, 6141, 6233, 6308, 6360, 6381, 6366, 6313, 6224, 6103, 5959, 5800, 5634, 5470, 5314, 5171, 5045, 4939, 4857, 4799, 4769, 4766, 4785, 4821, 4866, 4916, 4969, 5025, 5085, 5149, 5213, 5272, 5320, 5354, 5375, 5386, 5391, 5394, 5396, 5400, 5404, 5407, 5409, 5405, 5391, 5361, 5312, 5242, 5154, 5055, 4953, 4857, 4776, 4714, 4676, 4663, 4677, 4715, 4773, 4846 },
+	{ 5309, 5368, 5435, 5506, 5581, 5660, 5745, 5835, 5933, 6036, 6143, 6252, 6360, 6466, 6565, 6653, 6723, 6770, 6786, 6768, 6715, 6629, 6518, 6389, 6250, 6109, 5974, 5850, 5738, 5642, 5563, 5502, 5461, 5441, 5441, 5459, 5489, 5528, 5571, 5615, 5661, 5709, 5758, 5807, 5852, 5892, 5923, 5946, 5963, 5976, 5988, 5999, 6011, 6021, 6029, 6033, 6028, 6011, 5977, 5924, 5852, 5763, 5664, 5561, 5462, 5375, 5303, 5252, 5222, 5214, 5228, 5261, 5309 },
+	{ 5751, 5793, 5846, 5908, 5978, 6056, 6141, 6234, 6334, 6438, 6545, 6654, 6761, 6865, 6960, 7043, 7109, 7150, 7162, 7142, 7090, 7009, 6907, 6790, 6668, 6548, 6434, 6331, 6240, 6164, 6102, 6055, 6025, 6010, 6011, 6025, 6050, 6081, 6116, 6152, 6189, 6227, 6265, 6303, 6339, 6374, 6404, 6431, 6455, 6477, 6499, 6520, 6540, 6557, 6570, 6576, 6570, 6551, 6514, 6459, 6385, 6297, 6199, 6097, 5999, 5910, 5834, 5775, 5734, 5712, 5708, 5722, 5751 },
+	{ 6186, 6216, 6259, 6313, 6378, 6453, 6536, 6628, 6726, 6829, 6934, 7040, 7144, 7243, 7333, 7411, 7470, 7505, 7513, 7490, 7439, 7362, 7269, 7164, 7056, 6951, 6852, 6764, 6687, 6622, 6570, 6532, 6506, 6493, 6493, 6502, 6520, 6544, 6570, 6599, 6628, 6658, 6688, 6720, 6751, 6783, 6815, 6847, 6878, 6910, 6942, 6973, 7002, 7026, 7044, 7052, 7047, 7026, 6987, 6930, 6857, 6770, 6675, 6578, 6484, 6397, 6321, 6259, 6213, 6182, 6168, 6170, 6186 },
+	{ 6621, 6644, 6679, 6727, 6786, 6855, 6933, 7020, 7112, 7210, 7310, 7410, 7507, 7600, 7683, 7754, 7806, 7835, 7837, 7811, 7760, 7688, 7601, 7507, 7411, 7317, 7230, 7152, 7084, 7026, 6980, 6945, 6921, 6907, 6903, 6907, 6918, 6933, 6952, 6974, 6997, 7021, 7047, 7074, 7104, 7136, 7171, 7208, 7247, 7287, 7328, 7369, 7406, 7438, 7461, 7473, 7469, 7447, 7408, 7351, 7279, 7196, 7106, 7015, 6927, 6846, 6774, 6714, 6668, 6635, 6616, 6612, 6621 },
+	{ 7055, 7073, 7103, 7144, 7196, 7258, 7328, 7406, 7489, 7578, 7668, 7759, 7848, 7931, 8006, 8068, 8111, 8132, 8128, 8098, 8047, 7978, 7899, 7814, 7728, 7644, 7567, 7496, 7435, 7382, 7339, 7305, 7280, 7263, 7255, 7253, 7257, 7266, 7278, 7294, 7312, 7332, 7356, 7382, 7412, 7445, 7483, 7525, 7570, 7617, 7666, 7715, 7760, 7798, 7827, 7842, 7840, 7820, 7782, 7727, 7660, 7583, 7501, 7419, 7340, 7267, 7202, 7148, 7105, 7073, 7055, 7048, 7055 },
+	{ 7479, 7494, 7519, 7554, 7598, 7650, 7710, 7776, 7848, 7924, 8002, 8080, 8157, 8229, 8293, 8344, 8377, 8389, 8377, 8343, 8291, 8226, 8154, 8078, 8002, 7928, 7860, 7797, 7741, 7693, 7652, 7618, 7592, 7573, 7561, 7554, 7552, 7556, 7563, 7574, 7589, 7607, 7629, 7655, 7686, 7721, 7760, 7805, 7853, 7905, 7959, 8012, 8062, 8106, 8140, 8159, 8162, 8146, 8113, 8064, 8003, 7936, 7864, 7793, 7725, 7663, 7607, 7561, 7524, 7497, 7480, 7474, 7479 },
+	{ 7884, 7896, 7916, 7943, 7978, 8020, 8068, 8121, 8178, 8239, 8302, 8366, 8428, 8486, 8537, 8575, 8595, 8595, 8574, 8535, 8483, 8423, 8359, 8293, 8228, 8166, 8107, 8053, 8005, 7961, 7924, 7893, 7867, 7847, 7832, 7822, 7818, 7817, 7821, 7830, 7842, 7859, 7879, 7905, 7935, 7969, 8009, 8053, 8101, 8152, 8206, 8259, 8311, 8358, 8396, 8422, 8431, 8423, 8398, 8359, 8310, 8255, 8197, 8139, 8084, 8034, 7989, 7951, 7921, 7899, 7886, 7881, 7884 },
+	{ 8261, 8269, 8283, 8303, 8328, 8359, 8394, 8433, 8475, 8520, 8566, 8613, 8659, 8700, 8733, 8753, 8756, 8741, 8710, 8668, 8620, 8568, 8514, 8461, 8409, 8360, 8313, 8270, 8230, 8194, 8163, 8136, 8113, 8095, 8081, 8071, 8065, 8063, 8066, 8072, 8083, 8098, 8116, 8139, 8166, 8197, 8233, 8272, 8315, 8360, 8408, 8457, 8505, 8550, 8590, 8622, 8641, 8645, 8634, 8610, 8576, 8537, 8495, 8453, 8412, 8375, 8342, 8313, 8291, 8274, 8264, 8259, 8261 },
+	{ 8604, 8609, 8617, 8629, 8645, 8664, 8686, 8710, 8737, 8765, 8794, 8822, 8847, 8865, 8872, 8866, 8846, 8817, 8783, 8746, 8707, 8668, 8630, 8592, 8555, 8520, 8487, 8457, 8428, 8403, 8380, 8360, 8343, 8329, 8318, 8310, 8306, 8305, 8307, 8312, 8320, 8332, 8346, 8364, 8385, 8410, 8437, 8466, 8499, 8533, 8569, 8607, 8645, 8682, 8718, 8751, 8778, 8798, 8807, 8805, 8794, 8775, 8752, 8728, 8703, 8680, 8659, 8641, 8626, 8615, 8607, 8604, 8604 },
+	{ 8912, 8915, 8918, 8924, 8930, 8938, 8947, 8956, 8962, 8963, 8958, 8946, 8930, 8912, 8893, 8873, 8851, 8830, 8808, 8786, 8764, 8743, 8722, 8702, 8683, 8664, 8646, 8630, 8615, 8601, 8589, 8578, 8569, 8562, 8556, 8552, 8550, 8550, 8551, 8554, 8560, 8566, 8575, 8585, 8597, 8611, 8626, 8642, 8660, 8679, 8698, 8719, 8740, 8762, 8784, 8805, 8827, 8848, 8867, 8886, 8902, 8915, 8925, 8931, 8933, 8932, 8928, 8924, 8919, 8916, 8913, 8912, 8912 },
+	{ 8808, 8808, 8808, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8806, 8806, 8806, 8806, 8806, 8806, 8806, 8806, 8806, 8806, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8807, 8808, 8808 },
+};
+
+/* strength in 10 nT */
+static const int16_t strength_table[37][73] = {
+	{ 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5488, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489, 5489 },
+	{ 5830, 5817, 5802, 5784, 5765, 5743, 5719, 5693, 5666, 5638, 5608, 5578, 5547, 5515, 5483, 5450, 5418, 5386, 5355, 5324, 5294, 5266, 5238, 5213, 5189, 5166, 5147, 5129, 5113, 5101, 5090, 5083, 5079, 5077, 5078, 5083, 5090, 5100, 5114, 5130, 5149, 5171, 5195, 5222, 5250, 5281, 5313, 5347, 5381, 5417, 5452, 5488, 5524, 5559, 5594, 5627, 5659, 5689, 5717, 5743, 5766, 5787, 5806, 5821, 5834, 5844, 5850, 5854, 5855, 5853, 5848, 5841, 5830 },
+	{ 6095, 6067, 6035, 5999, 5959, 5916, 5870, 5822, 5770, 5716, 5660, 5603, 5544, 5484, 5423, 5362, 5301, 5240, 5180, 5122, 5065, 5011, 4959, 4910, 4864, 4821, 4783, 4748, 4717, 4692, 4670, 4654, 4644, 4638, 4639, 4645, 4657, 4676, 4700, 4731, 4767, 4810, 4858, 4911, 4970, 5032, 5099, 5168, 5240, 5314, 5389, 5463, 5537, 5610, 5680, 5748, 5812, 5871, 5926, 5976, 6020, 6059, 6091, 6117, 6138, 6152, 6160, 6163, 6159, 6151, 6137, 6118, 6095 },
+	{ 6266, 6222, 6173, 6119, 6061, 6000, 5934, 5865, 5793, 5717, 5639, 5558, 5474, 5389, 5303, 5216, 5129, 5043, 4958, 4875, 4795, 4718, 4645, 4577, 4512, 4453, 4400, 4351, 4309, 4272, 4242, 4218, 4201, 4192, 4190, 4197, 4212, 4236, 4270, 4313, 4366, 4428, 4499, 4579, 4667, 4762, 4864, 4971, 5081, 5194, 5309, 5423, 5536, 5647, 5753, 5853, 5947, 6034, 6113, 6182, 6242, 6293, 6334, 6365, 6386, 6399, 6402, 6397, 6385, 6365, 6338, 6305, 6266 },
+	{ 6339, 6278, 6213, 6143, 6069, 5991, 5910, 5824, 5735, 5642, 5546, 5446, 5342, 5236, 5128, 5018, 4908, 4798, 4691, 4586, 4485, 4390, 4300, 4216, 4139, 4069, 4005, 3949, 3899, 3856, 3819, 3791, 3770, 3757, 3753, 3760, 3777, 3806, 3847, 3901, 3968, 4048, 4141, 4247, 4363, 4490, 4626, 4768, 4916, 5068, 5221, 5374, 5524, 5669, 5808, 5939, 6060, 6169, 6266, 6350, 6421, 6477, 6520, 6550, 6567, 6571, 6565, 6548, 6521, 6486, 6444, 6394, 6339 },
+	{ 6319, 6243, 6162, 6078, 5991, 5900, 5807, 5709, 5608, 5503, 5393, 5279, 5159, 5036, 4909, 4779, 4649, 4518, 4391, 4267, 4149, 4038, 3935, 3842, 3757, 3682, 3615, 3556, 3504, 3460, 3423, 3392, 3369, 3355, 3349, 3355, 3373, 3405, 3452, 3515, 3594, 3691, 3803, 3932, 4075, 4231, 4398, 4574, 4757, 4943, 5131, 5317, 5500, 5675, 5842, 5997, 6139, 6266, 6376, 6469, 6544, 6600, 6640, 6663, 6670, 6663, 6642, 6610, 6568, 6516, 6457, 6391, 6319 },
+	{ 6222, 6131, 6038, 5942, 5844, 5744, 5641, 5536, 5428, 5315, 5196, 5072, 4942, 4806, 4664, 4519, 4371, 4223, 4078, 3938, 3806, 3684, 3573, 3474, 3388, 3313, 3249, 3195, 3148, 3108, 3074, 3046, 3024, 3008, 3002, 3006, 3023, 3055, 3105, 3174, 3262, 3372, 3501, 3650, 3816, 3998, 4193, 4398, 4609, 4825, 5041, 5255, 5463, 5662, 5849, 6022, 6179, 6316, 6433, 6528, 6602, 6655, 6687, 6700, 6695, 6674, 6639, 6591, 6533, 6465, 6390, 6308, 6222 },
+	{ 6066, 5964, 5860, 5755, 5649, 5542, 5434, 5324, 5211, 5094, 4972, 4843, 4706, 4562, 4411, 4254, 4094, 3933, 3775, 3623, 3480, 3351, 3236, 3137, 3054, 2986, 2931, 2887, 2851, 2821, 2795, 2772, 2753, 2738, 2730, 2731, 2745, 2774, 2822, 2891, 2985, 3102, 3244, 3409, 3595, 3799, 4016, 4245, 4480, 4718, 4956, 5189, 5414, 5629, 5829, 6011, 6174, 6315, 6432, 6525, 6593, 6638, 6661, 6663, 6646, 6612, 6564, 6502, 6430, 6348, 6259, 6165, 6066 },
+	{ 5872, 5761, 5649, 5537, 5425, 5313, 5201, 5088, 4974, 4856, 4732, 4603, 4465, 4318, 4163, 4001, 3834, 3665, 3499, 3340, 3191, 3058, 2944, 2849, 2774, 2718, 2677, 2649, 2628, 2612, 2597, 2583, 2569, 2556, 2547, 2543, 2550, 2572, 2613, 2678, 2769, 2889, 3038, 3214, 3414, 3635, 3872, 4119, 4372, 4627, 4878, 5123, 5358, 5578, 5782, 5966, 6128, 6264, 6376, 6461, 6521, 6556, 6569, 6561, 6533, 6489, 6430, 6358, 6275, 6183, 6084, 5980, 5872 },
+	{ 5652, 5535, 5418, 5301, 5185, 5070, 4955, 4841, 4726, 4608, 4487, 4359, 4224, 4080, 3927, 3766, 3599, 3429, 3261, 3100, 2950, 2818, 2707, 2620, 2557, 2516, 2492, 2481, 2478, 2477, 2476, 2473, 2467, 2459, 2450, 2444, 2444, 2456, 2486, 2540, 2623, 2738, 2886, 3067, 3276, 3509, 3759, 4021, 4286, 4551, 4810, 5060, 5295, 5515, 5714, 5891, 6043, 6170, 6269, 6343, 6391, 6416, 6419, 6402, 6367, 6316, 6251, 6172, 6082, 5984, 5878, 5766, 5652 },
+	{ 5413, 5293, 5174, 5054, 4936, 4819, 4703, 4588, 4473, 4358, 4239, 4117, 3987, 3851, 3705, 3552, 3392, 3228, 3064, 2906, 2761, 2633, 2530, 2452, 2402, 2376, 2369, 2376, 2389, 2404, 2417, 2426, 2431, 2432, 2429, 2425, 2422, 2427, 2445, 2484, 2552, 2655, 2795, 2972, 3182, 3420, 3678, 3947, 4220, 4489, 4750, 4997, 5228, 5439, 5627, 5790, 5927, 6036, 6120, 6178, 6213, 6227, 6222, 6199, 6159, 6104, 6034, 5952, 5859, 5757, 5647, 5531, 5413 },
+	{ 5159, 5039, 4919, 4800, 4682, 4565, 4449, 4334, 4221, 4108, 3994, 3878, 3758, 3632, 3499, 3359, 3211, 3059, 2906, 2757, 2620, 2501, 2406, 2340, 2302, 2289, 2297, 2317, 2344, 2371, 2398, 2421, 2440, 2454, 2465, 2470, 2472, 2475, 2485, 2511, 2561, 2645, 2768, 2932, 3134, 3367, 3623, 3893, 4166, 4434, 4690, 4931, 5152, 5349, 5521, 5665, 5781, 5869, 5932, 5972, 5993, 5997, 5985, 5957, 5914, 5857, 5787, 5704, 5610, 5506, 5395, 5278, 5159 },
+	{ 4891, 4774, 4656, 4540, 4425, 4310, 4196, 4084, 3974, 3865, 3757, 3649, 3540, 3428, 3311, 3188, 3058, 2922, 2784, 2649, 2524, 2416, 2332, 2276, 2249, 2246, 2264, 2293, 2329, 2367, 2405, 2442, 2478, 2512, 2541, 2563, 2578, 2587, 2595, 2610, 2643, 2705, 2804, 2945, 3127, 3345, 3590, 3851, 4115, 4375, 4622, 4851, 5059, 5240, 5393, 5514, 5606, 5669, 5710, 5731, 5739, 5733, 5715, 5684, 5640, 5582, 5512, 5430, 5337, 5234, 5124, 5009, 4891 },
+	{ 4613, 4500, 4388, 4278, 4169, 4059, 3951, 3844, 3739, 3637, 3537, 3440, 3344, 3247, 3148, 3044, 2934, 2818, 2699, 2581, 2471, 2377, 2304, 2257, 2236, 2240, 2262, 2297, 2339, 2385, 2434, 2485, 2538, 2591, 2641, 2684, 2716, 2736, 2748, 2759, 2778, 2818, 2890, 3001, 3155, 3347, 3570, 3812, 4060, 4304, 4536, 4750, 4941, 5104, 5236, 5335, 5401, 5439, 5457, 5461, 5455, 5441, 5418, 5385, 5339, 5282, 5213, 5132, 5042, 4943, 4836, 4725, 4613 },
+	{ 4329, 4224, 4122, 4021, 3920, 3820, 3721, 3623, 3527, 3435, 3346, 3261, 3180, 3100, 3019, 2936, 2847, 2753, 2654, 2556, 2464, 2383, 2321, 2280, 2262, 2267, 2290, 2326, 2372, 2424, 2481, 2544, 2612, 2683, 2752, 2813, 2861, 2895, 2913, 2923, 2933, 2955, 3000, 3080, 3201, 3361, 3554, 3769, 3992, 4214, 4426, 4621, 4793, 4938, 5049, 5126, 5168, 5184, 5181, 5168, 5151, 5130, 5103, 5068, 5022, 4964, 4896, 4818, 4732, 4638, 4537, 4434, 4329 },
+	{ 4051, 3958, 3867, 3779, 3691, 3603, 3517, 3432, 3349, 3271, 3196, 3126, 3061, 2998, 2937, 2874, 2806, 2734, 2657, 2579, 2504, 2437, 2382, 2345, 2326, 2327, 2346, 2380, 2426, 2482, 2546, 2617, 2695, 2776, 2857, 2930, 2990, 3034, 3060, 3072, 3077, 3086, 3110, 3163, 3251, 3378, 3537, 3720, 3913, 4107, 4294, 4467, 4619, 4744, 4837, 4894, 4917, 4913, 4893, 4868, 4841, 4814, 4784, 4747, 4699, 4641, 4574, 4500, 4418, 4331, 4239, 4145, 4051 },
+	{ 3794, 3716, 3640, 3566, 3493, 3421, 3351, 3283, 3217, 3156, 3099, 3046, 2998, 2954, 2912, 2868, 2822, 2771, 2715, 2656, 2596, 2539, 2490, 2451, 2427, 2420, 2430, 2457, 2500, 2555, 2621, 2696, 2777, 2861, 2944, 3022, 3087, 3136, 3168, 3184, 3188, 3190, 3202, 3234, 3296, 3392, 3519, 3669, 3830, 3994, 4153, 4301, 4431, 4537, 4613, 4654, 4663, 4646, 4616, 4581, 4547, 4515, 4480, 4439, 4389, 4331, 4265, 4194, 4118, 4039, 3957, 3875, 3794 },
+	{ 3577, 3515, 3456, 3398, 3342, 3288, 3236, 3187, 3141, 3100, 3062, 3029, 3000, 2975, 2951, 2928, 2901, 2869, 2831, 2787, 2739, 2689, 2640, 2598, 2565, 2545, 2543, 2558, 2592, 2642, 2704, 2775, 2852, 2932, 3011, 3085, 3149, 3200, 3235, 3255, 3263, 3265, 3272, 3293, 3339, 3412, 3511, 3630, 3760, 3893, 4024, 4146, 4255, 4343, 4403, 4433, 4433, 4410, 4374, 4333, 4294, 4256, 4215, 4169, 4116, 4055, 3990, 3921, 3851, 3781, 3711, 3643, 3577 },
+	{ 3416, 3370, 3328, 3288, 3249, 3213, 3180, 3151, 3127, 3107, 3091, 3078, 3069, 3063, 3058, 3053, 3044, 3028, 3004, 2971, 2929, 2882, 2831, 2782, 2738, 2704, 2685, 2685, 2705, 2743, 2795, 2857, 2925, 2995, 3064, 3131, 3190, 3240, 3277, 3302, 3316, 3325, 3334, 3355, 3392, 3451, 3529, 3623, 3725, 3831, 3935, 4034, 4121, 4192, 4240, 4262, 4258, 4233, 4196, 4153, 4109, 4063, 4014, 3960, 3900, 3836, 3770, 3703, 3638, 3577, 3518, 3465, 3416 },
+	{ 3318, 3289, 3263, 3240, 3218, 3199, 3185, 3176, 3173, 3175, 3181, 3190, 3201, 3215, 3228, 3240, 3246, 3243, 3228, 3200, 3161, 3112, 3057, 2999, 2943, 2894, 2859, 2841, 2844, 2866, 2903, 2951, 3006, 3064, 3123, 3181, 3236, 3284, 3323, 3353, 3376, 3393, 3412, 3438, 3476, 3528, 3593, 3667, 3747, 3830, 3912, 3990, 4060, 4116, 4155, 4172, 4167, 4145, 4109, 4064, 4013, 3958, 3898, 3833, 3764, 3693, 3623, 3556, 3495, 3440, 3392, 3352, 3318 },
+	{ 3286, 3271, 3260, 3252, 3245, 3243, 3246, 3257, 3274, 3297, 3324, 3355, 3387, 3419, 3450, 3477, 3496, 3502, 3493, 3468, 3428, 3374, 3312, 3244, 3176, 3113, 3063, 3029, 3015, 3020, 3040, 3073, 3114, 3160, 3210, 3262, 3312, 3360, 3401, 3437, 3468, 3497, 3527, 3563, 3606, 3657, 3713, 3775, 3839, 3904, 3970, 4033, 4089, 4135, 4167, 4182, 4179, 4159, 4125, 4077, 4019, 3952, 3878, 3799, 3718, 3638, 3561, 3491, 3429, 3377, 3337, 3307, 3286 },
+	{ 3316, 3312, 3313, 3317, 3324, 3337, 3357, 3385, 3421, 3464, 3511, 3562, 3613, 3663, 3710, 3751, 3780, 3794, 3789, 3764, 3721, 3662, 3591, 3513, 3433, 3359, 3296, 3250, 3221, 3211, 3217, 3235, 3263, 3299, 3342, 3389, 3438, 3486, 3530, 3571, 3609, 3647, 3688, 3734, 3783, 3835, 3888, 3942, 3996, 4051, 4106, 4160, 4209, 4249, 4278, 4293, 4293, 4276, 4242, 4191, 4125, 4045, 3956, 3861, 3765, 3672, 3585, 3507, 3442, 3390, 3353, 3329, 3316 },
+	{ 3402, 3404, 3413, 3428, 3447, 3474, 3508, 3553, 3606, 3666, 3732, 3800, 3868, 3934, 3995, 4047, 4085, 4105, 4104, 4079, 4032, 3967, 3888, 3801, 3712, 3628, 3555, 3499, 3460, 3438, 3432, 3439, 3456, 3484, 3521, 3565, 3613, 3661, 3708, 3753, 3796, 3841, 3889, 3941, 3995, 4049, 4102, 4153, 4203, 4254, 4305, 4356, 4402, 4442, 4472, 4490, 4492, 4477, 4443, 4388, 4314, 4222, 4118, 4007, 3895, 3788, 3689, 3602, 3529, 3473, 3434, 3411, 3402 },
+	{ 3540, 3543, 3557, 3579, 3610, 3648, 3697, 3756, 3824, 3899, 3980, 4062, 4143, 4221, 4293, 4354, 4399, 4424, 4425, 4400, 4352, 4282, 4197, 4102, 4005, 3914, 3834, 3770, 3723, 3693, 3678, 3675, 3684, 3705, 3737, 3777, 3823, 3871, 3919, 3966, 4012, 4060, 4111, 4166, 4223, 4279, 4334, 4386, 4438, 4490, 4543, 4595, 4645, 4688, 4722, 4743, 4749, 4736, 4701, 4643, 4562, 4460, 4343, 4219, 4093, 3972, 3861, 3764, 3682, 3619, 3575, 3549, 3540 },
+	{ 3725, 3727, 3743, 3771, 3809, 3859, 3919, 3990, 4071, 4158, 4249, 4341, 4431, 4517, 4595, 4660, 4709, 4737, 4740, 4717, 4667, 4596, 4507, 4407, 4306, 4209, 4124, 4054, 4001, 3963, 3940, 3930, 3931, 3945, 3971, 4007, 4050, 4096, 4142, 4188, 4234, 4283, 4334, 4389, 4447, 4505, 4563, 4621, 4678, 4736, 4796, 4854, 4909, 4958, 4998, 5024, 5033, 5022, 4987, 4927, 4841, 4732, 4608, 4474, 4338, 4207, 4086, 3980, 3890, 3820, 3769, 3738, 3725 },
+	{ 3954, 3954, 3970, 4001, 4046, 4103, 4173, 4254, 4343, 4437, 4535, 4632, 4725, 4813, 4892, 4958, 5007, 5035, 5038, 5015, 4966, 4895, 4805, 4705, 4602, 4502, 4413, 4338, 4279, 4235, 4204, 4187, 4181, 4188, 4207, 4236, 4274, 4315, 4358, 4402, 4446, 4492, 4542, 4596, 4654, 4715, 4778, 4842, 4908, 4976, 5044, 5111, 5174, 5230, 5275, 5306, 5319, 5309, 5274, 5213, 5125, 5015, 4887, 4750, 4609, 4474, 4347, 4235, 4140, 4064, 4008, 3971, 3954 },
+	{ 4222, 4220, 4236, 4268, 4316, 4379, 4453, 4538, 4631, 4728, 4826, 4923, 5015, 5100, 5175, 5237, 5282, 5306, 5308, 5284, 5236, 5167, 5080, 4982, 4880, 4781, 4690, 4611, 4547, 4496, 4458, 4433, 4420, 4420, 4431, 4452, 4482, 4517, 4554, 4594, 4634, 4678, 4726, 4779, 4838, 4902, 4970, 5042, 5118, 5195, 5273, 5349, 5421, 5483, 5534, 5569, 5584, 5576, 5542, 5481, 5395, 5287, 5162, 5027, 4888, 4754, 4628, 4516, 4419, 4341, 4282, 4242, 4222 },
+	{ 4519, 4516, 4532, 4564, 4612, 4674, 4749, 4833, 4923, 5016, 5109, 5199, 5284, 5361, 5428, 5481, 5519, 5538, 5535, 5511, 5464, 5398, 5316, 5224, 5127, 5031, 4941, 4861, 4792, 4736, 4692, 4660, 4639, 4631, 4634, 4647, 4667, 4694, 4726, 4760, 4797, 4839, 4885, 4938, 4998, 5065, 5139, 5218, 5301, 5388, 5474, 5558, 5635, 5703, 5758, 5795, 5812, 5805, 5774, 5716, 5635, 5533, 5416, 5288, 5158, 5031, 4912, 4805, 4712, 4637, 4579, 4540, 4519 },
+	{ 4828, 4826, 4840, 4870, 4915, 4973, 5041, 5117, 5198, 5281, 5364, 5442, 5515, 5580, 5635, 5678, 5705, 5717, 5710, 5684, 5639, 5578, 5504, 5419, 5330, 5240, 5155, 5076, 5006, 4947, 4898, 4860, 4833, 4817, 4812, 4816, 4828, 4848, 4872, 4902, 4936, 4976, 5022, 5075, 5137, 5206, 5284, 5367, 5456, 5548, 5639, 5726, 5807, 5877, 5933, 5972, 5989, 5985, 5957, 5905, 5832, 5740, 5635, 5521, 5405, 5291, 5183, 5087, 5003, 4935, 4883, 4847, 4828 },
+	{ 5126, 5124, 5137, 5163, 5201, 5249, 5306, 5369, 5436, 5504, 5570, 5633, 5691, 5741, 5782, 5812, 5829, 5833, 5822, 5796, 5754, 5699, 5634, 5559, 5480, 5400, 5322, 5248, 5181, 5121, 5071, 5030, 4998, 4977, 4964, 4961, 4966, 4979, 4998, 5023, 5055, 5094, 5140, 5193, 5256, 5326, 5405, 5490, 5579, 5670, 5761, 5848, 5927, 5996, 6050, 6088, 6107, 6105, 6082, 6038, 5976, 5899, 5810, 5714, 5615, 5518, 5427, 5345, 5274, 5216, 5172, 5141, 5126 },
+	{ 5387, 5385, 5394, 5414, 5442, 5478, 5520, 5567, 5616, 5666, 5714, 5759, 5800, 5834, 5861, 5878, 5886, 5883, 5869, 5843, 5806, 5759, 5703, 5641, 5574, 5506, 5438, 5373, 5312, 5256, 5208, 5167, 5134, 5110, 5094, 5086, 5086, 5094, 5109, 5131, 5161, 5198, 5243, 5296, 5357, 5425, 5501, 5582, 5666, 5752, 5837, 5917, 5990, 6053, 6104, 6139, 6158, 6159, 6142, 6109, 6061, 6001, 5931, 5855, 5777, 5701, 5629, 5563, 5506, 5460, 5424, 5400, 5387 },
+	{ 5589, 5586, 5591, 5602, 5620, 5642, 5669, 5698, 5729, 5761, 5790, 5818, 5842, 5861, 5875, 5882, 5882, 5874, 5858, 5834, 5802, 5764, 5719, 5669, 5615, 5560, 5505, 5451, 5400, 5353, 5311, 5274, 5244, 5221, 5204, 5195, 5193, 5199, 5211, 5231, 5259, 5293, 5335, 5384, 5441, 5503, 5571, 5643, 5717, 5792, 5865, 5934, 5996, 6050, 6094, 6125, 6144, 6148, 6140, 6118, 6085, 6043, 5993, 5939, 5883, 5827, 5774, 5725, 5683, 5648, 5620, 5601, 5589 },
+	{ 5721, 5716, 5715, 5718, 5726, 5736, 5749, 5763, 5778, 5793, 5807, 5819, 5829, 5836, 5839, 5838, 5832, 5821, 5805, 5784, 5758, 5728, 5694, 5656, 5617, 5576, 5535, 5494, 5455, 5419, 5386, 5358, 5334, 5315, 5302, 5294, 5293, 5298, 5310, 5327, 5351, 5382, 5418, 5460, 5508, 5560, 5615, 5673, 5733, 5792, 5850, 5904, 5953, 5996, 6031, 6058, 6075, 6082, 6081, 6070, 6052, 6027, 5996, 5962, 5926, 5890, 5855, 5822, 5793, 5767, 5747, 5731, 5721 },
+	{ 5781, 5774, 5770, 5767, 5767, 5768, 5770, 5773, 5776, 5779, 5781, 5782, 5782, 5780, 5776, 5770, 5761, 5750, 5735, 5718, 5698, 5676, 5652, 5626, 5599, 5572, 5545, 5518, 5492, 5468, 5447, 5428, 5412, 5400, 5392, 5389, 5390, 5395, 5405, 5420, 5439, 5463, 5491, 5523, 5559, 5597, 5637, 5679, 5721, 5763, 5804, 5842, 5876, 5907, 5933, 5954, 5969, 5978, 5981, 5979, 5973, 5961, 5947, 5930, 5910, 5891, 5870, 5851, 5833, 5817, 5802, 5791, 5781 },
+	{ 5781, 5774, 5768, 5763, 5759, 5755, 5751, 5747, 5744, 5740, 5736, 5731, 5726, 5720, 5713, 5705, 5696, 5686, 5675, 5662, 5649, 5635, 5620, 5604, 5589, 5573, 5558, 5544, 5530, 5517, 5506, 5497, 5490, 5485, 5482, 5482, 5484, 5490, 5498, 5508, 5522, 5538, 5556, 5576, 5598, 5621, 5645, 5670, 5695, 5720, 5744, 5767, 5788, 5807, 5823, 5837, 5849, 5857, 5863, 5866, 5866, 5864, 5860, 5855, 5848, 5839, 5831, 5822, 5813, 5804, 5796, 5788, 5781 },
+	{ 5736, 5732, 5728, 5724, 5720, 5716, 5711, 5707, 5702, 5698, 5693, 5688, 5682, 5677, 5671, 5665, 5659, 5653, 5646, 5640, 5633, 5626, 5620, 5613, 5607, 5601, 5595, 5590, 5585, 5581, 5578, 5575, 5574, 5573, 5573, 5575, 5577, 5581, 5585, 5590, 5597, 5604, 5612, 5621, 5630, 5640, 5650, 5661, 5671, 5681, 5691, 5701, 5710, 5719, 5727, 5734, 5740, 5745, 5749, 5753, 5755, 5757, 5758, 5758, 5757, 5756, 5754, 5752, 5749, 5746, 5743, 5740, 5736 },
+	{ 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5663, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664, 5664 },
+};
+
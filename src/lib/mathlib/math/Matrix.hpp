@@ -49,16 +49,21 @@
 #ifdef CONFIG_ARCH_ARM
 #include "../CMSIS/Include/arm_math.h"
 #else
-#include "modules/local_position_estimator/matrix/src/Matrix.hpp"
+#include <matrix/Matrix.hpp>
 #endif
 #include <platforms/px4_defines.h>
 
+#include "MatrixKernels.hpp"
+
 namespace math
 {
 
 template<unsigned int M, unsigned int N>
 class __EXPORT Matrix;
 
+template<unsigned int M, unsigned int N>
+class MatrixTransposed;
+
 // MxN matrix with float elements
 template <unsigned int M, unsigned int N>
 class __EXPORT MatrixBase
@@ -302,32 +307,39 @@ public:
 	 */
 	template <unsigned int P>
 	Matrix<M, P> operator *(const Matrix<N, P> &m) const {
-#ifdef CONFIG_ARCH_ARM
 		Matrix<M, P> res;
-		arm_mat_mult_f32(&arm_mat, &m.arm_mat, &res.arm_mat);
+#ifdef CONFIG_ARCH_ARM
+
+		// the call overhead of CMSIS dominates for the small sizes
+		if (M > 4 || N > 4 || P > 4) {
+			arm_mat_mult_f32(&arm_mat, &m.arm_mat, &res.arm_mat);
+			return res;
+		}
+
+#endif
+		kernels::mult(data, m.data, res.data);
 		return res;
-#else
-		matrix::Matrix<float, M, N> Me(this->arm_mat.pData);
-		matrix::Matrix<float, N, P> Him(m.arm_mat.pData);
-		matrix::Matrix<float, M, P> Product = Me * Him;
-		Matrix<M, P> res(Product.data());
+	}
+
+	/**
+	 * multiplication by a transposed matrix
+	 */
+	template <unsigned int P>
+	Matrix<M, P> operator *(const MatrixTransposed<P, N> &m) const {
+		Matrix<M, P> res;
+		kernels::mult_by_transposed(data, m.source().data, res.data);
 		return res;
-#endif
 	}
 
 	/**
 	 * transpose the matrix
+	 *
+	 * Returns a view that converts to Matrix<N, M>; products with the
+	 * view are evaluated directly from this matrix without forming
+	 * the transpose.
 	 */
-	Matrix<N, M> transposed(void) const {
-#ifdef CONFIG_ARCH_ARM
-		Matrix<N, M> res;
-		arm_mat_trans_f32(&this->arm_mat, &res.arm_mat);
-		return res;
-#else
-		matrix::Matrix<float, N, M> Me(this->arm_mat.pData);
-		Matrix<N, M> res(Me.transpose().data());
-		return res;
-#endif
+	MatrixTransposed<M, N> transposed(void) const {
+		return MatrixTransposed<M, N>(*this);
 	}
 
 	/**
@@ -402,15 +414,16 @@ public:
 	 * multiplication by a vector
 	 */
 	Vector<M> operator *(const Vector<N> &v) const {
-#ifdef CONFIG_ARCH_ARM
 		Vector<M> res;
-		arm_mat_mult_f32(&this->arm_mat, &v.arm_col, &res.arm_col);
-#else
-		matrix::Matrix<float, M, N> Me(this->arm_mat.pData);
-		matrix::Matrix<float, N, 1> Vec(v.arm_col.pData);
-		matrix::Matrix<float, M, 1> Product = Me * Vec;
-		Vector<M> res(Product.data());
+#ifdef CONFIG_ARCH_ARM
+
+		if (M > 4 || N > 4) {
+			arm_mat_mult_f32(&this->arm_mat, &v.arm_col, &res.arm_col);
+			return res;
+		}
+
 #endif
+		kernels::mult(this->data, v.data, res.data);
 		return res;
 	}
 };
@@ -509,6 +522,68 @@ public:
 	}
 };
 
+/**
+ * Transpose of an MxN matrix, evaluated lazily
+ */
+template <unsigned int M, unsigned int N>
+class MatrixTransposed
+{
+public:
+	explicit MatrixTransposed(const MatrixBase<M, N> &m) : _m(m) {}
+
+	/**
+	 * access by index
+	 */
+	float operator()(const unsigned int row, const unsigned int col) const {
+		return _m.data[col][row];
+	}
+
+	/**
+	 * evaluate the transpose
+	 */
+	operator Matrix<N, M>() const {
+		Matrix<N, M> res;
+		kernels::transpose(_m.data, res.data);
+		return res;
+	}
+
+	/**
+	 * multiplication by a vector
+	 */
+	Vector<N> operator *(const Vector<M> &v) const {
+		Vector<N> res;
+		kernels::mult_transposed(_m.data, v.data, res.data);
+		return res;
+	}
+
+	/**
+	 * multiplication by another matrix
+	 */
+	template <unsigned int P>
+	Matrix<N, P> operator *(const Matrix<M, P> &m) const {
+		Matrix<N, P> res;
+		kernels::mult_transposed(_m.data, m.data, res.data);
+		return res;
+	}
+
+	/**
+	 * the matrix this is the transpose of
+	 */
+	const MatrixBase<M, N> &source() const {
+		return _m;
+	}
+
+	/**
+	 * transpose back
+	 */
+	Matrix<M, N> transposed(void) const {
+		return Matrix<M, N>(_m.data);
+	}
+
+private:
+	const MatrixBase<M, N> &_m;
+};
+
 }
 
 #endif // MATRIX_HPP
@@ -0,0 +1,371 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file MatrixKernels.hpp
+ *
+ * Fixed size kernels behind the Matrix and Vector operators.
+ *
+ * All kernels work on row-major arrays and write to a result that must
+ * not alias the inputs. Products are formed as sums of scaled rows, which
+ * keeps the inner loops contiguous so the compiler can unroll and
+ * vectorise them. The 3x3, 4x4 and 3- and 4-vector shapes used by the
+ * controllers have hand written SSE and NEON versions.
+ */
+
+#ifndef MATRIX_KERNELS_HPP
+#define MATRIX_KERNELS_HPP
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#define MATH_KERNELS_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MATH_KERNELS_NEON
+#endif
+
+namespace math
+{
+namespace kernels
+{
+
+/**
+ * res = a * b
+ */
+template <unsigned int M, unsigned int N, unsigned int P>
+inline void mult(const float (&a)[M][N], const float (&b)[N][P], float (&res)[M][P])
+{
+	for (unsigned int i = 0; i < M; i++) {
+		for (unsigned int j = 0; j < P; j++) {
+			res[i][j] = a[i][0] * b[0][j];
+		}
+
+		for (unsigned int k = 1; k < N; k++) {
+			const float s = a[i][k];
+
+			for (unsigned int j = 0; j < P; j++) {
+				res[i][j] += s * b[k][j];
+			}
+		}
+	}
+}
+
+/**
+ * res = a' * b
+ */
+template <unsigned int M, unsigned int N, unsigned int P>
+inline void mult_transposed(const float (&a)[M][N], const float (&b)[M][P], float (&res)[N][P])
+{
+	for (unsigned int i = 0; i < N; i++) {
+		for (unsigned int j = 0; j < P; j++) {
+			res[i][j] = a[0][i] * b[0][j];
+		}
+
+		for (unsigned int k = 1; k < M; k++) {
+			const float s = a[k][i];
+
+			for (unsigned int j = 0; j < P; j++) {
+				res[i][j] += s * b[k][j];
+			}
+		}
+	}
+}
+
+/**
+ * res = a * b'
+ */
+template <unsigned int M, unsigned int N, unsigned int P>
+inline void mult_by_transposed(const float (&a)[M][N], const float (&b)[P][N], float (&res)[M][P])
+{
+	for (unsigned int i = 0; i < M; i++) {
+		for (unsigned int j = 0; j < P; j++) {
+			float sum = 0.0f;
+
+			for (unsigned int k = 0; k < N; k++) {
+				sum += a[i][k] * b[j][k];
+			}
+
+			res[i][j] = sum;
+		}
+	}
+}
+
+/**
+ * res = a * v
+ */
+template <unsigned int M, unsigned int N>
+inline void mult(const float (&a)[M][N], const float (&v)[N], float (&res)[M])
+{
+	for (unsigned int i = 0; i < M; i++) {
+		float sum = 0.0f;
+
+		for (unsigned int k = 0; k < N; k++) {
+			sum += a[i][k] * v[k];
+		}
+
+		res[i] = sum;
+	}
+}
+
+/**
+ * res = a' * v
+ */
+template <unsigned int M, unsigned int N>
+inline void mult_transposed(const float (&a)[M][N], const float (&v)[M], float (&res)[N])
+{
+	for (unsigned int j = 0; j < N; j++) {
+		res[j] = a[0][j] * v[0];
+	}
+
+	for (unsigned int k = 1; k < M; k++) {
+		const float s = v[k];
+
+		for (unsigned int j = 0; j < N; j++) {
+			res[j] += a[k][j] * s;
+		}
+	}
+}
+
+/**
+ * res = a'
+ */
+template <unsigned int M, unsigned int N>
+inline void transpose(const float (&a)[M][N], float (&res)[N][M])
+{
+	for (unsigned int i = 0; i < M; i++) {
+		for (unsigned int j = 0; j < N; j++) {
+			res[j][i] = a[i][j];
+		}
+	}
+}
+
+#if defined(MATH_KERNELS_SSE)
+
+/* 3 element rows are loaded and stored without touching the 4th lane */
+static inline __m128 load3(const float *p)
+{
+	return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)p), _mm_load_ss(p + 2));
+}
+
+static inline void store3(float *p, __m128 x)
+{
+	_mm_storel_pi((__m64 *)p, x);
+	_mm_store_ss(p + 2, _mm_movehl_ps(x, x));
+}
+
+static inline __m128 splat(float s)
+{
+	return _mm_set1_ps(s);
+}
+
+template <>
+inline void mult<4, 4, 4>(const float (&a)[4][4], const float (&b)[4][4], float (&res)[4][4])
+{
+	const __m128 b0 = _mm_loadu_ps(b[0]);
+	const __m128 b1 = _mm_loadu_ps(b[1]);
+	const __m128 b2 = _mm_loadu_ps(b[2]);
+	const __m128 b3 = _mm_loadu_ps(b[3]);
+
+	for (unsigned int i = 0; i < 4; i++) {
+		__m128 r = _mm_mul_ps(splat(a[i][0]), b0);
+		r = _mm_add_ps(r, _mm_mul_ps(splat(a[i][1]), b1));
+		r = _mm_add_ps(r, _mm_mul_ps(splat(a[i][2]), b2));
+		r = _mm_add_ps(r, _mm_mul_ps(splat(a[i][3]), b3));
+		_mm_storeu_ps(res[i], r);
+	}
+}
+
+template <>
+inline void mult<3, 3, 3>(const float (&a)[3][3], const float (&b)[3][3], float (&res)[3][3])
+{
+	const __m128 b0 = load3(b[0]);
+	const __m128 b1 = load3(b[1]);
+	const __m128 b2 = load3(b[2]);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		__m128 r = _mm_mul_ps(splat(a[i][0]), b0);
+		r = _mm_add_ps(r, _mm_mul_ps(splat(a[i][1]), b1));
+		r = _mm_add_ps(r, _mm_mul_ps(splat(a[i][2]), b2));
+		store3(res[i], r);
+	}
+}
+
+template <>
+inline void mult_transposed<3, 3, 3>(const float (&a)[3][3], const float (&b)[3][3], float (&res)[3][3])
+{
+	const __m128 b0 = load3(b[0]);
+	const __m128 b1 = load3(b[1]);
+	const __m128 b2 = load3(b[2]);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		__m128 r = _mm_mul_ps(splat(a[0][i]), b0);
+		r = _mm_add_ps(r, _mm_mul_ps(splat(a[1][i]), b1));
+		r = _mm_add_ps(r, _mm_mul_ps(splat(a[2][i]), b2));
+		store3(res[i], r);
+	}
+}
+
+template <>
+inline void mult<4, 4>(const float (&a)[4][4], const float (&v)[4], float (&res)[4])
+{
+	__m128 r0 = _mm_loadu_ps(a[0]);
+	__m128 r1 = _mm_loadu_ps(a[1]);
+	__m128 r2 = _mm_loadu_ps(a[2]);
+	__m128 r3 = _mm_loadu_ps(a[3]);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	__m128 r = _mm_mul_ps(r0, splat(v[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(r1, splat(v[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(r2, splat(v[2])));
+	r = _mm_add_ps(r, _mm_mul_ps(r3, splat(v[3])));
+	_mm_storeu_ps(res, r);
+}
+
+template <>
+inline void mult_transposed<4, 4>(const float (&a)[4][4], const float (&v)[4], float (&res)[4])
+{
+	__m128 r = _mm_mul_ps(_mm_loadu_ps(a[0]), splat(v[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a[1]), splat(v[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a[2]), splat(v[2])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a[3]), splat(v[3])));
+	_mm_storeu_ps(res, r);
+}
+
+template <>
+inline void mult_transposed<3, 3>(const float (&a)[3][3], const float (&v)[3], float (&res)[3])
+{
+	__m128 r = _mm_mul_ps(load3(a[0]), splat(v[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(load3(a[1]), splat(v[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(load3(a[2]), splat(v[2])));
+	store3(res, r);
+}
+
+#elif defined(MATH_KERNELS_NEON)
+
+static inline float32x4_t load3(const float *p)
+{
+	return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, vdup_n_f32(0.0f), 0));
+}
+
+static inline void store3(float *p, float32x4_t x)
+{
+	vst1_f32(p, vget_low_f32(x));
+	vst1q_lane_f32(p + 2, x, 2);
+}
+
+template <>
+inline void mult<4, 4, 4>(const float (&a)[4][4], const float (&b)[4][4], float (&res)[4][4])
+{
+	const float32x4_t b0 = vld1q_f32(b[0]);
+	const float32x4_t b1 = vld1q_f32(b[1]);
+	const float32x4_t b2 = vld1q_f32(b[2]);
+	const float32x4_t b3 = vld1q_f32(b[3]);
+
+	for (unsigned int i = 0; i < 4; i++) {
+		float32x4_t r = vmulq_n_f32(b0, a[i][0]);
+		r = vmlaq_n_f32(r, b1, a[i][1]);
+		r = vmlaq_n_f32(r, b2, a[i][2]);
+		r = vmlaq_n_f32(r, b3, a[i][3]);
+		vst1q_f32(res[i], r);
+	}
+}
+
+template <>
+inline void mult<3, 3, 3>(const float (&a)[3][3], const float (&b)[3][3], float (&res)[3][3])
+{
+	const float32x4_t b0 = load3(b[0]);
+	const float32x4_t b1 = load3(b[1]);
+	const float32x4_t b2 = load3(b[2]);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		float32x4_t r = vmulq_n_f32(b0, a[i][0]);
+		r = vmlaq_n_f32(r, b1, a[i][1]);
+		r = vmlaq_n_f32(r, b2, a[i][2]);
+		store3(res[i], r);
+	}
+}
+
+template <>
+inline void mult_transposed<3, 3, 3>(const float (&a)[3][3], const float (&b)[3][3], float (&res)[3][3])
+{
+	const float32x4_t b0 = load3(b[0]);
+	const float32x4_t b1 = load3(b[1]);
+	const float32x4_t b2 = load3(b[2]);
+
+	for (unsigned int i = 0; i < 3; i++) {
+		float32x4_t r = vmulq_n_f32(b0, a[0][i]);
+		r = vmlaq_n_f32(r, b1, a[1][i]);
+		r = vmlaq_n_f32(r, b2, a[2][i]);
+		store3(res[i], r);
+	}
+}
+
+template <>
+inline void mult<4, 4>(const float (&a)[4][4], const float (&v)[4], float (&res)[4])
+{
+	/* de-interleaving load, c.val[k] is column k of a */
+	const float32x4x4_t c = vld4q_f32(&a[0][0]);
+
+	float32x4_t r = vmulq_n_f32(c.val[0], v[0]);
+	r = vmlaq_n_f32(r, c.val[1], v[1]);
+	r = vmlaq_n_f32(r, c.val[2], v[2]);
+	r = vmlaq_n_f32(r, c.val[3], v[3]);
+	vst1q_f32(res, r);
+}
+
+template <>
+inline void mult_transposed<4, 4>(const float (&a)[4][4], const float (&v)[4], float (&res)[4])
+{
+	float32x4_t r = vmulq_n_f32(vld1q_f32(a[0]), v[0]);
+	r = vmlaq_n_f32(r, vld1q_f32(a[1]), v[1]);
+	r = vmlaq_n_f32(r, vld1q_f32(a[2]), v[2]);
+	r = vmlaq_n_f32(r, vld1q_f32(a[3]), v[3]);
+	vst1q_f32(res, r);
+}
+
+template <>
+inline void mult_transposed<3, 3>(const float (&a)[3][3], const float (&v)[3], float (&res)[3])
+{
+	float32x4_t r = vmulq_n_f32(load3(a[0]), v[0]);
+	r = vmlaq_n_f32(r, load3(a[1]), v[1]);
+	r = vmlaq_n_f32(r, load3(a[2]), v[2]);
+	store3(res, r);
+}
+
+#endif
+
+}
+}
+
+#endif // MATRIX_KERNELS_HPP
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "Matrix.hpp"
+#include "SymmetricMatrix.hpp"
+
+namespace matrix
+{
+
+/**
+ * In place factorizations and solves for symmetric positive definite
+ * matrices, e.g. innovation covariances. They are better conditioned
+ * than forming the inverse, report a matrix that is not positive definite
+ * instead of returning a garbage result, and use no storage besides the
+ * factored matrix and the right hand side.
+ *
+ * Only the lower triangle of the input is read and overwritten, so they
+ * work on Matrix as well as on SymmetricMatrix.
+ */
+
+namespace detail
+{
+
+template<typename T, size_t M, class A_t>
+bool ldlt(A_t &A)
+{
+	T LD[M];
+
+	for (size_t j = 0; j < M; j++) {
+		T d = A(j, j);
+
+		for (size_t k = 0; k < j; k++) {
+			LD[k] = A(j, k) * A(k, k);
+			d -= A(j, k) * LD[k];
+		}
+
+		// also catches NaN
+		if (!(d > 0)) {
+			return false;
+		}
+
+		A(j, j) = d;
+
+		for (size_t i = j + 1; i < M; i++) {
+			T sum = A(i, j);
+
+			for (size_t k = 0; k < j; k++) {
+				sum -= A(i, k) * LD[k];
+			}
+
+			A(i, j) = sum / d;
+		}
+	}
+
+	return true;
+}
+
+// the substitutions run over whole rows of B so all right hand
+// sides are solved in the same pass
+template<typename T, size_t M, size_t N, class A_t>
+void ldltSolve(const A_t &LD, Matrix<T, M, N> &B)
+{
+	// forward substitution, L has a unit diagonal
+	for (size_t i = 1; i < M; i++) {
+		for (size_t k = 0; k < i; k++) {
+			const T l = LD(i, k);
+
+			for (size_t c = 0; c < N; c++) {
+				B(i, c) -= l * B(k, c);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < M; i++) {
+		const T d_inv = T(1) / LD(i, i);
+
+		for (size_t c = 0; c < N; c++) {
+			B(i, c) *= d_inv;
+		}
+	}
+
+	// back substitution with L'
+	for (size_t i = M - 1; i-- > 0;) {
+		for (size_t k = i + 1; k < M; k++) {
+			const T l = LD(k, i);
+
+			for (size_t c = 0; c < N; c++) {
+				B(i, c) -= l * B(k, c);
+			}
+		}
+	}
+}
+
+template<typename T, size_t M, class A_t>
+bool cholesky(A_t &A)
+{
+	for (size_t j = 0; j < M; j++) {
+		T d = A(j, j);
+
+		for (size_t k = 0; k < j; k++) {
+			d -= A(j, k) * A(j, k);
+		}
+
+		if (!(d > 0)) {
+			return false;
+		}
+
+		d = T(sqrt(d));
+		A(j, j) = d;
+
+		for (size_t i = j + 1; i < M; i++) {
+			T sum = A(i, j);
+
+			for (size_t k = 0; k < j; k++) {
+				sum -= A(i, k) * A(j, k);
+			}
+
+			A(i, j) = sum / d;
+		}
+	}
+
+	return true;
+}
+
+template<typename T, size_t M, size_t N, class A_t>
+void choleskySolve(const A_t &L, Matrix<T, M, N> &B)
+{
+	for (size_t i = 0; i < M; i++) {
+		for (size_t k = 0; k < i; k++) {
+			const T l = L(i, k);
+
+			for (size_t c = 0; c < N; c++) {
+				B(i, c) -= l * B(k, c);
+			}
+		}
+
+		const T d_inv = T(1) / L(i, i);
+
+		for (size_t c = 0; c < N; c++) {
+			B(i, c) *= d_inv;
+		}
+	}
+
+	for (size_t i = M; i-- > 0;) {
+		for (size_t k = i + 1; k < M; k++) {
+			const T l = L(k, i);
+
+			for (size_t c = 0; c < N; c++) {
+				B(i, c) -= l * B(k, c);
+			}
+		}
+
+		const T d_inv = T(1) / L(i, i);
+
+		for (size_t c = 0; c < N; c++) {
+			B(i, c) *= d_inv;
+		}
+	}
+}
+
+}; // namespace detail
+
+/**
+ * LDL' factorization in place, the strictly lower triangle holds the
+ * unit lower triangular factor L and the diagonal holds D.
+ *
+ * @return false if A is not positive definite
+ */
+template<typename T, size_t M>
+bool ldlt(Matrix<T, M, M> &A)
+{
+	return detail::ldlt<T, M>(A);
+}
+
+template<typename T, size_t M>
+bool ldlt(SymmetricMatrix<T, M> &A)
+{
+	return detail::ldlt<T, M>(A);
+}
+
+/**
+ * Solve A * X = B in place, given the factor of A from ldlt().
+ */
+template<typename T, size_t M, size_t N>
+void ldltSolve(const Matrix<T, M, M> &LD, Matrix<T, M, N> &B)
+{
+	detail::ldltSolve<T, M, N>(LD, B);
+}
+
+template<typename T, size_t M, size_t N>
+void ldltSolve(const SymmetricMatrix<T, M> &LD, Matrix<T, M, N> &B)
+{
+	detail::ldltSolve<T, M, N>(LD, B);
+}
+
+/**
+ * Cholesky factorization A = L * L' in place, the lower triangle holds L.
+ *
+ * @return false if A is not positive definite
+ */
+template<typename T, size_t M>
+bool cholesky(Matrix<T, M, M> &A)
+{
+	return detail::cholesky<T, M>(A);
+}
+
+template<typename T, size_t M>
+bool cholesky(SymmetricMatrix<T, M> &A)
+{
+	return detail::cholesky<T, M>(A);
+}
+
+/**
+ * Solve A * X = B in place, given the factor of A from cholesky().
+ */
+template<typename T, size_t M, size_t N>
+void choleskySolve(const Matrix<T, M, M> &L, Matrix<T, M, N> &B)
+{
+	detail::choleskySolve<T, M, N>(L, B);
+}
+
+template<typename T, size_t M, size_t N>
+void choleskySolve(const SymmetricMatrix<T, M> &L, Matrix<T, M, N> &B)
+{
+	detail::choleskySolve<T, M, N>(L, B);
+}
+
+}; // namespace matrix
@@ -43,6 +43,12 @@ public:
 		memcpy(_data, other._data, sizeof(_data));
 	}
 
+	Matrix &operator=(const Matrix &other)
+	{
+		memcpy(_data, other._data, sizeof(_data));
+		return *this;
+	}
+
 	Matrix(T x, T y, T z) :
 		_data(),
 		_rows(M),
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Matrix.hpp"
+
+namespace matrix
+{
+
+/**
+ * Symmetric matrix with packed storage of the lower triangle,
+ * element (i, j) and (j, i) share the same storage.
+ */
+template<typename T, size_t M>
+class SymmetricMatrix
+{
+
+private:
+	T _data[M * (M + 1) / 2];
+
+	static inline size_t index(size_t i, size_t j)
+	{
+		return (i >= j) ? (i * (i + 1) / 2 + j) : (j * (j + 1) / 2 + i);
+	}
+
+public:
+
+	SymmetricMatrix() :
+		_data()
+	{
+	}
+
+	/**
+	 * Copy the lower triangle of a square matrix.
+	 */
+	explicit SymmetricMatrix(const Matrix<T, M, M> &A) :
+		_data()
+	{
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j <= i; j++) {
+				_data[index(i, j)] = A(i, j);
+			}
+		}
+	}
+
+	/**
+	 * Accessors/ Assignment etc.
+	 */
+
+	inline size_t rows() const
+	{
+		return M;
+	}
+
+	inline size_t cols() const
+	{
+		return M;
+	}
+
+	inline T operator()(size_t i, size_t j) const
+	{
+		return _data[index(i, j)];
+	}
+
+	inline T &operator()(size_t i, size_t j)
+	{
+		return _data[index(i, j)];
+	}
+
+	Matrix<T, M, M> full() const
+	{
+		Matrix<T, M, M> res;
+		const SymmetricMatrix<T, M> &self = *this;
+
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < M; j++) {
+				res(i, j) = self(i, j);
+			}
+		}
+
+		return res;
+	}
+
+	/**
+	 * Matrix Operations
+	 */
+
+	template<size_t P>
+	Matrix<T, M, P> operator*(const Matrix<T, M, P> &other) const
+	{
+		const SymmetricMatrix<T, M> &self = *this;
+		Matrix<T, M, P> res;
+		res.setZero();
+
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < M; j++) {
+				const T a = self(i, j);
+
+				for (size_t k = 0; k < P; k++) {
+					res(i, k) += a * other(j, k);
+				}
+			}
+		}
+
+		return res;
+	}
+
+	void operator+=(const SymmetricMatrix<T, M> &other)
+	{
+		for (size_t i = 0; i < M * (M + 1) / 2; i++) {
+			_data[i] += other._data[i];
+		}
+	}
+
+	void operator-=(const SymmetricMatrix<T, M> &other)
+	{
+		for (size_t i = 0; i < M * (M + 1) / 2; i++) {
+			_data[i] -= other._data[i];
+		}
+	}
+
+	void operator*=(T scalar)
+	{
+		for (size_t i = 0; i < M * (M + 1) / 2; i++) {
+			_data[i] *= scalar;
+		}
+	}
+
+	/**
+	 * Misc. Functions
+	 */
+
+	void setZero()
+	{
+		memset(_data, 0, sizeof(_data));
+	}
+
+	void setIdentity()
+	{
+		setZero();
+
+		for (size_t i = 0; i < M; i++) {
+			_data[index(i, i)] = 1;
+		}
+	}
+};
+
+/**
+ * Congruence transform C * A * C', the result is symmetric by construction
+ * and only its lower triangle is computed.
+ */
+template<typename T, size_t M, size_t N>
+SymmetricMatrix<T, N> congruence(const Matrix<T, N, M> &C, const SymmetricMatrix<T, M> &A)
+{
+	Matrix<T, M, N> AC_T;
+	AC_T.setZero();
+
+	for (size_t i = 0; i < M; i++) {
+		for (size_t j = 0; j < M; j++) {
+			const T a = A(i, j);
+
+			for (size_t k = 0; k < N; k++) {
+				AC_T(i, k) += a * C(k, j);
+			}
+		}
+	}
+
+	SymmetricMatrix<T, N> res;
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j <= i; j++) {
+			T sum = 0;
+
+			for (size_t k = 0; k < M; k++) {
+				sum += C(i, k) * AC_T(k, j);
+			}
+
+			res(i, j) = sum;
+		}
+	}
+
+	return res;
+}
+
+typedef SymmetricMatrix<float, 3> SymmetricMatrix3f;
+
+}; // namespace matrix
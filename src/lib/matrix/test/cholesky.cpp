@@ -0,0 +1,108 @@
+#include "Cholesky.hpp"
+#include <assert.h>
+#include <stdio.h>
+#include <math.h>
+
+using namespace matrix;
+
+static const size_t n = 6;
+
+template<size_t M, size_t N>
+static bool isEqual(const Matrix<float, M, N> &A, const Matrix<float, M, N> &B, float tol)
+{
+	for (size_t i = 0; i < M; i++) {
+		for (size_t j = 0; j < N; j++) {
+			if (fabsf(A(i, j) - B(i, j)) > tol) {
+				printf("(%d, %d): %g != %g\n", int(i), int(j), double(A(i, j)), double(B(i, j)));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	// symmetric positive definite test matrix A = G * G' + I
+	Matrix<float, n, n> G;
+
+	for (size_t i = 0; i < n; i++) {
+		for (size_t j = 0; j < n; j++) {
+			G(i, j) = float((i * 7 + j * 3) % 11) / 11.0f - 0.4f;
+		}
+	}
+
+	Matrix<float, n, n> I;
+	I.setIdentity();
+	Matrix<float, n, n> A = G * G.transpose() + I;
+
+	Matrix<float, n, 2> B;
+
+	for (size_t i = 0; i < n; i++) {
+		B(i, 0) = float(i) - 2.5f;
+		B(i, 1) = 1.0f / float(i + 1);
+	}
+
+	Matrix<float, n, 2> X_check = A.inverse() * B;
+
+	// LDL' on a full matrix
+	Matrix<float, n, n> LD = A;
+	bool ok = ldlt(LD);
+	assert(ok);
+	Matrix<float, n, 2> X = B;
+	ldltSolve(LD, X);
+	assert(isEqual(X, X_check, 1e-5f));
+	assert(isEqual(A * X, B, 1e-5f));
+
+	// LDL' on packed symmetric storage
+	SymmetricMatrix<float, n> S(A);
+	assert(isEqual(S.full(), A, 0.0f));
+	ok = ldlt(S);
+	assert(ok);
+	X = B;
+	ldltSolve(S, X);
+	assert(isEqual(X, X_check, 1e-5f));
+
+	// Cholesky, L * L' must reproduce A
+	Matrix<float, n, n> L = A;
+	ok = cholesky(L);
+	assert(ok);
+
+	for (size_t i = 0; i < n; i++) {
+		for (size_t j = i + 1; j < n; j++) {
+			L(i, j) = 0;
+		}
+	}
+
+	assert(isEqual(L * L.transpose(), A, 1e-5f));
+	L = A;
+	ok = cholesky(L);
+	assert(ok);
+	X = B;
+	choleskySolve(L, X);
+	assert(isEqual(X, X_check, 1e-5f));
+
+	// congruence transform matches the dense product
+	Matrix<float, 2, n> C;
+	C.setZero();
+	C(0, 1) = 1;
+	C(1, 3) = -2;
+	C(1, 4) = 0.5f;
+	SymmetricMatrix<float, n> As(A);
+	assert(isEqual(congruence(C, As).full(), C * A * C.transpose(), 1e-5f));
+
+	// not positive definite
+	Matrix<float, 2, 2> N;
+	N(0, 0) = 1;
+	N(0, 1) = 2;
+	N(1, 0) = 2;
+	N(1, 1) = 1;
+	Matrix<float, 2, 2> N2 = N;
+	ok = ldlt(N);
+	assert(!ok);
+	ok = cholesky(N2);
+	assert(!ok);
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+#include "Cholesky.hpp"
+#include <assert.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+using namespace matrix;
+
+// state and measurement sizes of the BlockLocalPositionEstimator gps correction
+static const size_t n_x = 9;
+static const size_t n_y = 6;
+static const size_t iterations = 100000;
+
+static float elapsed_us(clock_t start)
+{
+	return 1e6f * float(clock() - start) / CLOCKS_PER_SEC / iterations;
+}
+
+int main()
+{
+	Matrix<float, n_x, n_x> A;
+
+	for (size_t i = 0; i < n_x; i++) {
+		for (size_t j = 0; j < n_x; j++) {
+			A(i, j) = float((i * 5 + j * 3) % 7) / 7.0f - 0.3f;
+		}
+	}
+
+	Matrix<float, n_x, n_x> P = A * A.transpose();
+
+	for (size_t i = 0; i < n_x; i++) {
+		P(i, i) += 0.1f;
+	}
+
+	Matrix<float, n_y, n_x> C;
+	C.setZero();
+
+	for (size_t i = 0; i < n_y; i++) {
+		C(i, i) = 1;
+	}
+
+	Matrix<float, n_y, n_y> R;
+	R.setZero();
+
+	for (size_t i = 0; i < n_y; i++) {
+		R(i, i) = 0.5f;
+	}
+
+	Matrix<float, n_y, 1> r;
+
+	for (size_t i = 0; i < n_y; i++) {
+		r(i) = 0.1f * float(i) - 0.2f;
+	}
+
+	volatile float sink = 0;
+	Matrix<float, n_x, n_y> K_inv;
+	float beta_inv = 0;
+
+	// general inversion of the innovation covariance
+	clock_t start = clock();
+
+	for (size_t it = 0; it < iterations; it++) {
+		// vary the input so the solve cannot be hoisted out of the loop
+		P(0, 0) = 1.0f + float(it % 2);
+		Matrix<float, n_y, n_y> S_I = (C * P * C.transpose() + R).inverse();
+		beta_inv = sqrtf((r.transpose() * (S_I * r))(0, 0));
+		K_inv = P * C.transpose() * S_I;
+		sink = sink + K_inv(0, 0);
+	}
+
+	float inverse_us = elapsed_us(start);
+
+	Matrix<float, n_x, n_y> K;
+	float beta = 0;
+
+	// LDL' factorization and solves
+	start = clock();
+
+	for (size_t it = 0; it < iterations; it++) {
+		P(0, 0) = 1.0f + float(it % 2);
+		Matrix<float, n_y, n_y> S = C * P * C.transpose() + R;
+		bool ok = ldlt(S);
+		assert(ok);
+		Matrix<float, n_y, 1> S_I_r = r;
+		ldltSolve(S, S_I_r);
+		beta = sqrtf((r.transpose() * S_I_r)(0, 0));
+		Matrix<float, n_y, n_x> S_I_CP = C * P;
+		ldltSolve(S, S_I_CP);
+		K = S_I_CP.transpose();
+		sink = sink + K(0, 0);
+	}
+
+	float ldlt_us = elapsed_us(start);
+
+	printf("innovation solve %dx%d: inverse %.3f us, ldlt %.3f us\n",
+	       int(n_y), int(n_y), double(inverse_us), double(ldlt_us));
+
+	assert(fabsf(beta - beta_inv) < 1e-4f);
+
+	for (size_t i = 0; i < n_x; i++) {
+		for (size_t j = 0; j < n_y; j++) {
+			assert(fabsf(K(i, j) - K_inv(i, j)) < 1e-4f);
+		}
+	}
+
+	return 0;
+}
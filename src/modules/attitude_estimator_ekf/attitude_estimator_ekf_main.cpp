@@ -329,6 +329,8 @@ int attitude_estimator_ekf_thread_main(int argc, char *argv[])
 
 	/* magnetic declination, in radians */
 	float mag_decl = 0.0f;
+	struct geo_mag_cache_s mag_cache;
+	geo_mag_cache_init(&mag_cache);
 
 	/* rotation matrix for magnetic declination */
 	math::Matrix<3, 3> R_decl;
@@ -383,8 +385,11 @@ int attitude_estimator_ekf_thread_main(int argc, char *argv[])
 				if (gps_updated) {
 					orb_copy(ORB_ID(vehicle_gps_position), sub_gps, &gps);
 
-					if (gps.eph < 20.0f && hrt_elapsed_time(&gps.timestamp_position) < 1000000) {
-						mag_decl = math::radians(get_mag_declination(gps.lat / 1e7f, gps.lon / 1e7f));
+					float mag_decl_deg;
+
+					if (gps.eph < 20.0f && hrt_elapsed_time(&gps.timestamp_position) < 1000000 &&
+					    get_mag_field_cached(&mag_cache, gps.lat / 1e7f, gps.lon / 1e7f, &mag_decl_deg, nullptr, nullptr) == 0) {
+						mag_decl = math::radians(mag_decl_deg);
 
 						/* update mag declination rotation matrix */
 						R_decl.from_euler(0.0f, 0.0f, mag_decl);
@@ -606,6 +611,7 @@ int attitude_estimator_ekf_thread_main(int argc, char *argv[])
 
 					/* send out */
 					att.timestamp = raw.timestamp;
+					att.timestamp_sample = raw.timestamp;
 
 					att.roll = euler[0];
 					att.pitch = euler[1];
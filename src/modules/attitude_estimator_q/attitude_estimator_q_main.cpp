@@ -41,6 +41,7 @@
 
 #include <px4_config.h>
 #include <px4_posix.h>
+#include <px4_vehicle.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -80,7 +81,7 @@ class AttitudeEstimatorQ;
 
 namespace attitude_estimator_q
 {
-AttitudeEstimatorQ *instance;
+px4::VehicleInstance<AttitudeEstimatorQ> instance;
 }
 
 
@@ -136,6 +137,7 @@ private:
 	float		_w_gyro_bias = 0.0f;
 	float		_mag_decl = 0.0f;
 	bool		_mag_decl_auto = false;
+	struct geo_mag_cache_s	_mag_cache;		/**< declination table cell of the last position */
 	bool		_acc_comp = false;
 	float		_bias_max = 0.0f;
 	float		_vibration_warning_threshold = 1.0f;
@@ -193,6 +195,7 @@ AttitudeEstimatorQ::AttitudeEstimatorQ() :
 	_lp_yaw_rate(250, 10.0f)
 {
 	_voter_mag.set_timeout(200000);
+	geo_mag_cache_init(&_mag_cache);
 
 	_params_handles.w_acc		= param_find("ATT_W_ACC");
 	_params_handles.w_mag		= param_find("ATT_W_MAG");
@@ -382,7 +385,11 @@ void AttitudeEstimatorQ::task_main()
 
 			if (_mag_decl_auto && _gpos.eph < 20.0f && hrt_elapsed_time(&_gpos.timestamp) < 1000000) {
 				/* set magnetic declination automatically */
-				_mag_decl = math::radians(get_mag_declination(_gpos.lat, _gpos.lon));
+				float mag_decl_deg;
+
+				if (get_mag_field_cached(&_mag_cache, _gpos.lat, _gpos.lon, &mag_decl_deg, nullptr, nullptr) == 0) {
+					_mag_decl = math::radians(mag_decl_deg);
+				}
 			}
 		}
 
@@ -426,6 +433,7 @@ void AttitudeEstimatorQ::task_main()
 
 		struct vehicle_attitude_s att = {};
 		att.timestamp = sensors.timestamp;
+		att.timestamp_sample = sensors.timestamp;
 
 		att.roll = euler(0);
 		att.pitch = euler(1);
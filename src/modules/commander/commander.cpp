@@ -2444,7 +2444,7 @@ int commander_thread_main(int argc, char *argv[])
 
 		status_changed = false;
 
-		usleep(COMMANDER_MONITORING_INTERVAL);
+		px4_usleep(COMMANDER_MONITORING_INTERVAL);
 	}
 
 	/* wait for threads to complete */
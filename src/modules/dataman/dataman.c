@@ -34,6 +34,11 @@
  * @file dataman.c
  * DATAMANAGER driver.
  *
+ * On POSIX the data manager file is memory mapped. Reads and writes then
+ * copy to and from the mapping under a lock per item type in the caller's
+ * context, and the worker task only writes changes back to the file with
+ * one msync for all writes that happened since the last one.
+ *
  * @author Jean Cyr
  * @author Lorenz Meier
  * @author Julian Oes
@@ -56,6 +61,11 @@
 #include "dataman.h"
 #include <systemlib/param/param.h>
 
+#ifdef __PX4_POSIX
+#include <sys/mman.h>
+#define DATAMAN_MMAP
+#endif
+
 /**
  * data manager app start / stop handling function
  *
@@ -64,8 +74,11 @@
 
 __EXPORT int dataman_main(int argc, char *argv[]);
 __EXPORT ssize_t dm_read(dm_item_t item, unsigned char index, void *buffer, size_t buflen);
+__EXPORT ssize_t dm_read_range(dm_item_t item, unsigned char index, void *buffer, unsigned count, size_t buflen);
 __EXPORT ssize_t dm_write(dm_item_t  item, unsigned char index, dm_persitence_t persistence, const void *buffer,
 			  size_t buflen);
+__EXPORT ssize_t dm_write_range(dm_item_t item, unsigned char index, dm_persitence_t persistence, const void *buffer,
+				unsigned count, size_t buflen);
 __EXPORT int dm_clear(dm_item_t item);
 __EXPORT void dm_lock(dm_item_t item);
 __EXPORT void dm_unlock(dm_item_t item);
@@ -77,6 +90,8 @@ typedef enum {
 	dm_read_func,
 	dm_clear_func,
 	dm_restart_func,
+	dm_read_range_func,
+	dm_write_range_func,
 	dm_number_of_funcs
 } dm_function_t;
 
@@ -107,13 +122,29 @@ typedef struct {
 		struct {
 			dm_reset_reason reason;
 		} restart_params;
+		struct {
+			dm_item_t item;
+			unsigned char index;
+			unsigned count;
+			void *buf;
+			size_t len;
+		} read_range_params;
+		struct {
+			dm_item_t item;
+			unsigned char index;
+			dm_persitence_t persistence;
+			unsigned count;
+			const void *buf;
+			size_t len;
+		} write_range_params;
 	};
 } work_q_item_t;
 
 const size_t k_work_item_allocation_chunk_size = 8;
 
-/* Usage statistics */
+/* Usage statistics, counted by the worker task and by callers accessing the mapping directly */
 static unsigned g_func_counts[dm_number_of_funcs];
+#define dm_count(func)	__atomic_fetch_add(&g_func_counts[func], 1, __ATOMIC_RELAXED)
 
 /* table of maximum number of instances for each item type */
 static const unsigned g_per_item_max_index[DM_KEY_NUM_KEYS] = {
@@ -157,6 +188,37 @@ static bool g_task_should_exit;	/**< if true, dataman task should exit */
 #define DM_SECTOR_HDR_SIZE 4	/* data manager per item header overhead */
 static const unsigned k_sector_size = DM_MAX_DATA_SIZE + DM_SECTOR_HDR_SIZE; /* total item sorage space */
 
+/* Layout of the data manager file, kept in the sector after the last item. A file written with another
+ * layout has its items at other offsets and is reset. Bump the version when the item formats change. */
+#define DM_LAYOUT_VERSION 1
+
+typedef struct {
+	uint32_t version;
+	uint32_t sector_size;
+	uint32_t max_index[DM_KEY_NUM_KEYS];	/* number of items of each type */
+} dm_layout_t;
+
+/* Range requests are transferred in chunks of this many sectors, one read or write per chunk */
+#define DM_RANGE_CHUNK_SECTORS 8
+
+/* Staging buffer for range requests, only used by the worker task */
+static unsigned char g_range_buffer[DM_RANGE_CHUNK_SECTORS * (DM_MAX_DATA_SIZE + DM_SECTOR_HDR_SIZE)];
+
+#ifdef DATAMAN_MMAP
+/* The memory mapped data manager file, NULL if the file could not be mapped */
+static unsigned char *g_map = NULL;
+static size_t g_map_size = 0;
+
+/* Mutual exclusion on the mapped items of each type, independent of dm_lock() */
+static px4_sem_t g_map_locks[DM_KEY_NUM_KEYS];
+
+static volatile bool g_sync_pending;	/**< mapping has changes not yet written back */
+static unsigned g_sync_count;
+
+/* Callers currently accessing the mapping directly, shutdown waits for them before releasing it */
+static unsigned g_direct_callers;
+#endif
+
 static void init_q(work_q_t *q)
 {
 	sq_init(&(q->q));		/* Initialize the NuttX queue structure */
@@ -309,6 +371,67 @@ calculate_offset(dm_item_t item, unsigned char index)
 	return g_key_offsets[item] + (index * k_sector_size);
 }
 
+/* Calculate the offset of the first item of a range, fails if any item of the range is out of bounds */
+static int
+calculate_range_offset(dm_item_t item, unsigned char index, unsigned count)
+{
+	if (item >= DM_KEY_NUM_KEYS || count == 0 || index + count > g_per_item_max_index[item]) {
+		return -1;
+	}
+
+	return calculate_offset(item, index);
+}
+
+/* The layout of this build */
+static void
+layout_get(dm_layout_t *layout)
+{
+	memset(layout, 0, sizeof(*layout));
+	layout->version = DM_LAYOUT_VERSION;
+	layout->sector_size = k_sector_size;
+
+	for (unsigned i = 0; i < DM_KEY_NUM_KEYS; i++) {
+		layout->max_index[i] = g_per_item_max_index[i];
+	}
+}
+
+/* Check whether the file was written with the layout of this build */
+static bool
+layout_check(int fd, unsigned offset)
+{
+	unsigned char sector[DM_SECTOR_HDR_SIZE + sizeof(dm_layout_t)];
+	dm_layout_t layout;
+	layout_get(&layout);
+
+	if (lseek(fd, offset, SEEK_SET) != (off_t)offset || read(fd, sector, sizeof(sector)) != (ssize_t)sizeof(sector)) {
+		return false;
+	}
+
+	return sector[0] == sizeof(layout) && memcmp(&sector[DM_SECTOR_HDR_SIZE], &layout, sizeof(layout)) == 0;
+}
+
+/* Record the layout of this build in the file, it survives all resets */
+static int
+layout_write(int fd, unsigned offset)
+{
+	/* a whole sector, the file stays a multiple of the sector size */
+	unsigned char sector[k_sector_size];
+	dm_layout_t layout;
+	layout_get(&layout);
+
+	memset(sector, 0, sizeof(sector));
+	sector[0] = sizeof(layout);
+	sector[1] = DM_PERSIST_POWER_ON_RESET;
+	memcpy(&sector[DM_SECTOR_HDR_SIZE], &layout, sizeof(layout));
+
+	if (lseek(fd, offset, SEEK_SET) != (off_t)offset || write(fd, sector, sizeof(sector)) != (ssize_t)sizeof(sector)) {
+		return -1;
+	}
+
+	fsync(fd);
+	return 0;
+}
+
 /* Each data item is stored as follows
  *
  * byte 0: Length of user data item
@@ -320,6 +443,230 @@ calculate_offset(dm_item_t item, unsigned char index)
  * The total size must not exceed k_sector_size
  */
 
+#ifdef DATAMAN_MMAP
+/* Register a caller accessing the mapping directly, fails once shutdown has begun */
+static bool
+direct_enter(void)
+{
+	__atomic_fetch_add(&g_direct_callers, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&g_task_should_exit, __ATOMIC_SEQ_CST)) {
+		__atomic_fetch_sub(&g_direct_callers, 1, __ATOMIC_SEQ_CST);
+		return false;
+	}
+
+	return true;
+}
+
+static void
+direct_leave(void)
+{
+	__atomic_fetch_sub(&g_direct_callers, 1, __ATOMIC_RELEASE);
+}
+
+/* tell the worker task to write back the mapping */
+static void
+request_sync(void)
+{
+	g_sync_pending = true;
+	px4_sem_post(&g_work_queued_sema);
+}
+
+/* write to the mapped data manager file */
+static ssize_t
+_mmap_write(dm_item_t item, unsigned char index, dm_persitence_t persistence, const void *buf, size_t count)
+{
+	int offset = calculate_offset(item, index);
+
+	if (offset < 0 || count > DM_MAX_DATA_SIZE) {
+		return -1;
+	}
+
+	px4_sem_wait(&g_map_locks[item]);
+
+	if (g_map == NULL) {
+		px4_sem_post(&g_map_locks[item]);
+		return -1;
+	}
+
+	unsigned char *sector = g_map + offset;
+
+	if (count > 0) {
+		memcpy(sector + DM_SECTOR_HDR_SIZE, buf, count);
+	}
+
+	sector[1] = persistence;
+	sector[2] = 0;
+	sector[3] = 0;
+	sector[0] = count;
+
+	px4_sem_post(&g_map_locks[item]);
+
+	request_sync();
+	return count;
+}
+
+/* Retrieve from the mapped data manager file */
+static ssize_t
+_mmap_read(dm_item_t item, unsigned char index, void *buf, size_t count)
+{
+	int offset = calculate_offset(item, index);
+
+	if (offset < 0 || count > DM_MAX_DATA_SIZE) {
+		return -1;
+	}
+
+	px4_sem_wait(&g_map_locks[item]);
+
+	if (g_map == NULL) {
+		px4_sem_post(&g_map_locks[item]);
+		return -1;
+	}
+
+	const unsigned char *sector = g_map + offset;
+	ssize_t len = sector[0];
+
+	if (len > (ssize_t)count) {
+		/* We got more than requested!!! */
+		len = -1;
+
+	} else if (len > 0) {
+		memcpy(buf, sector + DM_SECTOR_HDR_SIZE, len);
+	}
+
+	px4_sem_post(&g_map_locks[item]);
+	return len;
+}
+
+/* write a range of items to the mapped data manager file */
+static ssize_t
+_mmap_write_range(dm_item_t item, unsigned char index, dm_persitence_t persistence, const void *buf, unsigned count,
+		  size_t len)
+{
+	int offset = calculate_range_offset(item, index, count);
+
+	if (offset < 0 || len > DM_MAX_DATA_SIZE) {
+		return -1;
+	}
+
+	px4_sem_wait(&g_map_locks[item]);
+
+	if (g_map == NULL) {
+		px4_sem_post(&g_map_locks[item]);
+		return -1;
+	}
+
+	for (unsigned i = 0; i < count; i++) {
+		unsigned char *sector = g_map + offset + i * k_sector_size;
+
+		if (len > 0) {
+			memcpy(sector + DM_SECTOR_HDR_SIZE, (const unsigned char *)buf + i * len, len);
+		}
+
+		sector[1] = persistence;
+		sector[2] = 0;
+		sector[3] = 0;
+		sector[0] = len;
+	}
+
+	px4_sem_post(&g_map_locks[item]);
+
+	request_sync();
+	return count;
+}
+
+/* Retrieve a range of items from the mapped data manager file */
+static ssize_t
+_mmap_read_range(dm_item_t item, unsigned char index, void *buf, unsigned count, size_t len)
+{
+	int offset = calculate_range_offset(item, index, count);
+
+	if (offset < 0 || len == 0 || len > DM_MAX_DATA_SIZE) {
+		return -1;
+	}
+
+	px4_sem_wait(&g_map_locks[item]);
+
+	if (g_map == NULL) {
+		px4_sem_post(&g_map_locks[item]);
+		return -1;
+	}
+
+	unsigned i;
+
+	/* Stop at the first item that is empty or was stored with a different size */
+	for (i = 0; i < count; i++) {
+		const unsigned char *sector = g_map + offset + i * k_sector_size;
+
+		if (sector[0] != len) {
+			break;
+		}
+
+		memcpy((unsigned char *)buf + i * len, sector + DM_SECTOR_HDR_SIZE, len);
+	}
+
+	px4_sem_post(&g_map_locks[item]);
+	return i;
+}
+
+static int
+_mmap_clear(dm_item_t item)
+{
+	int offset = calculate_offset(item, 0);
+
+	if (offset < 0) {
+		return -1;
+	}
+
+	px4_sem_wait(&g_map_locks[item]);
+
+	if (g_map == NULL) {
+		px4_sem_post(&g_map_locks[item]);
+		return -1;
+	}
+
+	/* Avoid SD flash wear by only touching items that are in use */
+	for (unsigned i = 0; i < g_per_item_max_index[item]; i++) {
+		if (g_map[offset + i * k_sector_size]) {
+			g_map[offset + i * k_sector_size] = 0;
+		}
+	}
+
+	px4_sem_post(&g_map_locks[item]);
+
+	request_sync();
+	return 0;
+}
+
+static int
+_mmap_restart(dm_reset_reason reason)
+{
+	/* Items of all types are affected, take the locks in order */
+	for (unsigned i = 0; i < DM_KEY_NUM_KEYS; i++) {
+		px4_sem_wait(&g_map_locks[i]);
+	}
+
+	for (size_t offset = 0; g_map != NULL && offset + k_sector_size <= g_map_size; offset += k_sector_size) {
+		unsigned char *sector = g_map + offset;
+
+		/* Whether data gets deleted depends on reset type and data segment's persistence setting */
+		if (sector[0]) {
+			if ((reason == DM_INIT_REASON_POWER_ON && sector[1] > DM_PERSIST_POWER_ON_RESET) ||
+			    (reason != DM_INIT_REASON_POWER_ON && sector[1] > DM_PERSIST_IN_FLIGHT_RESET)) {
+				sector[0] = 0;
+			}
+		}
+	}
+
+	for (unsigned i = 0; i < DM_KEY_NUM_KEYS; i++) {
+		px4_sem_post(&g_map_locks[i]);
+	}
+
+	request_sync();
+	return 0;
+}
+#endif
+
 /* write to the data manager file */
 static ssize_t
 _write(dm_item_t item, unsigned char index, dm_persitence_t persistence, const void *buf, size_t count)
@@ -328,6 +675,14 @@ _write(dm_item_t item, unsigned char index, dm_persitence_t persistence, const v
 	size_t len;
 	int offset;
 
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		return _mmap_write(item, index, persistence, buf, count);
+	}
+
+#endif
+
 	/* Get the offset for this item */
 	offset = calculate_offset(item, index);
 
@@ -377,6 +732,14 @@ _read(dm_item_t item, unsigned char index, void *buf, size_t count)
 	unsigned char buffer[k_sector_size];
 	int len, offset;
 
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		return _mmap_read(item, index, buf, count);
+	}
+
+#endif
+
 	/* Get the offset for this item */
 	offset = calculate_offset(item, index);
 
@@ -422,11 +785,132 @@ _read(dm_item_t item, unsigned char index, void *buf, size_t count)
 	return buffer[0];
 }
 
+/* write a range of items to the data manager file */
+static ssize_t
+_write_range(dm_item_t item, unsigned char index, dm_persitence_t persistence, const void *buf, unsigned count,
+	     size_t len)
+{
+	int offset;
+
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		return _mmap_write_range(item, index, persistence, buf, count, len);
+	}
+
+#endif
+
+	offset = calculate_range_offset(item, index, count);
+
+	if (offset < 0 || len > DM_MAX_DATA_SIZE) {
+		return -1;
+	}
+
+	/* The items are contiguous in the file, a single seek positions all chunks */
+	if (lseek(g_task_fd, offset, SEEK_SET) != offset) {
+		return -1;
+	}
+
+	for (unsigned done = 0; done < count;) {
+		unsigned n = count - done;
+
+		if (n > DM_RANGE_CHUNK_SECTORS) {
+			n = DM_RANGE_CHUNK_SECTORS;
+		}
+
+		/* Assemble whole sectors, the unused tail of each sector is zeroed */
+		memset(g_range_buffer, 0, n * k_sector_size);
+
+		for (unsigned i = 0; i < n; i++) {
+			unsigned char *sector = g_range_buffer + i * k_sector_size;
+			sector[0] = len;
+			sector[1] = persistence;
+
+			if (len > 0) {
+				memcpy(sector + DM_SECTOR_HDR_SIZE, (const unsigned char *)buf + (done + i) * len, len);
+			}
+		}
+
+		if (write(g_task_fd, g_range_buffer, n * k_sector_size) != (ssize_t)(n * k_sector_size)) {
+			return -1;
+		}
+
+		done += n;
+	}
+
+	/* One sync for the whole range */
+	fsync(g_task_fd);
+
+	return count;
+}
+
+/* Retrieve a range of items from the data manager file */
+static ssize_t
+_read_range(dm_item_t item, unsigned char index, void *buf, unsigned count, size_t len)
+{
+	int offset;
+
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		return _mmap_read_range(item, index, buf, count, len);
+	}
+
+#endif
+
+	offset = calculate_range_offset(item, index, count);
+
+	if (offset < 0 || len == 0 || len > DM_MAX_DATA_SIZE) {
+		return -1;
+	}
+
+	if (lseek(g_task_fd, offset, SEEK_SET) != offset) {
+		return -1;
+	}
+
+	for (unsigned done = 0; done < count;) {
+		unsigned n = count - done;
+
+		if (n > DM_RANGE_CHUNK_SECTORS) {
+			n = DM_RANGE_CHUNK_SECTORS;
+		}
+
+		ssize_t got = read(g_task_fd, g_range_buffer, n * k_sector_size);
+
+		if (got < 0) {
+			return -1;
+		}
+
+		for (unsigned i = 0; i < n; i++) {
+			const unsigned char *sector = g_range_buffer + i * k_sector_size;
+
+			/* Stop at the end of the file or the first item that is empty or was stored with a different size */
+			if (got < (ssize_t)(i * k_sector_size + DM_SECTOR_HDR_SIZE + len) || sector[0] != len) {
+				return done + i;
+			}
+
+			memcpy((unsigned char *)buf + (done + i) * len, sector + DM_SECTOR_HDR_SIZE, len);
+		}
+
+		done += n;
+	}
+
+	return count;
+}
+
 static int
 _clear(dm_item_t item)
 {
 	int i, result = 0;
 
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		return _mmap_clear(item);
+	}
+
+#endif
+
 	/* Get the offset of 1st item of this type */
 	int offset = calculate_offset(item, 0);
 
@@ -479,6 +963,14 @@ _restart(dm_reset_reason reason)
 	unsigned char buffer[2];
 	int offset = 0, result = 0;
 
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		return _mmap_restart(reason);
+	}
+
+#endif
+
 	/* We need to scan the entire file and invalidate and data that should not persist after the last reset */
 
 	/* Loop through all of the data segments and delete those that are not persistent */
@@ -552,6 +1044,22 @@ dm_write(dm_item_t item, unsigned char index, dm_persitence_t persistence, const
 		return -1;
 	}
 
+#ifdef DATAMAN_MMAP
+
+	/* The mapping is accessed directly, no need to involve the worker task */
+	if (g_map != NULL) {
+		if (!direct_enter()) {
+			return -1;
+		}
+
+		dm_count(dm_write_func);
+		ssize_t result = _write(item, index, persistence, buf, count);
+		direct_leave();
+		return result;
+	}
+
+#endif
+
 	/* get a work item and queue up a write request */
 	if ((work = create_work_item()) == NULL) {
 		return -1;
@@ -579,6 +1087,21 @@ dm_read(dm_item_t item, unsigned char index, void *buf, size_t count)
 		return -1;
 	}
 
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		if (!direct_enter()) {
+			return -1;
+		}
+
+		dm_count(dm_read_func);
+		ssize_t result = _read(item, index, buf, count);
+		direct_leave();
+		return result;
+	}
+
+#endif
+
 	/* get a work item and queue up a read request */
 	if ((work = create_work_item()) == NULL) {
 		return -1;
@@ -594,6 +1117,100 @@ dm_read(dm_item_t item, unsigned char index, void *buf, size_t count)
 	return (ssize_t)enqueue_work_item_and_wait_for_result(work);
 }
 
+/** Write a range of consecutive items to the data manager file */
+__EXPORT ssize_t
+dm_write_range(dm_item_t item, unsigned char index, dm_persitence_t persistence, const void *buf, unsigned count,
+	       size_t len)
+{
+	work_q_item_t *work;
+
+	/* Make sure data manager has been started and is not shutting down */
+	if ((g_fd < 0) || g_task_should_exit) {
+		return -1;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		if (!direct_enter()) {
+			return -1;
+		}
+
+		dm_count(dm_write_range_func);
+		ssize_t result = _write_range(item, index, persistence, buf, count, len);
+		direct_leave();
+		return result;
+	}
+
+#endif
+
+	/* get a work item and queue up a range write request */
+	if ((work = create_work_item()) == NULL) {
+		return -1;
+	}
+
+	work->func = dm_write_range_func;
+	work->write_range_params.item = item;
+	work->write_range_params.index = index;
+	work->write_range_params.persistence = persistence;
+	work->write_range_params.count = count;
+	work->write_range_params.buf = buf;
+	work->write_range_params.len = len;
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	return (ssize_t)enqueue_work_item_and_wait_for_result(work);
+}
+
+/** Retrieve a range of consecutive items from the data manager file */
+__EXPORT ssize_t
+dm_read_range(dm_item_t item, unsigned char index, void *buf, unsigned count, size_t len)
+{
+	work_q_item_t *work;
+
+	/* Make sure data manager has been started and is not shutting down */
+	if ((g_fd < 0) || g_task_should_exit) {
+		return -1;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		if (!direct_enter()) {
+			return -1;
+		}
+
+		dm_count(dm_read_range_func);
+		ssize_t result = _read_range(item, index, buf, count, len);
+		direct_leave();
+		return result;
+	}
+
+#endif
+
+	/* get a work item and queue up a range read request */
+	if ((work = create_work_item()) == NULL) {
+		return -1;
+	}
+
+	work->func = dm_read_range_func;
+	work->read_range_params.item = item;
+	work->read_range_params.index = index;
+	work->read_range_params.count = count;
+	work->read_range_params.buf = buf;
+	work->read_range_params.len = len;
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	return (ssize_t)enqueue_work_item_and_wait_for_result(work);
+}
+
 __EXPORT int
 dm_clear(dm_item_t item)
 {
@@ -604,6 +1221,21 @@ dm_clear(dm_item_t item)
 		return -1;
 	}
 
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		if (!direct_enter()) {
+			return -1;
+		}
+
+		dm_count(dm_clear_func);
+		int result = _clear(item);
+		direct_leave();
+		return result;
+	}
+
+#endif
+
 	/* get a work item and queue up a clear request */
 	if ((work = create_work_item()) == NULL) {
 		return -1;
@@ -661,6 +1293,21 @@ dm_restart(dm_reset_reason reason)
 		return -1;
 	}
 
+#ifdef DATAMAN_MMAP
+
+	if (g_map != NULL) {
+		if (!direct_enter()) {
+			return -1;
+		}
+
+		dm_count(dm_restart_func);
+		int result = _restart(reason);
+		direct_leave();
+		return result;
+	}
+
+#endif
+
 	/* get a work item and queue up a restart request */
 	if ((work = create_work_item()) == NULL) {
 		return -1;
@@ -707,14 +1354,25 @@ task_main(int argc, char *argv[])
 
 	px4_sem_init(&g_work_queued_sema, 1, 0);
 
-	/* See if the data manage file exists and is a multiple of the sector size */
+#ifdef DATAMAN_MMAP
+
+	for (unsigned i = 0; i < DM_KEY_NUM_KEYS; i++) {
+		px4_sem_init(&g_map_locks[i], 1, 1);
+	}
+
+	g_sync_pending = false;
+	g_sync_count = 0;
+	g_direct_callers = 0;
+#endif
+
+	/* See if the data manage file exists, is a multiple of the sector size and has the same layout */
 	g_task_fd = open(k_data_manager_device_path, O_RDONLY | O_BINARY);
 
 	if (g_task_fd >= 0) {
-		/* File exists, check its size */
+		/* File exists, check its size and layout */
 		int file_size = lseek(g_task_fd, 0, SEEK_END);
 
-		if ((file_size % k_sector_size) != 0) {
+		if ((file_size % k_sector_size) != 0 || !layout_check(g_task_fd, max_offset)) {
 			warnx("Incompatible data manager file %s, resetting it", k_data_manager_device_path);
 			warnx("Size: %u, sector size: %d", file_size, k_sector_size);
 			close(g_task_fd);
@@ -741,8 +1399,33 @@ task_main(int argc, char *argv[])
 		return -1;
 	}
 
+	/* a new file, or one that was reset */
+	if (!layout_check(g_task_fd, max_offset) && layout_write(g_task_fd, max_offset) != 0) {
+		warnx("Could not write the layout to data manager file %s", k_data_manager_device_path);
+	}
+
 	fsync(g_task_fd);
 
+#ifdef DATAMAN_MMAP
+
+	/* The file needs to cover all items before it can be mapped */
+	if (lseek(g_task_fd, 0, SEEK_END) < (off_t)max_offset && ftruncate(g_task_fd, max_offset) != 0) {
+		warnx("Could not resize data manager file, not mapping it");
+
+	} else {
+		void *map = mmap(NULL, max_offset, PROT_READ | PROT_WRITE, MAP_SHARED, g_task_fd, 0);
+
+		if (map == MAP_FAILED) {
+			warnx("Could not map data manager file, using file access");
+
+		} else {
+			g_map = (unsigned char *)map;
+			g_map_size = max_offset;
+		}
+	}
+
+#endif
+
 	printf("dataman: ");
 	/* see if we need to erase any items based on restart type */
 	int sys_restart_val;
@@ -769,7 +1452,11 @@ task_main(int argc, char *argv[])
 	/* worker thread is shutting down but still processing requests */
 	g_fd = g_task_fd;
 
-	printf(", data manager file '%s' size is %d bytes\n", k_data_manager_device_path, max_offset);
+	printf(", data manager file '%s' size is %d bytes%s\n", k_data_manager_device_path, max_offset,
+#ifdef DATAMAN_MMAP
+	       (g_map != NULL) ? ", mapped" :
+#endif
+	       "");
 
 	/* Tell startup that the worker thread has completed its initialization */
 	px4_sem_post(&g_init_sema);
@@ -794,28 +1481,43 @@ task_main(int argc, char *argv[])
 			/* handle each work item with the appropriate handler */
 			switch (work->func) {
 			case dm_write_func:
-				g_func_counts[dm_write_func]++;
+				dm_count(dm_write_func);
 				work->result =
 					_write(work->write_params.item, work->write_params.index, work->write_params.persistence, work->write_params.buf,
 					       work->write_params.count);
 				break;
 
 			case dm_read_func:
-				g_func_counts[dm_read_func]++;
+				dm_count(dm_read_func);
 				work->result =
 					_read(work->read_params.item, work->read_params.index, work->read_params.buf, work->read_params.count);
 				break;
 
 			case dm_clear_func:
-				g_func_counts[dm_clear_func]++;
+				dm_count(dm_clear_func);
 				work->result = _clear(work->clear_params.item);
 				break;
 
 			case dm_restart_func:
-				g_func_counts[dm_restart_func]++;
+				dm_count(dm_restart_func);
 				work->result = _restart(work->restart_params.reason);
 				break;
 
+			case dm_read_range_func:
+				dm_count(dm_read_range_func);
+				work->result =
+					_read_range(work->read_range_params.item, work->read_range_params.index, work->read_range_params.buf,
+						    work->read_range_params.count, work->read_range_params.len);
+				break;
+
+			case dm_write_range_func:
+				dm_count(dm_write_range_func);
+				work->result =
+					_write_range(work->write_range_params.item, work->write_range_params.index,
+						     work->write_range_params.persistence, work->write_range_params.buf,
+						     work->write_range_params.count, work->write_range_params.len);
+				break;
+
 			default: /* should never happen */
 				work->result = -1;
 				break;
@@ -825,12 +1527,39 @@ task_main(int argc, char *argv[])
 			px4_sem_post(&work->wait_sem);
 		}
 
+#ifdef DATAMAN_MMAP
+
+		/* Write back all changes to the mapping since the last sync at once */
+		if (g_sync_pending && g_map != NULL) {
+			g_sync_pending = false;
+			msync(g_map, g_map_size, MS_SYNC);
+			g_sync_count++;
+		}
+
+#endif
+
 		/* time to go???? */
 		if ((g_task_should_exit) && (g_fd < 0)) {
 			break;
 		}
 	}
 
+#ifdef DATAMAN_MMAP
+
+	/* Callers that got past the exit check before stop() still use the mapping and its locks, wait for them */
+	while (__atomic_load_n(&g_direct_callers, __ATOMIC_SEQ_CST) > 0) {
+		usleep(1000);
+	}
+
+	if (g_map != NULL) {
+		msync(g_map, g_map_size, MS_SYNC);
+		munmap(g_map, g_map_size);
+		g_map = NULL;
+		g_map_size = 0;
+	}
+
+#endif
+
 	close(g_task_fd);
 	g_task_fd = -1;
 
@@ -850,6 +1579,14 @@ task_main(int argc, char *argv[])
 	px4_sem_destroy(&g_work_queued_sema);
 	px4_sem_destroy(&g_sys_state_mutex);
 
+#ifdef DATAMAN_MMAP
+
+	for (unsigned i = 0; i < DM_KEY_NUM_KEYS; i++) {
+		px4_sem_destroy(&g_map_locks[i]);
+	}
+
+#endif
+
 	return 0;
 }
 
@@ -881,14 +1618,18 @@ status(void)
 	warnx("Reads    %d", g_func_counts[dm_read_func]);
 	warnx("Clears   %d", g_func_counts[dm_clear_func]);
 	warnx("Restarts %d", g_func_counts[dm_restart_func]);
+	warnx("Range reads %d, writes %d", g_func_counts[dm_read_range_func], g_func_counts[dm_write_range_func]);
 	warnx("Max Q lengths work %d, free %d", g_work_q.max_size, g_free_q.max_size);
+#ifdef DATAMAN_MMAP
+	warnx("Mapped   %s, syncs %d", (g_map != NULL) ? "yes" : "no", g_sync_count);
+#endif
 }
 
 static void
 stop(void)
 {
-	/* Tell the worker task to shut down */
-	g_task_should_exit = true;
+	/* Tell the worker task to shut down, callers check the flag before accessing the mapping */
+	__atomic_store_n(&g_task_should_exit, true, __ATOMIC_SEQ_CST);
 	px4_sem_post(&g_work_queued_sema);
 }
 
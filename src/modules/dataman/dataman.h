@@ -62,7 +62,7 @@ typedef enum {
 
 /** The maximum number of instances for each item type */
 enum {
-	DM_KEY_SAFE_POINTS_MAX = 8,
+	DM_KEY_SAFE_POINTS_MAX = 64,
 #ifdef __cplusplus
 	DM_KEY_FENCE_POINTS_MAX = fence_s::GEOFENCE_MAX_VERTICES,
 #else
@@ -110,6 +110,28 @@ dm_write(
 	size_t buflen			/* Length in bytes of data to retrieve */
 );
 
+/** Retrieve consecutive items with a single request, returns the number of items read.
+ *  Reading stops at the first item that is empty or was stored with a different length. */
+__EXPORT ssize_t
+dm_read_range(
+	dm_item_t item,			/* The item type to retrieve */
+	unsigned char index,		/* The index of the first item */
+	void *buffer,			/* Pointer to caller data buffer of count * buflen bytes */
+	unsigned count,			/* Number of items to retrieve */
+	size_t buflen			/* Length in bytes of each item */
+);
+
+/** Write consecutive items with a single request, returns the number of items written */
+__EXPORT ssize_t
+dm_write_range(
+	dm_item_t  item,		/* The item type to store */
+	unsigned char index,		/* The index of the first item */
+	dm_persitence_t persistence,	/* The persistence level of the items */
+	const void *buffer,		/* Pointer to caller data buffer of count * buflen bytes */
+	unsigned count,			/* Number of items to store */
+	size_t buflen			/* Length in bytes of each item */
+);
+
 /** Lock all items of this type */
 __EXPORT void
 dm_lock(
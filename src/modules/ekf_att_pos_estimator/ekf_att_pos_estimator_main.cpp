@@ -818,6 +818,7 @@ void AttitudePositionEstimatorEKF::publishAttitude()
 	_att.R_valid = true;
 
 	_att.timestamp = _last_sensor_timestamp;
+	_att.timestamp_sample = _last_sensor_timestamp;
 	_att.roll = euler(0);
 	_att.pitch = euler(1);
 	_att.yaw = euler(2);
@@ -1108,7 +1109,7 @@ void AttitudePositionEstimatorEKF::updateSensorFusion(const bool fuseGPS, const
 
 	// Fuse Rangefinder Measurements
 	if (fuseRangeSensor) {
-		if (_ekf->Tnb.z.z > 0.9f) {
+		if (_ekf->Tnb(2, 2) > 0.9f) {
 			// _ekf->rngMea is set in sensor readout already
 			_ekf->fuseRngData = true;
 			_ekf->fuseOptFlowData = false;
@@ -1624,7 +1625,7 @@ int AttitudePositionEstimatorEKF::trip_nan()
 		usleep(100000);
 
 		PX4_INFO("tripping stored states[0] with NaN");
-		_ekf->storedStates[0][0] = nan_val;
+		_ekf->storedStates.get(0).states[0] = nan_val;
 		usleep(100000);
 
 		PX4_INFO("tripping states[9] with NaN");
@@ -40,10 +40,13 @@
 #pragma once
 
 #include "estimator_utilities.h"
+#include "estimator_state_buffer.h"
 #include <cstddef>
 
 constexpr size_t EKF_STATE_ESTIMATES = 22;
 constexpr size_t EKF_DATA_BUFFER_SIZE = 50;
+constexpr size_t EKF_COVARIANCE_PACKED_SIZE = EKF_STATE_ESTIMATES * (EKF_STATE_ESTIMATES + 1) / 2;
+constexpr size_t EKF_COV_DYNAMIC_STATES = 10; // states whose rows of the transition matrix are not identity
 
 class AttPosEKF {
 
@@ -120,8 +123,7 @@ public:
     float Kfusion[EKF_STATE_ESTIMATES]; // Kalman gains
     float states[EKF_STATE_ESTIMATES]; // state matrix
     float resetStates[EKF_STATE_ESTIMATES];
-    float storedStates[EKF_STATE_ESTIMATES][EKF_DATA_BUFFER_SIZE]; // state vectors stored for the last 50 time steps
-    uint32_t statetimeStamp[EKF_DATA_BUFFER_SIZE]; // time stamp for each state vector stored
+    EstimatorStateBuffer<EKF_STATE_ESTIMATES, EKF_DATA_BUFFER_SIZE> storedStates; // state vectors and angular rates stored for the last 50 time steps
 
     // Times
     uint64_t lastVelPosFusion;  // the time of the last velocity fusion, in the standard time unit of the filter
@@ -229,11 +231,6 @@ public:
 
     bool numericalProtection;
 
-    unsigned storeIndex;
-
-    // Optical Flow error estimation
-    float storedOmega[3][EKF_DATA_BUFFER_SIZE]; // angular rate vector stored for the last 50 time steps used by optical flow eror estimators
-
     // Two state EKF used to estimate focal length scale factor and terrain position
     float Popt[2][2];                       // state covariance matrix
     float flowStates[2];                    // flow states [scale factor, terrain position]
@@ -288,14 +285,15 @@ public:
     /**
      * Recall the state vector.
      *
-     * Recalls the vector stored at closest time to the one specified by msec
+     * Recalls the vector stored at closest time to the one specified by msec,
+     * or if interpolate is set, interpolates between the two vectors enclosing it.
      * @return zero on success, integer indicating the number of invalid states on failure.
      *         Does only copy valid states, if the statesForFusion vector was initialized
      *         correctly by the caller, the result can be safely used, but is a mixture
      *         time-wise where valid states were updated and invalid remained at the old
      *         value.
      */
-    int RecallStates(float *statesForFusion, uint64_t msec);
+    int RecallStates(float *statesForFusion, uint64_t msec, bool interpolate = false);
 
     void RecallOmega(float *omegaForFusion, uint64_t msec);
 
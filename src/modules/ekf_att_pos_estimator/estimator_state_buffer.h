@@ -0,0 +1,212 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file estimator_state_buffer.h
+ *
+ * Ring buffer of past filter states used to fuse delayed measurements.
+ *
+ * Samples are stored sample-major so that recalling one state vector
+ * touches a single contiguous block. Since samples are pushed in time
+ * order, the sample closest to a requested time is found by estimating
+ * its age from the mean sample interval and walking to the nearest
+ * neighbour, which is constant time for a regularly sampled IMU.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "estimator_utilities.h"
+
+template <size_t N_STATES, size_t N_SAMPLES>
+class EstimatorStateBuffer
+{
+public:
+    struct Sample {
+        float states[N_STATES];
+        float omega[3];         ///< body angular rate at the time of the sample (rad/s)
+        uint32_t time_ms;
+    };
+
+    EstimatorStateBuffer() :
+        _samples{},
+        _head(0),
+        _count(0)
+    {}
+
+    /**
+     * Discard all stored samples.
+     */
+    void reset()
+    {
+        memset(_samples, 0, sizeof(_samples));
+        _head = 0;
+        _count = 0;
+    }
+
+    /**
+     * Store a new sample, overwriting the oldest one if the buffer is full.
+     *
+     * @param time_ms time stamp, must not be older than the previous sample
+     */
+    void push(uint32_t time_ms, const float (&states)[N_STATES], const Vector3f &omega)
+    {
+        _head = (_head + 1) % N_SAMPLES;
+        Sample &s = _samples[_head];
+
+        memcpy(s.states, states, sizeof(s.states));
+        s.omega[0] = omega.x;
+        s.omega[1] = omega.y;
+        s.omega[2] = omega.z;
+        s.time_ms = time_ms;
+
+        if (_count < N_SAMPLES) {
+            _count++;
+        }
+    }
+
+    /**
+     * @return number of stored samples
+     */
+    unsigned size() const { return _count; }
+
+    /**
+     * Access a stored sample by age, 0 is the newest sample.
+     */
+    Sample &get(unsigned age) { return _samples[index(age)]; }
+    const Sample &get(unsigned age) const { return _samples[index(age)]; }
+
+    /**
+     * Find the sample closest in time.
+     *
+     * @return age of the closest sample, -1 if the buffer is empty
+     */
+    int find(uint64_t time_ms) const
+    {
+        if (_count == 0) {
+            return -1;
+        }
+
+        const uint32_t newest = get(0).time_ms;
+        const uint32_t span = newest - get(_count - 1).time_ms;
+        unsigned age = 0;
+
+        if (time_ms < newest && span > 0) {
+            // initial guess from the mean sample interval
+            uint64_t delay = newest - time_ms;
+            uint64_t guess = (delay * (_count - 1) + span / 2) / span;
+            age = (guess < _count) ? (unsigned)guess : _count - 1;
+        }
+
+        // The distance to the requested time is unimodal in the age, so
+        // walking downhill from the guess ends at the closest sample.
+        while (age > 0 && distance(age - 1, time_ms) <= distance(age, time_ms)) {
+            age--;
+        }
+
+        while (age + 1 < _count && distance(age + 1, time_ms) < distance(age, time_ms)) {
+            age++;
+        }
+
+        return age;
+    }
+
+    /**
+     * @return absolute time difference between a sample and the given time
+     */
+    uint64_t distance(unsigned age, uint64_t time_ms) const
+    {
+        uint64_t t = get(age).time_ms;
+        return (t > time_ms) ? (t - time_ms) : (time_ms - t);
+    }
+
+    /**
+     * Linearly interpolate the states between the two samples enclosing a time.
+     *
+     * @param age age of the closest sample as returned by find()
+     * @return false if the time is not enclosed by two distinct samples, out is not written then
+     */
+    bool interpolate(uint64_t time_ms, unsigned age, float (&out)[N_STATES]) const
+    {
+        const Sample &closest = get(age);
+        unsigned other;
+
+        if (closest.time_ms > time_ms && age + 1 < _count) {
+            other = age + 1;
+
+        } else if (closest.time_ms < time_ms && age > 0) {
+            other = age - 1;
+
+        } else {
+            return false;
+        }
+
+        const Sample &older = get((other > age) ? other : age);
+        const Sample &newer = get((other > age) ? age : other);
+
+        if (newer.time_ms <= older.time_ms) {
+            return false;
+        }
+
+        const float frac = (float)(time_ms - older.time_ms) / (float)(newer.time_ms - older.time_ms);
+
+        for (size_t i = 0; i < N_STATES; i++) {
+            out[i] = older.states[i] + frac * (newer.states[i] - older.states[i]);
+        }
+
+        return true;
+    }
+
+    /**
+     * Overwrite one state in all stored samples.
+     */
+    void setState(unsigned state, float value)
+    {
+        for (size_t i = 0; i < N_SAMPLES; i++) {
+            _samples[i].states[state] = value;
+        }
+    }
+
+private:
+    Sample _samples[N_SAMPLES];
+    unsigned _head;         ///< index of the newest sample
+    unsigned _count;
+
+    unsigned index(unsigned age) const
+    {
+        return (_head + N_SAMPLES - age) % N_SAMPLES;
+    }
+};
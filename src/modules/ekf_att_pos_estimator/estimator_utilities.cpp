@@ -86,36 +86,6 @@ void Vector3f::zero(void)
     z = 0.0f;
 }
 
-Mat3f::Mat3f() :
-    x{1.0f, 0.0f, 0.0f},
-    y{0.0f, 1.0f, 0.0f},
-    z{0.0f, 0.0f, 1.0f}
-{
-}
-
-void Mat3f::identity() {
-    x.x = 1.0f;
-    x.y = 0.0f;
-    x.z = 0.0f;
-
-    y.x = 0.0f;
-    y.y = 1.0f;
-    y.z = 0.0f;
-
-    z.x = 0.0f;
-    z.y = 0.0f;
-    z.z = 1.0f;
-}
-
-Mat3f Mat3f::transpose() const
-{
-    Mat3f ret = *this;
-    swap_var(ret.x.y, ret.y.x);
-    swap_var(ret.x.z, ret.z.x);
-    swap_var(ret.y.z, ret.z.y);
-    return ret;
-}
-
 void calcvelNED(float (&velNEDr)[3], float gpsCourse, float gpsGndSpd, float gpsVelD)
 {
     velNEDr[0] = gpsGndSpd*cosf(gpsCourse);
@@ -161,30 +131,12 @@ Vector3f operator-(const Vector3f &vecIn1, const Vector3f &vecIn2)
 Vector3f operator*(const Mat3f &matIn, const Vector3f &vecIn)
 {
     Vector3f vecOut;
-    vecOut.x = matIn.x.x*vecIn.x + matIn.x.y*vecIn.y + matIn.x.z*vecIn.z;
-    vecOut.y = matIn.y.x*vecIn.x + matIn.y.y*vecIn.y + matIn.y.z*vecIn.z;
-    vecOut.z = matIn.z.x*vecIn.x + matIn.z.y*vecIn.y + matIn.z.z*vecIn.z;
+    vecOut.x = matIn(0, 0)*vecIn.x + matIn(0, 1)*vecIn.y + matIn(0, 2)*vecIn.z;
+    vecOut.y = matIn(1, 0)*vecIn.x + matIn(1, 1)*vecIn.y + matIn(1, 2)*vecIn.z;
+    vecOut.z = matIn(2, 0)*vecIn.x + matIn(2, 1)*vecIn.y + matIn(2, 2)*vecIn.z;
     return vecOut;
 }
 
-// overload * operator to provide a matrix product
-Mat3f operator*(const Mat3f &matIn1, const Mat3f &matIn2)
-{
-    Mat3f matOut;
-    matOut.x.x = matIn1.x.x*matIn2.x.x + matIn1.x.y*matIn2.y.x + matIn1.x.z*matIn2.z.x;
-    matOut.x.y = matIn1.x.x*matIn2.x.y + matIn1.x.y*matIn2.y.y + matIn1.x.z*matIn2.z.y;
-    matOut.x.z = matIn1.x.x*matIn2.x.z + matIn1.x.y*matIn2.y.z + matIn1.x.z*matIn2.z.z;
-
-    matOut.y.x = matIn1.y.x*matIn2.x.x + matIn1.y.y*matIn2.y.x + matIn1.y.z*matIn2.z.x;
-    matOut.y.y = matIn1.y.x*matIn2.x.y + matIn1.y.y*matIn2.y.y + matIn1.y.z*matIn2.z.y;
-    matOut.y.z = matIn1.y.x*matIn2.x.z + matIn1.y.y*matIn2.y.z + matIn1.y.z*matIn2.z.z;
-
-    matOut.z.x = matIn1.z.x*matIn2.x.x + matIn1.z.y*matIn2.y.x + matIn1.z.z*matIn2.z.x;
-    matOut.z.y = matIn1.z.x*matIn2.x.y + matIn1.z.y*matIn2.y.y + matIn1.z.z*matIn2.z.y;
-    matOut.z.z = matIn1.z.x*matIn2.x.z + matIn1.z.y*matIn2.y.z + matIn1.z.z*matIn2.z.z;
-
-    return matOut;
-}
 
 // overload % operator to provide a vector cross product
 Vector3f operator%(const Vector3f &vecIn1, const Vector3f &vecIn2)
@@ -41,6 +41,7 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <matrix/Matrix.hpp>
 
 #define GRAVITY_MSS 9.80665f
 #define deg2rad 0.017453292f
@@ -66,25 +67,12 @@ public:
     void zero();
 };
 
-class Mat3f
-{
-private:
-public:
-    Vector3f x;
-    Vector3f y;
-    Vector3f z;
-
-    Mat3f();
-
-    void identity();
-    Mat3f transpose() const;
-};
+typedef matrix::Matrix<float, 3, 3> Mat3f;
 
 Vector3f operator*(const float sclIn1, const Vector3f &vecIn1);
 Vector3f operator+(const Vector3f &vecIn1, const Vector3f &vecIn2);
 Vector3f operator-(const Vector3f &vecIn1, const Vector3f &vecIn2);
 Vector3f operator*(const Mat3f &matIn, const Vector3f &vecIn);
-Mat3f operator*(const Mat3f &matIn1, const Mat3f &matIn2);
 Vector3f operator%(const Vector3f &vecIn1, const Vector3f &vecIn2);
 Vector3f operator*(const Vector3f &vecIn1, const float sclIn1);
 Vector3f operator/(const Vector3f &vec, const float scalar);
@@ -41,6 +41,7 @@
 #include <px4_config.h>
 #include <px4_defines.h>
 #include <px4_tasks.h>
+#include <px4_vehicle.h>
 #include <px4_posix.h>
 #include <unistd.h>					//usleep
 #include <stdio.h>
@@ -66,7 +67,7 @@ static void land_detector_stop();
 extern "C" __EXPORT int land_detector_main(int argc, char *argv[]);
 
 //Private variables
-static LandDetector *land_detector_task = nullptr;
+static px4::VehicleInstance<LandDetector> land_detector_task;
 static char _currentMode[12];
 
 /**
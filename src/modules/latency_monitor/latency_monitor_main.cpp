@@ -0,0 +1,421 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/*
+ * @file latency_monitor_main.cpp
+ *
+ * Latency of the control pipeline from the sensor sample to the
+ * publication of sensor_combined, vehicle_attitude, actuator_controls_0
+ * and actuator_outputs. Each topic carries the timestamp of the gyro
+ * sample it is based on, the publication time comes from orb_stat.
+ */
+
+#include <px4_config.h>
+#include <px4_posix.h>
+#include <px4_vehicle.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <uORB/uORB.h>
+#include <uORB/topics/sensor_combined.h>
+#include <uORB/topics/vehicle_attitude.h>
+#include <uORB/topics/actuator_controls.h>
+#include <uORB/topics/actuator_outputs.h>
+#include <uORB/topics/pipeline_latency.h>
+#include <drivers/drv_hrt.h>
+
+#include <systemlib/perf_counter.h>
+#include <systemlib/err.h>
+
+extern "C" __EXPORT int latency_monitor_main(int argc, char *argv[]);
+
+class LatencyMonitor;
+
+namespace latency_monitor
+{
+px4::VehicleInstance<LatencyMonitor> instance;
+}
+
+
+class LatencyMonitor
+{
+public:
+	/**
+	 * Constructor
+	 */
+	LatencyMonitor();
+
+	/**
+	 * Destructor, also kills task.
+	 */
+	~LatencyMonitor();
+
+	/**
+	 * Start task.
+	 *
+	 * @return		OK on success.
+	 */
+	int		start();
+
+	static void	task_main_trampoline(int argc, char *argv[]);
+
+	void		task_main();
+
+	void		print();
+
+private:
+	static constexpr unsigned _num_stages = pipeline_latency_s::PIPELINE_NUM_STAGES;
+	static constexpr unsigned _max_samples = 256;		/**< samples kept per stage and interval */
+	static constexpr hrt_abstime _interval = 1000000;	/**< publication interval of pipeline_latency */
+
+	struct Stage {
+		perf_counter_t	perf;
+		uint32_t	samples[_max_samples];
+		uint32_t	count;
+		uint64_t	sum;
+		uint32_t	max;
+	};
+
+	bool		_task_should_exit = false;		/**< if true, task should exit */
+	int		_control_task = -1;			/**< task handle for task */
+
+	int		_subs[_num_stages] = {-1, -1, -1, -1};
+
+	orb_advert_t	_latency_pub = nullptr;
+	struct pipeline_latency_s _latency = {};
+
+	Stage		_stages[_num_stages] = {};
+
+	/**
+	 * Copy a topic if it was updated and return the time it was published.
+	 *
+	 * @return		publication time, 0 if there is no new sample or
+	 *			it was published again while being copied.
+	 */
+	hrt_abstime	copy_updated(const struct orb_metadata *meta, int sub, void *buffer);
+
+	void		add_sample(unsigned stage, hrt_abstime published, hrt_abstime sampled);
+
+	void		publish();
+};
+
+
+LatencyMonitor::LatencyMonitor()
+{
+	static const char *const names[_num_stages] = {
+		"latency_sensors",
+		"latency_attitude",
+		"latency_controls",
+		"latency_outputs"
+	};
+
+	for (unsigned i = 0; i < _num_stages; i++) {
+		_stages[i].perf = perf_alloc(PC_HISTOGRAM, names[i]);
+	}
+}
+
+/**
+ * Destructor, also kills task.
+ */
+LatencyMonitor::~LatencyMonitor()
+{
+	if (_control_task != -1) {
+		/* task wakes up every 100ms or so at the longest */
+		_task_should_exit = true;
+
+		/* wait for a second for the task to quit at our request */
+		unsigned i = 0;
+
+		do {
+			/* wait 20ms */
+			usleep(20000);
+
+			/* if we have given up, kill it */
+			if (++i > 50) {
+				px4_task_delete(_control_task);
+				break;
+			}
+		} while (_control_task != -1);
+	}
+
+	for (unsigned i = 0; i < _num_stages; i++) {
+		perf_free(_stages[i].perf);
+	}
+
+	latency_monitor::instance = nullptr;
+}
+
+int LatencyMonitor::start()
+{
+	ASSERT(_control_task == -1);
+
+	/* start the task */
+	_control_task = px4_task_spawn_cmd("latency_monitor",
+					   SCHED_DEFAULT,
+					   SCHED_PRIORITY_DEFAULT,
+					   1600,
+					   (px4_main_t)&LatencyMonitor::task_main_trampoline,
+					   nullptr);
+
+	if (_control_task < 0) {
+		warn("task start failed");
+		return -errno;
+	}
+
+	return OK;
+}
+
+void LatencyMonitor::print()
+{
+	static const char *const names[_num_stages] = { "sensors", "attitude", "controls", "outputs" };
+
+	warnx("last interval (us):");
+
+	for (unsigned i = 0; i < _num_stages; i++) {
+		warnx("%-8s n %4u avg %6u p50 %6u p99 %6u max %6u", names[i], (unsigned)_latency.count[i],
+		      (unsigned)_latency.avg[i], (unsigned)_latency.p50[i], (unsigned)_latency.p99[i], (unsigned)_latency.max[i]);
+	}
+
+	for (unsigned i = 0; i < _num_stages; i++) {
+		perf_print_counter(_stages[i].perf);
+	}
+}
+
+void LatencyMonitor::task_main_trampoline(int argc, char *argv[])
+{
+	latency_monitor::instance->task_main();
+}
+
+hrt_abstime LatencyMonitor::copy_updated(const struct orb_metadata *meta, int sub, void *buffer)
+{
+	bool updated = false;
+	orb_check(sub, &updated);
+
+	if (!updated) {
+		return 0;
+	}
+
+	uint64_t before = 0;
+	uint64_t after = 0;
+	orb_stat(sub, &before);
+	orb_copy(meta, sub, buffer);
+	orb_stat(sub, &after);
+
+	/* published again in between, the copy may not belong to the time */
+	return (before == after) ? before : 0;
+}
+
+void LatencyMonitor::add_sample(unsigned stage, hrt_abstime published, hrt_abstime sampled)
+{
+	/* producers that don't know the sample time leave it at zero */
+	if (published == 0 || sampled == 0 || sampled > published) {
+		return;
+	}
+
+	Stage &s = _stages[stage];
+	uint32_t latency = published - sampled;
+
+	perf_set(s.perf, latency);
+
+	/* keep the most recent samples for the percentiles */
+	s.samples[s.count % _max_samples] = latency;
+	s.count++;
+	s.sum += latency;
+
+	if (latency > s.max) {
+		s.max = latency;
+	}
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+void LatencyMonitor::publish()
+{
+	_latency.timestamp = hrt_absolute_time();
+
+	for (unsigned i = 0; i < _num_stages; i++) {
+		Stage &s = _stages[i];
+		unsigned n = s.count;
+
+		if (n > _max_samples) {
+			n = _max_samples;
+		}
+
+		_latency.count[i] = s.count;
+		_latency.avg[i] = (s.count > 0) ? s.sum / s.count : 0;
+		_latency.max[i] = s.max;
+
+		if (n > 0) {
+			qsort(s.samples, n, sizeof(s.samples[0]), compare_latency);
+			_latency.p50[i] = s.samples[n / 2];
+			_latency.p99[i] = s.samples[(n * 99) / 100];
+
+		} else {
+			_latency.p50[i] = 0;
+			_latency.p99[i] = 0;
+		}
+
+		s.count = 0;
+		s.sum = 0;
+		s.max = 0;
+	}
+
+	if (_latency_pub == nullptr) {
+		_latency_pub = orb_advertise(ORB_ID(pipeline_latency), &_latency);
+
+	} else {
+		orb_publish(ORB_ID(pipeline_latency), _latency_pub, &_latency);
+	}
+}
+
+void LatencyMonitor::task_main()
+{
+	_subs[pipeline_latency_s::PIPELINE_STAGE_SENSORS] = orb_subscribe(ORB_ID(sensor_combined));
+	_subs[pipeline_latency_s::PIPELINE_STAGE_ATTITUDE] = orb_subscribe(ORB_ID(vehicle_attitude));
+	_subs[pipeline_latency_s::PIPELINE_STAGE_CONTROLS] = orb_subscribe(ORB_ID(actuator_controls_0));
+	_subs[pipeline_latency_s::PIPELINE_STAGE_OUTPUTS] = orb_subscribe(ORB_ID(actuator_outputs));
+
+	struct sensor_combined_s sensors = {};
+	struct vehicle_attitude_s att = {};
+	struct actuator_controls_s controls = {};
+	struct actuator_outputs_s outputs = {};
+
+	hrt_abstime last_publish = hrt_absolute_time();
+
+	/* sensor_combined is the fastest topic, the others are checked each time it arrives */
+	px4_pollfd_struct_t fds[1];
+	fds[0].fd = _subs[pipeline_latency_s::PIPELINE_STAGE_SENSORS];
+	fds[0].events = POLLIN;
+
+	while (!_task_should_exit) {
+		int ret = px4_poll(fds, 1, 100);
+
+		if (ret < 0) {
+			// Poll error, sleep and try again
+			usleep(10000);
+			continue;
+		}
+
+		hrt_abstime published = copy_updated(ORB_ID(sensor_combined), _subs[pipeline_latency_s::PIPELINE_STAGE_SENSORS],
+						     &sensors);
+		add_sample(pipeline_latency_s::PIPELINE_STAGE_SENSORS, published, sensors.timestamp);
+
+		published = copy_updated(ORB_ID(vehicle_attitude), _subs[pipeline_latency_s::PIPELINE_STAGE_ATTITUDE], &att);
+		add_sample(pipeline_latency_s::PIPELINE_STAGE_ATTITUDE, published, att.timestamp_sample);
+
+		published = copy_updated(ORB_ID(actuator_controls_0), _subs[pipeline_latency_s::PIPELINE_STAGE_CONTROLS], &controls);
+		add_sample(pipeline_latency_s::PIPELINE_STAGE_CONTROLS, published, controls.timestamp_sample);
+
+		published = copy_updated(ORB_ID(actuator_outputs), _subs[pipeline_latency_s::PIPELINE_STAGE_OUTPUTS], &outputs);
+		add_sample(pipeline_latency_s::PIPELINE_STAGE_OUTPUTS, published, outputs.timestamp_sample);
+
+		if (hrt_elapsed_time(&last_publish) >= _interval) {
+			publish();
+			last_publish = hrt_absolute_time();
+		}
+	}
+
+	for (unsigned i = 0; i < _num_stages; i++) {
+		orb_unsubscribe(_subs[i]);
+	}
+
+	_control_task = -1;
+}
+
+
+int latency_monitor_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		warnx("usage: latency_monitor {start|stop|status}");
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+
+		if (latency_monitor::instance != nullptr) {
+			warnx("already running");
+			return 1;
+		}
+
+		latency_monitor::instance = new LatencyMonitor;
+
+		if (latency_monitor::instance == nullptr) {
+			warnx("alloc failed");
+			return 1;
+		}
+
+		if (OK != latency_monitor::instance->start()) {
+			delete latency_monitor::instance;
+			latency_monitor::instance = nullptr;
+			warnx("start failed");
+			return 1;
+		}
+
+		return 0;
+	}
+
+	if (!strcmp(argv[1], "stop")) {
+		if (latency_monitor::instance == nullptr) {
+			warnx("not running");
+			return 1;
+		}
+
+		delete latency_monitor::instance;
+		latency_monitor::instance = nullptr;
+		return 0;
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		if (latency_monitor::instance) {
+			latency_monitor::instance->print();
+			warnx("running");
+			return 0;
+
+		} else {
+			warnx("not running");
+			return 1;
+		}
+	}
+
+	warnx("unrecognized command");
+	return 1;
+}
@@ -911,12 +911,12 @@ void BlockLocalPositionEstimator::correctFlow()
 	// residual
 	Vector2f r = y - C * _x;
 
-	// residual covariance, (inverse)
-	Matrix<float, n_y_flow, n_y_flow> S_I =
-		(C * _P * C.transpose() + R).inverse();
+	// residual covariance, factored in place
+	Matrix<float, n_y_flow, n_y_flow> S = C * _P * C.transpose() + R;
+	bool S_ok = ldlt(S);
 
 	// fault detection
-	float beta = sqrtf((r.transpose() * (S_I * r))(0, 0));
+	float beta = innovationTest(S, S_ok, r);
 
 	if (_sub_flow.get().quality < MIN_FLOW_QUALITY) {
 		if (!_flowFault) {
@@ -940,8 +940,7 @@ void BlockLocalPositionEstimator::correctFlow()
 
 	// kalman filter correction if no fault
 	if (_flowFault == FAULT_NONE) {
-		Matrix<float, n_x, n_y_flow> K =
-			_P * C.transpose() * S_I;
+		Matrix<float, n_x, n_y_flow> K = kalmanGain(S, C);
 		_x += K * r;
 		_P -= K * C * _P;
 		// reset flow integral to current estimate of position
@@ -989,12 +988,12 @@ void BlockLocalPositionEstimator::correctSonar()
 	// residual
 	Matrix<float, n_y_sonar, 1> r = y - C * _x;
 
-	// residual covariance, (inverse)
-	Matrix<float, n_y_sonar, n_y_sonar> S_I =
-		(C * _P * C.transpose() + R).inverse();
+	// residual covariance, factored in place
+	Matrix<float, n_y_sonar, n_y_sonar> S = C * _P * C.transpose() + R;
+	bool S_ok = ldlt(S);
 
 	// fault detection
-	float beta = sqrtf((r.transpose()  * (S_I * r))(0, 0));
+	float beta = innovationTest(S, S_ok, r);
 
 	if (d < _sub_distance.get().min_distance ||
 	    d > _sub_distance.get().max_distance) {
@@ -1019,10 +1018,7 @@ void BlockLocalPositionEstimator::correctSonar()
 
 	// kalman filter correction if no fault
 	if (_sonarFault == FAULT_NONE) {
-		Matrix<float, n_x, n_y_sonar> K =
-			_P * C.transpose() * S_I;
-		_x += K * r;
-		_P -= K * C * _P;
+		correctScalar(X_z, C(Y_sonar_z, X_z), r(0), R(0, 0));
 	}
 
 	_time_last_sonar = _sub_distance.get().timestamp;
@@ -1045,12 +1041,12 @@ void BlockLocalPositionEstimator::correctBaro()
 	R(0, 0) = _baro_stddev.get() * _baro_stddev.get();
 
 	// residual
-	Matrix<float, n_y_baro, n_y_baro> S_I =
-		((C * _P * C.transpose()) + R).inverse();
+	Matrix<float, n_y_baro, n_y_baro> S = (C * _P * C.transpose()) + R;
+	bool S_ok = ldlt(S);
 	Matrix<float, n_y_baro, 1> r = y - (C * _x);
 
 	// fault detection
-	float beta = sqrtf((r.transpose() * (S_I * r))(0, 0));
+	float beta = innovationTest(S, S_ok, r);
 
 	if (beta > _beta_max.get()) {
 		if (!_baroFault) {
@@ -1059,9 +1055,6 @@ void BlockLocalPositionEstimator::correctBaro()
 			_baroFault = FAULT_MINOR;
 		}
 
-		// lower baro trust
-		S_I = ((C * _P * C.transpose()) + R * 10).inverse();
-
 	} else if (_baroFault) {
 		_baroFault = FAULT_NONE;
 		mavlink_log_info(_mavlink_fd, "[lpe] baro OK");
@@ -1070,9 +1063,7 @@ void BlockLocalPositionEstimator::correctBaro()
 
 	// kalman filter correction if no fault
 	if (_baroFault == FAULT_NONE) {
-		Matrix<float, n_x, n_y_baro> K = _P * C.transpose() * S_I;
-		_x += K * r;
-		_P -= K * C * _P;
+		correctScalar(X_z, C(Y_baro_z, X_z), r(0), R(0, 0));
 	}
 
 	_time_last_baro = _sub_sensor.get().baro_timestamp[0];
@@ -1111,11 +1102,12 @@ void BlockLocalPositionEstimator::correctLidar()
 	       cosf(_sub_att.get().pitch);
 
 	// residual
-	Matrix<float, n_y_lidar, n_y_lidar> S_I = ((C * _P * C.transpose()) + R).inverse();
+	Matrix<float, n_y_lidar, n_y_lidar> S = (C * _P * C.transpose()) + R;
+	bool S_ok = ldlt(S);
 	Matrix<float, n_y_lidar, 1> r = y - C * _x;
 
 	// fault detection
-	float beta = sqrtf((r.transpose() * (S_I * r))(0, 0));
+	float beta = innovationTest(S, S_ok, r);
 
 	// zero is an error code for the lidar
 	if (d < _sub_distance.get().min_distance ||
@@ -1141,9 +1133,7 @@ void BlockLocalPositionEstimator::correctLidar()
 
 	// kalman filter correction if no fault
 	if (_lidarFault == FAULT_NONE) {
-		Matrix<float, n_x, n_y_lidar> K = _P * C.transpose() * S_I;
-		_x += K * r;
-		_P -= K * C * _P;
+		correctScalar(X_z, C(Y_lidar_z, X_z), r(0), R(0, 0));
 	}
 
 	_time_last_lidar = _sub_distance.get().timestamp;
@@ -1214,10 +1204,17 @@ void BlockLocalPositionEstimator::correctGps()  	// TODO : use another other met
 
 	// residual
 	Matrix<float, 6, 1> r = y - C * _x;
-	Matrix<float, 6, 6> S_I = (C * _P * C.transpose() + R).inverse();
+	Matrix<float, 6, 6> S = C * _P * C.transpose() + R;
+	Matrix<float, 6, 1> S_diag;
+
+	for (size_t i = 0; i < 6; i++) {
+		S_diag(i) = S(i, i);
+	}
+
+	bool S_ok = ldlt(S);
 
 	// fault detection
-	float beta = sqrtf((r.transpose() * (S_I * r))(0, 0));
+	float beta = innovationTest(S, S_ok, r);
 	uint8_t nSat = _sub_gps.get().satellites_used;
 	float eph = _sub_gps.get().eph;
 
@@ -1235,18 +1232,15 @@ void BlockLocalPositionEstimator::correctGps()  	// TODO : use another other met
 			mavlink_log_info(_mavlink_fd, "[lpe] r: %5.2f %5.2f %5.2f %5.2f %5.2f %5.2f",
 					 double(r(0)),  double(r(1)), double(r(2)),
 					 double(r(3)), double(r(4)), double(r(5)));
-			mavlink_log_info(_mavlink_fd, "[lpe] S_I: %5.2f %5.2f %5.2f %5.2f %5.2f %5.2f",
-					 double(S_I(0, 0)),  double(S_I(1, 1)), double(S_I(2, 2)),
-					 double(S_I(3, 3)),  double(S_I(4, 4)), double(S_I(5, 5)));
+			mavlink_log_info(_mavlink_fd, "[lpe] S: %5.2f %5.2f %5.2f %5.2f %5.2f %5.2f",
+					 double(S_diag(0)),  double(S_diag(1)), double(S_diag(2)),
+					 double(S_diag(3)),  double(S_diag(4)), double(S_diag(5)));
 			mavlink_log_info(_mavlink_fd, "[lpe] r: %5.2f %5.2f %5.2f %5.2f %5.2f %5.2f",
 					 double(r(0)),  double(r(1)), double(r(2)),
 					 double(r(3)), double(r(4)), double(r(5)));
 			_gpsFault = FAULT_MINOR;
 		}
 
-		// trust GPS less
-		S_I = ((C * _P * C.transpose()) + R * 10).inverse();
-
 	} else if (_gpsFault) {
 		_gpsFault = FAULT_NONE;
 		mavlink_log_info(_mavlink_fd, "[lpe] GPS OK");
@@ -1255,7 +1249,7 @@ void BlockLocalPositionEstimator::correctGps()  	// TODO : use another other met
 
 	// kalman filter correction if no hard fault
 	if (_gpsFault == FAULT_NONE) {
-		Matrix<float, n_x, n_y_gps> K = _P * C.transpose() * S_I;
+		Matrix<float, n_x, n_y_gps> K = kalmanGain(S, C);
 		_x += K * r;
 		_P -= K * C * _P;
 	}
@@ -1287,11 +1281,12 @@ void BlockLocalPositionEstimator::correctVision()
 	R(Y_vision_z, Y_vision_z) = _vision_z_stddev.get() * _vision_z_stddev.get();
 
 	// residual
-	Matrix<float, n_y_vision, n_y_vision> S_I = ((C * _P * C.transpose()) + R).inverse();
+	Matrix<float, n_y_vision, n_y_vision> S = (C * _P * C.transpose()) + R;
+	bool S_ok = ldlt(S);
 	Matrix<float, n_y_vision, 1> r = y - C * _x;
 
 	// fault detection
-	float beta = sqrtf((r.transpose() * (S_I * r))(0, 0));
+	float beta = innovationTest(S, S_ok, r);
 
 	if (beta > _beta_max.get()) {
 		if (!_visionFault) {
@@ -1300,9 +1295,6 @@ void BlockLocalPositionEstimator::correctVision()
 			_visionFault = FAULT_MINOR;
 		}
 
-		// trust less
-		S_I = ((C * _P * C.transpose()) + R * 10).inverse();
-
 	} else if (_visionFault) {
 		_visionFault = FAULT_NONE;
 		mavlink_log_info(_mavlink_fd, "[lpe] vision position OK");
@@ -1311,7 +1303,7 @@ void BlockLocalPositionEstimator::correctVision()
 
 	// kalman filter correction if no fault
 	if (_visionFault == FAULT_NONE) {
-		Matrix<float, n_x, n_y_vision> K = _P * C.transpose() * S_I;
+		Matrix<float, n_x, n_y_vision> K = kalmanGain(S, C);
 		_x += K * r;
 		_P -= K * C * _P;
 	}
@@ -1345,11 +1337,12 @@ void BlockLocalPositionEstimator::correctmocap()
 	R(Y_mocap_z, Y_mocap_z) = mocap_p_var;
 
 	// residual
-	Matrix<float, n_y_mocap, n_y_mocap> S_I = ((C * _P * C.transpose()) + R).inverse();
+	Matrix<float, n_y_mocap, n_y_mocap> S = (C * _P * C.transpose()) + R;
+	bool S_ok = ldlt(S);
 	Matrix<float, n_y_mocap, 1> r = y - C * _x;
 
 	// fault detection
-	float beta = sqrtf((r.transpose() * (S_I * r))(0, 0));
+	float beta = innovationTest(S, S_ok, r);
 
 	if (beta > _beta_max.get()) {
 		if (!_mocapFault) {
@@ -1358,9 +1351,6 @@ void BlockLocalPositionEstimator::correctmocap()
 			_mocapFault = FAULT_MINOR;
 		}
 
-		// trust less
-		S_I = ((C * _P * C.transpose()) + R * 10).inverse();
-
 	} else if (_mocapFault) {
 		_mocapFault = FAULT_NONE;
 		mavlink_log_info(_mavlink_fd, "[lpe] mocap OK");
@@ -1369,10 +1359,28 @@ void BlockLocalPositionEstimator::correctmocap()
 
 	// kalman filter correction if no fault
 	if (_mocapFault == FAULT_NONE) {
-		Matrix<float, n_x, n_y_mocap> K = _P * C.transpose() * S_I;
+		Matrix<float, n_x, n_y_mocap> K = kalmanGain(S, C);
 		_x += K * r;
 		_P -= K * C * _P;
 	}
 
 	_time_last_mocap = _sub_mocap.get().timestamp_boot;
 }
+
+void BlockLocalPositionEstimator::correctScalar(uint8_t state, float h, float r, float variance)
+{
+	// the observation row has a single non-zero entry, so P * C'
+	// is a row of P and the covariance update is a rank-2 correction
+	ECL_ScalarFusion<n_x, 1> fusion;
+	fusion.add(state, h);
+	fusion.innovationVariance(_P.data(), variance);
+
+	float K[n_x];
+	fusion.gain(K);
+
+	for (uint8_t i = 0; i < n_x; i++) {
+		_x(i) += K[i] * r;
+	}
+
+	fusion.updateCovariance(_P.data(), K);
+}
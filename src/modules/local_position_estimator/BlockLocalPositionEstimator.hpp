@@ -4,14 +4,11 @@
 #include <mathlib/mathlib.h>
 #include <systemlib/perf_counter.h>
 #include <lib/geo/geo.h>
+#include <ecl/ekf/ecl_scalar_fusion.h>
 
-#ifdef USE_MATRIX_LIB
-#include "matrix/src/Matrix.hpp"
+#include <matrix/Matrix.hpp>
+#include <matrix/Cholesky.hpp>
 using namespace matrix;
-#else
-#include <Eigen/Eigen>
-using namespace Eigen;
-#endif
 
 // uORB Subscriptions
 #include <uORB/Subscription.hpp>
@@ -154,6 +151,34 @@ private:
 	void correctVision();
 	void correctmocap();
 
+	// sequential update with a scalar measurement of a single state
+	void correctScalar(uint8_t state, float h, float r, float variance);
+
+	// fault detection statistic sqrt(r' S^-1 r), S factored by ldlt(),
+	// infinite if S is not positive definite
+	template<size_t n_y>
+	float innovationTest(const Matrix<float, n_y, n_y> &S, bool S_ok,
+			     const Matrix<float, n_y, 1> &r)
+	{
+		if (!S_ok) {
+			return INFINITY;
+		}
+
+		Matrix<float, n_y, 1> S_I_r = r;
+		ldltSolve(S, S_I_r);
+		return sqrtf((r.transpose() * S_I_r)(0, 0));
+	}
+
+	// kalman gain P C' S^-1, computed as (S^-1 C P)' since P is symmetric
+	template<size_t n_y>
+	Matrix<float, n_x, n_y> kalmanGain(const Matrix<float, n_y, n_y> &S,
+					   const Matrix<float, n_y, n_x> &C)
+	{
+		Matrix<float, n_y, n_x> S_I_CP = C * _P;
+		ldltSolve(S, S_I_CP);
+		return S_I_CP.transpose();
+	}
+
 	// sensor initialization
 	void updateHome();
 	void initBaro();
@@ -41,6 +41,7 @@
 
 #include <px4_config.h>
 #include <px4_getopt.h>
+#include <px4_time.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -1776,7 +1777,7 @@ Mavlink::task_main(int argc, char *argv[])
 
 	while (!_task_should_exit) {
 		/* main loop */
-		usleep(_main_loop_delay);
+		px4_usleep(_main_loop_delay);
 
 		perf_begin(_loop_perf);
 
@@ -89,6 +89,11 @@ MavlinkMissionManager::MavlinkMissionManager(Mavlink *mavlink) : MavlinkStream(m
 	_mission_result_sub(-1),
 	_offboard_mission_pub(nullptr),
 	_slow_rate_limiter(_interval / 10.0f),
+	_item_block_first(0),
+	_item_block_count(0),
+	_read_block_first(0),
+	_read_block_count(0),
+	_read_block_dataman_id(0),
 	_verbose(false)
 {
 	_offboard_mission_sub = orb_subscribe(ORB_ID(offboard_mission));
@@ -158,6 +163,7 @@ MavlinkMissionManager::update_active_mission(int dataman_id, unsigned count, int
 		_count = count;
 		_current_seq = seq;
 		_my_dataman_id = _dataman_id;
+		_read_block_count = 0;
 
 		/* mission state saved successfully, publish offboard_mission topic */
 		if (_offboard_mission_pub == nullptr) {
@@ -236,14 +242,33 @@ void
 MavlinkMissionManager::send_mission_item(uint8_t sysid, uint8_t compid, uint16_t seq)
 {
 	dm_item_t dm_item = DM_KEY_WAYPOINTS_OFFBOARD(_dataman_id);
-	struct mission_item_s mission_item;
 
-	if (dm_read(dm_item, seq, &mission_item, sizeof(struct mission_item_s)) == sizeof(struct mission_item_s)) {
+	/* another instance may have switched the active mission */
+	if (_read_block_dataman_id != _dataman_id) {
+		_read_block_count = 0;
+	}
+
+	if (seq < _read_block_first || seq >= _read_block_first + _read_block_count) {
+		/* prefetch the items the partner is going to request next */
+		unsigned count = (seq < _count) ? _count - seq : 1;
+
+		if (count > ITEM_BLOCK_SIZE) {
+			count = ITEM_BLOCK_SIZE;
+		}
+
+		ssize_t ret = dm_read_range(dm_item, seq, _read_block, count, sizeof(struct mission_item_s));
+
+		_read_block_first = seq;
+		_read_block_count = (ret > 0) ? ret : 0;
+		_read_block_dataman_id = _dataman_id;
+	}
+
+	if (seq >= _read_block_first && seq < _read_block_first + _read_block_count) {
 		_time_last_sent = hrt_absolute_time();
 
 		/* create mission_item_s from mavlink_mission_item_t */
 		mavlink_mission_item_t wp;
-		format_mavlink_mission_item(&mission_item, &wp);
+		format_mavlink_mission_item(&_read_block[seq - _read_block_first], &wp);
 
 		wp.target_system = sysid;
 		wp.target_component = compid;
@@ -265,6 +290,23 @@ MavlinkMissionManager::send_mission_item(uint8_t sysid, uint8_t compid, uint16_t
 }
 
 
+int
+MavlinkMissionManager::write_item_block()
+{
+	dm_item_t dm_item = DM_KEY_WAYPOINTS_OFFBOARD(_transfer_dataman_id);
+	unsigned count = _item_block_count;
+
+	_item_block_count = 0;
+
+	if (dm_write_range(dm_item, _item_block_first, DM_PERSIST_POWER_ON_RESET, _item_block, count,
+			   sizeof(struct mission_item_s)) != (ssize_t)count) {
+		return ERROR;
+	}
+
+	return OK;
+}
+
+
 void
 MavlinkMissionManager::send_mission_request(uint8_t sysid, uint8_t compid, uint16_t seq)
 {
@@ -322,7 +364,8 @@ MavlinkMissionManager::send(const hrt_abstime now)
 		send_mission_current(_current_seq);
 
 		if (mission_result.item_do_jump_changed) {
-			/* send a mission item again if the remaining DO_JUMPs has changed */
+			/* send a mission item again if the remaining DO_JUMPs has changed, navigator rewrote it */
+			_read_block_count = 0;
 			send_mission_item(_transfer_partner_sysid, _transfer_partner_compid,
 					  (uint16_t)mission_result.item_changed_index);
 		}
@@ -478,6 +521,7 @@ MavlinkMissionManager::handle_mission_request_list(const mavlink_message_t *msg)
 			_state = MAVLINK_WPM_STATE_SENDLIST;
 			_transfer_seq = 0;
 			_transfer_count = _count;
+			_read_block_count = 0;
 			_transfer_partner_sysid = msg->sysid;
 			_transfer_partner_compid = msg->compid;
 
@@ -615,6 +659,7 @@ MavlinkMissionManager::handle_mission_count(const mavlink_message_t *msg)
 			_transfer_count = wpc.count;
 			_transfer_dataman_id = _dataman_id == 0 ? 1 : 0;	// use inactive storage for transmission
 			_transfer_current_seq = -1;
+			_item_block_count = 0;
 
 		} else if (_state == MAVLINK_WPM_STATE_GETLIST) {
 			_time_last_recv = hrt_absolute_time();
@@ -688,9 +733,14 @@ MavlinkMissionManager::handle_mission_item(const mavlink_message_t *msg)
 			return;
 		}
 
-		dm_item_t dm_item = DM_KEY_WAYPOINTS_OFFBOARD(_transfer_dataman_id);
+		/* items arrive in sequence, collect them and write a whole block at once */
+		if (_item_block_count == 0) {
+			_item_block_first = wp.seq;
+		}
+
+		_item_block[_item_block_count++] = mission_item;
 
-		if (dm_write(dm_item, wp.seq, DM_PERSIST_POWER_ON_RESET, &mission_item, sizeof(struct mission_item_s)) != sizeof(struct mission_item_s)) {
+		if ((_item_block_count == ITEM_BLOCK_SIZE || wp.seq + 1u == _transfer_count) && write_item_block() != OK) {
 			if (_verbose) { warnx("WPM: MISSION_ITEM ERROR: error writing seq %u to dataman ID %i", wp.seq, _transfer_dataman_id); }
 
 			send_mission_ack(_transfer_partner_sysid, _transfer_partner_compid, MAV_MISSION_ERROR);
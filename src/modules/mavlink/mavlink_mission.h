@@ -43,6 +43,7 @@
 #pragma once
 
 #include <uORB/uORB.h>
+#include <navigator/navigation.h>
 
 #include "mavlink_bridge_header.h"
 #include "mavlink_rate_limiter.h"
@@ -131,6 +132,17 @@ private:
 
 	MavlinkRateLimiter	_slow_rate_limiter;
 
+	static constexpr unsigned ITEM_BLOCK_SIZE = 8;			///< Mission items moved per dataman request
+
+	struct mission_item_s	_item_block[ITEM_BLOCK_SIZE];		///< Received items not yet written
+	unsigned		_item_block_first;			///< Sequence of the first item in the block
+	unsigned		_item_block_count;			///< Number of items in the block
+
+	struct mission_item_s	_read_block[ITEM_BLOCK_SIZE];		///< Items of the active mission read ahead to send
+	unsigned		_read_block_first;			///< Sequence of the first item in the read block
+	unsigned		_read_block_count;			///< Number of items in the read block, 0 if invalid
+	int			_read_block_dataman_id;			///< Dataman storage ID the read block was read from
+
 	bool _verbose;
 
 	static constexpr unsigned int	FILESYSTEM_ERRCOUNT_NOTIFY_LIMIT = 2;	///< Error count limit before stopping to report FS errors
@@ -163,6 +175,11 @@ private:
 
 	void send_mission_item(uint8_t sysid, uint8_t compid, uint16_t seq);
 
+	/**
+	 *  @brief Writes the received items of the current block to dataman with a single request
+	 */
+	int write_item_block();
+
 	void send_mission_request(uint8_t sysid, uint8_t compid, uint16_t seq);
 
 	/**
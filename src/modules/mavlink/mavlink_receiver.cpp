@@ -1596,6 +1596,7 @@ MavlinkReceiver::handle_message_hil_state_quaternion(mavlink_message_t *msg)
 		math::Vector<3> euler = C_nb.to_euler();
 
 		hil_attitude.timestamp = timestamp;
+		hil_attitude.timestamp_sample = timestamp;
 		memcpy(hil_attitude.R, C_nb.data, sizeof(hil_attitude.R));
 		hil_attitude.R_valid = true;
 
@@ -55,6 +55,7 @@
 #include <px4_config.h>
 #include <px4_defines.h>
 #include <px4_tasks.h>
+#include <px4_vehicle.h>
 #include <px4_posix.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -288,7 +289,7 @@ namespace mc_att_control
 #endif
 static const int ERROR = -1;
 
-MulticopterAttitudeControl	*g_control;
+px4::VehicleInstance<MulticopterAttitudeControl> g_control;
 }
 
 MulticopterAttitudeControl::MulticopterAttitudeControl() :
@@ -862,7 +863,7 @@ MulticopterAttitudeControl::task_main()
 				_actuators.control[2] = (PX4_ISFINITE(_att_control(2))) ? _att_control(2) : 0.0f;
 				_actuators.control[3] = (PX4_ISFINITE(_thrust_sp)) ? _thrust_sp : 0.0f;
 				_actuators.timestamp = hrt_absolute_time();
-				_actuators.timestamp_sample = _v_att.timestamp;
+				_actuators.timestamp_sample = _v_att.timestamp_sample;
 
 				_controller_status.roll_rate_integ = _rates_int(0);
 				_controller_status.pitch_rate_integ = _rates_int(1);
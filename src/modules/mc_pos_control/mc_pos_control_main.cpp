@@ -52,6 +52,7 @@
 #include <px4_config.h>
 #include <px4_defines.h>
 #include <px4_tasks.h>
+#include <px4_vehicle.h>
 #include <px4_posix.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -309,7 +310,7 @@ namespace pos_control
 #endif
 static const int ERROR = -1;
 
-MulticopterPositionControl	*g_control;
+px4::VehicleInstance<MulticopterPositionControl> g_control;
 }
 
 MulticopterPositionControl::MulticopterPositionControl() :
@@ -862,9 +863,9 @@ void MulticopterPositionControl::control_auto(float dt)
 
 		/* project setpoint to local frame */
 		math::Vector<3> curr_sp;
-		map_projection_project(&_ref_pos,
-				       _pos_sp_triplet.current.lat, _pos_sp_triplet.current.lon,
-				       &curr_sp.data[0], &curr_sp.data[1]);
+		map_projection_project_fast(&_ref_pos,
+					    _pos_sp_triplet.current.lat, _pos_sp_triplet.current.lon,
+					    &curr_sp.data[0], &curr_sp.data[1]);
 		curr_sp(2) = -(_pos_sp_triplet.current.alt - _ref_alt);
 
 		/* scaled space: 1 == position error resulting max allowed speed */
@@ -879,7 +880,7 @@ void MulticopterPositionControl::control_auto(float dt)
 		if (_pos_sp_triplet.current.type == position_setpoint_s::SETPOINT_TYPE_POSITION && _pos_sp_triplet.previous.valid) {
 			/* follow "previous - current" line */
 			math::Vector<3> prev_sp;
-			map_projection_project(&_ref_pos,
+			map_projection_project_fast(&_ref_pos,
 						   _pos_sp_triplet.previous.lat, _pos_sp_triplet.previous.lon,
 						   &prev_sp.data[0], &prev_sp.data[1]);
 			prev_sp(2) = -(_pos_sp_triplet.previous.alt - _ref_alt);
@@ -897,7 +898,7 @@ void MulticopterPositionControl::control_auto(float dt)
 					/* check next waypoint and use it to avoid slowing down when passing via waypoint */
 					if (_pos_sp_triplet.next.valid) {
 						math::Vector<3> next_sp;
-						map_projection_project(&_ref_pos,
+						map_projection_project_fast(&_ref_pos,
 									   _pos_sp_triplet.next.lat, _pos_sp_triplet.next.lon,
 									   &next_sp.data[0], &next_sp.data[1]);
 						next_sp(2) = -(_pos_sp_triplet.next.alt - _ref_alt);
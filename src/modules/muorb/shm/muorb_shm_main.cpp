@@ -0,0 +1,95 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file muorb_shm_main.cpp
+ * Shares uORB topics with other PX4 processes on the same host.
+ */
+
+#include <string.h>
+#include "modules/uORB/uORBManager.hpp"
+#include "uORBShmChannel.hpp"
+
+extern "C" { __EXPORT int muorb_shm_main(int argc, char *argv[]); }
+
+static const char *default_segment = "/px4_uorb";
+
+static void usage()
+{
+	warnx("Usage: muorb_shm 'start [-s <segment>]', 'stop', 'status'");
+}
+
+int
+muorb_shm_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return -EINVAL;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		const char *segment = default_segment;
+
+		if (argc == 4 && !strcmp(argv[2], "-s")) {
+			segment = argv[3];
+
+		} else if (argc != 2) {
+			usage();
+			return -EINVAL;
+		}
+
+		int ret = uORB::ShmChannel::GetInstance()->Start(segment);
+
+		if (ret != 0) {
+			warnx("could not attach to %s: %s", segment, strerror(-ret));
+			return ret;
+		}
+
+		// register the shared memory channel with UORB.
+		uORB::Manager::get_instance()->set_uorb_communicator(uORB::ShmChannel::GetInstance());
+		return OK;
+	}
+
+	if (!strcmp(argv[1], "stop")) {
+		uORB::Manager::get_instance()->set_uorb_communicator(nullptr);
+		uORB::ShmChannel::GetInstance()->Stop();
+		return OK;
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		uORB::ShmChannel::GetInstance()->Status();
+		return OK;
+	}
+
+	usage();
+	return -EINVAL;
+}
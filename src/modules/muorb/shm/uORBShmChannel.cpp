@@ -0,0 +1,274 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBShmChannel.hpp"
+#include "px4_log.h"
+#include "px4_tasks.h"
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+uORB::ShmChannel uORB::ShmChannel::_Instance;
+
+uORB::ShmChannel::ShmChannel() :
+	_RxHandler(nullptr),
+	_ThreadStarted(false),
+	_ThreadShouldExit(false),
+	_SubscriptionGeneration(0),
+	_SentCount(0),
+	_ReceivedCount(0)
+{
+	pthread_mutex_init(&_Mutex, nullptr);
+}
+
+int uORB::ShmChannel::topic_index(const char *messageName, unsigned size)
+{
+	int index = -1;
+	pthread_mutex_lock(&_Mutex);
+
+	if (_Segment.attached()) {
+		std::map<std::string, int>::iterator it = _TopicIndex.find(messageName);
+
+		if (it != _TopicIndex.end() && (size == 0 || _Segment.topic_size(it->second) == size)) {
+			index = it->second;
+
+		} else {
+			/* adds the slot or fixes its size */
+			index = _Segment.topic(messageName, size);
+
+			if (index >= 0) {
+				_TopicIndex[messageName] = index;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&_Mutex);
+	return index;
+}
+
+int16_t uORB::ShmChannel::add_subscription(const char *messageName, int32_t msgRateInHz)
+{
+	int index = topic_index(messageName, 0);
+
+	if (index < 0) {
+		PX4_ERR("no shared memory slot for [%s]", messageName);
+		return -1;
+	}
+
+	_Segment.subscribe(index, true);
+	return 0;
+}
+
+int16_t uORB::ShmChannel::remove_subscription(const char *messageName)
+{
+	int index = topic_index(messageName, 0);
+
+	if (index < 0) {
+		return -1;
+	}
+
+	_Segment.subscribe(index, false);
+	return 0;
+}
+
+int16_t uORB::ShmChannel::register_handler(uORBCommunicator::IChannelRxHandler *handler)
+{
+	_RxHandler = handler;
+	return 0;
+}
+
+int16_t uORB::ShmChannel::send_message(const char *messageName, int32_t length, uint8_t *data)
+{
+	int index = topic_index(messageName, 0);
+
+	if (index < 0) {
+		return -1;
+	}
+
+	if (!_Segment.remote_subscribers(index)) {
+		return 0;
+	}
+
+	if (_Segment.topic_size(index) != (unsigned)length) {
+		index = topic_index(messageName, length);
+
+		if (index < 0) {
+			PX4_ERR("size of [%s] differs from the shared memory slot", messageName);
+			return -1;
+		}
+	}
+
+	_SentCount++;
+	return _Segment.write(index, data, length);
+}
+
+int uORB::ShmChannel::Start(const char *segment_name)
+{
+	if (_ThreadStarted) {
+		return -EBUSY;
+	}
+
+	pthread_mutex_lock(&_Mutex);
+	int ret = _Segment.attach(segment_name);
+	pthread_mutex_unlock(&_Mutex);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	_SegmentName = segment_name;
+	memset(_Generation, 0, sizeof(_Generation));
+	memset(_RemoteSubscribers, 0, sizeof(_RemoteSubscribers));
+
+	/* look at the subscriptions of the other processes first thing */
+	_SubscriptionGeneration = _Segment.subscription_generation() - 1;
+
+	_ThreadStarted = true;
+	_ThreadShouldExit = false;
+	pthread_attr_t recv_thread_attr;
+	pthread_attr_init(&recv_thread_attr);
+
+	struct sched_param param;
+	(void)pthread_attr_getschedparam(&recv_thread_attr, &param);
+	param.sched_priority = SCHED_PRIORITY_MAX - 80;
+	(void)pthread_attr_setschedparam(&recv_thread_attr, &param);
+
+	pthread_attr_setstacksize(&recv_thread_attr, PTHREAD_STACK_MIN + 8192);
+
+	if (pthread_create(&_RecvThread, &recv_thread_attr, thread_start, (void *)this) != 0) {
+		PX4_ERR("Error  creating the receive thread for muorb_shm");
+		_ThreadStarted = false;
+		_Segment.detach();
+		ret = -EAGAIN;
+
+	} else {
+		pthread_setname_np(_RecvThread, "muorb_shm_receiver");
+	}
+
+	pthread_attr_destroy(&recv_thread_attr);
+	return ret;
+}
+
+void uORB::ShmChannel::Stop()
+{
+	if (!_ThreadStarted) {
+		return;
+	}
+
+	_ThreadShouldExit = true;
+	_Segment.wake(_Segment.peer());
+	pthread_join(_RecvThread, NULL);
+	_ThreadStarted = false;
+
+	pthread_mutex_lock(&_Mutex);
+	_Segment.detach();
+	_TopicIndex.clear();
+	pthread_mutex_unlock(&_Mutex);
+}
+
+void uORB::ShmChannel::Status()
+{
+	if (!_ThreadStarted) {
+		PX4_INFO("not running");
+		return;
+	}
+
+	PX4_INFO("segment %s, peer %u of %u, %u topics", _SegmentName.c_str(), _Segment.peer(), _Segment.peer_count(),
+		 _Segment.topic_count());
+	PX4_INFO("sent %u, received %u messages", _SentCount, _ReceivedCount);
+}
+
+void  *uORB::ShmChannel::thread_start(void *handler)
+{
+	if (handler != nullptr) {
+		((uORB::ShmChannel *)handler)->shm_recv_thread();
+	}
+
+	return 0;
+}
+
+void uORB::ShmChannel::update_remote_subscriptions()
+{
+	_SubscriptionGeneration = _Segment.subscription_generation();
+	unsigned count = _Segment.topic_count();
+
+	for (unsigned i = 0; i < count; i++) {
+		bool remote = _Segment.remote_subscribers(i);
+
+		if (remote == _RemoteSubscribers[i]) {
+			continue;
+		}
+
+		_RemoteSubscribers[i] = remote;
+
+		if (_RxHandler == nullptr) {
+			continue;
+		}
+
+		if (remote) {
+			_RxHandler->process_add_subscription(_Segment.topic_name(i), 1);
+
+		} else {
+			_RxHandler->process_remove_subscription(_Segment.topic_name(i));
+		}
+	}
+}
+
+void uORB::ShmChannel::shm_recv_thread()
+{
+	while (!_ThreadShouldExit) {
+		/* read before looking at the slots, so that no wakeup gets lost */
+		uint32_t wakeups = _Segment.wakeups();
+
+		if (_Segment.subscription_generation() != _SubscriptionGeneration) {
+			update_remote_subscriptions();
+		}
+
+		unsigned count = _Segment.topic_count();
+
+		for (unsigned i = 0; i < count; i++) {
+			if (!_Segment.subscribed(i)) {
+				continue;
+			}
+
+			int length = _Segment.read(i, _Buffer, sizeof(_Buffer), &_Generation[i]);
+
+			if (length > 0 && _RxHandler != nullptr) {
+				_RxHandler->process_received_message(_Segment.topic_name(i), length, _Buffer);
+				_ReceivedCount++;
+			}
+		}
+
+		_Segment.wait(wakeups, 100);
+	}
+}
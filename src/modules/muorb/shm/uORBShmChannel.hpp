@@ -0,0 +1,166 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef _uORBShmChannel_hpp_
+#define _uORBShmChannel_hpp_
+
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <pthread.h>
+#include "uORB/uORBCommunicator.hpp"
+#include "uORBShmSegment.hpp"
+
+namespace uORB
+{
+class ShmChannel;
+}
+
+/**
+ * IChannel between processes on the same host, see ShmSegment.
+ *
+ * Messages of topics with a subscriber in another process are copied into
+ * the shared slot on publication. The receive thread copies them out of
+ * the slots this process subscribed to and hands them to uORB; it also
+ * reports when the first remote subscriber of a topic comes or the last
+ * one goes. Rate hints of subscriptions are not used.
+ */
+class uORB::ShmChannel : public uORBCommunicator::IChannel
+{
+public:
+	/**
+	 * static method to get the IChannel Implementor.
+	 */
+	static uORB::ShmChannel *GetInstance()
+	{
+		return &(_Instance);
+	}
+
+	/**
+	 * @brief Interface to notify the remote entity of interest of a
+	 * subscription for a message.
+	 *
+	 * @param messageName
+	 * 	This represents the uORB message name; This message name should be
+	 * 	globally unique.
+	 * @param msgRate
+	 * 	The max rate at which the subscriber can accept the messages.
+	 * @return
+	 * 	0 = success; This means the messages is successfully sent to the receiver
+	 * 		Note: This does not mean that the receiver as received it.
+	 *  otherwise = failure.
+	 */
+	virtual int16_t add_subscription(const char *messageName, int32_t msgRateInHz);
+
+	/**
+	 * @brief Interface to notify the remote entity of removal of a subscription
+	 *
+	 * @param messageName
+	 * 	This represents the uORB message name; This message name should be
+	 * 	globally unique.
+	 * @return
+	 * 	0 = success; This means the messages is successfully sent to the receiver
+	 * 		Note: This does not necessarily mean that the receiver as received it.
+	 *  otherwise = failure.
+	 */
+	virtual int16_t remove_subscription(const char *messageName);
+
+	/**
+	 * Register Message Handler.  This is internal for the IChannel implementer*
+	 */
+	virtual int16_t register_handler(uORBCommunicator::IChannelRxHandler *handler);
+
+	/**
+	 * @brief Sends the data message over the communication link.
+	 *
+	 * Nothing is copied while no other process subscribed to the topic.
+	 *
+	 * @param messageName
+	 * 	This represents the uORB message name; This message name should be
+	 * 	globally unique.
+	 * @param length
+	 * 	The length of the data buffer to be sent.
+	 * @param data
+	 * 	The actual data to be sent.
+	 * @return
+	 *  0 = success; This means the messages is successfully sent to the receiver
+	 * 		Note: This does not mean that the receiver as received it.
+	 *  otherwise = failure.
+	 */
+	virtual int16_t send_message(const char *messageName, int32_t length, uint8_t *data);
+
+	/**
+	 * Attach to the segment and start the receive thread.
+	 *
+	 * @return 0 on success, -errno otherwise
+	 */
+	int Start(const char *segment_name);
+	void Stop();
+	void Status();
+
+private: // data members
+	static uORB::ShmChannel _Instance;
+	uORBCommunicator::IChannelRxHandler *_RxHandler;
+	pthread_t _RecvThread;
+	bool _ThreadStarted;
+	volatile bool _ThreadShouldExit;
+
+	ShmSegment _Segment;
+	std::string _SegmentName;
+
+	/** guards _TopicIndex, send_message is called from any publishing thread */
+	pthread_mutex_t _Mutex;
+	std::map<std::string, int> _TopicIndex;
+
+	/** receive thread state per slot */
+	uint32_t _Generation[ShmSegment::MAX_TOPICS];
+	bool _RemoteSubscribers[ShmSegment::MAX_TOPICS];
+	uint8_t _Buffer[ShmSegment::MAX_TOPIC_SIZE];
+
+	uint32_t _SubscriptionGeneration;
+	unsigned _SentCount;
+	unsigned _ReceivedCount;
+
+private://class members.
+	/// constructor.
+	ShmChannel();
+
+	int topic_index(const char *messageName, unsigned size);
+
+	static void *thread_start(void *handler);
+
+	void shm_recv_thread();
+	void update_remote_subscriptions();
+};
+
+#endif /* _uORBShmChannel_hpp_ */
@@ -0,0 +1,521 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBShmSegment.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __PX4_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+/* "uRB" and the version of the layout */
+static const uint32_t SHM_MAGIC = 0x75524202;
+
+/* spins on a lock before looking whether its holder is still alive */
+static const unsigned OWNER_CHECK_SPINS = 1024;
+
+struct uORB::ShmSegment::Layout {
+	struct Peer {
+		int32_t pid;		/**< owner, 0 if free */
+		uint32_t wakeups;	/**< futex word */
+		uint32_t waiting;	/**< set while the owner blocks on wakeups */
+	} __attribute__((aligned(64)));
+
+	struct Topic {
+		char name[MAX_NAME_LEN];
+		uint32_t sequence;	/**< seqlock, odd while the message is written */
+		int32_t writer;		/**< pid of the writing process, 0 if there is none */
+		uint32_t size;		/**< 0 until the first writer allocated the message */
+		uint32_t offset;	/**< of the message in the heap */
+		uint32_t subscribers;	/**< mask of peers */
+	} __attribute__((aligned(64)));
+
+	uint32_t magic;
+	int32_t lock;			/**< pid of the process adding topics or allocating messages, 0 if free */
+	uint32_t topic_count;
+	uint32_t heap_used;
+	uint32_t subscription_generation;
+
+	Peer peers[MAX_PEERS];
+	Topic topics[MAX_TOPICS];
+	uint8_t heap[HEAP_SIZE] __attribute__((aligned(64)));
+};
+
+static inline void
+cpu_relax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+	__builtin_ia32_pause();
+#endif
+}
+
+/* a process which died can not release what it holds in the segment */
+static bool
+process_alive(int32_t pid)
+{
+	return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+uORB::ShmSegment::ShmSegment() :
+	_layout(nullptr),
+	_peer(0),
+	_pid(0)
+{
+}
+
+uORB::ShmSegment::~ShmSegment()
+{
+	detach();
+}
+
+int
+uORB::ShmSegment::attach(const char *name)
+{
+	if (_layout != nullptr) {
+		return -EALREADY;
+	}
+
+	int fd = shm_open(name, O_RDWR | O_CREAT, 0660);
+
+	if (fd < 0) {
+		return -errno;
+	}
+
+	/* a new segment is empty, all zeros is a valid empty table */
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 ||
+	    (st.st_size == 0 && ftruncate(fd, sizeof(Layout)) != 0)) {
+		int ret = -errno;
+		close(fd);
+		return ret;
+	}
+
+	if (st.st_size != 0 && st.st_size != (off_t)sizeof(Layout)) {
+		close(fd);
+		return -EINVAL;
+	}
+
+	void *p = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (p == MAP_FAILED) {
+		return -errno;
+	}
+
+	Layout *layout = (Layout *)p;
+	uint32_t magic = 0;
+
+	if (!__atomic_compare_exchange_n(&layout->magic, &magic, SHM_MAGIC, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) &&
+	    magic != SHM_MAGIC) {
+		munmap(p, sizeof(Layout));
+		return -EINVAL;
+	}
+
+	/* take a free slot or one of a process which is gone */
+	int32_t pid = getpid();
+
+	for (unsigned i = 0; i < MAX_PEERS; i++) {
+		Layout::Peer &peer = layout->peers[i];
+		int32_t owner = __atomic_load_n(&peer.pid, __ATOMIC_ACQUIRE);
+
+		if (owner != 0 && process_alive(owner)) {
+			continue;
+		}
+
+		if (__atomic_compare_exchange_n(&peer.pid, &owner, pid, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+			_layout = layout;
+			_peer = i;
+			_pid = pid;
+			__atomic_store_n(&peer.waiting, 0, __ATOMIC_RELAXED);
+
+			if (owner != 0) {
+				release_peer(i);
+			}
+
+			return 0;
+		}
+	}
+
+	munmap(p, sizeof(Layout));
+	return -EBUSY;
+}
+
+void
+uORB::ShmSegment::detach()
+{
+	if (_layout == nullptr) {
+		return;
+	}
+
+	release_peer(_peer);
+	__atomic_store_n(&_layout->peers[_peer].pid, 0, __ATOMIC_RELEASE);
+
+	munmap(_layout, sizeof(Layout));
+	_layout = nullptr;
+}
+
+int
+uORB::ShmSegment::unlink(const char *name)
+{
+	return shm_unlink(name);
+}
+
+unsigned
+uORB::ShmSegment::peer_count() const
+{
+	unsigned count = 0;
+
+	for (unsigned i = 0; i < MAX_PEERS; i++) {
+		if (__atomic_load_n(&_layout->peers[i].pid, __ATOMIC_RELAXED) != 0) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+void
+uORB::ShmSegment::release_peer(unsigned peer)
+{
+	unsigned count = topic_count();
+
+	for (unsigned i = 0; i < count; i++) {
+		__atomic_fetch_and(&_layout->topics[i].subscribers, ~(1u << peer), __ATOMIC_ACQ_REL);
+	}
+
+	__atomic_fetch_add(&_layout->subscription_generation, 1, __ATOMIC_ACQ_REL);
+
+	for (unsigned i = 0; i < MAX_PEERS; i++) {
+		if (i != peer && __atomic_load_n(&_layout->peers[i].pid, __ATOMIC_RELAXED) != 0) {
+			wake(i);
+		}
+	}
+}
+
+void
+uORB::ShmSegment::lock()
+{
+	/*
+	 * Held for a few hundred instructions at most. The lock of a process
+	 * which died is taken over, the table stays consistent as topic_count
+	 * and the message size are published last; at worst some heap is lost.
+	 */
+	for (unsigned spins = 1;; spins++) {
+		int32_t owner = 0;
+
+		if (__atomic_compare_exchange_n(&_layout->lock, &owner, _pid, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return;
+		}
+
+		if (spins % OWNER_CHECK_SPINS == 0 && !process_alive(owner) &&
+		    __atomic_compare_exchange_n(&_layout->lock, &owner, _pid, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return;
+		}
+
+		sched_yield();
+	}
+}
+
+void
+uORB::ShmSegment::unlock()
+{
+	__atomic_store_n(&_layout->lock, 0, __ATOMIC_RELEASE);
+}
+
+int
+uORB::ShmSegment::topic(const char *name, unsigned size)
+{
+	if (strlen(name) >= MAX_NAME_LEN || size > MAX_TOPIC_SIZE) {
+		return -1;
+	}
+
+	int index = -1;
+	unsigned count = topic_count();
+
+	for (unsigned i = 0; i < count; i++) {
+		if (strcmp(_layout->topics[i].name, name) == 0) {
+			index = i;
+			break;
+		}
+	}
+
+	if (index >= 0 && (size == 0 || topic_size(index) != 0)) {
+		return (size == 0 || topic_size(index) == size) ? index : -1;
+	}
+
+	lock();
+
+	/* another peer might have added it in the meantime */
+	count = _layout->topic_count;
+
+	for (unsigned i = 0; i < count && index < 0; i++) {
+		if (strcmp(_layout->topics[i].name, name) == 0) {
+			index = i;
+		}
+	}
+
+	if (index < 0) {
+		if (count == MAX_TOPICS) {
+			unlock();
+			return -1;
+		}
+
+		Layout::Topic &t = _layout->topics[count];
+		strncpy(t.name, name, MAX_NAME_LEN);
+		t.sequence = 0;
+		t.writer = 0;
+		t.size = 0;
+		t.offset = 0;
+		t.subscribers = 0;
+		__atomic_store_n(&_layout->topic_count, count + 1, __ATOMIC_RELEASE);
+		index = count;
+	}
+
+	Layout::Topic &t = _layout->topics[index];
+
+	if (size != 0 && t.size == 0) {
+		/* keep every message on its own cache lines */
+		unsigned allocated = (size + 63) & ~63u;
+
+		if (_layout->heap_used + allocated > HEAP_SIZE) {
+			unlock();
+			return -1;
+		}
+
+		t.offset = _layout->heap_used;
+		_layout->heap_used += allocated;
+		__atomic_store_n(&t.size, size, __ATOMIC_RELEASE);
+	}
+
+	unlock();
+
+	return (size == 0 || t.size == size) ? index : -1;
+}
+
+unsigned
+uORB::ShmSegment::topic_count() const
+{
+	return __atomic_load_n(&_layout->topic_count, __ATOMIC_ACQUIRE);
+}
+
+const char *
+uORB::ShmSegment::topic_name(int topic) const
+{
+	return _layout->topics[topic].name;
+}
+
+unsigned
+uORB::ShmSegment::topic_size(int topic) const
+{
+	return __atomic_load_n(&_layout->topics[topic].size, __ATOMIC_ACQUIRE);
+}
+
+void
+uORB::ShmSegment::subscribe(int topic, bool subscribe)
+{
+	uint32_t bit = 1u << _peer;
+	uint32_t old;
+
+	if (subscribe) {
+		old = __atomic_fetch_or(&_layout->topics[topic].subscribers, bit, __ATOMIC_ACQ_REL);
+
+	} else {
+		old = __atomic_fetch_and(&_layout->topics[topic].subscribers, ~bit, __ATOMIC_ACQ_REL);
+	}
+
+	if (((old & bit) != 0) == subscribe) {
+		return;
+	}
+
+	__atomic_fetch_add(&_layout->subscription_generation, 1, __ATOMIC_ACQ_REL);
+
+	for (unsigned i = 0; i < MAX_PEERS; i++) {
+		if (i != _peer && __atomic_load_n(&_layout->peers[i].pid, __ATOMIC_RELAXED) != 0) {
+			wake(i);
+		}
+	}
+}
+
+uint32_t
+uORB::ShmSegment::subscribers(int topic) const
+{
+	return __atomic_load_n(&_layout->topics[topic].subscribers, __ATOMIC_ACQUIRE);
+}
+
+uint32_t
+uORB::ShmSegment::subscription_generation() const
+{
+	return __atomic_load_n(&_layout->subscription_generation, __ATOMIC_ACQUIRE);
+}
+
+int
+uORB::ShmSegment::write(int topic, const void *data, unsigned size)
+{
+	Layout::Topic &t = _layout->topics[topic];
+
+	if (size == 0 || topic_size(topic) != size) {
+		return -1;
+	}
+
+	/* writers take turns, the slot of a writer which died is taken over */
+	for (unsigned spins = 1;; spins++) {
+		int32_t owner = 0;
+
+		if (__atomic_compare_exchange_n(&t.writer, &owner, _pid, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+			break;
+		}
+
+		if (spins % OWNER_CHECK_SPINS == 0 && !process_alive(owner) &&
+		    __atomic_compare_exchange_n(&t.writer, &owner, _pid, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+			break;
+		}
+
+		cpu_relax();
+	}
+
+	/* still odd if the previous writer died during the copy */
+	uint32_t sequence = __atomic_load_n(&t.sequence, __ATOMIC_RELAXED) | 1;
+	__atomic_store_n(&t.sequence, sequence, __ATOMIC_RELAXED);
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&_layout->heap[t.offset], data, size);
+	__atomic_store_n(&t.sequence, sequence + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&t.writer, 0, __ATOMIC_RELEASE);
+
+	uint32_t remote = subscribers(topic) & ~(1u << _peer);
+
+	for (unsigned i = 0; remote != 0; i++, remote >>= 1) {
+		if (remote & 1) {
+			wake(i);
+		}
+	}
+
+	return 0;
+}
+
+int
+uORB::ShmSegment::read(int topic, void *data, unsigned size, uint32_t *generation) const
+{
+	const Layout::Topic &t = _layout->topics[topic];
+	unsigned topic_size = this->topic_size(topic);
+
+	if (topic_size > size) {
+		return -1;
+	}
+
+	for (unsigned spins = 1;; spins++) {
+		uint32_t sequence = __atomic_load_n(&t.sequence, __ATOMIC_ACQUIRE);
+
+		if (sequence == *generation) {
+			return 0;
+		}
+
+		if (sequence & 1) {
+			/* a writer died during the copy, there is nothing to read until the next write */
+			int32_t writer = __atomic_load_n(&t.writer, __ATOMIC_RELAXED);
+
+			if (spins % OWNER_CHECK_SPINS == 0 && writer != 0 && !process_alive(writer)) {
+				return 0;
+			}
+
+			cpu_relax();
+			continue;
+		}
+
+		memcpy(data, &_layout->heap[t.offset], topic_size);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(&t.sequence, __ATOMIC_RELAXED) == sequence) {
+			*generation = sequence;
+			return topic_size;
+		}
+	}
+}
+
+uint32_t
+uORB::ShmSegment::wakeups() const
+{
+	return __atomic_load_n(&_layout->peers[_peer].wakeups, __ATOMIC_SEQ_CST);
+}
+
+void
+uORB::ShmSegment::wait(uint32_t last, unsigned timeout_ms)
+{
+	Layout::Peer &peer = _layout->peers[_peer];
+
+	/* announce the wait before the last check, wake() looks at it after bumping the counter */
+	__atomic_store_n(&peer.waiting, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&peer.wakeups, __ATOMIC_SEQ_CST) == last) {
+#ifdef __PX4_LINUX
+		struct timespec timeout;
+		timeout.tv_sec = timeout_ms / 1000;
+		timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+		syscall(SYS_futex, &peer.wakeups, FUTEX_WAIT, last, &timeout, nullptr, 0);
+#else
+
+		for (unsigned i = 0; i < timeout_ms * 10 && __atomic_load_n(&peer.wakeups, __ATOMIC_SEQ_CST) == last; i++) {
+			usleep(100);
+		}
+
+#endif
+	}
+
+	__atomic_store_n(&peer.waiting, 0, __ATOMIC_SEQ_CST);
+}
+
+void
+uORB::ShmSegment::wake(unsigned peer)
+{
+	Layout::Peer &p = _layout->peers[peer];
+	__atomic_fetch_add(&p.wakeups, 1, __ATOMIC_SEQ_CST);
+
+#ifdef __PX4_LINUX
+
+	if (__atomic_load_n(&p.waiting, __ATOMIC_SEQ_CST) != 0) {
+		syscall(SYS_futex, &p.wakeups, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+	}
+
+#endif
+}
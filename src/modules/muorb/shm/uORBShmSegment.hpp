@@ -0,0 +1,184 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file uORBShmSegment.hpp
+ * Topic table in POSIX shared memory, shared by several processes
+ *
+ * Every topic has one slot with the latest message, guarded by a seqlock:
+ * the writer makes the sequence odd, copies the message and makes it even
+ * again, readers retry when the sequence was odd or changed during the
+ * copy. Like a uORB node a slot only keeps the latest message.
+ *
+ * The table lock and the writer of a slot are held under the pid of the
+ * process, a waiter takes them over when that process is gone. A slot
+ * whose writer died during the copy has nothing to read until the next
+ * write. The segment is only accessible to the user and group.
+ *
+ * Each attached process (peer) owns a wakeup counter, which writers bump
+ * for every subscriber of the topic. A peer blocks on its counter with a
+ * futex, so a wakeup costs no syscall while the peer is busy.
+ *
+ * Slots are never removed; their size is fixed by the first writer.
+ */
+
+#ifndef _uORBShmSegment_hpp_
+#define _uORBShmSegment_hpp_
+
+#include <stdint.h>
+
+namespace uORB
+{
+class ShmSegment;
+}
+
+class uORB::ShmSegment
+{
+public:
+	static const unsigned MAX_PEERS = 16;
+	static const unsigned MAX_TOPICS = 256;
+	static const unsigned MAX_NAME_LEN = 64;
+	static const unsigned MAX_TOPIC_SIZE = 4096;
+	static const unsigned HEAP_SIZE = 1024 * 1024;
+
+	ShmSegment();
+	~ShmSegment();
+
+	/**
+	 * Open or create the segment and take a free peer slot.
+	 *
+	 * Slots of processes which are gone are taken over.
+	 *
+	 * @param name	name of the segment, starting with '/'
+	 * @return	0 on success, -errno otherwise
+	 */
+	int attach(const char *name);
+
+	/**
+	 * Release the peer slot and its subscriptions and unmap the segment.
+	 */
+	void detach();
+
+	/**
+	 * Remove the segment name; attached processes keep their mapping.
+	 */
+	static int unlink(const char *name);
+
+	bool attached() const { return _layout != nullptr; }
+	unsigned peer() const { return _peer; }
+
+	/**
+	 * Number of peer slots in use.
+	 */
+	unsigned peer_count() const;
+
+	/**
+	 * Find or add the slot of a topic.
+	 *
+	 * @param name	topic name
+	 * @param size	message size, 0 if not known yet
+	 * @return	slot index, -1 if the table is full or the size differs
+	 */
+	int topic(const char *name, unsigned size);
+
+	unsigned topic_count() const;
+	const char *topic_name(int topic) const;
+	unsigned topic_size(int topic) const;
+
+	/**
+	 * Add or remove this peer as subscriber of a topic.
+	 *
+	 * All other peers are woken up to look at the subscription change.
+	 */
+	void subscribe(int topic, bool subscribe);
+
+	/**
+	 * Mask of the peers subscribed to a topic.
+	 */
+	uint32_t subscribers(int topic) const;
+
+	bool subscribed(int topic) const { return subscribers(topic) & (1u << _peer); }
+	bool remote_subscribers(int topic) const { return subscribers(topic) & ~(1u << _peer); }
+
+	/**
+	 * Incremented on every subscription change by any peer.
+	 */
+	uint32_t subscription_generation() const;
+
+	/**
+	 * Copy a message into the slot and wake up the remote subscribers.
+	 *
+	 * @return	0 on success, -1 if the size does not match the slot
+	 */
+	int write(int topic, const void *data, unsigned size);
+
+	/**
+	 * Copy the message out of the slot if it changed.
+	 *
+	 * @param generation	sequence of the last message read, updated
+	 * @return		message size, 0 if there is nothing new, -1 on error
+	 */
+	int read(int topic, void *data, unsigned size, uint32_t *generation) const;
+
+	/**
+	 * Wakeup counter of this peer, read before looking for new messages.
+	 */
+	uint32_t wakeups() const;
+
+	/**
+	 * Block until the wakeup counter differs from last or the timeout
+	 * passed. Only one thread per peer may wait.
+	 */
+	void wait(uint32_t last, unsigned timeout_ms);
+
+	/**
+	 * Bump the wakeup counter of a peer.
+	 */
+	void wake(unsigned peer);
+
+private:
+	struct Layout;
+
+	Layout *_layout;
+	unsigned _peer;
+	int32_t _pid;
+
+	void lock();
+	void unlock();
+	void release_peer(unsigned peer);
+
+	/* disallow copy */
+	ShmSegment(const ShmSegment &);
+	ShmSegment &operator=(const ShmSegment &);
+};
+
+#endif /* _uORBShmSegment_hpp_ */
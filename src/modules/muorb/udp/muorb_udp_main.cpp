@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file muorb_udp_main.cpp
+ * Shares uORB topics with a PX4 instance on another host.
+ *
+ * Two instances on one machine talk over loopback with swapped ports:
+ *   muorb_udp start -p 14570 -r 127.0.0.1:14571
+ *   muorb_udp start -p 14571 -r 127.0.0.1:14570
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <px4_getopt.h>
+#include "modules/uORB/uORBManager.hpp"
+#include "uORBUdpChannel.hpp"
+
+extern "C" { __EXPORT int muorb_udp_main(int argc, char *argv[]); }
+
+static uORB::UdpChannel *g_channel = nullptr;
+
+static void usage()
+{
+	warnx("Usage: muorb_udp 'start -p <port> -r <host>:<port> [-b <batch interval us>]', 'stop', 'status'");
+}
+
+static int start(int argc, char *argv[])
+{
+	int myoptind = 1;
+	const char *myoptarg = NULL;
+	int ch;
+	unsigned long port = 0;
+	unsigned long remote_port = 0;
+	unsigned long batch_interval = 1000;
+	char remote_host[32] = "";
+	bool err_flag = false;
+
+	while ((ch = px4_getopt(argc, argv, "p:r:b:", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 'p':
+			port = strtoul(myoptarg, NULL, 10);
+			break;
+
+		case 'r': {
+				const char *colon = strrchr(myoptarg, ':');
+
+				if (colon == nullptr || colon - myoptarg >= (int)sizeof(remote_host)) {
+					err_flag = true;
+					break;
+				}
+
+				strncpy(remote_host, myoptarg, colon - myoptarg);
+				remote_host[colon - myoptarg] = '\0';
+				remote_port = strtoul(colon + 1, NULL, 10);
+				break;
+			}
+
+		case 'b':
+			batch_interval = strtoul(myoptarg, NULL, 10);
+			break;
+
+		default:
+			err_flag = true;
+			break;
+		}
+	}
+
+	if (err_flag || port == 0 || port > 65535 || remote_port == 0 || remote_port > 65535) {
+		usage();
+		return -EINVAL;
+	}
+
+	if (g_channel != nullptr) {
+		warnx("already running");
+		return -EBUSY;
+	}
+
+	g_channel = new uORB::UdpChannel();
+	int ret = g_channel->Start(port, remote_host, remote_port, batch_interval);
+
+	if (ret != 0) {
+		warnx("could not start: %s", strerror(-ret));
+		delete g_channel;
+		g_channel = nullptr;
+		return ret;
+	}
+
+	// register the UDP channel with UORB.
+	uORB::Manager::get_instance()->set_uorb_communicator(g_channel);
+	return OK;
+}
+
+int
+muorb_udp_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return -EINVAL;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		return start(argc - 1, argv + 1);
+	}
+
+	if (!strcmp(argv[1], "stop")) {
+		if (g_channel != nullptr) {
+			uORB::Manager::get_instance()->set_uorb_communicator(nullptr);
+			g_channel->Stop();
+			delete g_channel;
+			g_channel = nullptr;
+		}
+
+		return OK;
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		if (g_channel == nullptr) {
+			warnx("not running");
+
+		} else {
+			g_channel->Status();
+		}
+
+		return OK;
+	}
+
+	usage();
+	return -EINVAL;
+}
@@ -0,0 +1,591 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBUdpChannel.hpp"
+#include "px4_log.h"
+#include "px4_tasks.h"
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+using namespace uORB::UdpProtocol;
+
+uORB::UdpChannel::UdpChannel() :
+	_RxHandler(nullptr),
+	_ThreadStarted(false),
+	_ThreadShouldExit(false),
+	_Socket(-1),
+	_BatchInterval(0),
+	_PendingCount(0),
+	_NextHousekeeping(0),
+	_TxSequence(0),
+	_RxSequence(0),
+	_TxPackets(0),
+	_TxRecords(0),
+	_RxPackets(0),
+	_RxRecords(0),
+	_RxLost(0)
+{
+	memset(&_RemoteAddr, 0, sizeof(_RemoteAddr));
+	pthread_mutex_init(&_Mutex, nullptr);
+	pthread_cond_init(&_Cond, nullptr);
+}
+
+uORB::UdpChannel::~UdpChannel()
+{
+	Stop();
+	pthread_cond_destroy(&_Cond);
+	pthread_mutex_destroy(&_Mutex);
+}
+
+int16_t uORB::UdpChannel::add_subscription(const char *messageName, int32_t msgRateInHz)
+{
+	pthread_mutex_lock(&_Mutex);
+	_LocalSubscriptions[messageName] = msgRateInHz;
+	int ret = send_control(ADD_SUBSCRIPTION, messageName, &msgRateInHz, sizeof(msgRateInHz));
+	pthread_mutex_unlock(&_Mutex);
+	return ret;
+}
+
+int16_t uORB::UdpChannel::remove_subscription(const char *messageName)
+{
+	pthread_mutex_lock(&_Mutex);
+	_LocalSubscriptions.erase(messageName);
+	int ret = send_control(REMOVE_SUBSCRIPTION, messageName, nullptr, 0);
+	pthread_mutex_unlock(&_Mutex);
+	return ret;
+}
+
+int16_t uORB::UdpChannel::register_handler(uORBCommunicator::IChannelRxHandler *handler)
+{
+	_RxHandler = handler;
+	return 0;
+}
+
+int16_t uORB::UdpChannel::send_message(const char *messageName, int32_t length, uint8_t *data)
+{
+	pthread_mutex_lock(&_Mutex);
+	std::map<std::string, RemoteTopic>::iterator it = _RemoteTopics.find(messageName);
+
+	if (it == _RemoteTopics.end()) {
+		pthread_mutex_unlock(&_Mutex);
+		return 0;
+	}
+
+	RemoteTopic &topic = it->second;
+	topic.data.assign(data, data + length);
+
+	if (!topic.pending) {
+		topic.pending = true;
+		_PendingCount++;
+		pthread_cond_signal(&_Cond);
+	}
+
+	pthread_mutex_unlock(&_Mutex);
+	return 0;
+}
+
+int uORB::UdpChannel::Start(uint16_t port, const char *remote_host, uint16_t remote_port, unsigned batch_interval)
+{
+	if (_ThreadStarted) {
+		return -EBUSY;
+	}
+
+	_RemoteAddr.sin_family = AF_INET;
+	_RemoteAddr.sin_port = htons(remote_port);
+
+	if (inet_aton(remote_host, &_RemoteAddr.sin_addr) == 0) {
+		return -EINVAL;
+	}
+
+	_Socket = socket(AF_INET, SOCK_DGRAM, 0);
+
+	if (_Socket < 0) {
+		return -errno;
+	}
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+
+	/* wake up now and then to see if the thread should exit */
+	struct timeval timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 100000;
+
+	if (bind(_Socket, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+	    setsockopt(_Socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) {
+		int ret = -errno;
+		close(_Socket);
+		_Socket = -1;
+		return ret;
+	}
+
+	_BatchInterval = batch_interval;
+	_NextHousekeeping = 0;
+	_TimeSync.reset();
+	_TxPackets = _TxRecords = _RxPackets = _RxRecords = _RxLost = 0;
+
+	_ThreadStarted = true;
+	_ThreadShouldExit = false;
+	pthread_attr_t thread_attr;
+	pthread_attr_init(&thread_attr);
+
+	struct sched_param param;
+	(void)pthread_attr_getschedparam(&thread_attr, &param);
+	param.sched_priority = SCHED_PRIORITY_MAX - 80;
+	(void)pthread_attr_setschedparam(&thread_attr, &param);
+
+	pthread_attr_setstacksize(&thread_attr, PTHREAD_STACK_MIN + 8192);
+
+	int ret = 0;
+
+	if (pthread_create(&_RecvThread, &thread_attr, recv_thread_start, (void *)this) != 0) {
+		PX4_ERR("Error  creating the receive thread for muorb_udp");
+		ret = -EAGAIN;
+
+	} else if (pthread_create(&_SendThread, &thread_attr, send_thread_start, (void *)this) != 0) {
+		PX4_ERR("Error  creating the send thread for muorb_udp");
+		_ThreadShouldExit = true;
+		pthread_join(_RecvThread, NULL);
+		ret = -EAGAIN;
+
+	} else {
+		pthread_setname_np(_RecvThread, "muorb_udp_receiver");
+		pthread_setname_np(_SendThread, "muorb_udp_sender");
+	}
+
+	pthread_attr_destroy(&thread_attr);
+
+	if (ret != 0) {
+		_ThreadStarted = false;
+		close(_Socket);
+		_Socket = -1;
+	}
+
+	return ret;
+}
+
+void uORB::UdpChannel::Stop()
+{
+	if (!_ThreadStarted) {
+		return;
+	}
+
+	pthread_mutex_lock(&_Mutex);
+	_ThreadShouldExit = true;
+	pthread_cond_signal(&_Cond);
+	pthread_mutex_unlock(&_Mutex);
+
+	pthread_join(_SendThread, NULL);
+	pthread_join(_RecvThread, NULL);
+	_ThreadStarted = false;
+
+	close(_Socket);
+	_Socket = -1;
+
+	pthread_mutex_lock(&_Mutex);
+	_RemoteTopics.clear();
+	_PendingCount = 0;
+	pthread_mutex_unlock(&_Mutex);
+}
+
+void uORB::UdpChannel::Status()
+{
+	if (!_ThreadStarted) {
+		PX4_INFO("not running");
+		return;
+	}
+
+	pthread_mutex_lock(&_Mutex);
+	PX4_INFO("remote %s:%u, batch interval %u us", inet_ntoa(_RemoteAddr.sin_addr), ntohs(_RemoteAddr.sin_port),
+		 _BatchInterval);
+	PX4_INFO("sent %u datagrams with %u records, received %u with %u records, %u lost",
+		 _TxPackets, _TxRecords, _RxPackets, _RxRecords, _RxLost);
+	PX4_INFO("%u local subscriptions, %u remote", (unsigned)_LocalSubscriptions.size(), (unsigned)_RemoteTopics.size());
+
+	if (_TimeSync.valid()) {
+		PX4_INFO("time offset %lld us, round trip %llu us", (long long)_TimeSync.offset(),
+			 (unsigned long long)_TimeSync.round_trip());
+
+	} else {
+		PX4_INFO("time not synchronized");
+	}
+
+	pthread_mutex_unlock(&_Mutex);
+}
+
+bool uORB::UdpChannel::TimeOffset(int64_t *offset)
+{
+	pthread_mutex_lock(&_Mutex);
+	bool valid = _TimeSync.valid();
+	*offset = _TimeSync.offset();
+	pthread_mutex_unlock(&_Mutex);
+	return valid;
+}
+
+unsigned uORB::UdpChannel::RemoteSubscriptions()
+{
+	pthread_mutex_lock(&_Mutex);
+	unsigned count = _RemoteTopics.size();
+	pthread_mutex_unlock(&_Mutex);
+	return count;
+}
+
+int uORB::UdpChannel::send_packet(UdpPacketWriter &packet)
+{
+	packet.set_sequence(_TxSequence++);
+
+	if (sendto(_Socket, packet.data(), packet.size(), 0, (struct sockaddr *)&_RemoteAddr, sizeof(_RemoteAddr)) < 0) {
+		return -1;
+	}
+
+	_TxPackets++;
+	_TxRecords += packet.count();
+	return 0;
+}
+
+int uORB::UdpChannel::send_control(uint8_t type, const char *name, const void *payload, unsigned length)
+{
+	if (_Socket < 0) {
+		return -1;
+	}
+
+	UdpPacketWriter packet(_ControlBuffer, sizeof(_ControlBuffer));
+	packet.begin();
+
+	if (!packet.add(type, name, payload, length)) {
+		return -1;
+	}
+
+	return send_packet(packet);
+}
+
+void  *uORB::UdpChannel::recv_thread_start(void *handler)
+{
+	if (handler != nullptr) {
+		((uORB::UdpChannel *)handler)->udp_recv_thread();
+	}
+
+	return 0;
+}
+
+void  *uORB::UdpChannel::send_thread_start(void *handler)
+{
+	if (handler != nullptr) {
+		((uORB::UdpChannel *)handler)->udp_send_thread();
+	}
+
+	return 0;
+}
+
+void uORB::UdpChannel::udp_recv_thread()
+{
+	while (!_ThreadShouldExit) {
+		struct sockaddr_in from;
+		socklen_t from_len = sizeof(from);
+		ssize_t size = recvfrom(_Socket, _RxBuffer, sizeof(_RxBuffer), 0, (struct sockaddr *)&from, &from_len);
+
+		if (size <= 0) {
+			continue;
+		}
+
+		if (from.sin_addr.s_addr != _RemoteAddr.sin_addr.s_addr || from.sin_port != _RemoteAddr.sin_port) {
+			continue;
+		}
+
+		process_packet(size);
+	}
+}
+
+void uORB::UdpChannel::process_packet(unsigned size)
+{
+	UdpPacketReader packet;
+
+	if (!packet.open(_RxBuffer, size)) {
+		return;
+	}
+
+	if (_RxPackets > 0 && packet.sequence() != _RxSequence) {
+		_RxLost += (uint16_t)(packet.sequence() - _RxSequence);
+	}
+
+	_RxSequence = packet.sequence() + 1;
+	_RxPackets++;
+
+	Record record;
+
+	while (packet.next(&record)) {
+		_RxRecords++;
+
+		switch (record.type) {
+		case DATA:
+			if (_RxHandler != nullptr) {
+				_RxHandler->process_received_message(record.name, record.length, (uint8_t *)record.payload);
+			}
+
+			break;
+
+		case ADD_SUBSCRIPTION: {
+				int32_t rate = 0;
+
+				if (record.length == sizeof(rate)) {
+					memcpy(&rate, record.payload, sizeof(rate));
+					process_add_subscription(record.name, rate);
+				}
+
+				break;
+			}
+
+		case REMOVE_SUBSCRIPTION:
+			process_remove_subscription(record.name);
+			break;
+
+		case TIME_REQUEST:
+			if (record.length == sizeof(uint64_t)) {
+				uint64_t times[2];
+				memcpy(&times[0], record.payload, sizeof(times[0]));
+				times[1] = hrt_absolute_time();
+				pthread_mutex_lock(&_Mutex);
+				send_control(TIME_REPLY, "", times, sizeof(times));
+				pthread_mutex_unlock(&_Mutex);
+			}
+
+			break;
+
+		case TIME_REPLY:
+			if (record.length == 2 * sizeof(uint64_t)) {
+				uint64_t times[2];
+				memcpy(times, record.payload, sizeof(times));
+				hrt_abstime now = hrt_absolute_time();
+				pthread_mutex_lock(&_Mutex);
+				_TimeSync.update(times[0], times[1], now);
+				pthread_mutex_unlock(&_Mutex);
+			}
+
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+void uORB::UdpChannel::process_add_subscription(const char *name, int32_t rate)
+{
+	hrt_abstime now = hrt_absolute_time();
+	pthread_mutex_lock(&_Mutex);
+	std::map<std::string, RemoteTopic>::iterator it = _RemoteTopics.find(name);
+	bool added = (it == _RemoteTopics.end());
+
+	if (added) {
+		RemoteTopic &topic = _RemoteTopics[name];
+		topic.last_sent = 0;
+		topic.pending = false;
+		it = _RemoteTopics.find(name);
+	}
+
+	it->second.interval = (rate > 0) ? 1000000 / rate : 0;
+	it->second.refreshed = now;
+	pthread_mutex_unlock(&_Mutex);
+
+	// the publisher sends its current data right away
+	if (added && _RxHandler != nullptr) {
+		_RxHandler->process_add_subscription(name, rate);
+	}
+}
+
+void uORB::UdpChannel::process_remove_subscription(const char *name)
+{
+	pthread_mutex_lock(&_Mutex);
+	std::map<std::string, RemoteTopic>::iterator it = _RemoteTopics.find(name);
+	bool removed = (it != _RemoteTopics.end());
+
+	if (removed) {
+		if (it->second.pending) {
+			_PendingCount--;
+		}
+
+		_RemoteTopics.erase(it);
+	}
+
+	pthread_mutex_unlock(&_Mutex);
+
+	if (removed && _RxHandler != nullptr) {
+		_RxHandler->process_remove_subscription(name);
+	}
+}
+
+hrt_abstime uORB::UdpChannel::flush(hrt_abstime now)
+{
+	UdpPacketWriter packet(_TxBuffer, sizeof(_TxBuffer));
+	packet.begin();
+	hrt_abstime next_due = 0;
+
+	for (std::map<std::string, RemoteTopic>::iterator it = _RemoteTopics.begin(); it != _RemoteTopics.end(); ++it) {
+		RemoteTopic &topic = it->second;
+
+		if (!topic.pending) {
+			continue;
+		}
+
+		if (topic.interval != 0 && now < topic.last_sent + topic.interval) {
+			hrt_abstime due = topic.last_sent + topic.interval;
+			next_due = (next_due == 0 || due < next_due) ? due : next_due;
+			continue;
+		}
+
+		/* a datagram holds as many updates as fit into a frame, larger topics go alone */
+		unsigned size = UdpPacketWriter::record_size(it->first.c_str(), topic.data.size());
+
+		if (!packet.empty() && packet.size() + size > BATCH_SIZE) {
+			send_packet(packet);
+			packet.begin();
+		}
+
+		if (packet.add(DATA, it->first.c_str(), topic.data.data(), topic.data.size())) {
+			topic.last_sent = now;
+		}
+
+		topic.pending = false;
+		_PendingCount--;
+	}
+
+	if (!packet.empty()) {
+		send_packet(packet);
+	}
+
+	return next_due;
+}
+
+void uORB::UdpChannel::housekeeping(hrt_abstime now, std::vector<std::string> &expired)
+{
+	UdpPacketWriter packet(_TxBuffer, BATCH_SIZE);
+	packet.begin();
+
+	uint64_t request = now;
+	packet.add(TIME_REQUEST, "", &request, sizeof(request));
+
+	/* announce our subscriptions, in case the other side started later or missed one */
+	for (std::map<std::string, int32_t>::iterator it = _LocalSubscriptions.begin(); it != _LocalSubscriptions.end(); ++it) {
+		if (!packet.add(ADD_SUBSCRIPTION, it->first.c_str(), &it->second, sizeof(it->second))) {
+			send_packet(packet);
+			packet.begin();
+			packet.add(ADD_SUBSCRIPTION, it->first.c_str(), &it->second, sizeof(it->second));
+		}
+	}
+
+	send_packet(packet);
+
+	/* subscriptions which were not announced for a while */
+	std::map<std::string, RemoteTopic>::iterator it = _RemoteTopics.begin();
+
+	while (it != _RemoteTopics.end()) {
+		if (now > it->second.refreshed + _SubscriptionTimeout) {
+			if (it->second.pending) {
+				_PendingCount--;
+			}
+
+			expired.push_back(it->first);
+			_RemoteTopics.erase(it++);
+
+		} else {
+			++it;
+		}
+	}
+}
+
+void uORB::UdpChannel::udp_send_thread()
+{
+	std::vector<std::string> expired;
+	pthread_mutex_lock(&_Mutex);
+
+	while (!_ThreadShouldExit) {
+		hrt_abstime now = hrt_absolute_time();
+
+		if (now >= _NextHousekeeping) {
+			housekeeping(now, expired);
+			_NextHousekeeping = now + _HousekeepingInterval;
+
+			if (!expired.empty()) {
+				pthread_mutex_unlock(&_Mutex);
+
+				for (unsigned i = 0; i < expired.size() && _RxHandler != nullptr; i++) {
+					_RxHandler->process_remove_subscription(expired[i].c_str());
+				}
+
+				expired.clear();
+				pthread_mutex_lock(&_Mutex);
+				continue;
+			}
+		}
+
+		unsigned sent = _TxPackets;
+		hrt_abstime wakeup = _NextHousekeeping;
+
+		if (_PendingCount > 0) {
+			hrt_abstime next_due = flush(now);
+
+			if (next_due != 0 && next_due < wakeup) {
+				wakeup = next_due;
+			}
+		}
+
+		/* collect updates for the next datagram */
+		if (_TxPackets != sent && _BatchInterval > 0) {
+			pthread_mutex_unlock(&_Mutex);
+			usleep(_BatchInterval);
+			pthread_mutex_lock(&_Mutex);
+			continue;
+		}
+
+		/* sleep until something is published or gets due */
+		if (wakeup > now) {
+			struct timeval tv;
+			gettimeofday(&tv, nullptr);
+			uint64_t deadline = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec + (wakeup - now);
+			struct timespec ts;
+			ts.tv_sec = deadline / 1000000;
+			ts.tv_nsec = (deadline % 1000000) * 1000;
+			pthread_cond_timedwait(&_Cond, &_Mutex, &ts);
+		}
+	}
+
+	pthread_mutex_unlock(&_Mutex);
+}
@@ -0,0 +1,216 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef _uORBUdpChannel_hpp_
+#define _uORBUdpChannel_hpp_
+
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <vector>
+#include <pthread.h>
+#include <netinet/in.h>
+#include "uORB/uORBCommunicator.hpp"
+#include "uORBUdpProtocol.hpp"
+
+namespace uORB
+{
+class UdpChannel;
+}
+
+/**
+ * IChannel to a PX4 instance on another host, over UDP.
+ *
+ * Only topics which the other side subscribed to are sent. Updates are
+ * kept per topic until the send thread packs all due ones into a datagram,
+ * so a subscriber asking for a rate below the publication rate gets the
+ * latest message at that rate. Subscriptions are announced again every
+ * second, which lets either side start first and drops subscriptions of a
+ * side which went away. Time sync messages keep track of the offset
+ * between the two clocks.
+ */
+class uORB::UdpChannel : public uORBCommunicator::IChannel
+{
+public:
+	UdpChannel();
+	virtual ~UdpChannel();
+
+	/**
+	 * @brief Interface to notify the remote entity of interest of a
+	 * subscription for a message.
+	 *
+	 * @param messageName
+	 * 	This represents the uORB message name; This message name should be
+	 * 	globally unique.
+	 * @param msgRate
+	 * 	The max rate at which the subscriber can accept the messages,
+	 * 	0 for no limit.
+	 * @return
+	 * 	0 = success; This means the messages is successfully sent to the receiver
+	 * 		Note: This does not mean that the receiver as received it.
+	 *  otherwise = failure.
+	 */
+	virtual int16_t add_subscription(const char *messageName, int32_t msgRateInHz);
+
+	/**
+	 * @brief Interface to notify the remote entity of removal of a subscription
+	 *
+	 * @param messageName
+	 * 	This represents the uORB message name; This message name should be
+	 * 	globally unique.
+	 * @return
+	 * 	0 = success; This means the messages is successfully sent to the receiver
+	 * 		Note: This does not necessarily mean that the receiver as received it.
+	 *  otherwise = failure.
+	 */
+	virtual int16_t remove_subscription(const char *messageName);
+
+	/**
+	 * Register Message Handler.  This is internal for the IChannel implementer*
+	 */
+	virtual int16_t register_handler(uORBCommunicator::IChannelRxHandler *handler);
+
+	/**
+	 * @brief Queues the data message for the next datagram.
+	 *
+	 * Nothing is sent if the remote side did not subscribe to the topic.
+	 *
+	 * @param messageName
+	 * 	This represents the uORB message name; This message name should be
+	 * 	globally unique.
+	 * @param length
+	 * 	The length of the data buffer to be sent.
+	 * @param data
+	 * 	The actual data to be sent.
+	 * @return
+	 *  0 = success; This means the messages is successfully sent to the receiver
+	 * 		Note: This does not mean that the receiver as received it.
+	 *  otherwise = failure.
+	 */
+	virtual int16_t send_message(const char *messageName, int32_t length, uint8_t *data);
+
+	/**
+	 * Bind the local port and start the send and receive threads.
+	 *
+	 * @param port			local UDP port
+	 * @param remote_host		IPv4 address of the other side
+	 * @param remote_port		UDP port of the other side
+	 * @param batch_interval	minimum time between datagrams with topic updates in us,
+	 *				0 to send every update right away
+	 * @return			0 on success, -errno otherwise
+	 */
+	int Start(uint16_t port, const char *remote_host, uint16_t remote_port, unsigned batch_interval);
+	void Stop();
+	void Status();
+
+	/**
+	 * Remote minus local hrt_absolute_time() in us.
+	 *
+	 * @return false while there was no time sync reply
+	 */
+	bool TimeOffset(int64_t *offset);
+
+	/**
+	 * Number of topics the remote side subscribed to.
+	 */
+	unsigned RemoteSubscriptions();
+
+private: // data members
+	struct RemoteTopic {
+		unsigned interval;		/**< minimum time between updates, 0 for no limit */
+		hrt_abstime last_sent;
+		hrt_abstime refreshed;		/**< last time the subscription was announced */
+		bool pending;			/**< data was not sent yet */
+		std::vector<uint8_t> data;
+	};
+
+	static const hrt_abstime _HousekeepingInterval = 1000000;
+	static const hrt_abstime _SubscriptionTimeout = 3500000;
+
+	uORBCommunicator::IChannelRxHandler *_RxHandler;
+	pthread_t _RecvThread;
+	pthread_t _SendThread;
+	bool _ThreadStarted;
+	volatile bool _ThreadShouldExit;
+
+	int _Socket;
+	struct sockaddr_in _RemoteAddr;
+	unsigned _BatchInterval;
+
+	/** guards everything below, the condition wakes up the send thread */
+	pthread_mutex_t _Mutex;
+	pthread_cond_t _Cond;
+
+	std::map<std::string, RemoteTopic> _RemoteTopics;	/**< subscribed by the remote side */
+	std::map<std::string, int32_t> _LocalSubscriptions;	/**< rate of our subscriptions */
+	unsigned _PendingCount;
+	hrt_abstime _NextHousekeeping;
+	UdpTimeSync _TimeSync;
+
+	uint16_t _TxSequence;
+	uint16_t _RxSequence;
+	unsigned _TxPackets;
+	unsigned _TxRecords;
+	unsigned _RxPackets;
+	unsigned _RxRecords;
+	unsigned _RxLost;
+
+	uint8_t _TxBuffer[UdpProtocol::MAX_PACKET_SIZE];
+	uint8_t _RxBuffer[UdpProtocol::MAX_PACKET_SIZE];
+	uint8_t _ControlBuffer[128];
+
+private://class members.
+	static void *recv_thread_start(void *handler);
+	static void *send_thread_start(void *handler);
+
+	void udp_recv_thread();
+	void udp_send_thread();
+
+	void process_packet(unsigned size);
+	void process_add_subscription(const char *name, int32_t rate);
+	void process_remove_subscription(const char *name);
+
+	/** send all due topic updates, returns the time the next one gets due or 0 */
+	hrt_abstime flush(hrt_abstime now);
+	void housekeeping(hrt_abstime now, std::vector<std::string> &expired);
+
+	/** send a single record right away, _Mutex held */
+	int send_control(uint8_t type, const char *name, const void *payload, unsigned length);
+	int send_packet(UdpPacketWriter &packet);
+
+	/* disallow copy */
+	UdpChannel(const UdpChannel &);
+	UdpChannel &operator=(const UdpChannel &);
+};
+
+#endif /* _uORBUdpChannel_hpp_ */
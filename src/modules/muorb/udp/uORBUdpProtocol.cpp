@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBUdpProtocol.hpp"
+
+#include <stddef.h>
+#include <string.h>
+
+using namespace uORB::UdpProtocol;
+
+uORB::UdpPacketWriter::UdpPacketWriter(uint8_t *buffer, unsigned size) :
+	_buffer(buffer),
+	_capacity(size),
+	_size(0),
+	_count(0)
+{
+}
+
+void
+uORB::UdpPacketWriter::begin()
+{
+	Header header;
+	header.magic = MAGIC;
+	header.sequence = 0;
+	header.count = 0;
+	memcpy(_buffer, &header, sizeof(header));
+	_size = sizeof(header);
+	_count = 0;
+}
+
+void
+uORB::UdpPacketWriter::set_sequence(uint16_t sequence)
+{
+	memcpy(&_buffer[offsetof(Header, sequence)], &sequence, sizeof(sequence));
+}
+
+unsigned
+uORB::UdpPacketWriter::record_size(const char *name, unsigned length)
+{
+	return sizeof(RecordHeader) + strlen(name) + length;
+}
+
+bool
+uORB::UdpPacketWriter::add(uint8_t type, const char *name, const void *payload, unsigned length)
+{
+	unsigned name_len = strlen(name);
+
+	if (name_len > MAX_NAME_LEN || length > UINT16_MAX ||
+	    _size + sizeof(RecordHeader) + name_len + length > _capacity) {
+		return false;
+	}
+
+	RecordHeader record;
+	record.type = type;
+	record.name_len = name_len;
+	record.length = length;
+	memcpy(&_buffer[_size], &record, sizeof(record));
+	_size += sizeof(record);
+	memcpy(&_buffer[_size], name, name_len);
+	_size += name_len;
+
+	if (length > 0) {
+		memcpy(&_buffer[_size], payload, length);
+		_size += length;
+	}
+
+	_count++;
+	uint16_t count = _count;
+	memcpy(&_buffer[offsetof(Header, count)], &count, sizeof(count));
+	return true;
+}
+
+bool
+uORB::UdpPacketReader::open(const uint8_t *buffer, unsigned size)
+{
+	Header header;
+
+	if (size < sizeof(header)) {
+		return false;
+	}
+
+	memcpy(&header, buffer, sizeof(header));
+
+	if (header.magic != MAGIC) {
+		return false;
+	}
+
+	_buffer = buffer;
+	_size = size;
+	_offset = sizeof(header);
+	_sequence = header.sequence;
+	_count = header.count;
+	_read = 0;
+	return true;
+}
+
+bool
+uORB::UdpPacketReader::next(Record *record)
+{
+	RecordHeader header;
+
+	if (_read == _count || _offset + sizeof(header) > _size) {
+		return false;
+	}
+
+	memcpy(&header, &_buffer[_offset], sizeof(header));
+
+	if (header.name_len > MAX_NAME_LEN ||
+	    _offset + sizeof(header) + header.name_len + header.length > _size) {
+		return false;
+	}
+
+	_offset += sizeof(header);
+	record->type = header.type;
+	memcpy(record->name, &_buffer[_offset], header.name_len);
+	record->name[header.name_len] = '\0';
+	_offset += header.name_len;
+	record->payload = &_buffer[_offset];
+	record->length = header.length;
+	_offset += header.length;
+	_read++;
+	return true;
+}
+
+uORB::UdpTimeSync::UdpTimeSync()
+{
+	reset();
+}
+
+void
+uORB::UdpTimeSync::reset()
+{
+	_offset = 0;
+	_round_trip = 0;
+	_min_round_trip = 0;
+	_samples = 0;
+}
+
+bool
+uORB::UdpTimeSync::update(hrt_abstime request, hrt_abstime remote, hrt_abstime reply)
+{
+	if (reply < request) {
+		return false;
+	}
+
+	hrt_abstime round_trip = reply - request;
+
+	/* let the shortest round trip age, the link might have become slower */
+	if (_samples == 0 || round_trip < _min_round_trip) {
+		_min_round_trip = round_trip;
+
+	} else {
+		_min_round_trip += _min_round_trip / 64 + 1;
+	}
+
+	if (_samples > 0 && round_trip > 2 * _min_round_trip + 100) {
+		return false;
+	}
+
+	int64_t offset = (int64_t)remote - (int64_t)(request + round_trip / 2);
+
+	if (_samples == 0) {
+		_offset = offset;
+
+	} else {
+		_offset += (offset - _offset) / 8;
+	}
+
+	_round_trip = round_trip;
+	_samples++;
+	return true;
+}
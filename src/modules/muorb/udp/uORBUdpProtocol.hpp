@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file uORBUdpProtocol.hpp
+ * Datagrams of the uORB UDP bridge
+ *
+ * A datagram starts with a header and holds a batch of records, each one a
+ * topic update, a subscription change or a time sync message. Messages are
+ * sent in host byte order and layout, so both sides have to run the same
+ * build on the same architecture.
+ */
+
+#ifndef _uORBUdpProtocol_hpp_
+#define _uORBUdpProtocol_hpp_
+
+#include <stdint.h>
+#include <drivers/drv_hrt.h>
+
+namespace uORB
+{
+class UdpPacketWriter;
+class UdpPacketReader;
+class UdpTimeSync;
+
+namespace UdpProtocol
+{
+static const uint32_t MAGIC = 0x31555275;	/**< "uRU1" */
+static const unsigned MAX_NAME_LEN = 64;
+static const unsigned MAX_PACKET_SIZE = 65000;
+static const unsigned BATCH_SIZE = 1472;	/**< fills an ethernet frame */
+
+enum RecordType {
+	DATA = 1,			/**< topic update */
+	ADD_SUBSCRIPTION = 2,		/**< int32 rate in Hz, 0 for no limit */
+	REMOVE_SUBSCRIPTION = 3,
+	TIME_REQUEST = 4,		/**< uint64 local time of the sender */
+	TIME_REPLY = 5			/**< the request time and uint64 local time of the replier */
+};
+
+struct Header {
+	uint32_t magic;
+	uint16_t sequence;
+	uint16_t count;
+};
+
+struct RecordHeader {
+	uint8_t type;
+	uint8_t name_len;
+	uint16_t length;
+};
+
+struct Record {
+	uint8_t type;
+	char name[MAX_NAME_LEN + 1];
+	const uint8_t *payload;
+	unsigned length;
+};
+}
+}
+
+/**
+ * Packs records into a datagram.
+ */
+class uORB::UdpPacketWriter
+{
+public:
+	UdpPacketWriter(uint8_t *buffer, unsigned size);
+
+	void begin();
+
+	/**
+	 * Number the datagram, right before it is sent.
+	 */
+	void set_sequence(uint16_t sequence);
+
+	/**
+	 * Append a record.
+	 *
+	 * @return false if it does not fit, the datagram is unchanged then
+	 */
+	bool add(uint8_t type, const char *name, const void *payload, unsigned length);
+
+	/**
+	 * Space a record takes.
+	 */
+	static unsigned record_size(const char *name, unsigned length);
+
+	const uint8_t *data() const { return _buffer; }
+	unsigned size() const { return _size; }
+	unsigned count() const { return _count; }
+	bool empty() const { return _count == 0; }
+
+private:
+	uint8_t *_buffer;
+	unsigned _capacity;
+	unsigned _size;
+	unsigned _count;
+};
+
+/**
+ * Iterates over the records of a received datagram.
+ */
+class uORB::UdpPacketReader
+{
+public:
+	/**
+	 * @return false if the header is not valid
+	 */
+	bool open(const uint8_t *buffer, unsigned size);
+
+	uint16_t sequence() const { return _sequence; }
+	unsigned count() const { return _count; }
+
+	/**
+	 * Next record, the payload points into the datagram.
+	 *
+	 * @return false at the end or if the datagram is truncated
+	 */
+	bool next(UdpProtocol::Record *record);
+
+private:
+	const uint8_t *_buffer;
+	unsigned _size;
+	unsigned _offset;
+	uint16_t _sequence;
+	unsigned _count;
+	unsigned _read;
+};
+
+/**
+ * Offset between the clock of the remote side and hrt_absolute_time().
+ *
+ * Estimated from request and reply times like NTP does: the remote time
+ * is assumed to be taken halfway through the round trip. Samples with a
+ * much longer round trip than the shortest one seen are dropped, the
+ * others are low pass filtered.
+ */
+class uORB::UdpTimeSync
+{
+public:
+	UdpTimeSync();
+
+	void reset();
+
+	/**
+	 * @param request	local time the request was sent
+	 * @param remote	remote time in the reply
+	 * @param reply		local time the reply arrived
+	 * @return		false if the sample was dropped
+	 */
+	bool update(hrt_abstime request, hrt_abstime remote, hrt_abstime reply);
+
+	bool valid() const { return _samples > 0; }
+
+	/**
+	 * Remote minus local time in microseconds.
+	 */
+	int64_t offset() const { return _offset; }
+
+	hrt_abstime round_trip() const { return _round_trip; }
+
+	hrt_abstime to_local(hrt_abstime remote) const { return remote - _offset; }
+
+private:
+	int64_t _offset;
+	hrt_abstime _round_trip;
+	hrt_abstime _min_round_trip;
+	unsigned _samples;
+};
+
+#endif /* _uORBUdpProtocol_hpp_ */
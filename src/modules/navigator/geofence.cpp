@@ -70,7 +70,7 @@ Geofence::Geofence() :
 	_last_vertical_range_warning(0),
 	_altitude_min(0),
 	_altitude_max(0),
-	_vertices_count(0),
+	_index(),
 	_param_action(this, "ACTION"),
 	_param_altitude_mode(this, "ALTMODE"),
 	_param_source(this, "SOURCE"),
@@ -194,36 +194,8 @@ bool Geofence::inside_polygon(double lat, double lon, float altitude)
 				return false;
 			}
 
-			/*Horizontal check */
-			/* Adaptation of algorithm originally presented as
-			 * PNPOLY - Point Inclusion in Polygon Test
-			 * W. Randolph Franklin (WRF) */
-
-			bool c = false;
-
-			struct fence_vertex_s temp_vertex_i;
-			struct fence_vertex_s temp_vertex_j;
-
-			/* Red until fence is finished */
-			for (unsigned i = 0, j = _vertices_count - 1; i < _vertices_count; j = i++) {
-				if (dm_read(DM_KEY_FENCE_POINTS, i, &temp_vertex_i, sizeof(struct fence_vertex_s)) != sizeof(struct fence_vertex_s)) {
-					break;
-				}
-
-				if (dm_read(DM_KEY_FENCE_POINTS, j, &temp_vertex_j, sizeof(struct fence_vertex_s)) != sizeof(struct fence_vertex_s)) {
-					break;
-				}
-
-				// skip vertex 0 (return point)
-				if (((double)temp_vertex_i.lon >= lon) != ((double)temp_vertex_j.lon >= lon) &&
-				    (lat <= (double)(temp_vertex_j.lat - temp_vertex_i.lat) * (lon - (double)temp_vertex_i.lon) /
-				     (double)(temp_vertex_j.lon - temp_vertex_i.lon) + (double)temp_vertex_i.lat)) {
-					c = !c;
-				}
-
-			}
-
-			return c;
+			/* Horizontal check against the compiled polygons */
+			return _index.inside(lat, lon);
 
 		} else {
 			/* Empty fence --> accept all points */
@@ -245,8 +217,8 @@ Geofence::valid()
 	}
 
 	// Otherwise
-	if ((_vertices_count < 4) || (_vertices_count > fence_s::GEOFENCE_MAX_VERTICES)) {
-		warnx("Fence must have at least 3 sides and not more than %d", fence_s::GEOFENCE_MAX_VERTICES - 1);
+	if (!_index.valid()) {
+		warnx("Fence polygons must have at least 3 sides");
 		return false;
 	}
 
@@ -263,6 +235,7 @@ Geofence::addPoint(int argc, char *argv[])
 
 	if ((argc == 1) && (strcmp("-clear", argv[0]) == 0)) {
 		dm_clear(DM_KEY_FENCE_POINTS);
+		_index.reset();
 		publishFence(0);
 		return;
 	}
@@ -291,6 +264,7 @@ Geofence::addPoint(int argc, char *argv[])
 
 	if (dm_write(DM_KEY_FENCE_POINTS, ix, DM_PERSIST_POWER_ON_RESET, &vertex, sizeof(vertex)) == sizeof(vertex)) {
 		if (last) {
+			loadFromDm((unsigned)ix + 1);
 			publishFence((unsigned)ix + 1);
 		}
 
@@ -311,6 +285,24 @@ Geofence::publishFence(unsigned vertices)
 	}
 }
 
+int
+Geofence::loadFromDm(unsigned vertices)
+{
+	struct fence_vertex_s vertex;
+
+	_index.reset();
+
+	for (unsigned i = 0; i < vertices; i++) {
+		if (dm_read(DM_KEY_FENCE_POINTS, i, &vertex, sizeof(vertex)) != sizeof(vertex) ||
+		    !_index.addVertex(vertex.lat, vertex.lon)) {
+			_index.reset();
+			return ERROR;
+		}
+	}
+
+	return _index.build() ? OK : ERROR;
+}
+
 int
 Geofence::loadFromFile(const char *filename)
 {
@@ -323,6 +315,7 @@ Geofence::loadFromFile(const char *filename)
 
 	/* Make sure no data is left in the datamanager */
 	clearDm();
+	_index.reset();
 
 	/* open the mixer definition file */
 	fp = fopen(GEOFENCE_FILENAME, "r");
@@ -331,7 +324,8 @@ Geofence::loadFromFile(const char *filename)
 		return ERROR;
 	}
 
-	/* create geofence points from valid lines and store in DM */
+	/* create geofence polygons from valid lines, a line INCLUSION or EXCLUSION
+	 * starts a new polygon, a fence without these is a single inclusion polygon */
 	for (;;) {
 		/* get a line, bail on error/EOF */
 		if (fgets(line, sizeof(line), fp) == NULL) {
@@ -353,7 +347,14 @@ Geofence::loadFromFile(const char *filename)
 			continue;
 		}
 
-		if (gotVertical) {
+		if (gotVertical && (strncmp(&line[textStart], "INCLUSION", 9) == 0 ||
+				    strncmp(&line[textStart], "EXCLUSION", 9) == 0)) {
+			if (!_index.addPolygon(line[textStart] == 'I')) {
+				warnx("Geofence: too many polygons");
+				goto error;
+			}
+
+		} else if (gotVertical) {
 			/* Parse the line as a geofence point */
 			struct fence_vertex_s vertex;
 
@@ -380,7 +381,8 @@ Geofence::loadFromFile(const char *filename)
 				}
 			}
 
-			if (dm_write(DM_KEY_FENCE_POINTS, pointCounter, DM_PERSIST_POWER_ON_RESET, &vertex, sizeof(vertex)) != sizeof(vertex)) {
+			if (!_index.addVertex(vertex.lat, vertex.lon)) {
+				warnx("Geofence: too many vertices");
 				goto error;
 			}
 
@@ -400,18 +402,19 @@ Geofence::loadFromFile(const char *filename)
 	}
 
 	/* Check if import was successful */
-	if (gotVertical && pointCounter > 0) {
-		_vertices_count = pointCounter;
+	if (gotVertical && pointCounter > 0 && _index.build()) {
 		warnx("Geofence: imported successfully");
 		mavlink_log_info(_mavlinkFd, "Geofence imported");
 		rc = OK;
 
-	} else {
-		warnx("Geofence: import error");
-		mavlink_log_critical(_mavlinkFd, "Geofence import error");
+		fclose(fp);
+		return rc;
 	}
 
 error:
+	warnx("Geofence: import error");
+	mavlink_log_critical(_mavlinkFd, "Geofence import error");
+	_index.reset();
 	fclose(fp);
 	return rc;
 }
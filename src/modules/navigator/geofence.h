@@ -51,6 +51,8 @@
 #include <drivers/drv_hrt.h>
 #include <px4_defines.h>
 
+#include "geofence_index.h"
+
 #define GEOFENCE_FILENAME PX4_ROOTFSDIR"/fs/microsd/etc/geofence.txt"
 
 class Geofence : public control::SuperBlock
@@ -97,7 +99,7 @@ public:
 
 	int loadFromFile(const char *filename);
 
-	bool isEmpty() {return _vertices_count == 0;}
+	bool isEmpty() {return _index.empty();}
 
 	int getAltitudeMode() { return _param_altitude_mode.get(); }
 
@@ -119,7 +121,7 @@ private:
 	float _altitude_min;
 	float _altitude_max;
 
-	uint8_t _vertices_count;
+	GeofenceIndex _index;
 
 	/* Params */
 	control::BlockParamInt _param_action;
@@ -136,6 +138,11 @@ private:
 	bool inside(double lat, double lon, float altitude);
 	bool inside(const struct vehicle_global_position_s &global_position);
 	bool inside(const struct vehicle_global_position_s &global_position, float baro_altitude_amsl);
+
+	/**
+	 * Compile the fence from the vertices stored in the datamanager.
+	 */
+	int loadFromDm(unsigned vertices);
 };
 
 
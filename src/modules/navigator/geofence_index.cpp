@@ -0,0 +1,279 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file geofence_index.cpp
+ * Compiled in-memory form of the geofence polygons
+ */
+
+#include "geofence_index.h"
+
+#include <math.h>
+#include <string.h>
+#include <geo/geo.h>
+
+GeofenceIndex::GeofenceIndex() :
+	_lat{},
+	_lon{},
+	_vertex_count(0),
+	_polygons{},
+	_polygon_count(0),
+	_inclusion_mask(0),
+	_ref_lat(0.0),
+	_ref_lon(0.0),
+	_north_scale(0.0f),
+	_east_scale(0.0f),
+	_edges{},
+	_slab_start{},
+	_slab_edges{},
+	_slabs_valid(false),
+	_x_min(0.0f),
+	_x_max(0.0f),
+	_y_min(0.0f),
+	_y_max(0.0f),
+	_slab_scale(0.0f),
+	_valid(true)
+{
+}
+
+void
+GeofenceIndex::reset()
+{
+	_vertex_count = 0;
+	_polygon_count = 0;
+	_inclusion_mask = 0;
+	_slabs_valid = false;
+	_valid = true;
+}
+
+bool
+GeofenceIndex::addPolygon(bool inclusion)
+{
+	if (_polygon_count >= MAX_POLYGONS) {
+		return false;
+	}
+
+	Polygon &p = _polygons[_polygon_count];
+	p.first = _vertex_count;
+	p.count = 0;
+	p.inclusion = inclusion;
+
+	if (inclusion) {
+		_inclusion_mask |= (1 << _polygon_count);
+	}
+
+	_polygon_count++;
+	_valid = false;
+	return true;
+}
+
+bool
+GeofenceIndex::addVertex(float lat, float lon)
+{
+	if (_vertex_count >= MAX_VERTICES) {
+		return false;
+	}
+
+	if (_polygon_count == 0 && !addPolygon(true)) {
+		return false;
+	}
+
+	_lat[_vertex_count] = lat;
+	_lon[_vertex_count] = lon;
+	_vertex_count++;
+	_polygons[_polygon_count - 1].count++;
+	_valid = false;
+	return true;
+}
+
+unsigned
+GeofenceIndex::slab(float y) const
+{
+	int s = (int)((y - _y_min) * _slab_scale);
+
+	if (s < 0) {
+		return 0;
+	}
+
+	if (s >= (int)SLABS) {
+		return SLABS - 1;
+	}
+
+	return s;
+}
+
+bool
+GeofenceIndex::build()
+{
+	_valid = false;
+	_slabs_valid = false;
+
+	if (empty()) {
+		_valid = true;
+		return true;
+	}
+
+	for (unsigned p = 0; p < _polygon_count; p++) {
+		if (_polygons[p].count < MIN_POLYGON_VERTICES) {
+			return false;
+		}
+	}
+
+	/* project around the centre of the fence, the projection is affine in
+	 * lat/lon so the point test gives the same result as on the raw coordinates */
+	float lat_min = _lat[0], lat_max = _lat[0];
+	float lon_min = _lon[0], lon_max = _lon[0];
+
+	for (unsigned i = 1; i < _vertex_count; i++) {
+		lat_min = fminf(lat_min, _lat[i]);
+		lat_max = fmaxf(lat_max, _lat[i]);
+		lon_min = fminf(lon_min, _lon[i]);
+		lon_max = fmaxf(lon_max, _lon[i]);
+	}
+
+	_ref_lat = 0.5 * ((double)lat_min + (double)lat_max);
+	_ref_lon = 0.5 * ((double)lon_min + (double)lon_max);
+	_north_scale = (float)(M_DEG_TO_RAD * CONSTANTS_RADIUS_OF_EARTH);
+	_east_scale = (float)(M_DEG_TO_RAD * CONSTANTS_RADIUS_OF_EARTH * cos(_ref_lat * M_DEG_TO_RAD));
+
+	/* edges from the previous to the current vertex, as in PNPOLY */
+	for (unsigned p = 0; p < _polygon_count; p++) {
+		const Polygon &poly = _polygons[p];
+
+		for (unsigned k = 0; k < poly.count; k++) {
+			unsigned i = poly.first + k;
+			unsigned j = poly.first + ((k == 0) ? poly.count - 1 : k - 1);
+
+			float xi = (float)(((double)_lat[i] - _ref_lat) * _north_scale);
+			float yi = (float)(((double)_lon[i] - _ref_lon) * _east_scale);
+			float xj = (float)(((double)_lat[j] - _ref_lat) * _north_scale);
+			float yj = (float)(((double)_lon[j] - _ref_lon) * _east_scale);
+
+			Edge &e = _edges[i];
+			e.y0 = yi;
+			e.y1 = yj;
+			e.x0 = xi;
+			e.slope = (yj != yi) ? (xj - xi) / (yj - yi) : 0.0f;
+			e.polygon = p;
+
+			if (i == 0) {
+				_x_min = _x_max = xi;
+				_y_min = _y_max = yi;
+
+			} else {
+				_x_min = fminf(_x_min, xi);
+				_x_max = fmaxf(_x_max, xi);
+				_y_min = fminf(_y_min, yi);
+				_y_max = fmaxf(_y_max, yi);
+			}
+		}
+	}
+
+	/* bucket the edges by the east range they span */
+	_slab_scale = (_y_max > _y_min) ? SLABS / (_y_max - _y_min) : 0.0f;
+	memset(_slab_start, 0, sizeof(_slab_start));
+
+	for (unsigned i = 0; i < _vertex_count; i++) {
+		unsigned s0 = slab(fminf(_edges[i].y0, _edges[i].y1));
+		unsigned s1 = slab(fmaxf(_edges[i].y0, _edges[i].y1));
+
+		for (unsigned s = s0; s <= s1; s++) {
+			_slab_start[s + 1]++;
+		}
+	}
+
+	for (unsigned s = 0; s < SLABS; s++) {
+		_slab_start[s + 1] += _slab_start[s];
+	}
+
+	if (_slab_start[SLABS] <= MAX_SLAB_EDGES) {
+		uint16_t fill[SLABS];
+		memcpy(fill, _slab_start, sizeof(fill));
+
+		for (unsigned i = 0; i < _vertex_count; i++) {
+			unsigned s0 = slab(fminf(_edges[i].y0, _edges[i].y1));
+			unsigned s1 = slab(fmaxf(_edges[i].y0, _edges[i].y1));
+
+			for (unsigned s = s0; s <= s1; s++) {
+				_slab_edges[fill[s]++] = i;
+			}
+		}
+
+		_slabs_valid = true;
+	}
+
+	_valid = true;
+	return true;
+}
+
+bool
+GeofenceIndex::inside(double lat, double lon) const
+{
+	if (!_valid || empty()) {
+		/* Empty or invalid fence --> accept all points */
+		return true;
+	}
+
+	const float x = (float)((lat - _ref_lat) * _north_scale);
+	const float y = (float)((lon - _ref_lon) * _east_scale);
+
+	/* one crossing parity bit per polygon */
+	unsigned parity = 0;
+
+	if (x >= _x_min && x <= _x_max && y >= _y_min && y <= _y_max) {
+		if (_slabs_valid) {
+			const unsigned s = slab(y);
+
+			for (unsigned k = _slab_start[s]; k < _slab_start[s + 1]; k++) {
+				const Edge &e = _edges[_slab_edges[k]];
+
+				if (((e.y0 >= y) != (e.y1 >= y)) && (x <= e.slope * (y - e.y0) + e.x0)) {
+					parity ^= (1 << e.polygon);
+				}
+			}
+
+		} else {
+			for (unsigned i = 0; i < _vertex_count; i++) {
+				const Edge &e = _edges[i];
+
+				if (((e.y0 >= y) != (e.y1 >= y)) && (x <= e.slope * (y - e.y0) + e.x0)) {
+					parity ^= (1 << e.polygon);
+				}
+			}
+		}
+	}
+
+	const bool included = (_inclusion_mask == 0) || (parity & _inclusion_mask);
+	const bool excluded = (parity & ~(unsigned)_inclusion_mask) != 0;
+
+	return included && !excluded;
+}
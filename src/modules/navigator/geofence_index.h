@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file geofence_index.h
+ * Compiled in-memory form of the geofence polygons
+ *
+ * The vertices are projected to metres around the centre of the fence and
+ * the edges are bucketed into slabs along the east axis, so a point test
+ * only looks at the edges crossing the slab of the point.
+ */
+
+#ifndef GEOFENCE_INDEX_H_
+#define GEOFENCE_INDEX_H_
+
+#include <stdint.h>
+
+class GeofenceIndex
+{
+public:
+	static const unsigned MAX_VERTICES = 128;	/**< total number of vertices of all polygons */
+	static const unsigned MAX_POLYGONS = 8;
+	static const unsigned MIN_POLYGON_VERTICES = 4;	/**< closed polygon, first vertex repeated */
+
+	GeofenceIndex();
+
+	/**
+	 * Discard all polygons.
+	 */
+	void reset();
+
+	/**
+	 * Start a new polygon, the following vertices are added to it.
+	 *
+	 * @param inclusion true: the vehicle has to stay inside, false: the vehicle has to stay outside
+	 * @return false if there are too many polygons
+	 */
+	bool addPolygon(bool inclusion);
+
+	/**
+	 * Add a vertex to the current polygon. If no polygon was started,
+	 * an inclusion polygon is started.
+	 *
+	 * @return false if there are too many vertices
+	 */
+	bool addVertex(float lat, float lon);
+
+	/**
+	 * Project the vertices and build the edge index. Needs to be called
+	 * after adding the vertices and before testing points.
+	 *
+	 * @return false if a polygon has too few vertices
+	 */
+	bool build();
+
+	/**
+	 * Test a point against the fence.
+	 *
+	 * @return true if the point is inside any inclusion polygon (or there is none)
+	 * and outside all exclusion polygons
+	 */
+	bool inside(double lat, double lon) const;
+
+	bool empty() const { return _vertex_count == 0; }
+
+	bool valid() const { return _valid; }
+
+	unsigned vertexCount() const { return _vertex_count; }
+
+	unsigned polygonCount() const { return _polygon_count; }
+
+private:
+	static const unsigned SLABS = 32;
+	static const unsigned MAX_SLAB_EDGES = 768;
+
+	struct Edge {
+		float y0;		/**< east of the first vertex */
+		float y1;		/**< east of the second vertex */
+		float x0;		/**< north of the first vertex */
+		float slope;		/**< change of north per east */
+		uint8_t polygon;
+	};
+
+	struct Polygon {
+		uint8_t first;		/**< index of the first vertex */
+		uint8_t count;
+		bool inclusion;
+	};
+
+	float _lat[MAX_VERTICES];
+	float _lon[MAX_VERTICES];
+	unsigned _vertex_count;
+
+	Polygon _polygons[MAX_POLYGONS];
+	unsigned _polygon_count;
+	uint8_t _inclusion_mask;	/**< bit set for each inclusion polygon */
+
+	/* projection */
+	double _ref_lat;
+	double _ref_lon;
+	float _north_scale;		/**< metres per degree latitude */
+	float _east_scale;		/**< metres per degree longitude at the reference latitude */
+
+	Edge _edges[MAX_VERTICES];
+
+	/* edges crossing each slab, _slab_edges[_slab_start[s]] to _slab_edges[_slab_start[s + 1]] */
+	uint16_t _slab_start[SLABS + 1];
+	uint8_t _slab_edges[MAX_SLAB_EDGES];
+	bool _slabs_valid;		/**< false if the slab table overflowed, all edges are tested then */
+
+	float _x_min, _x_max;
+	float _y_min, _y_max;
+	float _slab_scale;		/**< slabs per metre east */
+
+	bool _valid;
+
+	unsigned slab(float y) const;
+};
+
+#endif /* GEOFENCE_INDEX_H_ */
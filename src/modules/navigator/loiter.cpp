@@ -92,3 +92,10 @@ void
 Loiter::on_active()
 {
 }
+
+unsigned
+Loiter::get_update_interval()
+{
+	/* the setpoint is held, no need to follow the position */
+	return 0;
+}
@@ -60,6 +60,8 @@ public:
 
 	virtual void on_active();
 
+	virtual unsigned get_update_interval();
+
 private:
 	control::BlockParamFloat _param_min_alt;
 };
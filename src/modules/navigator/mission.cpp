@@ -81,6 +81,8 @@ Mission::Mission(Navigator *navigator, const char *name) :
 	_inited(false),
 	_home_inited(false),
 	_missionFeasiblityChecker(),
+	_geometry(),
+	_current_sp_index(-1),
 	_min_current_sp_distance_xy(FLT_MAX),
 	_mission_item_previous_alt(NAN),
   	_on_arrival_yaw(NAN),
@@ -97,6 +99,9 @@ Mission::~Mission()
 void
 Mission::on_inactive()
 {
+	/* other modes take over the setpoint triplet */
+	_current_sp_index = -1;
+
 	if (_inited) {
 		/* check if missions have changed so that feedback to ground station is given */
 		bool onboard_updated = false;
@@ -250,15 +255,12 @@ Mission::update_offboard_mission()
 			/* otherwise, just leave it */
 		}
 
+		/* the item indices of the old mission are meaningless now */
+		_current_sp_index = -1;
+
 		/* Check mission feasibility, for now do not handle the return value,
 		 * however warnings are issued to the gcs via mavlink from inside the MissionFeasiblityChecker */
-		dm_item_t dm_current = DM_KEY_WAYPOINTS_OFFBOARD(_offboard_mission.dataman_id);
-
-		failed = !_missionFeasiblityChecker.checkMissionFeasible(_navigator->get_mavlink_fd(), _navigator->get_vstatus()->is_rotary_wing,
-				dm_current, (size_t) _offboard_mission.count, _navigator->get_geofence(),
-				_navigator->get_home_position()->alt, _navigator->home_position_valid(),
-				_navigator->get_global_position()->lat, _navigator->get_global_position()->lon,
-				_param_dist_1wp.get(), _navigator->get_mission_result()->warning);
+		failed = !check_offboard_mission();
 
 		_navigator->get_mission_result()->valid = !failed;
 		_navigator->increment_mission_instance_count();
@@ -327,6 +329,9 @@ Mission::set_mission_items()
 	/* set previous position setpoint to current */
 	set_previous_pos_setpoint();
 
+	int previous_sp_index = _current_sp_index;
+	_current_sp_index = -1;
+
 	/* Copy previous mission item altitude (can be extended to a copy of the full mission item if needed) */
 	if (pos_sp_triplet->previous.valid) {
 		_mission_item_previous_alt = get_absolute_altitude_for_item(_mission_item);
@@ -468,6 +473,10 @@ Mission::set_mission_items()
 	/* set current position setpoint from mission item */
 	mission_item_to_position_setpoint(&_mission_item, &pos_sp_triplet->current);
 
+	if (_mission_type == MISSION_TYPE_OFFBOARD) {
+		_current_sp_index = _current_offboard_mission_index;
+	}
+
 	/* require takeoff after landing or idle */
 	if (pos_sp_triplet->current.type == position_setpoint_s::SETPOINT_TYPE_LAND || pos_sp_triplet->current.type == position_setpoint_s::SETPOINT_TYPE_IDLE) {
 		_need_takeoff = true;
@@ -500,10 +509,17 @@ Mission::set_mission_items()
 
 	/* Save the distance between the current sp and the previous one */
 	if (pos_sp_triplet->current.valid && pos_sp_triplet->previous.valid) {
-		_distance_current_previous = get_distance_to_next_waypoint(pos_sp_triplet->current.lat,
-				pos_sp_triplet->current.lon,
-				pos_sp_triplet->previous.lat,
-				pos_sp_triplet->previous.lon);
+		if (previous_sp_index >= 0 && _current_sp_index >= 0 &&
+		    _geometry.hasLeg(previous_sp_index, _current_sp_index)) {
+			/* flying a leg of the mission, the length is known since the upload */
+			_distance_current_previous = _geometry.entry(_current_sp_index).leg_distance;
+
+		} else {
+			_distance_current_previous = get_distance_to_next_waypoint(pos_sp_triplet->current.lat,
+					pos_sp_triplet->current.lon,
+					pos_sp_triplet->previous.lat,
+					pos_sp_triplet->previous.lon);
+		}
 	}
 
 	_navigator->set_position_setpoint_triplet_updated();
@@ -536,21 +552,21 @@ Mission::heading_sp_update()
 		_mission_item.yaw = _on_arrival_yaw;
 	/* always keep the front of the rotary wing pointing to the next waypoint */
 	} else if (_param_yawmode.get() == MISSION_YAWMODE_FRONT_TO_WAYPOINT) {
-		_mission_item.yaw = get_bearing_to_next_waypoint(
+		_mission_item.yaw = get_bearing_to_next_waypoint_fast(
 		        _navigator->get_global_position()->lat,
 		        _navigator->get_global_position()->lon,
 		        _mission_item.lat,
 		        _mission_item.lon);
 	/* always keep the back of the rotary wing pointing towards home */
 	} else if (_param_yawmode.get() == MISSION_YAWMODE_FRONT_TO_HOME) {
-		_mission_item.yaw = get_bearing_to_next_waypoint(
+		_mission_item.yaw = get_bearing_to_next_waypoint_fast(
 		        _navigator->get_global_position()->lat,
 		        _navigator->get_global_position()->lon,
 		        _navigator->get_home_position()->lat,
 		        _navigator->get_home_position()->lon);
 	/* always keep the back of the rotary wing pointing towards home */
 	} else if (_param_yawmode.get() == MISSION_YAWMODE_BACK_TO_HOME) {
-		_mission_item.yaw = _wrap_pi(get_bearing_to_next_waypoint(
+		_mission_item.yaw = _wrap_pi(get_bearing_to_next_waypoint_fast(
 		        _navigator->get_global_position()->lat,
 		        _navigator->get_global_position()->lon,
 		        _navigator->get_home_position()->lat,
@@ -586,7 +602,7 @@ Mission::altitude_sp_foh_update()
 
 
 	/* Calculate distance to current waypoint */
-	float d_current = get_distance_to_next_waypoint(_mission_item.lat, _mission_item.lon,
+	float d_current = get_distance_to_next_waypoint_fast(_mission_item.lat, _mission_item.lon,
 			_navigator->get_global_position()->lat, _navigator->get_global_position()->lon);
 
 	/* Save distance to waypoint if it is the smallest ever achieved, however make sure that
@@ -808,13 +824,7 @@ Mission::check_mission_valid()
 	/* check if the home position became valid in the meantime */
 	if (!_home_inited && _navigator->home_position_valid()) {
 
-		dm_item_t dm_current = DM_KEY_WAYPOINTS_OFFBOARD(_offboard_mission.dataman_id);
-
-		_navigator->get_mission_result()->valid = _missionFeasiblityChecker.checkMissionFeasible(_navigator->get_mavlink_fd(), _navigator->get_vstatus()->is_rotary_wing,
-				dm_current, (size_t) _offboard_mission.count, _navigator->get_geofence(),
-				_navigator->get_home_position()->alt, _navigator->home_position_valid(),
-				_navigator->get_global_position()->lat, _navigator->get_global_position()->lon,
-				_param_dist_1wp.get(), _navigator->get_mission_result()->warning);
+		_navigator->get_mission_result()->valid = check_offboard_mission();
 
 		_navigator->increment_mission_instance_count();
 		_navigator->set_mission_result_updated();
@@ -824,3 +834,19 @@ Mission::check_mission_valid()
 
 	return _navigator->get_mission_result()->valid;
 }
+
+bool
+Mission::check_offboard_mission()
+{
+	dm_item_t dm_current = DM_KEY_WAYPOINTS_OFFBOARD(_offboard_mission.dataman_id);
+
+	/* only items that changed since the last update are recomputed,
+	 * a failed update is reported by the feasibility check */
+	_geometry.update(dm_current, _offboard_mission.count);
+
+	return _missionFeasiblityChecker.checkMissionFeasible(_navigator->get_mavlink_fd(), _navigator->get_vstatus()->is_rotary_wing,
+			(size_t) _offboard_mission.count, _geometry, _navigator->get_geofence(),
+			_navigator->get_home_position()->alt, _navigator->home_position_valid(),
+			_navigator->get_global_position()->lat, _navigator->get_global_position()->lon,
+			_param_dist_1wp.get(), _navigator->get_mission_result()->warning);
+}
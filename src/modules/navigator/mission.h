@@ -63,6 +63,7 @@
 #include "navigator_mode.h"
 #include "mission_block.h"
 #include "mission_feasibility_checker.h"
+#include "mission_geometry.h"
 
 class Navigator;
 
@@ -171,6 +172,11 @@ private:
 	 */
 	bool check_mission_valid();
 
+	/**
+	 * Update the geometry of the offboard mission and check its feasibility
+	 */
+	bool check_offboard_mission();
+
 	control::BlockParamInt _param_onboard_enabled;
 	control::BlockParamFloat _param_takeoff_alt;
 	control::BlockParamFloat _param_dist_1wp;
@@ -195,6 +201,8 @@ private:
 	bool _home_inited;
 
 	MissionFeasibilityChecker _missionFeasiblityChecker; /**< class that checks if a mission is feasible */
+	MissionGeometry _geometry; /**< legs and per item checks of the offboard mission */
+	int _current_sp_index; /**< offboard mission item of the current sp in pos_sp_triplet, -1 if it is no mission item */
 
 	float _min_current_sp_distance_xy; /**< minimum distance which was achieved to the current waypoint  */
 	float _mission_item_previous_alt; /**< holds the altitude of the previous mission item,
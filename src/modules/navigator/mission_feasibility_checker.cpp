@@ -60,9 +60,8 @@ MissionFeasibilityChecker::MissionFeasibilityChecker() :
 	_nav_caps = {0};
 }
 
-
 bool MissionFeasibilityChecker::checkMissionFeasible(int mavlink_fd, bool isRotarywing,
-	dm_item_t dm_current, size_t nMissionItems, Geofence &geofence,
+	size_t nMissionItems, const MissionGeometry &geometry, Geofence &geofence,
 	float home_alt, bool home_valid, double curr_lat, double curr_lon, float max_waypoint_distance, bool &warning_issued)
 {
 	bool failed = false;
@@ -78,18 +77,18 @@ bool MissionFeasibilityChecker::checkMissionFeasible(int mavlink_fd, bool isRota
 		warned = true;
 		mavlink_log_info(_mavlink_fd, "Not yet ready for mission, no position lock.");
 	} else {
-		failed = failed || !check_dist_1wp(dm_current, nMissionItems, curr_lat, curr_lon, max_waypoint_distance, warning_issued);
+		failed = failed || !check_dist_1wp(nMissionItems, geometry, curr_lat, curr_lon, max_waypoint_distance, warning_issued);
 	}
 
 	// check if all mission item commands are supported
-	failed = failed || !checkMissionItemValidity(dm_current, nMissionItems);
-	failed = failed || !checkGeofence(dm_current, nMissionItems, geofence);
-	failed = failed || !checkHomePositionAltitude(dm_current, nMissionItems, home_alt, home_valid, warned);
+	failed = failed || !checkMissionItemValidity(nMissionItems, geometry);
+	failed = failed || !checkGeofence(geometry, geofence);
+	failed = failed || !checkHomePositionAltitude(geometry, home_alt, home_valid, warned);
 
 	if (isRotarywing) {
-		failed = failed || !checkMissionFeasibleRotarywing(dm_current, nMissionItems, geofence, home_alt, home_valid);
+		failed = failed || !checkMissionFeasibleRotarywing(geometry, geofence, home_alt, home_valid);
 	} else {
-		failed = failed || !checkMissionFeasibleFixedwing(dm_current, nMissionItems, geofence, home_alt, home_valid);
+		failed = failed || !checkMissionFeasibleFixedwing(geometry);
 	}
 
 	if (!failed) {
@@ -99,38 +98,32 @@ bool MissionFeasibilityChecker::checkMissionFeasible(int mavlink_fd, bool isRota
 	return !failed;
 }
 
-bool MissionFeasibilityChecker::checkMissionFeasibleRotarywing(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid)
+bool MissionFeasibilityChecker::checkMissionFeasibleRotarywing(const MissionGeometry &geometry, Geofence &geofence, float home_alt, bool home_valid)
 {
 	/* no custom rotary wing checks yet */
 	return true;
 }
 
-bool MissionFeasibilityChecker::checkMissionFeasibleFixedwing(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid)
+bool MissionFeasibilityChecker::checkMissionFeasibleFixedwing(const MissionGeometry &geometry)
 {
 	/* Update fixed wing navigation capabilites */
 	updateNavigationCapabilities();
 
 	/* Perform checks and issue feedback to the user for all checks */
-	bool resLanding = checkFixedWingLanding(dm_current, nMissionItems);
+	bool resLanding = checkFixedWingLanding(geometry);
 
 	/* Mission is only marked as feasible if all checks return true */
 	return resLanding;
 }
 
-bool MissionFeasibilityChecker::checkGeofence(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence)
+bool MissionFeasibilityChecker::checkGeofence(const MissionGeometry &geometry, Geofence &geofence)
 {
 	/* Check if all mission items are inside the geofence (if we have a valid geofence) */
 	if (geofence.valid()) {
-		for (size_t i = 0; i < nMissionItems; i++) {
-			struct mission_item_s missionitem;
-			const ssize_t len = sizeof(missionitem);
-
-			if (dm_read(dm_current, i, &missionitem, len) != len) {
-				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-				return false;
-			}
+		for (size_t i = 0; i < geometry.count(); i++) {
+			const MissionGeometry::Entry &entry = geometry.entry(i);
 
-			if (!geofence.inside_polygon(missionitem.lat, missionitem.lon, missionitem.altitude)) {
+			if (!geofence.inside_polygon(entry.lat, entry.lon, entry.altitude)) {
 				mavlink_log_critical(_mavlink_fd, "Geofence violation for waypoint %d", i);
 				return false;
 			}
@@ -140,29 +133,23 @@ bool MissionFeasibilityChecker::checkGeofence(dm_item_t dm_current, size_t nMiss
 	return true;
 }
 
-bool MissionFeasibilityChecker::checkHomePositionAltitude(dm_item_t dm_current, size_t nMissionItems,
+bool MissionFeasibilityChecker::checkHomePositionAltitude(const MissionGeometry &geometry,
 	float home_alt, bool home_valid, bool &warning_issued, bool throw_error)
 {
 	/* Check if all all waypoints are above the home altitude, only return false if bool throw_error = true */
-	for (size_t i = 0; i < nMissionItems; i++) {
-		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(struct mission_item_s);
-
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
-			warning_issued = true;
-			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-			return false;
-		}
+	for (size_t i = 0; i < geometry.count(); i++) {
+		const MissionGeometry::Entry &entry = geometry.entry(i);
+		const bool altitude_is_relative = (entry.flags & MissionGeometry::ITEM_ALT_RELATIVE) != 0;
 
 		/* always reject relative alt without home set */
-		if (missionitem.altitude_is_relative && !home_valid) {
+		if (altitude_is_relative && !home_valid) {
 			mavlink_log_critical(_mavlink_fd, "Rejecting Mission: No home pos, WP %d uses rel alt", i);
 			warning_issued = true;
 			return false;
 		}
 
 		/* calculate the global waypoint altitude */
-		float wp_alt = (missionitem.altitude_is_relative) ? missionitem.altitude + home_alt : missionitem.altitude;
+		float wp_alt = (altitude_is_relative) ? entry.altitude + home_alt : entry.altitude;
 
 		if (home_alt > wp_alt) {
 
@@ -181,61 +168,35 @@ bool MissionFeasibilityChecker::checkHomePositionAltitude(dm_item_t dm_current,
 	return true;
 }
 
-bool MissionFeasibilityChecker::checkMissionItemValidity(dm_item_t dm_current, size_t nMissionItems) {
-	// do not allow mission if we find unsupported item
-	for (size_t i = 0; i < nMissionItems; i++) {
-		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(struct mission_item_s);
-
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
-			// not supposed to happen unless the datamanager can't access the SD card, etc.
-			mavlink_log_critical(_mavlink_fd, "Rejecting Mission: Cannot access SD card");
-			return false;
-		}
+bool MissionFeasibilityChecker::checkMissionItemValidity(size_t nMissionItems, const MissionGeometry &geometry) {
+	if (geometry.count() != nMissionItems) {
+		// not supposed to happen unless the datamanager can't access the SD card, etc.
+		mavlink_log_critical(_mavlink_fd, "Rejecting Mission: Cannot access SD card");
+		return false;
+	}
 
-		// check if we find unsupported item and reject mission if so
-		if (missionitem.nav_cmd != NAV_CMD_IDLE &&
-			missionitem.nav_cmd != NAV_CMD_WAYPOINT &&
-			missionitem.nav_cmd != NAV_CMD_LOITER_UNLIMITED &&
-			missionitem.nav_cmd != NAV_CMD_LOITER_TURN_COUNT &&
-			missionitem.nav_cmd != NAV_CMD_LOITER_TIME_LIMIT &&
-			missionitem.nav_cmd != NAV_CMD_LAND &&
-			missionitem.nav_cmd != NAV_CMD_TAKEOFF &&
-			missionitem.nav_cmd != NAV_CMD_ROI &&
-			missionitem.nav_cmd != NAV_CMD_PATHPLANNING &&
-			missionitem.nav_cmd != NAV_CMD_DO_JUMP &&
-			missionitem.nav_cmd != NAV_CMD_DO_SET_SERVO) {
-
-			mavlink_log_critical(_mavlink_fd, "Rejecting mission item %i: unsupported action.", (int)(i+1));
-			return false;
-		}
+	// do not allow mission if we find unsupported item
+	if (geometry.firstUnsupported() >= 0) {
+		mavlink_log_critical(_mavlink_fd, "Rejecting mission item %i: unsupported action.", geometry.firstUnsupported() + 1);
+		return false;
 	}
+
 	return true;
 }
 
-bool MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size_t nMissionItems)
+bool MissionFeasibilityChecker::checkFixedWingLanding(const MissionGeometry &geometry)
 {
 	/* Go through all mission items and search for a landing waypoint
 	 * if landing waypoint is found: the previous waypoint is checked to be at a feasible distance and altitude given the landing slope */
 
-
-	for (size_t i = 0; i < nMissionItems; i++) {
-		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
-			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-			return false;
-		}
-
-		if (missionitem.nav_cmd == NAV_CMD_LAND) {
-			struct mission_item_s missionitem_previous;
+	for (size_t i = 0; i < geometry.count(); i++) {
+		if (geometry.entry(i).nav_cmd == NAV_CMD_LAND) {
 			if (i != 0) {
-				if (dm_read(dm_current, i-1, &missionitem_previous, len) != len) {
-					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
-					return false;
-				}
+				const MissionGeometry::Entry &missionitem = geometry.entry(i);
+				const MissionGeometry::Entry &missionitem_previous = geometry.entry(i - 1);
 
-				float wp_distance = get_distance_to_next_waypoint(missionitem_previous.lat , missionitem_previous.lon, missionitem.lat, missionitem.lon);
+				float wp_distance = geometry.hasLeg(i - 1, i) ? missionitem.leg_distance :
+						    get_distance_to_next_waypoint(missionitem_previous.lat , missionitem_previous.lon, missionitem.lat, missionitem.lon);
 				float slope_alt_req = Landingslope::getLandingSlopeAbsoluteAltitude(wp_distance, missionitem.altitude, _nav_caps.landing_horizontal_slope_displacement, _nav_caps.landing_slope_angle_rad);
 				float wp_distance_req = Landingslope::getLandingSlopeWPDistance(missionitem_previous.altitude, missionitem.altitude, _nav_caps.landing_horizontal_slope_displacement, _nav_caps.landing_slope_angle_rad);
 				float delta_altitude = missionitem.altitude - missionitem_previous.altitude;
@@ -282,7 +243,7 @@ bool MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size
 }
 
 bool
-MissionFeasibilityChecker::check_dist_1wp(dm_item_t dm_current, size_t nMissionItems, double curr_lat, double curr_lon, float dist_first_wp, bool &warning_issued)
+MissionFeasibilityChecker::check_dist_1wp(size_t nMissionItems, const MissionGeometry &geometry, double curr_lat, double curr_lon, float dist_first_wp, bool &warning_issued)
 {
 	if (_dist_1wp_ok) {
 		/* always return true after at least one successful check */
@@ -291,61 +252,53 @@ MissionFeasibilityChecker::check_dist_1wp(dm_item_t dm_current, size_t nMissionI
 
 	/* check if first waypoint is not too far from home */
 	if (dist_first_wp > 0.0f) {
-		struct mission_item_s mission_item;
-
-		/* find first waypoint (with lat/lon) item in datamanager */
-		for (unsigned i = 0; i < nMissionItems; i++) {
-			if (dm_read(dm_current, i,
-					&mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s)) {
-				/* Check non navigation item */
-				if (mission_item.nav_cmd == NAV_CMD_DO_SET_SERVO){
-
-					/* check actuator number */
-					if (mission_item.actuator_num < 0 || mission_item.actuator_num > 5) {
-						mavlink_log_critical(_mavlink_fd, "Actuator number %d is out of bounds 0..5", (int)mission_item.actuator_num);
-						warning_issued = true;
-						return false;
-					}
-					/* check actuator value */
-					if (mission_item.actuator_value < -2000 || mission_item.actuator_value > 2000) {
-						mavlink_log_critical(_mavlink_fd, "Actuator value %d is out of bounds -2000..2000", (int)mission_item.actuator_value);
-						warning_issued = true;
-						return false;
-					}
-				}
-				/* check only items with valid lat/lon */
-				else if ( mission_item.nav_cmd == NAV_CMD_WAYPOINT ||
-						mission_item.nav_cmd == NAV_CMD_LOITER_TIME_LIMIT ||
-						mission_item.nav_cmd == NAV_CMD_LOITER_TURN_COUNT ||
-						mission_item.nav_cmd == NAV_CMD_LOITER_UNLIMITED ||
-						mission_item.nav_cmd == NAV_CMD_TAKEOFF ||
-						mission_item.nav_cmd == NAV_CMD_PATHPLANNING) {
-
-					/* check distance from current position to item */
-					float dist_to_1wp = get_distance_to_next_waypoint(
-							mission_item.lat, mission_item.lon, curr_lat, curr_lon);
-
-					if (dist_to_1wp < dist_first_wp) {
-						_dist_1wp_ok = true;
-						if (dist_to_1wp > ((dist_first_wp * 3) / 2)) {
-							/* allow at 2/3 distance, but warn */
-							mavlink_log_critical(_mavlink_fd, "Warning: First waypoint very far: %d m", (int)dist_to_1wp);
-							warning_issued = true;
-						}
-						return true;
+		if (geometry.count() != nMissionItems) {
+			/* error reading, mission is invalid */
+			mavlink_log_info(_mavlink_fd, "error reading offboard mission");
+			return false;
+		}
 
-					} else {
-						/* item is too far from home */
-						mavlink_log_critical(_mavlink_fd, "First waypoint too far: %d m,refusing mission", (int)dist_to_1wp, (int)dist_first_wp);
+		/* find first waypoint (with lat/lon) item */
+		for (unsigned i = 0; i < geometry.count(); i++) {
+			const MissionGeometry::Entry &mission_item = geometry.entry(i);
+
+			/* Check non navigation item */
+			if (mission_item.nav_cmd == NAV_CMD_DO_SET_SERVO) {
+
+				/* check actuator number and value, items before the first waypoint are checked in order */
+				if ((int)i == geometry.firstActuatorError()) {
+					mavlink_log_critical(_mavlink_fd, "Actuator of item %d is out of bounds 0..5, -2000..2000", i + 1);
+					warning_issued = true;
+					return false;
+				}
+			}
+			/* check only items with valid lat/lon */
+			else if ( mission_item.nav_cmd == NAV_CMD_WAYPOINT ||
+					mission_item.nav_cmd == NAV_CMD_LOITER_TIME_LIMIT ||
+					mission_item.nav_cmd == NAV_CMD_LOITER_TURN_COUNT ||
+					mission_item.nav_cmd == NAV_CMD_LOITER_UNLIMITED ||
+					mission_item.nav_cmd == NAV_CMD_TAKEOFF ||
+					mission_item.nav_cmd == NAV_CMD_PATHPLANNING) {
+
+				/* check distance from current position to item */
+				float dist_to_1wp = get_distance_to_next_waypoint(
+						mission_item.lat, mission_item.lon, curr_lat, curr_lon);
+
+				if (dist_to_1wp < dist_first_wp) {
+					_dist_1wp_ok = true;
+					if (dist_to_1wp > ((dist_first_wp * 3) / 2)) {
+						/* allow at 2/3 distance, but warn */
+						mavlink_log_critical(_mavlink_fd, "Warning: First waypoint very far: %d m", (int)dist_to_1wp);
 						warning_issued = true;
-						return false;
 					}
-				}
+					return true;
 
-			} else {
-				/* error reading, mission is invalid */
-				mavlink_log_info(_mavlink_fd, "error reading offboard mission");
-				return false;
+				} else {
+					/* item is too far from home */
+					mavlink_log_critical(_mavlink_fd, "First waypoint too far: %d m,refusing mission", (int)dist_to_1wp, (int)dist_first_wp);
+					warning_issued = true;
+					return false;
+				}
 			}
 		}
 
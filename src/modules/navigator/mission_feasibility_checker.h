@@ -46,6 +46,7 @@
 #include <uORB/topics/navigation_capabilities.h>
 #include <dataman/dataman.h>
 #include "geofence.h"
+#include "mission_geometry.h"
 
 
 class MissionFeasibilityChecker
@@ -61,28 +62,29 @@ private:
 	void init();
 
 	/* Checks for all airframes */
-	bool checkGeofence(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence);
-	bool checkHomePositionAltitude(dm_item_t dm_current, size_t nMissionItems, float home_alt, bool home_valid, bool &warning_issued, bool throw_error = false);
-	bool checkMissionItemValidity(dm_item_t dm_current, size_t nMissionItems);
-	bool check_dist_1wp(dm_item_t dm_current, size_t nMissionItems, double curr_lat, double curr_lon, float dist_first_wp, bool &warning_issued);
+	bool checkGeofence(const MissionGeometry &geometry, Geofence &geofence);
+	bool checkHomePositionAltitude(const MissionGeometry &geometry, float home_alt, bool home_valid, bool &warning_issued, bool throw_error = false);
+	bool checkMissionItemValidity(size_t nMissionItems, const MissionGeometry &geometry);
+	bool check_dist_1wp(size_t nMissionItems, const MissionGeometry &geometry, double curr_lat, double curr_lon, float dist_first_wp, bool &warning_issued);
 
 	/* Checks specific to fixedwing airframes */
-	bool checkMissionFeasibleFixedwing(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid);
-	bool checkFixedWingLanding(dm_item_t dm_current, size_t nMissionItems);
+	bool checkMissionFeasibleFixedwing(const MissionGeometry &geometry);
+	bool checkFixedWingLanding(const MissionGeometry &geometry);
 	void updateNavigationCapabilities();
 
 	/* Checks specific to rotarywing airframes */
-	bool checkMissionFeasibleRotarywing(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid);
+	bool checkMissionFeasibleRotarywing(const MissionGeometry &geometry, Geofence &geofence, float home_alt, bool home_valid);
 public:
 
 	MissionFeasibilityChecker();
 	~MissionFeasibilityChecker() {}
 
 	/*
-	 * Returns true if mission is feasible and false otherwise
+	 * Returns true if mission is feasible and false otherwise,
+	 * geometry needs to be up to date with the stored mission
 	 */
-	bool checkMissionFeasible(int mavlink_fd, bool isRotarywing, dm_item_t dm_current,
-		size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid,
+	bool checkMissionFeasible(int mavlink_fd, bool isRotarywing,
+		size_t nMissionItems, const MissionGeometry &geometry, Geofence &geofence, float home_alt, bool home_valid,
 		double curr_lat, double curr_lon, float max_waypoint_distance, bool &warning_issued);
 
 };
@@ -0,0 +1,247 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file mission_geometry.cpp
+ * Geometry and feasibility data of the stored mission
+ */
+
+#include "mission_geometry.h"
+
+#include <crc32.h>
+
+MissionGeometry::MissionGeometry() :
+	_entries{},
+	_count(0),
+	_first_unsupported(-1),
+	_first_actuator_error(-1),
+	_index(0),
+	_recomputed(0),
+	_previous(-1),
+	_previous_changed(false),
+	_block{}
+{
+}
+
+bool MissionGeometry::hasPosition(unsigned nav_cmd)
+{
+	switch (nav_cmd) {
+	case NAV_CMD_WAYPOINT:
+	case NAV_CMD_LOITER_UNLIMITED:
+	case NAV_CMD_LOITER_TURN_COUNT:
+	case NAV_CMD_LOITER_TIME_LIMIT:
+	case NAV_CMD_LAND:
+	case NAV_CMD_TAKEOFF:
+	case NAV_CMD_PATHPLANNING:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+static bool isSupported(unsigned nav_cmd)
+{
+	switch (nav_cmd) {
+	case NAV_CMD_IDLE:
+	case NAV_CMD_WAYPOINT:
+	case NAV_CMD_LOITER_UNLIMITED:
+	case NAV_CMD_LOITER_TURN_COUNT:
+	case NAV_CMD_LOITER_TIME_LIMIT:
+	case NAV_CMD_LAND:
+	case NAV_CMD_TAKEOFF:
+	case NAV_CMD_ROI:
+	case NAV_CMD_PATHPLANNING:
+	case NAV_CMD_DO_JUMP:
+	case NAV_CMD_DO_SET_SERVO:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/* checksum of an item field by field, the padding between them is whatever the writer of the item left there */
+static uint32_t itemCrc(const struct mission_item_s &item)
+{
+	uint32_t crc = 0;
+
+#define ITEM_CRC_FIELD(field) crc = crc32part((const uint8_t *)&item.field, sizeof(item.field), crc)
+	ITEM_CRC_FIELD(altitude_is_relative);
+	ITEM_CRC_FIELD(lat);
+	ITEM_CRC_FIELD(lon);
+	ITEM_CRC_FIELD(altitude);
+	ITEM_CRC_FIELD(yaw);
+	ITEM_CRC_FIELD(loiter_radius);
+	ITEM_CRC_FIELD(loiter_direction);
+	ITEM_CRC_FIELD(nav_cmd);
+	ITEM_CRC_FIELD(acceptance_radius);
+	ITEM_CRC_FIELD(time_inside);
+	ITEM_CRC_FIELD(pitch_min);
+	ITEM_CRC_FIELD(autocontinue);
+	ITEM_CRC_FIELD(origin);
+	ITEM_CRC_FIELD(do_jump_mission_index);
+	ITEM_CRC_FIELD(do_jump_repeat_count);
+	/* not do_jump_current_count, the navigator counts DO_JUMP repetitions in the stored item */
+	ITEM_CRC_FIELD(actuator_num);
+	ITEM_CRC_FIELD(actuator_value);
+#undef ITEM_CRC_FIELD
+
+	return crc;
+}
+
+void MissionGeometry::reset()
+{
+	_count = 0;
+	_first_unsupported = -1;
+	_first_actuator_error = -1;
+}
+
+int MissionGeometry::update(dm_item_t dm_item, unsigned count)
+{
+	if (count > MAX_ITEMS) {
+		reset();
+		return -1;
+	}
+
+	begin();
+
+	for (unsigned first = 0; first < count; first += READ_BLOCK) {
+		unsigned n = count - first;
+
+		if (n > READ_BLOCK) {
+			n = READ_BLOCK;
+		}
+
+		if (dm_read_range(dm_item, first, _block, n, sizeof(struct mission_item_s)) != (ssize_t)n) {
+			/* the entries are partially updated, start over next time */
+			reset();
+			return -1;
+		}
+
+		for (unsigned i = 0; i < n; i++) {
+			add(_block[i]);
+		}
+	}
+
+	return end();
+}
+
+void MissionGeometry::begin()
+{
+	_index = 0;
+	_recomputed = 0;
+	_previous = -1;
+	_previous_changed = false;
+	_first_unsupported = -1;
+	_first_actuator_error = -1;
+}
+
+bool MissionGeometry::add(const struct mission_item_s &item)
+{
+	if (_index >= MAX_ITEMS) {
+		return false;
+	}
+
+	const uint32_t crc = itemCrc(item);
+
+	Entry &e = _entries[_index];
+	const bool changed = (_index >= _count) || e.crc != crc;
+	const bool position = hasPosition(item.nav_cmd);
+
+	const bool want_leg = position && _previous >= 0;
+	const bool leg_stale = want_leg && (changed || _previous_changed || !(e.flags & ITEM_LEG) || e.leg_start != _previous);
+
+	if (changed) {
+		e.crc = crc;
+		e.lat = item.lat;
+		e.lon = item.lon;
+		e.altitude = item.altitude;
+		e.nav_cmd = item.nav_cmd;
+		e.flags &= ITEM_LEG;
+
+		if (position) {
+			e.flags |= ITEM_POSITION;
+		}
+
+		if (item.altitude_is_relative) {
+			e.flags |= ITEM_ALT_RELATIVE;
+		}
+
+		if (isSupported(item.nav_cmd)) {
+			e.flags |= ITEM_SUPPORTED;
+		}
+
+		if (item.nav_cmd != NAV_CMD_DO_SET_SERVO ||
+		    (item.actuator_num >= 0 && item.actuator_num <= 5 &&
+		     item.actuator_value >= -2000 && item.actuator_value <= 2000)) {
+			e.flags |= ITEM_ACTUATOR_OK;
+		}
+	}
+
+	if (leg_stale) {
+		const Entry &start = _entries[_previous];
+		e.leg_distance = get_distance_to_next_waypoint(start.lat, start.lon, e.lat, e.lon);
+		e.leg_start = _previous;
+		e.flags |= ITEM_LEG;
+
+	} else if (!want_leg) {
+		e.leg_distance = 0.0f;
+		e.flags &= ~ITEM_LEG;
+	}
+
+	if (changed || leg_stale) {
+		_recomputed++;
+	}
+
+	if (!(e.flags & ITEM_SUPPORTED) && _first_unsupported < 0) {
+		_first_unsupported = _index;
+	}
+
+	if (!(e.flags & ITEM_ACTUATOR_OK) && _first_actuator_error < 0) {
+		_first_actuator_error = _index;
+	}
+
+	if (position) {
+		_previous = _index;
+		_previous_changed = changed;
+	}
+
+	_index++;
+	return true;
+}
+
+int MissionGeometry::end()
+{
+	_count = _index;
+	return _recomputed;
+}
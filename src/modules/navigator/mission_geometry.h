@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file mission_geometry.h
+ * Geometry and feasibility data of the stored mission
+ *
+ * Holds the leg distances, the positions and the per item checks of every
+ * mission item, the feasibility checks run on this instead of the stored items. The data is refreshed after each
+ * mission upload, only items that changed since the last update and the
+ * legs touching them are recomputed.
+ */
+
+#ifndef NAVIGATOR_MISSION_GEOMETRY_H
+#define NAVIGATOR_MISSION_GEOMETRY_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <dataman/dataman.h>
+#include <geo/geo.h>
+
+class MissionGeometry
+{
+public:
+	static const unsigned MAX_ITEMS = NUM_MISSIONS_SUPPORTED;
+
+	static_assert(MAX_ITEMS <= 256, "Entry::leg_start holds an item index in a uint8_t");
+
+	enum {
+		ITEM_POSITION = 1 << 0,		/**< item has a horizontal position */
+		ITEM_LEG = 1 << 1,		/**< a leg from a previous position item ends at this item */
+		ITEM_SUPPORTED = 1 << 2,	/**< navigation command is supported */
+		ITEM_ACTUATOR_OK = 1 << 3,	/**< actuator number and value are in range */
+		ITEM_ALT_RELATIVE = 1 << 4	/**< altitude is relative to home */
+	};
+
+	struct Entry {
+		double lat;		/**< position of the item as stored, also set for items without one */
+		double lon;
+		float altitude;		/**< altitude of the item, see ITEM_ALT_RELATIVE */
+		float leg_distance;	/**< distance from the previous position item, metres */
+		uint32_t crc;		/**< checksum of the item the entry was computed from */
+		uint16_t nav_cmd;
+		uint8_t leg_start;	/**< index of the previous position item */
+		uint8_t flags;
+	};
+
+	MissionGeometry();
+
+	/**
+	 * Bring the data in sync with the mission stored in the datamanager.
+	 *
+	 * @return number of recomputed items, -1 if the mission could not be read
+	 */
+	int update(dm_item_t dm_item, unsigned count);
+
+	/**
+	 * Feed the mission item by item, an update starts with begin() and
+	 * ends with end(). update() is built on these.
+	 */
+	void begin();
+	bool add(const struct mission_item_s &item);
+	int end();
+
+	/**
+	 * Forget all items, the next update recomputes everything.
+	 */
+	void reset();
+
+	unsigned count() const { return _count; }
+
+	const Entry &entry(unsigned index) const { return _entries[index]; }
+
+	/**
+	 * @return true if the leg ending at item index starts at item from
+	 */
+	bool hasLeg(unsigned from, unsigned index) const
+	{
+		return index < _count && (_entries[index].flags & ITEM_LEG) && _entries[index].leg_start == from;
+	}
+
+	/**
+	 * @return index of the first item with an unsupported command, -1 if there is none
+	 */
+	int firstUnsupported() const { return _first_unsupported; }
+
+	/**
+	 * @return index of the first item with an actuator out of range, -1 if there is none
+	 */
+	int firstActuatorError() const { return _first_actuator_error; }
+
+	/**
+	 * @return true if the command has a horizontal position
+	 */
+	static bool hasPosition(unsigned nav_cmd);
+
+private:
+	static const unsigned READ_BLOCK = 8;	/**< mission items per datamanager request */
+
+	Entry _entries[MAX_ITEMS];
+	unsigned _count;
+
+	int _first_unsupported;
+	int _first_actuator_error;
+
+	/* state of the update in progress */
+	unsigned _index;
+	unsigned _recomputed;
+	int _previous;			/**< index of the previous position item, -1 if there is none */
+	bool _previous_changed;
+
+	struct mission_item_s _block[READ_BLOCK];
+};
+
+#endif /* NAVIGATOR_MISSION_GEOMETRY_H */
@@ -102,6 +102,16 @@ struct mission_item_s {
 	int actuator_value;             /**< new value for selected actuator in ms 900...2000         */
 };
 
+/**
+ * Rally point, stored in DM_KEY_SAFE_POINTS from index 1 on (index 0 is
+ * reserved for the home position). The list ends at the first empty item.
+ */
+struct mission_safe_point_s {
+	double lat;			/**< latitude in degrees				*/
+	double lon;			/**< longitude in degrees				*/
+	float alt;			/**< altitude in meters (AMSL)				*/
+};
+
 #include <uORB/topics/mission.h>
 
 /**
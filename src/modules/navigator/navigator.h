@@ -211,9 +211,12 @@ private:
 	int		_mission_instance_count;	/**< instance count for the current mission */
 
 	perf_counter_t	_loop_perf;			/**< loop performance counter */
+	perf_counter_t	_skip_perf;			/**< wakeups without any mode to run */
 
 	Geofence	_geofence;			/**< class that handles the geofence */
 	bool		_geofence_violation_warning_sent; /**< prevents spaming to mavlink */
+	bool		_geofence_position_updated;	/**< position changed since the last geofence check */
+	hrt_abstime	_last_geofence_check;		/**< time of the last geofence check */
 
 	bool		_inside_fence;			/**< vehicle is inside fence */
 
@@ -234,6 +237,9 @@ private:
 	bool		_pos_sp_triplet_updated;		/**< flags if position SP triplet needs to be published */
 	bool 		_pos_sp_triplet_published_invalid_once;	/**< flags if position SP triplet has been published once to UORB */
 	bool		_mission_result_updated;		/**< flags if mission result has seen an update */
+	bool		_inactive_can_loiter_at_sp;		/**< _can_loiter_at_sp when the inactive modes last ran */
+	unsigned	_position_interval;			/**< current global position update interval in ms */
+	hrt_abstime	_last_mode_run;				/**< time the navigation modes last ran */
 
 	control::BlockParamFloat _param_loiter_radius;	/**< loiter radius for fixedwing */
 	control::BlockParamFloat _param_acceptance_radius;	/**< acceptance for takeoff */
@@ -279,6 +285,11 @@ private:
 	 */
 	void		params_update();
 
+	/**
+	 * Check the geofence if due and the position changed since the last check
+	 */
+	void		geofence_check();
+
 	/**
 	 * Shim for calling task_main from task_create.
 	 */
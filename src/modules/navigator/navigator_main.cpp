@@ -91,6 +91,12 @@ extern "C" __EXPORT int navigator_main(int argc, char *argv[]);
 
 #define GEOFENCE_CHECK_INTERVAL 200000
 
+/* longest sleep in ms without any update, to notice a stop request */
+#define NAVIGATOR_IDLE_TIMEOUT 200
+
+/* position update interval in ms when no mode follows it, twice per geofence check */
+#define NAVIGATOR_IDLE_POSITION_INTERVAL (GEOFENCE_CHECK_INTERVAL / 2000)
+
 namespace navigator
 {
 
@@ -130,8 +136,11 @@ Navigator::Navigator() :
 	_mission_item_valid(false),
 	_mission_instance_count(0),
 	_loop_perf(perf_alloc(PC_ELAPSED, "navigator")),
+	_skip_perf(perf_alloc(PC_COUNT, "navigator skipped")),
 	_geofence{},
 	_geofence_violation_warning_sent(false),
+	_geofence_position_updated(false),
+	_last_geofence_check(0),
 	_inside_fence(true),
 	_navigation_mode(nullptr),
 	_mission(this, "MIS"),
@@ -145,6 +154,9 @@ Navigator::Navigator() :
 	_pos_sp_triplet_updated(false),
 	_pos_sp_triplet_published_invalid_once(false),
 	_mission_result_updated(false),
+	_inactive_can_loiter_at_sp(false),
+	_position_interval(NAVIGATOR_IDLE_POSITION_INTERVAL),
+	_last_mode_run(0),
 	_param_loiter_radius(this, "LOITER_RAD"),
 	_param_acceptance_radius(this, "ACC_RAD"),
 	_param_datalinkloss_obc(this, "DLL_OBC"),
@@ -252,6 +264,60 @@ Navigator::params_update()
 	orb_copy(ORB_ID(parameter_update), _param_update_sub, &param_update);
 }
 
+void
+Navigator::geofence_check()
+{
+	if (_geofence.getGeofenceAction() == geofence_result_s::GF_ACTION_NONE
+	    || hrt_elapsed_time(&_last_geofence_check) <= GEOFENCE_CHECK_INTERVAL) {
+		return;
+	}
+
+	/* only fetch gps and sensors when a check is due */
+	if (_geofence.getSource() == Geofence::GF_SOURCE_GPS) {
+		bool updated = false;
+		orb_check(_gps_pos_sub, &updated);
+
+		if (!updated) {
+			return;
+		}
+
+		gps_position_update();
+
+	} else if (!_geofence_position_updated) {
+		return;
+	}
+
+	bool updated = false;
+	orb_check(_sensor_combined_sub, &updated);
+
+	if (updated) {
+		sensor_combined_update();
+	}
+
+	bool inside = _geofence.inside(_global_pos, _gps_pos, _sensor_combined.baro_alt_meter[0], _home_pos, _home_position_set);
+	_last_geofence_check = hrt_absolute_time();
+	_geofence_position_updated = false;
+
+	_geofence_result.geofence_action = _geofence.getGeofenceAction();
+	if (!inside) {
+		/* inform other apps via the mission result */
+		_geofence_result.geofence_violated = true;
+		publish_geofence_result();
+
+		/* Issue a warning about the geofence violation once */
+		if (!_geofence_violation_warning_sent) {
+			mavlink_log_critical(_mavlink_fd, "Geofence violation");
+			_geofence_violation_warning_sent = true;
+		}
+	} else {
+		/* inform other apps via the mission result */
+		_geofence_result.geofence_violated = false;
+		publish_geofence_result();
+		/* Reset the _geofence_violation_warning_sent field */
+		_geofence_violation_warning_sent = false;
+	}
+}
+
 void
 Navigator::task_main_trampoline(int argc, char *argv[])
 {
@@ -302,14 +368,13 @@ Navigator::task_main()
 	navigation_capabilities_update();
 	params_update();
 
-	/* rate limit position and sensor updates to 50 Hz */
-	orb_set_interval(_global_pos_sub, 20);
-	orb_set_interval(_sensor_combined_sub, 20);
+	/* position updates are rate limited to what the active mode needs, see below */
+	orb_set_interval(_global_pos_sub, _position_interval);
 
 	hrt_abstime mavlink_open_time = 0;
 	const hrt_abstime mavlink_open_interval = 500000;
 
-	/* wakeup source(s) */
+	/* wakeup source(s), gps and sensors are only read when the geofence is checked */
 	px4_pollfd_struct_t fds[8];
 
 	/* Setup of loop */
@@ -325,22 +390,25 @@ Navigator::task_main()
 	fds[4].events = POLLIN;
 	fds[5].fd = _param_update_sub;
 	fds[5].events = POLLIN;
-	fds[6].fd = _sensor_combined_sub;
+	fds[6].fd = _onboard_mission_sub;
 	fds[6].events = POLLIN;
-	fds[7].fd = _gps_pos_sub;
+	fds[7].fd = _offboard_mission_sub;
 	fds[7].events = POLLIN;
 
 	while (!_task_should_exit) {
 
-		/* wait for up to 200ms for data */
-		int pret = px4_poll(&fds[0], (sizeof(fds) / sizeof(fds[0])), 200);
+		/* wait for data, but not longer than the active mode wants to run */
+		unsigned update_interval = (_navigation_mode != nullptr) ? _navigation_mode->get_update_interval() : 0;
+		int timeout = NAVIGATOR_IDLE_TIMEOUT;
 
-		if (pret == 0) {
-			/* timed out - periodic check for _task_should_exit, etc. */
-			PX4_WARN("timed out");
-			continue;
+		if (update_interval > 0) {
+			hrt_abstime elapsed = hrt_elapsed_time(&_last_mode_run);
+			timeout = (elapsed < update_interval * 1000) ? (update_interval * 1000 - elapsed + 999) / 1000 : 0;
+		}
 
-		} else if (pret < 0) {
+		int pret = px4_poll(&fds[0], (sizeof(fds) / sizeof(fds[0])), timeout);
+
+		if (pret < 0) {
 			/* this is undesirable but not much we can do - might want to flag unhappy status */
 			PX4_WARN("poll error %d, %d", pret, errno);
 			continue;
@@ -354,83 +422,56 @@ Navigator::task_main()
 			_mavlink_fd = px4_open(MAVLINK_LOG_DEVICE, 0);
 		}
 
-		static bool have_geofence_position_data = false;
-
-		/* gps updated */
-		if (fds[7].revents & POLLIN) {
-			gps_position_update();
-			if (_geofence.getSource() == Geofence::GF_SOURCE_GPS) {
-				have_geofence_position_data = true;
-			}
-		}
+		/* any update but the position wakes all modes, the first pass as well */
+		bool event = (_last_mode_run == 0);
 
-		/* sensors combined updated */
-		if (fds[6].revents & POLLIN) {
-			sensor_combined_update();
+		/* mission updates are read by the mission mode itself */
+		if ((fds[6].revents & POLLIN) || (fds[7].revents & POLLIN)) {
+			event = true;
 		}
 
 		/* parameters updated */
 		if (fds[5].revents & POLLIN) {
 			params_update();
 			updateParams();
+			event = true;
 		}
 
 		/* vehicle control mode updated */
 		if (fds[4].revents & POLLIN) {
 			vehicle_control_mode_update();
+			event = true;
 		}
 
 		/* vehicle status updated */
 		if (fds[3].revents & POLLIN) {
 			vehicle_status_update();
+			event = true;
 		}
 
 		/* navigation capabilities updated */
 		if (fds[2].revents & POLLIN) {
 			navigation_capabilities_update();
+			event = true;
 		}
 
 		/* home position updated */
 		if (fds[1].revents & POLLIN) {
 			home_position_update();
+			event = true;
 		}
 
 		/* global position updated */
-		if (fds[0].revents & POLLIN) {
+		bool position_updated = fds[0].revents & POLLIN;
+
+		if (position_updated) {
 			global_position_update();
-			if (_geofence.getSource() == Geofence::GF_SOURCE_GLOBALPOS) {
-				have_geofence_position_data = true;
-			}
+			_geofence_position_updated = true;
 		}
 
-		/* Check geofence violation */
-		static hrt_abstime last_geofence_check = 0;
-		if (have_geofence_position_data &&
-			(_geofence.getGeofenceAction() != geofence_result_s::GF_ACTION_NONE) &&
-			(hrt_elapsed_time(&last_geofence_check) > GEOFENCE_CHECK_INTERVAL)) {
-			bool inside = _geofence.inside(_global_pos, _gps_pos, _sensor_combined.baro_alt_meter[0], _home_pos, _home_position_set);
-			last_geofence_check = hrt_absolute_time();
-			have_geofence_position_data = false;
-
-			_geofence_result.geofence_action = _geofence.getGeofenceAction();
-			if (!inside) {
-				/* inform other apps via the mission result */
-				_geofence_result.geofence_violated = true;
-				publish_geofence_result();
-
-				/* Issue a warning about the geofence violation once */
-				if (!_geofence_violation_warning_sent) {
-					mavlink_log_critical(_mavlink_fd, "Geofence violation");
-					_geofence_violation_warning_sent = true;
-				}
-			} else {
-				/* inform other apps via the mission result */
-				_geofence_result.geofence_violated = false;
-				publish_geofence_result();
-				/* Reset the _geofence_violation_warning_sent field */
-				_geofence_violation_warning_sent = false;
-			}
-		}
+		geofence_check();
+
+		NavigatorMode *last_navigation_mode = _navigation_mode;
 
 		/* Do stuff according to navigation state set by commander */
 		switch (_vstatus.nav_state) {
@@ -488,9 +529,48 @@ Navigator::task_main()
 				break;
 		}
 
+		if (_navigation_mode != last_navigation_mode) {
+			/* the new mode starts from the latest position, not the rate limited one */
+			if (!position_updated) {
+				global_position_update();
+			}
+
+			event = true;
+		}
+
+		/* follow the position only as fast as the active mode needs it, the geofence needs it anyway */
+		update_interval = (_navigation_mode != nullptr) ? _navigation_mode->get_update_interval() : 0;
+		unsigned position_interval = (update_interval > 0
+					      && update_interval < NAVIGATOR_IDLE_POSITION_INTERVAL) ? update_interval : NAVIGATOR_IDLE_POSITION_INTERVAL;
+
+		if (position_interval != _position_interval) {
+			_position_interval = position_interval;
+			orb_set_interval(_global_pos_sub, _position_interval);
+		}
+
+		/* the active mode runs on events, on position updates and when it is due, inactive ones on events only */
+		bool run_active = event || (update_interval > 0
+					    && (position_updated || hrt_elapsed_time(&_last_mode_run) >= update_interval * 1000));
+		bool run_inactive = event || (_can_loiter_at_sp != _inactive_can_loiter_at_sp);
+
+		if (run_inactive) {
+			_inactive_can_loiter_at_sp = _can_loiter_at_sp;
+		}
+
 		/* iterate through navigation modes and set active/inactive for each */
 		for(unsigned int i = 0; i < NAVIGATOR_MODE_ARRAY_SIZE; i++) {
-			_navigation_mode_array[i]->run(_navigation_mode == _navigation_mode_array[i]);
+			bool active = (_navigation_mode == _navigation_mode_array[i]);
+
+			if (active ? run_active : run_inactive) {
+				_navigation_mode_array[i]->run(active);
+			}
+		}
+
+		if (run_active || run_inactive) {
+			_last_mode_run = hrt_absolute_time();
+
+		} else {
+			perf_count(_skip_perf);
 		}
 
 		/* if nothing is running, set position setpoint triplet invalid once */
@@ -566,6 +646,10 @@ Navigator::status()
 	} else {
 		warnx("Geofence not set (no /etc/geofence.txt on microsd) or not valid");
 	}
+
+	warnx("position update interval %u ms", _position_interval);
+	perf_print_counter(_loop_perf);
+	perf_print_counter(_skip_perf);
 }
 
 void
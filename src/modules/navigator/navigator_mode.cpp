@@ -39,14 +39,20 @@
  * @author Anton Babushkin <anton.babushkin@me.com>
  */
 
+#include <stdio.h>
+
 #include "navigator_mode.h"
 #include "navigator.h"
 
 NavigatorMode::NavigatorMode(Navigator *navigator, const char *name) :
 	SuperBlock(navigator, name),
 	_navigator(navigator),
-	_first_run(true)
+	_first_run(true),
+	_perf_name()
 {
+	snprintf(_perf_name, sizeof(_perf_name), "navigator %s", name);
+	_perf = perf_alloc(PC_ELAPSED, _perf_name);
+
 	/* load initial params */
 	updateParams();
 	/* set initial mission items */
@@ -55,11 +61,14 @@ NavigatorMode::NavigatorMode(Navigator *navigator, const char *name) :
 
 NavigatorMode::~NavigatorMode()
 {
+	perf_free(_perf);
 }
 
 void
 NavigatorMode::run(bool active)
 {
+	perf_begin(_perf);
+
 	if (active) {
 		if (_first_run) {
 			/* first run */
@@ -79,6 +88,8 @@ NavigatorMode::run(bool active)
 		_first_run = true;
 		on_inactive();
 	}
+
+	perf_end(_perf);
 }
 
 void
@@ -97,3 +108,9 @@ void
 NavigatorMode::on_active()
 {
 }
+
+unsigned
+NavigatorMode::get_update_interval()
+{
+	return NAVIGATOR_MODE_UPDATE_INTERVAL;
+}
@@ -43,6 +43,7 @@
 #define NAVIGATOR_MODE_H
 
 #include <drivers/drv_hrt.h>
+#include <systemlib/perf_counter.h>
 
 #include <controllib/blocks.hpp>
 #include <controllib/block/BlockParam.hpp>
@@ -51,6 +52,11 @@
 
 #include <uORB/topics/position_setpoint_triplet.h>
 
+/**
+ * Default interval in ms at which an active mode runs
+ */
+#define NAVIGATOR_MODE_UPDATE_INTERVAL 20
+
 class Navigator;
 
 class NavigatorMode : public control::SuperBlock
@@ -83,12 +89,22 @@ public:
 	 */
 	virtual void on_active();
 
+	/**
+	 * Interval in ms at which the mode wants to run while active, on position updates
+	 * or when no update arrived in time. Zero if it only reacts to other events.
+	 */
+	virtual unsigned get_update_interval();
+
 protected:
 	Navigator *_navigator;
 
 private:
 	bool _first_run;
 
+	static const uint8_t _perf_name_max = 24;
+	char _perf_name[_perf_name_max];
+	perf_counter_t _perf;		/**< time spent in this mode */
+
 	/* this class has ptr data members, so it should not be copied,
 	 * consequently the copy constructors are private.
 	 */
@@ -0,0 +1,207 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file rally_point_index.cpp
+ * Nearest rally point lookup
+ */
+
+#include "rally_point_index.h"
+
+#include <math.h>
+
+RallyPointIndex::RallyPointIndex(Point *points, unsigned capacity) :
+	_points(points),
+	_capacity(capacity),
+	_count(0),
+	_built(false),
+	_ref{}
+{
+}
+
+void
+RallyPointIndex::reset()
+{
+	_count = 0;
+	_built = false;
+	_ref.init_done = false;
+}
+
+bool
+RallyPointIndex::add(double lat, double lon, float alt, uint16_t id)
+{
+	if (_count >= _capacity) {
+		return false;
+	}
+
+	if (_count == 0) {
+		map_projection_init(&_ref, lat, lon);
+	}
+
+	Point &p = _points[_count++];
+	map_projection_project_fast(&_ref, lat, lon, &p.north, &p.east);
+	p.alt = alt;
+	p.id = id;
+	_built = false;
+
+	return true;
+}
+
+void
+RallyPointIndex::build()
+{
+	sort(0, _count, 0);
+	_built = true;
+}
+
+void
+RallyPointIndex::sort(unsigned lo, unsigned hi, unsigned depth)
+{
+	while (hi - lo > 1) {
+		unsigned mid = lo + (hi - lo) / 2;
+		select(lo, hi, mid, depth & 1);
+
+		/* recurse into the smaller half */
+		sort(lo, mid, depth + 1);
+		lo = mid + 1;
+		depth++;
+	}
+}
+
+void
+RallyPointIndex::select(unsigned lo, unsigned hi, unsigned k, bool east)
+{
+	/* quickselect, leaves the k-th smallest point at k with smaller ones before it */
+	while (hi - lo > 1) {
+		const Point &pivot_point = _points[lo + (hi - lo) / 2];
+		float pivot = east ? pivot_point.east : pivot_point.north;
+		unsigned i = lo;
+		unsigned j = hi - 1;
+
+		while (i <= j) {
+			while ((east ? _points[i].east : _points[i].north) < pivot) {
+				i++;
+			}
+
+			while ((east ? _points[j].east : _points[j].north) > pivot) {
+				j--;
+			}
+
+			if (i <= j) {
+				Point tmp = _points[i];
+				_points[i] = _points[j];
+				_points[j] = tmp;
+				i++;
+
+				if (j == 0) {
+					break;
+				}
+
+				j--;
+			}
+		}
+
+		/* lo..j <= pivot <= i..hi-1 */
+		if (k <= j) {
+			hi = j + 1;
+
+		} else if (k >= i) {
+			lo = i;
+
+		} else {
+			return;
+		}
+	}
+}
+
+int
+RallyPointIndex::nearest(double lat, double lon, float max_distance, float *distance) const
+{
+	if (!_built || _count == 0) {
+		return -1;
+	}
+
+	float north, east;
+	map_projection_project_fast(&_ref, lat, lon, &north, &east);
+
+	int best = -1;
+	float best_sq = max_distance * max_distance;
+	search(0, _count, 0, north, east, &best, &best_sq);
+
+	if (best >= 0 && distance != nullptr) {
+		*distance = sqrtf(best_sq);
+	}
+
+	return best;
+}
+
+void
+RallyPointIndex::search(unsigned lo, unsigned hi, unsigned depth, float north, float east, int *best,
+			float *best_sq) const
+{
+	while (lo < hi) {
+		unsigned mid = lo + (hi - lo) / 2;
+		const Point &p = _points[mid];
+		float dn = north - p.north;
+		float de = east - p.east;
+		float d_sq = dn * dn + de * de;
+
+		if (d_sq < *best_sq) {
+			*best_sq = d_sq;
+			*best = mid;
+		}
+
+		/* search the side of the split containing the position first */
+		float delta = (depth & 1) ? de : dn;
+		depth++;
+
+		if (delta < 0.0f) {
+			search(lo, mid, depth, north, east, best, best_sq);
+			lo = mid + 1;
+
+		} else {
+			search(mid + 1, hi, depth, north, east, best, best_sq);
+			hi = mid;
+		}
+
+		/* the other side only if it can contain a closer point */
+		if (delta * delta >= *best_sq) {
+			return;
+		}
+	}
+}
+
+void
+RallyPointIndex::position(unsigned index, double *lat, double *lon) const
+{
+	map_projection_reproject_fast(&_ref, _points[index].north, _points[index].east, lat, lon);
+}
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file rally_point_index.h
+ * Nearest rally point lookup
+ *
+ * The points are projected to metres around the first one and sorted into
+ * an implicit k-d tree: the median of each range along the split axis is
+ * in the middle of the range, the two halves are split along the other axis.
+ */
+
+#ifndef RALLY_POINT_INDEX_H_
+#define RALLY_POINT_INDEX_H_
+
+#include <stdint.h>
+#include <geo/geo.h>
+
+class RallyPointIndex
+{
+public:
+	struct Point {
+		float north;
+		float east;
+		float alt;		/**< altitude in meters (AMSL) */
+		uint16_t id;		/**< number of the point given by the caller */
+	};
+
+	/**
+	 * @param points storage for up to capacity points
+	 */
+	RallyPointIndex(Point *points, unsigned capacity);
+
+	/**
+	 * Discard all points.
+	 */
+	void reset();
+
+	/**
+	 * Add a point, the first one is the origin of the local coordinates.
+	 *
+	 * @return false if there are too many points
+	 */
+	bool add(double lat, double lon, float alt, uint16_t id);
+
+	/**
+	 * Sort the points into the tree. Needs to be called after adding the
+	 * points and before searching.
+	 */
+	void build();
+
+	/**
+	 * Find the point closest to a position.
+	 *
+	 * @param max_distance only points closer than this are considered
+	 * @param distance set to the distance of the point found, may be nullptr
+	 * @return index of the point, -1 if there is none
+	 */
+	int nearest(double lat, double lon, float max_distance, float *distance = nullptr) const;
+
+	/**
+	 * Global position of a point.
+	 */
+	void position(unsigned index, double *lat, double *lon) const;
+
+	const Point &point(unsigned index) const { return _points[index]; }
+
+	unsigned count() const { return _count; }
+
+	bool empty() const { return _count == 0; }
+
+private:
+	Point *_points;
+	unsigned _capacity;
+	unsigned _count;
+	bool _built;
+
+	struct map_projection_reference_s _ref;
+
+	void sort(unsigned lo, unsigned hi, unsigned depth);
+
+	void select(unsigned lo, unsigned hi, unsigned k, bool east);
+
+	void search(unsigned lo, unsigned hi, unsigned depth, float north, float east, int *best, float *best_sq) const;
+};
+
+#endif /* RALLY_POINT_INDEX_H_ */
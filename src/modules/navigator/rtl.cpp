@@ -59,9 +59,17 @@ RTL::RTL(Navigator *navigator, const char *name) :
 	MissionBlock(navigator, name),
 	_rtl_state(RTL_STATE_NONE),
 	_rtl_start_lock(false),
+	_rally_points{},
+	_rally_index(_rally_points, DM_KEY_SAFE_POINTS_MAX - 1),
+	_return_home(true),
+	_return_lat(0.0),
+	_return_lon(0.0),
+	_return_alt(0.0f),
+	_return_yaw(NAN),
 	_param_return_alt(this, "RTL_RETURN_ALT", false),
 	_param_descend_alt(this, "RTL_DESCEND_ALT", false),
-	_param_land_delay(this, "RTL_LAND_DELAY", false)
+	_param_land_delay(this, "RTL_LAND_DELAY", false),
+	_param_rally_dist(this, "RTL_RALLY_DIST", false)
 {
 	/* load initial params */
 	updateParams();
@@ -87,6 +95,10 @@ RTL::on_activation()
 {
 	/* decide where to enter the RTL procedure when we switch into it */
 	if (_rtl_state == RTL_STATE_NONE) {
+		/* make sure we have the latest params */
+		updateParams();
+		set_return_point();
+
 		/* for safety reasons don't go into RTL if landed */
 		if (_navigator->get_vstatus()->condition_landed) {
 			_rtl_state = RTL_STATE_LANDED;
@@ -135,6 +147,13 @@ RTL::set_rtl_item()
 
 	_navigator->set_can_loiter_at_sp(false);
 
+	if (_return_home) {
+		_return_lat = _navigator->get_home_position()->lat;
+		_return_lon = _navigator->get_home_position()->lon;
+		_return_alt = _navigator->get_home_position()->alt;
+		_return_yaw = _navigator->get_home_position()->yaw;
+	}
+
 	switch (_rtl_state) {
 	case RTL_STATE_CLIMB: {
 		float climb_alt = _navigator->get_home_position()->alt + _param_return_alt.get();
@@ -160,8 +179,8 @@ RTL::set_rtl_item()
 	}
 
 	case RTL_STATE_RETURN: {
-		_mission_item.lat = _navigator->get_home_position()->lat;
-		_mission_item.lon = _navigator->get_home_position()->lon;
+		_mission_item.lat = _return_lat;
+		_mission_item.lon = _return_lon;
 		 // don't change altitude
 
 		 if (pos_sp_triplet->previous.valid) {
@@ -194,11 +213,11 @@ RTL::set_rtl_item()
 	}
 
 	case RTL_STATE_DESCEND: {
-		_mission_item.lat = _navigator->get_home_position()->lat;
-		_mission_item.lon = _navigator->get_home_position()->lon;
+		_mission_item.lat = _return_lat;
+		_mission_item.lon = _return_lon;
 		_mission_item.altitude_is_relative = false;
-		_mission_item.altitude = _navigator->get_home_position()->alt + _param_descend_alt.get();
-		_mission_item.yaw = _navigator->get_home_position()->yaw;
+		_mission_item.altitude = _return_alt + _param_descend_alt.get();
+		_mission_item.yaw = _return_yaw;
 		_mission_item.loiter_radius = _navigator->get_loiter_radius();
 		_mission_item.loiter_direction = 1;
 		_mission_item.nav_cmd = NAV_CMD_LOITER_TIME_LIMIT;
@@ -217,11 +236,11 @@ RTL::set_rtl_item()
 	case RTL_STATE_LOITER: {
 		bool autoland = _param_land_delay.get() > -DELAY_SIGMA;
 
-		_mission_item.lat = _navigator->get_home_position()->lat;
-		_mission_item.lon = _navigator->get_home_position()->lon;
+		_mission_item.lat = _return_lat;
+		_mission_item.lon = _return_lon;
 		_mission_item.altitude_is_relative = false;
-		_mission_item.altitude = _navigator->get_home_position()->alt + _param_descend_alt.get();
-		_mission_item.yaw = _navigator->get_home_position()->yaw;
+		_mission_item.altitude = _return_alt + _param_descend_alt.get();
+		_mission_item.yaw = _return_yaw;
 		_mission_item.loiter_radius = _navigator->get_loiter_radius();
 		_mission_item.loiter_direction = 1;
 		_mission_item.nav_cmd = autoland ? NAV_CMD_LOITER_TIME_LIMIT : NAV_CMD_LOITER_UNLIMITED;
@@ -243,11 +262,11 @@ RTL::set_rtl_item()
 	}
 
 	case RTL_STATE_LAND: {
-		_mission_item.lat = _navigator->get_home_position()->lat;
-		_mission_item.lon = _navigator->get_home_position()->lon;
+		_mission_item.lat = _return_lat;
+		_mission_item.lon = _return_lon;
 		_mission_item.altitude_is_relative = false;
-		_mission_item.altitude = _navigator->get_home_position()->alt;
-		_mission_item.yaw = _navigator->get_home_position()->yaw;
+		_mission_item.altitude = _return_alt;
+		_mission_item.yaw = _return_yaw;
 		_mission_item.loiter_radius = _navigator->get_loiter_radius();
 		_mission_item.loiter_direction = 1;
 		_mission_item.nav_cmd = NAV_CMD_LAND;
@@ -257,15 +276,15 @@ RTL::set_rtl_item()
 		_mission_item.autocontinue = true;
 		_mission_item.origin = ORIGIN_ONBOARD;
 
-		mavlink_log_critical(_navigator->get_mavlink_fd(), "RTL: land at home");
+		mavlink_log_critical(_navigator->get_mavlink_fd(), _return_home ? "RTL: land at home" : "RTL: land at rally point");
 		break;
 	}
 
 	case RTL_STATE_LANDED: {
-		_mission_item.lat = _navigator->get_home_position()->lat;
-		_mission_item.lon = _navigator->get_home_position()->lon;
+		_mission_item.lat = _return_lat;
+		_mission_item.lon = _return_lon;
 		_mission_item.altitude_is_relative = false;
-		_mission_item.altitude = _navigator->get_home_position()->alt;
+		_mission_item.altitude = _return_alt;
 		// Do not change / control yaw in landed
 		_mission_item.yaw = NAN;
 		_mission_item.loiter_radius = _navigator->get_loiter_radius();
@@ -328,3 +347,68 @@ RTL::advance_rtl()
 		break;
 	}
 }
+
+void
+RTL::load_rally_points()
+{
+	static const unsigned READ_BLOCK = 4;
+	struct mission_safe_point_s block[READ_BLOCK];
+
+	_rally_index.reset();
+
+	/* index 0 is the home position */
+	for (unsigned index = 1; index < DM_KEY_SAFE_POINTS_MAX; index += READ_BLOCK) {
+		unsigned count = (DM_KEY_SAFE_POINTS_MAX - index < READ_BLOCK) ? DM_KEY_SAFE_POINTS_MAX - index : READ_BLOCK;
+		ssize_t n = dm_read_range(DM_KEY_SAFE_POINTS, index, block, count, sizeof(block[0]));
+
+		for (ssize_t i = 0; i < n; i++) {
+			/* a rally point outside the geofence can't be reached */
+			if (_navigator->get_geofence().inside_polygon(block[i].lat, block[i].lon, block[i].alt)) {
+				_rally_index.add(block[i].lat, block[i].lon, block[i].alt, index + i);
+			}
+		}
+
+		if (n < (ssize_t)count) {
+			break;
+		}
+	}
+
+	_rally_index.build();
+}
+
+void
+RTL::set_return_point()
+{
+	_return_home = true;
+
+	/* RTL doesn't take off again once landed */
+	if (_param_rally_dist.get() <= 0.0f || _navigator->get_vstatus()->condition_landed) {
+		return;
+	}
+
+	load_rally_points();
+
+	/* only return to a rally point closer than home */
+	const struct vehicle_global_position_s *pos = _navigator->get_global_position();
+	float max_distance = get_distance_to_next_waypoint(pos->lat, pos->lon,
+			     _navigator->get_home_position()->lat, _navigator->get_home_position()->lon);
+
+	if (_param_rally_dist.get() < max_distance) {
+		max_distance = _param_rally_dist.get();
+	}
+
+	float distance;
+	int rally = _rally_index.nearest(pos->lat, pos->lon, max_distance, &distance);
+
+	if (rally < 0) {
+		return;
+	}
+
+	_return_home = false;
+	_rally_index.position(rally, &_return_lat, &_return_lon);
+	_return_alt = _rally_index.point(rally).alt;
+	_return_yaw = NAN;
+
+	mavlink_log_info(_navigator->get_mavlink_fd(), "RTL: rally point %u, %d m away",
+			 (unsigned)_rally_index.point(rally).id, (int)distance);
+}
@@ -45,11 +45,13 @@
 #include <controllib/block/BlockParam.hpp>
 
 #include <navigator/navigation.h>
+#include <dataman/dataman.h>
 #include <uORB/topics/home_position.h>
 #include <uORB/topics/vehicle_global_position.h>
 
 #include "navigator_mode.h"
 #include "mission_block.h"
+#include "rally_point_index.h"
 
 class Navigator;
 
@@ -77,6 +79,16 @@ private:
 	 */
 	void		advance_rtl();
 
+	/**
+	 * Read the rally points inside the geofence from the datamanager
+	 */
+	void		load_rally_points();
+
+	/**
+	 * Return to the closest of home and the rally points
+	 */
+	void		set_return_point();
+
 	enum RTLState {
 		RTL_STATE_NONE = 0,
 		RTL_STATE_CLIMB,
@@ -89,9 +101,20 @@ private:
 
 	bool _rtl_start_lock;
 
+	RallyPointIndex::Point _rally_points[DM_KEY_SAFE_POINTS_MAX - 1];
+	RallyPointIndex _rally_index;
+
+	/* where RTL goes to */
+	bool _return_home;
+	double _return_lat;
+	double _return_lon;
+	float _return_alt;		/**< altitude of the return point (AMSL) */
+	float _return_yaw;
+
 	control::BlockParamFloat _param_return_alt;
 	control::BlockParamFloat _param_descend_alt;
 	control::BlockParamFloat _param_land_delay;
+	control::BlockParamFloat _param_rally_dist;
 };
 
 #endif
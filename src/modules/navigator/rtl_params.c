@@ -81,3 +81,17 @@ PARAM_DEFINE_FLOAT(RTL_DESCEND_ALT, 30);
  * @group Return To Land
  */
 PARAM_DEFINE_FLOAT(RTL_LAND_DELAY, -1.0f);
+
+/**
+ * RTL rally point distance
+ *
+ * Return to the closest rally point instead of home if it is closer than
+ * home and than this distance. Rally points outside the geofence are ignored.
+ * Set to 0 to always return home.
+ *
+ * @unit meters
+ * @min 0
+ * @max 100000
+ * @group Return To Land
+ */
+PARAM_DEFINE_FLOAT(RTL_RALLY_DIST, 5000.0f);
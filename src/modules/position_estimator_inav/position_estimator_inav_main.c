@@ -46,6 +46,7 @@
 #include <fcntl.h>
 #include <string.h>
 #include <px4_config.h>
+#include <px4_vehicle.h>
 #include <math.h>
 #include <float.h>
 #include <uORB/uORB.h>
@@ -81,9 +82,13 @@
 #define PUB_INTERVAL 10000	// limit publish rate to 100 Hz
 #define EST_BUF_SIZE 250000 / PUB_INTERVAL		// buffer size is 0.5s
 
-static bool thread_should_exit = false; /**< Deamon exit flag */
-static bool thread_running = false; /**< Deamon status flag */
-static int position_estimator_inav_task; /**< Handle of deamon task / thread */
+/* one daemon for each vehicle, the task runs for the vehicle which started it */
+static bool thread_should_exit_vehicle[PX4_MAX_VEHICLES]; /**< Deamon exit flag */
+static bool thread_running_vehicle[PX4_MAX_VEHICLES]; /**< Deamon status flag */
+static int position_estimator_inav_task_vehicle[PX4_MAX_VEHICLES]; /**< Handle of deamon task / thread */
+#define thread_should_exit thread_should_exit_vehicle[px4_vehicle_id()]
+#define thread_running thread_running_vehicle[px4_vehicle_id()]
+#define position_estimator_inav_task position_estimator_inav_task_vehicle[px4_vehicle_id()]
 static bool inav_verbose_mode = false;
 
 static const hrt_abstime vision_topic_timeout = 500000;	// Vision topic timeout = 0.5s
@@ -863,7 +868,7 @@ int position_estimator_inav_thread_main(int argc, char *argv[])
 					if (ref_inited) {
 						/* project GPS lat lon to plane */
 						float gps_proj[2];
-						map_projection_project(&ref, lat, lon, &(gps_proj[0]), &(gps_proj[1]));
+						map_projection_project_fast(&ref, lat, lon, &(gps_proj[0]), &(gps_proj[1]));
 
 						/* reset position estimate when GPS becomes good */
 						if (reset_est) {
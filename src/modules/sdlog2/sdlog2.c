@@ -108,6 +108,7 @@
 #include <uORB/topics/vtol_vehicle_status.h>
 #include <uORB/topics/time_offset.h>
 #include <uORB/topics/mc_att_ctrl_status.h>
+#include <uORB/topics/pipeline_latency.h>
 
 #include <systemlib/systemlib.h>
 #include <systemlib/param/param.h>
@@ -1089,6 +1090,7 @@ int sdlog2_thread_main(int argc, char *argv[])
 		struct vtol_vehicle_status_s vtol_status;
 		struct time_offset_s time_offset;
 		struct mc_att_ctrl_status_s mc_att_ctrl_status;
+		struct pipeline_latency_s pipeline_latency;
 	} buf;
 
 	memset(&buf, 0, sizeof(buf));
@@ -1137,6 +1139,7 @@ int sdlog2_thread_main(int argc, char *argv[])
 			struct log_ENCD_s log_ENCD;
 			struct log_TSYN_s log_TSYN;
 			struct log_MACS_s log_MACS;
+			struct log_LAT_s log_LAT;
 		} body;
 	} log_msg = {
 		LOG_PACKET_HEADER_INIT(0)
@@ -1179,6 +1182,7 @@ int sdlog2_thread_main(int argc, char *argv[])
 		int encoders_sub;
 		int tsync_sub;
 		int mc_att_ctrl_status_sub;
+		int pipeline_latency_sub;
 	} subs;
 
 	subs.cmd_sub = -1;
@@ -1212,6 +1216,7 @@ int sdlog2_thread_main(int argc, char *argv[])
 	subs.wind_sub = -1;
 	subs.tsync_sub = -1;
 	subs.mc_att_ctrl_status_sub = -1;
+	subs.pipeline_latency_sub = -1;
 	subs.encoders_sub = -1;
 
 	/* add new topics HERE */
@@ -1263,7 +1268,7 @@ int sdlog2_thread_main(int argc, char *argv[])
 	thread_running = true;
 
 	while (!main_thread_should_exit) {
-		usleep(sleep_delay);
+		px4_usleep(sleep_delay);
 
 		/* --- VEHICLE COMMAND - LOG MANAGEMENT --- */
 		if (copy_if_updated(ORB_ID(vehicle_command), &subs.cmd_sub, &buf.cmd)) {
@@ -1856,6 +1861,19 @@ int sdlog2_thread_main(int argc, char *argv[])
 			LOGBUFFER_WRITE_AND_COUNT(MACS);
 		}
 
+		/* --- PIPELINE LATENCY --- */
+		if (copy_if_updated(ORB_ID(pipeline_latency), &subs.pipeline_latency_sub, &buf.pipeline_latency)) {
+			for (unsigned i = 0; i < PIPELINE_NUM_STAGES; i++) {
+				log_msg.msg_type = LOG_LAT0_MSG + i;
+				log_msg.body.log_LAT.count = buf.pipeline_latency.count[i];
+				log_msg.body.log_LAT.avg = buf.pipeline_latency.avg[i];
+				log_msg.body.log_LAT.p50 = buf.pipeline_latency.p50[i];
+				log_msg.body.log_LAT.p99 = buf.pipeline_latency.p99[i];
+				log_msg.body.log_LAT.max = buf.pipeline_latency.max[i];
+				LOGBUFFER_WRITE_AND_COUNT(LAT);
+			}
+		}
+
 		/* signal the other thread new data, but not yet unlock */
 		if (logbuffer_count(&lb) > MIN_BYTES_TO_WRITE) {
 			/* only request write if several packets can be written at once */
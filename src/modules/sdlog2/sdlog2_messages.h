@@ -479,6 +479,19 @@ struct log_MACS_s {
 
 /* WARNING: ID 46 is already in use for ATTC1 */
 
+/* --- LAT0..3 - PIPELINE LATENCY OF SENSORS, ATTITUDE, CONTROLS AND OUTPUTS --- */
+#define LOG_LAT0_MSG 47
+#define LOG_LAT1_MSG 48
+#define LOG_LAT2_MSG 49
+#define LOG_LAT3_MSG 50
+struct log_LAT_s {
+	uint32_t count;
+	uint32_t avg;
+	uint32_t p50;
+	uint32_t p99;
+	uint32_t max;
+};
+
 /********** SYSTEM MESSAGES, ID > 0x80 **********/
 
 /* --- TIME - TIME STAMP --- */
@@ -550,6 +563,10 @@ static const struct log_format_s log_formats[] = {
 	LOG_FORMAT(ENCD, "qfqf",	"cnt0,vel0,cnt1,vel1"),
 	LOG_FORMAT(TSYN, "Q", 		"TimeOffset"),
 	LOG_FORMAT(MACS, "fff", "RRint,PRint,YRint"),
+	LOG_FORMAT_S(LAT0, LAT, "IIIII",	"Count,Avg,P50,P99,Max"),
+	LOG_FORMAT_S(LAT1, LAT, "IIIII",	"Count,Avg,P50,P99,Max"),
+	LOG_FORMAT_S(LAT2, LAT, "IIIII",	"Count,Avg,P50,P99,Max"),
+	LOG_FORMAT_S(LAT3, LAT, "IIIII",	"Count,Avg,P50,P99,Max"),
 
 	/* system-level messages, ID >= 0x80 */
 	/* FMT: don't write format of format message, it's useless */
@@ -51,6 +51,7 @@
 #include <px4_config.h>
 #include <px4_tasks.h>
 #include <px4_posix.h>
+#include <px4_vehicle.h>
 #include <px4_time.h>
 
 #include <fcntl.h>
@@ -481,7 +482,7 @@ private:
 namespace sensors
 {
 
-Sensors	*g_sensors = nullptr;
+px4::VehicleInstance<Sensors> g_sensors;
 }
 
 Sensors::Sensors() :
@@ -0,0 +1,975 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file sim_scenario.cpp
+ * Headless scenario runner for SITL
+ *
+ * Replaces the simulator and the estimators by a kinematic vehicle model which
+ * follows the output of the position controller on a simulated clock. A
+ * scenario is a startup script mixing normal commands with sim_scenario
+ * commands, which act as RC, ground station and test harness:
+ *
+ *	sim_scenario start
+ *	sim_scenario mission takeoff 10
+ *	sim_scenario mission waypoint 47.3985 8.5460 20
+ *	sim_scenario mission upload
+ *	sim_scenario arm
+ *	sim_scenario mode mission
+ *	sim_scenario rc off
+ *	sim_scenario expect nav_state rtl 5
+ *	sim_scenario finish
+ */
+
+#include <px4_config.h>
+#include <px4_defines.h>
+#include <px4_tasks.h>
+#include <px4_time.h>
+#include <px4_posix.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <drivers/drv_hrt.h>
+#include <dataman/dataman.h>
+#include <geo/geo.h>
+#include <navigator/navigation.h>
+#include <systemlib/err.h>
+#include <uORB/uORB.h>
+#include <uORB/topics/geofence_result.h>
+#include <uORB/topics/manual_control_setpoint.h>
+#include <uORB/topics/mission.h>
+#include <uORB/topics/mission_result.h>
+#include <uORB/topics/sensor_combined.h>
+#include <uORB/topics/vehicle_attitude.h>
+#include <uORB/topics/vehicle_command.h>
+#include <uORB/topics/vehicle_control_mode.h>
+#include <uORB/topics/vehicle_global_position.h>
+#include <uORB/topics/vehicle_gps_position.h>
+#include <uORB/topics/vehicle_land_detected.h>
+#include <uORB/topics/vehicle_local_position.h>
+#include <uORB/topics/vehicle_local_position_setpoint.h>
+#include <uORB/topics/vehicle_status.h>
+
+#include "vehicle_model.h"
+
+extern "C" __EXPORT int sim_scenario_main(int argc, char *argv[]);
+
+/* simulation step and publication rates in steps */
+#define SIM_STEP_US		4000
+#define SIM_POSITION_DIVIDER	5
+#define SIM_GPS_DIVIDER		25
+#define SIM_SETPOINT_TIMEOUT	500000
+
+/* longest wait in ms for the tasks woken by a step to be done with it */
+#define SIM_LOCKSTEP_TIMEOUT	100
+
+#define SIM_MISSION_ITEMS_MAX	32
+
+class ScenarioRunner
+{
+public:
+	ScenarioRunner(double lat, double lon, float alt, float speedup);
+
+	~ScenarioRunner();
+
+	/**
+	 * Switch to simulated time and start the vehicle.
+	 *
+	 * @return		OK on success.
+	 */
+	int		start();
+
+	void		status();
+
+	int		arm(bool arm);
+	int		set_mode(const char *mode);
+	void		set_rc(bool enabled) { _rc_enabled = enabled; }
+	void		set_gps(bool enabled) { _gps_enabled = enabled; }
+
+	void		mission_clear() { _mission_count = 0; }
+	int		mission_add(enum NAV_CMD cmd, double lat, double lon, float alt);
+	int		mission_upload();
+
+	/**
+	 * Let the simulation run for the given simulated time.
+	 */
+	void		wait(float seconds);
+
+	/**
+	 * Check a condition, waiting up to timeout simulated seconds for it to become true.
+	 *
+	 * @return		true if the condition was met.
+	 */
+	bool		expect(const char *what, const char *value, float timeout);
+
+	double		get_home_lat() { return _home_lat; }
+	double		get_home_lon() { return _home_lon; }
+	unsigned	get_failures() { return _failures; }
+
+private:
+	bool		_task_should_exit;
+	int		_task;
+
+	const double	_home_lat;
+	const double	_home_lon;
+	const float	_home_alt;
+	const float	_speedup;			/**< simulated per wall clock time, 0 for as fast as the lockstep allows */
+
+	volatile bool	_rc_enabled;
+	volatile bool	_gps_enabled;
+	manual_control_setpoint_s	_manual;	/**< switch positions, written by the shell */
+
+	int		_local_pos_sp_sub;
+	int		_control_mode_sub;
+
+	orb_advert_t	_attitude_pub;
+	orb_advert_t	_local_pos_pub;
+	orb_advert_t	_global_pos_pub;
+	orb_advert_t	_gps_pub;
+	orb_advert_t	_sensors_pub;
+	orb_advert_t	_land_detected_pub;
+	orb_advert_t	_manual_pub;
+	orb_advert_t	_command_pub;
+	orb_advert_t	_mission_pub;
+
+	vehicle_local_position_setpoint_s	_local_pos_sp;
+	vehicle_control_mode_s			_control_mode;
+
+	struct map_projection_reference_s	_ref;
+	VehicleModel	_model;
+	VehicleModel::State	_state;		/**< copy of the model state for the shell */
+	hrt_abstime	_ref_timestamp;
+	unsigned	_steps;
+	unsigned	_lockstep_timeouts;		/**< steps not finished by every woken task in time */
+	unsigned	_failures;
+	bool		_landed_published;
+
+	mission_item_s	_mission_items[SIM_MISSION_ITEMS_MAX];
+	unsigned	_mission_count;
+	int		_mission_dataman_id;
+
+	static void	task_main_trampoline(int argc, char *argv[]);
+	void		task_main();
+
+	void		step();
+	void		publish_vehicle();
+	void		publish_manual();
+	void		publish_command(unsigned command, float param1, float param2);
+
+	template<typename T>
+	void		publish(const struct orb_metadata *meta, orb_advert_t &pub, const T &data);
+
+	/* this class has ptr data members, so it should not be copied,
+	 * consequently the copy constructors are private.
+	 */
+	ScenarioRunner(const ScenarioRunner &);
+	ScenarioRunner operator=(const ScenarioRunner &);
+};
+
+namespace sim_scenario
+{
+
+ScenarioRunner	*g_runner;
+}
+
+/* conditions of the expect command */
+enum expect_field {
+	EXPECT_ARMING,
+	EXPECT_NAV_STATE,
+	EXPECT_FAILSAFE,
+	EXPECT_LANDED,
+	EXPECT_MISSION_FINISHED,
+	EXPECT_MISSION_REACHED,
+	EXPECT_GEOFENCE_VIOLATED,
+	EXPECT_ALTITUDE_ABOVE,
+	EXPECT_ALTITUDE_BELOW,
+	EXPECT_HOME_DISTANCE_ABOVE,
+	EXPECT_HOME_DISTANCE_BELOW
+};
+
+static const struct {
+	const char *name;
+	enum expect_field field;
+} expect_fields[] = {
+	{ "arming", EXPECT_ARMING },
+	{ "nav_state", EXPECT_NAV_STATE },
+	{ "failsafe", EXPECT_FAILSAFE },
+	{ "landed", EXPECT_LANDED },
+	{ "mission_finished", EXPECT_MISSION_FINISHED },
+	{ "mission_reached", EXPECT_MISSION_REACHED },
+	{ "geofence_violated", EXPECT_GEOFENCE_VIOLATED },
+	{ "altitude_above", EXPECT_ALTITUDE_ABOVE },
+	{ "altitude_below", EXPECT_ALTITUDE_BELOW },
+	{ "home_distance_above", EXPECT_HOME_DISTANCE_ABOVE },
+	{ "home_distance_below", EXPECT_HOME_DISTANCE_BELOW }
+};
+
+static const char *arming_state_names[vehicle_status_s::ARMING_STATE_MAX] = {
+	"init", "standby", "armed", "armed_error", "standby_error", "reboot", "in_air_restore"
+};
+
+static const char *nav_state_names[vehicle_status_s::NAVIGATION_STATE_MAX] = {
+	"manual", "altctl", "posctl", "mission", "loiter", "rtl", "rcrecover", "rtgs", "landengfail",
+	"landgpsfail", "acro", "land", "descend", "termination", "offboard", "stab", "rattitude"
+};
+
+/* index of name in names, -1 if not found */
+static int
+find_name(const char *name, const char *const names[], unsigned count)
+{
+	for (unsigned i = 0; i < count; i++) {
+		if (strcmp(name, names[i]) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+ScenarioRunner::ScenarioRunner(double lat, double lon, float alt, float speedup) :
+	_task_should_exit(false),
+	_task(-1),
+	_home_lat(lat),
+	_home_lon(lon),
+	_home_alt(alt),
+	_speedup(speedup),
+	_rc_enabled(true),
+	_gps_enabled(true),
+	_manual{},
+	_local_pos_sp_sub(-1),
+	_control_mode_sub(-1),
+	_attitude_pub(nullptr),
+	_local_pos_pub(nullptr),
+	_global_pos_pub(nullptr),
+	_gps_pub(nullptr),
+	_sensors_pub(nullptr),
+	_land_detected_pub(nullptr),
+	_manual_pub(nullptr),
+	_command_pub(nullptr),
+	_mission_pub(nullptr),
+	_local_pos_sp{},
+	_control_mode{},
+	_ref{},
+	_model(),
+	_state{},
+	_ref_timestamp(0),
+	_steps(0),
+	_lockstep_timeouts(0),
+	_failures(0),
+	_landed_published(false),
+	_mission_items{},
+	_mission_count(0),
+	_mission_dataman_id(0)
+{
+	/* sticks centered, throttle low, main switch in manual */
+	_manual.z = 0.0f;
+	_manual.mode_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	_manual.return_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	_manual.posctl_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	_manual.loiter_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	_manual.acro_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	_manual.offboard_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+
+	map_projection_init(&_ref, lat, lon);
+	_state = _model.state();
+}
+
+ScenarioRunner::~ScenarioRunner()
+{
+	if (_task != -1) {
+		_task_should_exit = true;
+
+		/* the task checks for exit every simulation step */
+		unsigned i = 0;
+
+		do {
+			usleep(20000);
+
+			if (++i > 50) {
+				px4_task_delete(_task);
+				break;
+			}
+		} while (_task != -1);
+	}
+
+	sim_scenario::g_runner = nullptr;
+}
+
+template<typename T>
+void
+ScenarioRunner::publish(const struct orb_metadata *meta, orb_advert_t &pub, const T &data)
+{
+	if (pub != nullptr) {
+		orb_publish(meta, pub, &data);
+
+	} else {
+		pub = orb_advertise(meta, &data);
+	}
+}
+
+int
+ScenarioRunner::start()
+{
+	ASSERT(_task == -1);
+
+	/* everything started after this sees simulated time */
+	hrt_start_simulated_time();
+	_ref_timestamp = hrt_absolute_time();
+
+	/* the vehicle is on the ground at home until the task runs */
+	publish_vehicle();
+	publish_manual();
+
+	_task = px4_task_spawn_cmd("sim_scenario",
+				   SCHED_DEFAULT,
+				   SCHED_PRIORITY_MAX - 5,
+				   1800,
+				   (px4_main_t)&ScenarioRunner::task_main_trampoline,
+				   nullptr);
+
+	if (_task < 0) {
+		warn("task start failed");
+		return -errno;
+	}
+
+	return OK;
+}
+
+void
+ScenarioRunner::task_main_trampoline(int argc, char *argv[])
+{
+	sim_scenario::g_runner->task_main();
+}
+
+void
+ScenarioRunner::task_main()
+{
+	_local_pos_sp_sub = orb_subscribe(ORB_ID(vehicle_local_position_setpoint));
+	_control_mode_sub = orb_subscribe(ORB_ID(vehicle_control_mode));
+
+	while (!_task_should_exit) {
+		step();
+
+		/* lockstep: the simulated time stands still until the tasks woken by the step,
+		 * and those woken by their publications, wait in simulated time again */
+		if (hrt_wait_sleepers(SIM_LOCKSTEP_TIMEOUT * 1000) != 0) {
+			_lockstep_timeouts++;
+		}
+
+		if (_speedup > 0.0f) {
+			usleep(SIM_STEP_US / _speedup);
+		}
+	}
+
+	orb_unsubscribe(_local_pos_sp_sub);
+	orb_unsubscribe(_control_mode_sub);
+
+	_task = -1;
+}
+
+void
+ScenarioRunner::step()
+{
+	hrt_advance_simulated_time(SIM_STEP_US);
+	_steps++;
+
+	bool updated = false;
+	orb_check(_control_mode_sub, &updated);
+
+	if (updated) {
+		orb_copy(ORB_ID(vehicle_control_mode), _control_mode_sub, &_control_mode);
+	}
+
+	orb_check(_local_pos_sp_sub, &updated);
+
+	if (updated) {
+		orb_copy(ORB_ID(vehicle_local_position_setpoint), _local_pos_sp_sub, &_local_pos_sp);
+	}
+
+	const float dt = SIM_STEP_US * 1e-6f;
+
+	/* follow the position controller while it is in charge, otherwise come to rest */
+	if (_control_mode.flag_armed &&
+	    (_control_mode.flag_control_velocity_enabled || _control_mode.flag_control_climb_rate_enabled) &&
+	    hrt_elapsed_time(&_local_pos_sp.timestamp) < SIM_SETPOINT_TIMEOUT) {
+		_model.update(dt, _local_pos_sp.vx, _local_pos_sp.vy, _local_pos_sp.vz, _local_pos_sp.yaw);
+
+	} else {
+		_model.hold(dt);
+	}
+
+	_state = _model.state();
+
+	publish_vehicle();
+
+	if ((_steps % SIM_POSITION_DIVIDER) == 0) {
+		publish_manual();
+	}
+}
+
+void
+ScenarioRunner::publish_vehicle()
+{
+	const VehicleModel::State &state = _model.state();
+	hrt_abstime now = hrt_absolute_time();
+
+	vehicle_attitude_s att = {};
+	att.timestamp = now;
+	att.timestamp_sample = now;
+	att.yaw = state.yaw;
+
+	/* level, rotated by yaw */
+	float cy = cosf(state.yaw);
+	float sy = sinf(state.yaw);
+	att.R[0] = cy;
+	att.R[1] = -sy;
+	att.R[3] = sy;
+	att.R[4] = cy;
+	att.R[8] = 1.0f;
+	att.R_valid = true;
+	att.q[0] = cosf(0.5f * state.yaw);
+	att.q[3] = sinf(0.5f * state.yaw);
+	att.q_valid = true;
+	publish(ORB_ID(vehicle_attitude), _attitude_pub, att);
+
+	if ((_steps % SIM_POSITION_DIVIDER) != 0) {
+		return;
+	}
+
+	/* without gps only the altitude is known */
+	bool gps = _gps_enabled;
+
+	vehicle_local_position_s local_pos = {};
+	local_pos.timestamp = now;
+	local_pos.xy_valid = gps;
+	local_pos.z_valid = true;
+	local_pos.v_xy_valid = gps;
+	local_pos.v_z_valid = true;
+	local_pos.x = state.x;
+	local_pos.y = state.y;
+	local_pos.z = state.z;
+	local_pos.vx = state.vx;
+	local_pos.vy = state.vy;
+	local_pos.vz = state.vz;
+	local_pos.yaw = state.yaw;
+	local_pos.xy_global = gps;
+	local_pos.z_global = true;
+	local_pos.ref_timestamp = _ref_timestamp;
+	local_pos.ref_lat = _home_lat;
+	local_pos.ref_lon = _home_lon;
+	local_pos.ref_alt = _home_alt;
+	local_pos.dist_bottom = -state.z;
+	local_pos.dist_bottom_valid = true;
+	local_pos.eph = 0.5f;
+	local_pos.epv = 0.8f;
+	publish(ORB_ID(vehicle_local_position), _local_pos_pub, local_pos);
+
+	double lat, lon;
+	map_projection_reproject(&_ref, state.x, state.y, &lat, &lon);
+	float alt = _home_alt - state.z;
+
+	if (gps) {
+		vehicle_global_position_s global_pos = {};
+		global_pos.timestamp = now;
+		global_pos.lat = lat;
+		global_pos.lon = lon;
+		global_pos.alt = alt;
+		global_pos.vel_n = state.vx;
+		global_pos.vel_e = state.vy;
+		global_pos.vel_d = state.vz;
+		global_pos.yaw = state.yaw;
+		global_pos.eph = 0.5f;
+		global_pos.epv = 0.8f;
+		publish(ORB_ID(vehicle_global_position), _global_pos_pub, global_pos);
+	}
+
+	if (gps && (_steps % SIM_GPS_DIVIDER) == 0) {
+		vehicle_gps_position_s gps_pos = {};
+		gps_pos.timestamp_position = now;
+		gps_pos.timestamp_velocity = now;
+		gps_pos.timestamp_time = now;
+		gps_pos.lat = (int32_t)(lat * 1e7);
+		gps_pos.lon = (int32_t)(lon * 1e7);
+		gps_pos.alt = (int32_t)(alt * 1e3f);
+		gps_pos.fix_type = 3;
+		gps_pos.eph = 0.8f;
+		gps_pos.epv = 1.2f;
+		gps_pos.vel_n_m_s = state.vx;
+		gps_pos.vel_e_m_s = state.vy;
+		gps_pos.vel_d_m_s = state.vz;
+		gps_pos.vel_m_s = sqrtf(state.vx * state.vx + state.vy * state.vy);
+		gps_pos.cog_rad = atan2f(state.vy, state.vx);
+		gps_pos.vel_ned_valid = true;
+		gps_pos.satellites_used = 10;
+		publish(ORB_ID(vehicle_gps_position), _gps_pub, gps_pos);
+	}
+
+	sensor_combined_s sensors = {};
+	sensors.timestamp = now;
+	sensors.accelerometer_m_s2[2] = -CONSTANTS_ONE_G;
+	sensors.baro_alt_meter[0] = alt;
+	sensors.baro_timestamp[0] = now;
+	publish(ORB_ID(sensor_combined), _sensors_pub, sensors);
+
+	/* only on changes, like the land detector */
+	if (state.landed != _landed_published || _land_detected_pub == nullptr) {
+		vehicle_land_detected_s land_detected = {};
+		land_detected.timestamp = now;
+		land_detected.landed = state.landed;
+		publish(ORB_ID(vehicle_land_detected), _land_detected_pub, land_detected);
+		_landed_published = state.landed;
+	}
+}
+
+void
+ScenarioRunner::publish_manual()
+{
+	if (!_rc_enabled) {
+		return;
+	}
+
+	manual_control_setpoint_s manual = _manual;
+	manual.timestamp = hrt_absolute_time();
+	publish(ORB_ID(manual_control_setpoint), _manual_pub, manual);
+}
+
+void
+ScenarioRunner::publish_command(unsigned command, float param1, float param2)
+{
+	vehicle_command_s cmd = {};
+	cmd.command = command;
+	cmd.param1 = param1;
+	cmd.param2 = param2;
+	cmd.target_system = 1;
+	cmd.target_component = 0;
+	/* like a ground station */
+	cmd.source_system = 255;
+	cmd.source_component = 0;
+	cmd.confirmation = 1;
+	publish(ORB_ID(vehicle_command), _command_pub, cmd);
+}
+
+int
+ScenarioRunner::arm(bool arm)
+{
+	publish_command(vehicle_command_s::VEHICLE_CMD_COMPONENT_ARM_DISARM, arm ? 1.0f : 0.0f, 0.0f);
+	return OK;
+}
+
+int
+ScenarioRunner::set_mode(const char *mode)
+{
+	/* modes are selected with the RC switches, as a pilot would */
+	manual_control_setpoint_s manual = _manual;
+	manual.return_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	manual.posctl_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	manual.loiter_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+	manual.z = 0.5f;
+
+	if (!strcmp(mode, "manual")) {
+		manual.mode_switch = manual_control_setpoint_s::SWITCH_POS_OFF;
+		manual.z = 0.0f;
+
+	} else if (!strcmp(mode, "posctl")) {
+		manual.mode_switch = manual_control_setpoint_s::SWITCH_POS_MIDDLE;
+		manual.posctl_switch = manual_control_setpoint_s::SWITCH_POS_ON;
+
+	} else if (!strcmp(mode, "mission")) {
+		manual.mode_switch = manual_control_setpoint_s::SWITCH_POS_ON;
+
+	} else if (!strcmp(mode, "loiter")) {
+		manual.mode_switch = manual_control_setpoint_s::SWITCH_POS_ON;
+		manual.loiter_switch = manual_control_setpoint_s::SWITCH_POS_ON;
+
+	} else if (!strcmp(mode, "rtl")) {
+		manual.return_switch = manual_control_setpoint_s::SWITCH_POS_ON;
+
+	} else {
+		warnx("unknown mode %s", mode);
+		return ERROR;
+	}
+
+	_manual = manual;
+	return OK;
+}
+
+int
+ScenarioRunner::mission_add(enum NAV_CMD cmd, double lat, double lon, float alt)
+{
+	if (_mission_count >= SIM_MISSION_ITEMS_MAX) {
+		warnx("mission full");
+		return ERROR;
+	}
+
+	mission_item_s &item = _mission_items[_mission_count];
+	memset(&item, 0, sizeof(item));
+	item.lat = lat;
+	item.lon = lon;
+	item.altitude = _home_alt + alt;
+	item.altitude_is_relative = false;
+	item.yaw = NAN;
+	item.loiter_radius = 10.0f;
+	item.loiter_direction = 1;
+	item.nav_cmd = cmd;
+	item.acceptance_radius = 2.0f;
+	item.autocontinue = true;
+	item.origin = ORIGIN_MAVLINK;
+	_mission_count++;
+
+	return OK;
+}
+
+int
+ScenarioRunner::mission_upload()
+{
+	/* alternate the storage like the mavlink mission manager */
+	int dataman_id = (_mission_dataman_id == 0) ? 1 : 0;
+
+	if (_mission_count > 0 &&
+	    dm_write_range(DM_KEY_WAYPOINTS_OFFBOARD(dataman_id), 0, DM_PERSIST_POWER_ON_RESET, _mission_items, _mission_count,
+			   sizeof(mission_item_s)) != (ssize_t)_mission_count) {
+		warnx("can't store mission");
+		return ERROR;
+	}
+
+	mission_s mission = {};
+	mission.dataman_id = dataman_id;
+	mission.count = _mission_count;
+	mission.current_seq = 0;
+
+	if (dm_write(DM_KEY_MISSION_STATE, 0, DM_PERSIST_POWER_ON_RESET, &mission, sizeof(mission)) != sizeof(mission)) {
+		warnx("can't store mission state");
+		return ERROR;
+	}
+
+	_mission_dataman_id = dataman_id;
+	publish(ORB_ID(offboard_mission), _mission_pub, mission);
+	return OK;
+}
+
+void
+ScenarioRunner::wait(float seconds)
+{
+	hrt_abstime end = hrt_absolute_time() + (hrt_abstime)(seconds * 1e6f);
+
+	while (_task != -1 && hrt_absolute_time() < end) {
+		px4_usleep(1000);
+	}
+}
+
+bool
+ScenarioRunner::expect(const char *what, const char *value, float timeout)
+{
+	int field = -1;
+
+	for (unsigned i = 0; i < sizeof(expect_fields) / sizeof(expect_fields[0]); i++) {
+		if (!strcmp(what, expect_fields[i].name)) {
+			field = expect_fields[i].field;
+			break;
+		}
+	}
+
+	/* states are given by name, everything else by number */
+	int expected_state = -1;
+	char *end = nullptr;
+	float expected = strtof(value, &end);
+
+	if (field == EXPECT_ARMING) {
+		expected_state = find_name(value, arming_state_names, vehicle_status_s::ARMING_STATE_MAX);
+
+	} else if (field == EXPECT_NAV_STATE) {
+		expected_state = find_name(value, nav_state_names, vehicle_status_s::NAVIGATION_STATE_MAX);
+	}
+
+	if (field < 0 || ((field == EXPECT_ARMING || field == EXPECT_NAV_STATE) ? expected_state < 0 : *end != '\0')) {
+		warnx("FAIL: invalid condition %s %s", what, value);
+		_failures++;
+		return false;
+	}
+
+	int status_sub = orb_subscribe(ORB_ID(vehicle_status));
+	int mission_result_sub = orb_subscribe(ORB_ID(mission_result));
+	int geofence_result_sub = orb_subscribe(ORB_ID(geofence_result));
+
+	vehicle_status_s status = {};
+	mission_result_s mission_result = {};
+	geofence_result_s geofence_result = {};
+
+	hrt_abstime deadline = hrt_absolute_time() + (hrt_abstime)(timeout * 1e6f);
+	bool met = false;
+	float actual = NAN;
+
+	for (;;) {
+		orb_copy(ORB_ID(vehicle_status), status_sub, &status);
+		orb_copy(ORB_ID(mission_result), mission_result_sub, &mission_result);
+		orb_copy(ORB_ID(geofence_result), geofence_result_sub, &geofence_result);
+
+		VehicleModel::State state = _state;
+		float home_distance = sqrtf(state.x * state.x + state.y * state.y);
+
+		switch (field) {
+		case EXPECT_ARMING:
+			actual = status.arming_state;
+			met = (status.arming_state == expected_state);
+			break;
+
+		case EXPECT_NAV_STATE:
+			actual = status.nav_state;
+			met = (status.nav_state == expected_state);
+			break;
+
+		case EXPECT_FAILSAFE:
+			actual = status.failsafe;
+			met = (status.failsafe == (expected > 0.5f));
+			break;
+
+		case EXPECT_LANDED:
+			actual = state.landed;
+			met = (state.landed == (expected > 0.5f));
+			break;
+
+		case EXPECT_MISSION_FINISHED:
+			actual = mission_result.finished;
+			met = (mission_result.finished == (expected > 0.5f));
+			break;
+
+		case EXPECT_MISSION_REACHED:
+			actual = mission_result.reached ? (float)mission_result.seq_reached : -1.0f;
+			met = mission_result.reached && mission_result.seq_reached >= (unsigned)expected;
+			break;
+
+		case EXPECT_GEOFENCE_VIOLATED:
+			actual = geofence_result.geofence_violated;
+			met = (geofence_result.geofence_violated == (expected > 0.5f));
+			break;
+
+		case EXPECT_ALTITUDE_ABOVE:
+			actual = -state.z;
+			met = (actual > expected);
+			break;
+
+		case EXPECT_ALTITUDE_BELOW:
+			actual = -state.z;
+			met = (actual < expected);
+			break;
+
+		case EXPECT_HOME_DISTANCE_ABOVE:
+			actual = home_distance;
+			met = (actual > expected);
+			break;
+
+		case EXPECT_HOME_DISTANCE_BELOW:
+			actual = home_distance;
+			met = (actual < expected);
+			break;
+		}
+
+		if (met || _task == -1 || hrt_absolute_time() >= deadline) {
+			break;
+		}
+
+		px4_usleep(1000);
+	}
+
+	orb_unsubscribe(status_sub);
+	orb_unsubscribe(mission_result_sub);
+	orb_unsubscribe(geofence_result_sub);
+
+	float t = (hrt_absolute_time() - _ref_timestamp) * 1e-6f;
+
+	if (met) {
+		warnx("%8.2f s ok: %s %s", (double)t, what, value);
+
+	} else if (field == EXPECT_ARMING && actual >= 0 && actual < vehicle_status_s::ARMING_STATE_MAX) {
+		warnx("%8.2f s FAIL: %s %s, is %s", (double)t, what, value, arming_state_names[(int)actual]);
+		_failures++;
+
+	} else if (field == EXPECT_NAV_STATE && actual >= 0 && actual < vehicle_status_s::NAVIGATION_STATE_MAX) {
+		warnx("%8.2f s FAIL: %s %s, is %s", (double)t, what, value, nav_state_names[(int)actual]);
+		_failures++;
+
+	} else {
+		warnx("%8.2f s FAIL: %s %s, is %.2f", (double)t, what, value, (double)actual);
+		_failures++;
+	}
+
+	return met;
+}
+
+void
+ScenarioRunner::status()
+{
+	VehicleModel::State state = _state;
+	warnx("simulated time %.2f s, %u steps, %u lockstep timeouts, speedup %.1f",
+	      (double)((hrt_absolute_time() - _ref_timestamp) * 1e-6f), _steps, _lockstep_timeouts, (double)_speedup);
+	warnx("position N %.2f E %.2f D %.2f m, %s", (double)state.x, (double)state.y, (double)state.z,
+	      state.landed ? "landed" : "flying");
+	warnx("rc %s, gps %s, %u failed expectations", _rc_enabled ? "on" : "off", _gps_enabled ? "on" : "off", _failures);
+}
+
+static void usage(const char *reason)
+{
+	if (reason) {
+		warnx("%s", reason);
+	}
+
+	warnx("usage: sim_scenario {start [-r speedup] [-h lat lon alt]|stop|status|finish}");
+	warnx("       sim_scenario {arm|disarm|mode <manual|posctl|mission|loiter|rtl>|rc <on|off>|gps <on|off>}");
+	warnx("       sim_scenario mission {clear|takeoff <alt>|waypoint <lat> <lon> <alt>|land <lat> <lon>|upload}");
+	warnx("       sim_scenario {wait <seconds>|expect <condition> <value> [<timeout>]}");
+}
+
+int sim_scenario_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage("missing command");
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+
+		if (sim_scenario::g_runner != nullptr) {
+			warnx("already running");
+			return 1;
+		}
+
+		/* default home is the jMAVSim one */
+		double lat = 47.3977419;
+		double lon = 8.5455938;
+		float alt = 488.0f;
+		float speedup = 0.0f;
+
+		for (int i = 2; i < argc; i++) {
+			if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+				speedup = strtof(argv[++i], nullptr);
+
+			} else if (!strcmp(argv[i], "-h") && i + 3 < argc) {
+				lat = strtod(argv[++i], nullptr);
+				lon = strtod(argv[++i], nullptr);
+				alt = strtof(argv[++i], nullptr);
+
+			} else {
+				usage("invalid start option");
+				return 1;
+			}
+		}
+
+		sim_scenario::g_runner = new ScenarioRunner(lat, lon, alt, speedup);
+
+		if (sim_scenario::g_runner == nullptr) {
+			warnx("alloc failed");
+			return 1;
+		}
+
+		if (OK != sim_scenario::g_runner->start()) {
+			delete sim_scenario::g_runner;
+			sim_scenario::g_runner = nullptr;
+			warnx("start failed");
+			return 1;
+		}
+
+		return 0;
+	}
+
+	if (sim_scenario::g_runner == nullptr) {
+		warnx("not running");
+		return 1;
+	}
+
+	ScenarioRunner *runner = sim_scenario::g_runner;
+
+	if (!strcmp(argv[1], "stop")) {
+		delete runner;
+		return 0;
+
+	} else if (!strcmp(argv[1], "status")) {
+		runner->status();
+		return 0;
+
+	} else if (!strcmp(argv[1], "finish")) {
+		/* end of the scenario, the exit status tells the result */
+		unsigned failures = runner->get_failures();
+		warnx("%s, %u failed expectations", failures ? "FAILED" : "PASSED", failures);
+		delete runner;
+		exit(failures ? 1 : 0);
+
+	} else if (!strcmp(argv[1], "arm")) {
+		return runner->arm(true);
+
+	} else if (!strcmp(argv[1], "disarm")) {
+		return runner->arm(false);
+
+	} else if (!strcmp(argv[1], "mode") && argc > 2) {
+		return runner->set_mode(argv[2]);
+
+	} else if (!strcmp(argv[1], "rc") && argc > 2) {
+		runner->set_rc(!strcmp(argv[2], "on"));
+		return 0;
+
+	} else if (!strcmp(argv[1], "gps") && argc > 2) {
+		runner->set_gps(!strcmp(argv[2], "on"));
+		return 0;
+
+	} else if (!strcmp(argv[1], "wait") && argc > 2) {
+		runner->wait(strtof(argv[2], nullptr));
+		return 0;
+
+	} else if (!strcmp(argv[1], "expect") && argc > 3) {
+		return runner->expect(argv[2], argv[3], (argc > 4) ? strtof(argv[4], nullptr) : 0.0f) ? 0 : 1;
+
+	} else if (!strcmp(argv[1], "mission") && argc > 2) {
+		if (!strcmp(argv[2], "clear")) {
+			runner->mission_clear();
+			return 0;
+
+		} else if (!strcmp(argv[2], "takeoff") && argc > 3) {
+			return runner->mission_add(NAV_CMD_TAKEOFF, runner->get_home_lat(), runner->get_home_lon(),
+						   strtof(argv[3], nullptr));
+
+		} else if (!strcmp(argv[2], "waypoint") && argc > 5) {
+			return runner->mission_add(NAV_CMD_WAYPOINT, strtod(argv[3], nullptr), strtod(argv[4], nullptr),
+						   strtof(argv[5], nullptr));
+
+		} else if (!strcmp(argv[2], "land") && argc > 4) {
+			return runner->mission_add(NAV_CMD_LAND, strtod(argv[3], nullptr), strtod(argv[4], nullptr), 0.0f);
+
+		} else if (!strcmp(argv[2], "upload")) {
+			return runner->mission_upload();
+		}
+	}
+
+	usage("unrecognized command");
+	return 1;
+}
@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file vehicle_model.cpp
+ * Kinematic multicopter model for headless scenario runs
+ */
+
+#include <px4_defines.h>
+#include <math.h>
+
+#include "vehicle_model.h"
+
+/* time constant of the velocity response */
+static const float VELOCITY_TAU = 0.3f;
+static const float MAX_ACCELERATION = 6.0f;
+static const float MAX_YAW_RATE = M_PI_F / 2.0f;
+
+VehicleModel::VehicleModel() :
+	_state{}
+{
+	reset(0.0f);
+}
+
+void
+VehicleModel::reset(float yaw)
+{
+	_state = State{};
+	_state.yaw = yaw;
+	_state.landed = true;
+}
+
+void
+VehicleModel::step_velocity(float dt, float vx_sp, float vy_sp, float vz_sp)
+{
+	/* first order response, limited in acceleration */
+	float ax = (vx_sp - _state.vx) / VELOCITY_TAU;
+	float ay = (vy_sp - _state.vy) / VELOCITY_TAU;
+	float az = (vz_sp - _state.vz) / VELOCITY_TAU;
+	float a = sqrtf(ax * ax + ay * ay + az * az);
+
+	if (a > MAX_ACCELERATION) {
+		ax *= MAX_ACCELERATION / a;
+		ay *= MAX_ACCELERATION / a;
+		az *= MAX_ACCELERATION / a;
+	}
+
+	/* do not overshoot the setpoint within one step */
+	float k = (dt < VELOCITY_TAU) ? dt : VELOCITY_TAU;
+	_state.vx += ax * k;
+	_state.vy += ay * k;
+	_state.vz += az * k;
+
+	_state.x += _state.vx * dt;
+	_state.y += _state.vy * dt;
+	_state.z += _state.vz * dt;
+
+	/* the ground stops any descent and friction any sliding */
+	if (_state.z >= 0.0f) {
+		_state.z = 0.0f;
+		_state.vx = 0.0f;
+		_state.vy = 0.0f;
+
+		if (_state.vz > 0.0f) {
+			_state.vz = 0.0f;
+		}
+	}
+
+	_state.landed = (_state.z >= 0.0f) && (vz_sp >= 0.0f);
+}
+
+void
+VehicleModel::update(float dt, float vx_sp, float vy_sp, float vz_sp, float yaw_sp)
+{
+	if (!isfinite(vx_sp) || !isfinite(vy_sp) || !isfinite(vz_sp)) {
+		hold(dt);
+		return;
+	}
+
+	step_velocity(dt, vx_sp, vy_sp, vz_sp);
+
+	if (isfinite(yaw_sp) && !_state.landed) {
+		float yaw_err = yaw_sp - _state.yaw;
+
+		if (yaw_err > M_PI_F) {
+			yaw_err -= 2.0f * M_PI_F;
+
+		} else if (yaw_err < -M_PI_F) {
+			yaw_err += 2.0f * M_PI_F;
+		}
+
+		float max_step = MAX_YAW_RATE * dt;
+		_state.yaw += (yaw_err > max_step) ? max_step : ((yaw_err < -max_step) ? -max_step : yaw_err);
+
+		if (_state.yaw > M_PI_F) {
+			_state.yaw -= 2.0f * M_PI_F;
+
+		} else if (_state.yaw < -M_PI_F) {
+			_state.yaw += 2.0f * M_PI_F;
+		}
+	}
+}
+
+void
+VehicleModel::hold(float dt)
+{
+	/* without controller a resting vehicle stays on the ground, a flying one hovers */
+	step_velocity(dt, 0.0f, 0.0f, 0.0f);
+}
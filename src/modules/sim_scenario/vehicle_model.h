@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file vehicle_model.h
+ * Kinematic multicopter model for headless scenario runs
+ *
+ * The vehicle follows the velocity setpoint of the position controller with a
+ * first order lag and limited acceleration, on a flat ground at z = 0.
+ */
+
+#ifndef VEHICLE_MODEL_H_
+#define VEHICLE_MODEL_H_
+
+class VehicleModel
+{
+public:
+	struct State {
+		float x;		/**< position in meters NED */
+		float y;
+		float z;
+		float vx;		/**< velocity in meters/sec NED */
+		float vy;
+		float vz;
+		float yaw;		/**< in radians NED -PI..+PI */
+		bool landed;		/**< on the ground and not asked to climb */
+	};
+
+	VehicleModel();
+
+	/**
+	 * Put the vehicle on the ground at the origin.
+	 */
+	void reset(float yaw);
+
+	/**
+	 * Advance the model by dt seconds following a velocity and yaw setpoint.
+	 */
+	void update(float dt, float vx_sp, float vy_sp, float vz_sp, float yaw_sp);
+
+	/**
+	 * Advance the model by dt seconds without setpoint, the vehicle comes to rest.
+	 */
+	void hold(float dt);
+
+	const State &state() const { return _state; }
+
+private:
+	State _state;
+
+	void step_velocity(float dt, float vx_sp, float vy_sp, float vz_sp);
+};
+
+#endif /* VEHICLE_MODEL_H_ */
@@ -54,7 +54,7 @@ using namespace simulator;
 
 static px4_task_t g_sim_task = -1;
 
-Simulator *Simulator::_instance = NULL;
+px4::VehicleInstance<Simulator> Simulator::_instance;
 
 Simulator *Simulator::getInstance()
 {
@@ -121,39 +121,137 @@ void Simulator::write_airspeed_data(void *buf)
 	_airspeed.writeData(buf);
 }
 
-int Simulator::start(int argc, char *argv[])
+unsigned Simulator::getSequence(sim_dev_t dev)
+{
+	switch (dev) {
+	case SIM_GYRO:
+		return _mpu.sequence();
+
+	case SIM_ACCEL:
+		return _accel.sequence();
+
+	case SIM_MAG:
+		return _mag.sequence();
+
+	case SIM_BARO:
+		return _baro.sequence();
+
+	case SIM_GPS:
+		return _gps.sequence();
+
+	case SIM_AIRSPEED:
+		return _airspeed.sequence();
+	}
+
+	return 0;
+}
+
+bool Simulator::addNotify(sim_dev_t dev, void (*callback)(void *), void *arg, unsigned interval)
+{
+	switch (dev) {
+	case SIM_GYRO:
+		return _mpu.addNotify(callback, arg, interval);
+
+	case SIM_ACCEL:
+		return _accel.addNotify(callback, arg, interval);
+
+	case SIM_MAG:
+		return _mag.addNotify(callback, arg, interval);
+
+	case SIM_BARO:
+		return _baro.addNotify(callback, arg, interval);
+
+	case SIM_GPS:
+		return _gps.addNotify(callback, arg, interval);
+
+	case SIM_AIRSPEED:
+		return _airspeed.addNotify(callback, arg, interval);
+	}
+
+	return false;
+}
+
+void Simulator::removeNotify(sim_dev_t dev, void (*callback)(void *), void *arg)
 {
-	int ret = 0;
-	_instance = new Simulator();
+	switch (dev) {
+	case SIM_GYRO:
+		_mpu.removeNotify(callback, arg);
+		break;
+
+	case SIM_ACCEL:
+		_accel.removeNotify(callback, arg);
+		break;
+
+	case SIM_MAG:
+		_mag.removeNotify(callback, arg);
+		break;
+
+	case SIM_BARO:
+		_baro.removeNotify(callback, arg);
+		break;
+
+	case SIM_GPS:
+		_gps.removeNotify(callback, arg);
+		break;
+
+	case SIM_AIRSPEED:
+		_airspeed.removeNotify(callback, arg);
+		break;
+	}
+}
+
+Simulator *Simulator::create(int argc, char *argv[])
+{
+	Simulator *sim = new Simulator();
 
-	if (_instance) {
-		drv_led_start();
+	if (sim == nullptr) {
+		PX4_WARN("Simulator creation failed");
+		return nullptr;
+	}
+
+	drv_led_start();
 
-		if (argv[2][1] == 's') {
-			_instance->initializeSensorData();
 #ifndef __PX4_QURT
-			// Update sensor data
-			_instance->pollForMAVLinkMessages(false);
+	// run on the time of the simulator
+	sim->_lockstep = (argc > 3 && strcmp(argv[3], "-t") == 0);
+	sim->_publish = (argv[2][1] != 's');
 #endif
 
-		} else {
-			// Update sensor data
-			_instance->pollForMAVLinkMessages(true);
-		}
+	if (argv[2][1] == 's') {
+		sim->initializeSensorData();
+	}
 
-	} else {
-		PX4_WARN("Simulator creation failed");
-		ret = 1;
+	_instance = sim;
+	return sim;
+}
+
+int Simulator::start(int argc, char *argv[])
+{
+	Simulator *sim = create(argc, argv);
+
+	if (sim == nullptr) {
+		return 1;
 	}
 
-	return ret;
+#ifndef __PX4_QURT
+	// Update sensor data
+	sim->pollForMAVLinkMessages();
+#endif
+
+	return 0;
 }
 
 static void usage()
 {
-	PX4_WARN("Usage: simulator {start -[sc] |stop}");
+	PX4_WARN("Usage: simulator {start -[sc] [-t] |stop}");
 	PX4_WARN("Simulate raw sensors:     simulator start -s");
 	PX4_WARN("Publish sensors combined: simulator start -p");
+	PX4_WARN("Simulated time:           simulator start -s -t");
+#if PX4_MAX_VEHICLES > 1
+	PX4_WARN("Every vehicle starts its own simulator, the first one connects to the");
+	PX4_WARN("simulators of all vehicles. Vehicle n must send with MAVLink system id n + 1");
+	PX4_WARN("and only one vehicle can run on simulated time.");
+#endif
 }
 
 __BEGIN_DECLS
@@ -166,19 +264,26 @@ extern "C" {
 	{
 		int ret = 0;
 
-		if (argc == 3 && strcmp(argv[1], "start") == 0) {
-			if (strcmp(argv[2], "-s") == 0 || strcmp(argv[2], "-p") == 0) {
-				if (g_sim_task >= 0) {
+		if ((argc == 3 || argc == 4) && strcmp(argv[1], "start") == 0) {
+			if ((strcmp(argv[2], "-s") == 0 || strcmp(argv[2], "-p") == 0) &&
+			    (argc == 3 || strcmp(argv[3], "-t") == 0)) {
+				if (g_sim_task >= 0 && Simulator::getInstance() != nullptr) {
 					warnx("Simulator already started");
 					return 0;
 				}
 
-				g_sim_task = px4_task_spawn_cmd("Simulator",
-								SCHED_DEFAULT,
-								SCHED_PRIORITY_MAX - 5,
-								1500,
-								Simulator::start,
-								argv);
+				// the task of the first vehicle talks to the simulators of all vehicles
+				if (g_sim_task < 0) {
+					g_sim_task = px4_task_spawn_cmd("Simulator",
+									SCHED_DEFAULT,
+									SCHED_PRIORITY_MAX - 5,
+									1500,
+									Simulator::start,
+									argv);
+
+				} else if (Simulator::create(argc, argv) == nullptr) {
+					return 1;
+				}
 
 				// now wait for the command to complete
 				while (true) {
@@ -39,6 +39,7 @@
 #pragma once
 
 #include <px4_posix.h>
+#include <px4_vehicle.h>
 #include <uORB/topics/hil_sensor.h>
 #include <uORB/topics/manual_control_setpoint.h>
 #include <uORB/topics/actuator_outputs.h>
@@ -54,6 +55,9 @@
 #include <uORB/topics/optical_flow.h>
 #include <v1.0/mavlink_types.h>
 #include <v1.0/common/mavlink.h>
+#ifndef __PX4_QURT
+#include <netinet/in.h>
+#endif
 namespace simulator
 {
 
@@ -120,61 +124,184 @@ struct RawGPSData {
 };
 #pragma pack(pop)
 
+/**
+ * Latest report of a simulated sensor, written by the simulator thread and
+ * read by the sim drivers.
+ *
+ * The reports rotate through three buffers. A reader copies the latest one
+ * without locking and retries if the writer went round to that buffer in the
+ * meantime, so the writer never waits. Every report has a sequence number,
+ * and the writer calls back the drivers which want to run on fresh data.
+ */
 template <typename RType> class Report
 {
 public:
-	Report(int readers) :
-		_readidx(0),
-		_max_readers(readers),
-		_report_len(sizeof(RType))
+	typedef void (*notify_t)(void *arg);
+
+	static const int MAX_NOTIFY = 2;
+
+	Report() :
+		_state(0),
+		_report_len(sizeof(RType)),
+		_notify_count(0),
+		_notify{}
 	{
-		px4_sem_init(&_lock, 0, _max_readers);
+		px4_sem_init(&_notify_lock, 0, 1);
 	}
 
-	~Report() {};
+	~Report()
+	{
+		px4_sem_destroy(&_notify_lock);
+	}
 
-	bool copyData(void *outbuf, int len)
+	/**
+	 * Copy out the latest report.
+	 *
+	 * @param sequence	If not null, set to the sequence number of the
+	 *			report, which goes up by one with every write.
+	 */
+	bool copyData(void *outbuf, int len, unsigned *sequence = nullptr)
 	{
 		if (len != _report_len) {
 			return false;
 		}
 
-		read_lock();
-		memcpy(outbuf, &_buf[_readidx], _report_len);
-		read_unlock();
+		unsigned state;
+		unsigned check;
+
+		do {
+			state = __atomic_load_n(&_state, __ATOMIC_ACQUIRE);
+			memcpy(outbuf, &_buf[state & SLOT_MASK], _report_len);
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			check = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+
+			/* the buffer is only reused by the second write after this one */
+		} while (((check >> SEQUENCE_SHIFT) - (state >> SEQUENCE_SHIFT)) > 1);
+
+		if (sequence != nullptr) {
+			*sequence = state >> SEQUENCE_SHIFT;
+		}
+
 		return true;
 	}
+
+	/**
+	 * Store a new report, only ever called from one thread.
+	 */
 	void writeData(void *inbuf)
 	{
-		write_lock();
-		memcpy(&_buf[!_readidx], inbuf, _report_len);
-		_readidx = !_readidx;
-		write_unlock();
+		unsigned state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+		unsigned slot = ((state & SLOT_MASK) + 1) % 3;
+
+		/* order the last update of _state before overwriting a buffer, see copyData() */
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		memcpy(&_buf[slot], inbuf, _report_len);
+		__atomic_store_n(&_state, (state & ~SLOT_MASK) + (1 << SEQUENCE_SHIFT) + slot, __ATOMIC_RELEASE);
+
+		if (__atomic_load_n(&_notify_count, __ATOMIC_ACQUIRE) > 0) {
+			notify();
+		}
 	}
 
-protected:
-	void read_lock() { px4_sem_wait(&_lock); }
-	void read_unlock() { px4_sem_post(&_lock); }
-	void write_lock()
+	/**
+	 * Sequence number of the latest report.
+	 */
+	unsigned sequence()
+	{
+		return __atomic_load_n(&_state, __ATOMIC_ACQUIRE) >> SEQUENCE_SHIFT;
+	}
+
+	/**
+	 * Have the writer call back after a new report, at most once per interval.
+	 * The callback runs on the simulator thread, it must not block nor add or
+	 * remove callbacks.
+	 *
+	 * @param interval	Minimum interval between calls in microseconds, or 0
+	 *			to be called for every report.
+	 * @return		false if there are too many callbacks already.
+	 */
+	bool addNotify(notify_t callback, void *arg, unsigned interval)
+	{
+		bool ret = false;
+		px4_sem_wait(&_notify_lock);
+
+		for (int i = 0; i < MAX_NOTIFY; i++) {
+			if (_notify[i].callback == nullptr) {
+				_notify[i].callback = callback;
+				_notify[i].arg = arg;
+				_notify[i].interval = interval;
+				_notify[i].deadline = 0;
+				__atomic_add_fetch(&_notify_count, 1, __ATOMIC_RELEASE);
+				ret = true;
+				break;
+			}
+		}
+
+		px4_sem_post(&_notify_lock);
+		return ret;
+	}
+
+	/**
+	 * Remove a callback. It is not called any more once this returns.
+	 */
+	void removeNotify(notify_t callback, void *arg)
 	{
-		for (int i = 0; i < _max_readers; i++) {
-			px4_sem_wait(&_lock);
+		px4_sem_wait(&_notify_lock);
+
+		for (int i = 0; i < MAX_NOTIFY; i++) {
+			if (_notify[i].callback == callback && _notify[i].arg == arg) {
+				_notify[i].callback = nullptr;
+				__atomic_sub_fetch(&_notify_count, 1, __ATOMIC_RELEASE);
+			}
 		}
+
+		px4_sem_post(&_notify_lock);
 	}
-	void write_unlock()
+
+protected:
+	/* the low bits of _state are the buffer of the latest report, the rest its sequence number */
+	static const unsigned SLOT_MASK = 3;
+	static const unsigned SEQUENCE_SHIFT = 2;
+
+	struct Notify {
+		notify_t callback;
+		void *arg;
+		unsigned interval;
+		hrt_abstime deadline;
+	};
+
+	void notify()
 	{
-		for (int i = 0; i < _max_readers; i++) {
-			px4_sem_post(&_lock);
+		hrt_abstime now = hrt_absolute_time();
+		px4_sem_wait(&_notify_lock);
+
+		for (int i = 0; i < MAX_NOTIFY; i++) {
+			Notify &n = _notify[i];
+
+			/* allow for jitter of the reports, otherwise an interval equal to the report
+			 * period would skip every other one */
+			if (n.callback == nullptr || now + n.interval / 2 < n.deadline) {
+				continue;
+			}
+
+			/* keep the average rate if the reports come faster than the interval */
+			n.deadline = (n.deadline + n.interval > now) ? n.deadline + n.interval : now + n.interval;
+			n.callback(n.arg);
 		}
+
+		px4_sem_post(&_notify_lock);
 	}
 
-	int _readidx;
-	px4_sem_t _lock;
-	const int _max_readers;
+	unsigned _state;
 	const int _report_len;
-	RType _buf[2];
+	RType _buf[3];
+
+	px4_sem_t _notify_lock;
+	int _notify_count;
+	Notify _notify[MAX_NOTIFY];
 };
 
+
 };
 
 class Simulator
@@ -183,9 +310,12 @@ public:
 	static Simulator *getInstance();
 
 	enum sim_dev_t {
-		SIM_GYRO,
+		SIM_GYRO,	/**< MPU report with gyro and accel */
 		SIM_ACCEL,
-		SIM_MAG
+		SIM_MAG,
+		SIM_BARO,
+		SIM_GPS,
+		SIM_AIRSPEED
 	};
 
 	struct sample {
@@ -196,8 +326,18 @@ public:
 		sample(float a, float b, float c) : x(a), y(b), z(c) {}
 	};
 
+	/**
+	 * Task which creates the simulator of the calling task's vehicle and
+	 * then talks to the simulators of all vehicles.
+	 */
 	static int start(int argc, char *argv[]);
 
+	/**
+	 * Create the simulator of the calling task's vehicle, for the task
+	 * started before to talk to.
+	 */
+	static Simulator *create(int argc, char *argv[]);
+
 	bool getRawAccelReport(uint8_t *buf, int len);
 	bool getMagReport(uint8_t *buf, int len);
 	bool getMPUReport(uint8_t *buf, int len);
@@ -212,16 +352,30 @@ public:
 	void write_gps_data(void *buf);
 	void write_airspeed_data(void *buf);
 
+	/**
+	 * Sequence number of the latest report of a sensor, which goes up by one
+	 * with every report from the simulator.
+	 */
+	unsigned getSequence(sim_dev_t dev);
+
+	/**
+	 * Call back on the simulator thread after each new report of a sensor, at
+	 * most once per interval in microseconds. The callback must not block.
+	 */
+	bool addNotify(sim_dev_t dev, void (*callback)(void *), void *arg, unsigned interval);
+	void removeNotify(sim_dev_t dev, void (*callback)(void *), void *arg);
+
 	bool isInitialized() { return _initialized; }
 
 private:
 	Simulator() :
-		_accel(1),
-		_mpu(1),
-		_baro(1),
-		_mag(1),
-		_gps(1),
-		_airspeed(1),
+		_vehicle(px4_vehicle_id()),
+		_accel(),
+		_mpu(),
+		_baro(),
+		_mag(),
+		_gps(),
+		_airspeed(),
 		_accel_pub(nullptr),
 		_baro_pub(nullptr),
 		_gyro_pub(nullptr),
@@ -234,18 +388,24 @@ private:
 		_vehicle_attitude_sub(-1),
 		_manual_sub(-1),
 		_vehicle_status_sub(-1),
+		_publish(false),
+		_lockstep(false),
+		_time_offset(0),
 		_rc_input{},
 		_actuators{},
 		_attitude{},
 		_manual{},
-		_vehicle_status{}
+		_vehicle_status{},
+		_srcaddr{}
 #endif
 	{}
 	~Simulator() { _instance = NULL; }
 
 	void initializeSensorData();
 
-	static Simulator *_instance;
+	static px4::VehicleInstance<Simulator> _instance;
+
+	const int _vehicle;
 
 	// simulated sensor instances
 	simulator::Report<simulator::RawAccelData>	_accel;
@@ -278,6 +438,13 @@ private:
 	int _manual_sub;
 	int _vehicle_status_sub;
 
+	// publish the sensor topics instead of feeding the sim drivers
+	bool _publish;
+
+	// simulated time from the HIL_SENSOR timestamps
+	bool _lockstep;
+	uint64_t _time_offset;
+
 	// uORB data containers
 	struct rc_input_values _rc_input;
 	struct actuator_outputs_s _actuators;
@@ -285,16 +452,22 @@ private:
 	struct manual_control_setpoint_s _manual;
 	struct vehicle_status_s _vehicle_status;
 
+	// where the simulator of this vehicle sends from
+	struct sockaddr_in _srcaddr;
+
 	void poll_topics();
 	void handle_message(mavlink_message_t *msg, bool publish);
 	void send_controls();
-	void pollForMAVLinkMessages(bool publish);
+	void pollForMAVLinkMessages();
+	void handle_datagram(const uint8_t *buf, int len, const struct sockaddr_in &srcaddr);
+	void receive(mavlink_message_t *msg, const struct sockaddr_in &srcaddr);
 
 	void pack_actuator_message(mavlink_hil_controls_t &actuator_msg);
 	void send_mavlink_message(const uint8_t msgid, const void *msg, uint8_t component_ID);
 	void update_sensors(mavlink_hil_sensor_t *imu);
 	void update_gps(mavlink_hil_gps_t *gps_sim);
-	static void *sending_trampoline(void *);
+	void update_time(uint64_t time_usec);
+	static void *sending_trampoline(void *arg);
 	void send();
 #endif
 };
@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file simulator_datagram.cpp
+ * MAVLink messages of the UDP datagrams sent by the simulator
+ */
+
+#include <string.h>
+#include "simulator_datagram.h"
+
+static const uint8_t mavlink_message_lengths[256] = MAVLINK_MESSAGE_LENGTHS;
+static const uint8_t mavlink_message_crcs[256] = MAVLINK_MESSAGE_CRCS;
+
+bool decode_datagram(const uint8_t *buf, int len, mavlink_message_t *msg)
+{
+	if (len < MAVLINK_NUM_NON_PAYLOAD_BYTES || buf[0] != MAVLINK_STX) {
+		return false;
+	}
+
+	const uint8_t payload_len = buf[1];
+	const uint8_t msgid = buf[5];
+
+	if (len != payload_len + MAVLINK_NUM_NON_PAYLOAD_BYTES || payload_len != mavlink_message_lengths[msgid]) {
+		return false;
+	}
+
+	uint16_t checksum;
+	crc_init(&checksum);
+	crc_accumulate_buffer(&checksum, (const char *)&buf[1], MAVLINK_CORE_HEADER_LEN + payload_len);
+	crc_accumulate(mavlink_message_crcs[msgid], &checksum);
+
+	if (buf[len - 2] != (uint8_t)(checksum & 0xFF) || buf[len - 1] != (uint8_t)(checksum >> 8)) {
+		return false;
+	}
+
+	msg->checksum = checksum;
+	msg->magic = buf[0];
+	msg->len = payload_len;
+	msg->seq = buf[2];
+	msg->sysid = buf[3];
+	msg->compid = buf[4];
+	msg->msgid = msgid;
+	memcpy(_MAV_PAYLOAD_NON_CONST(msg), &buf[MAVLINK_NUM_HEADER_BYTES], payload_len);
+
+	return true;
+}
+
+DatagramReader::DatagramReader(const uint8_t *buf, int len) :
+	_buf(buf),
+	_len(len),
+	_pos(0),
+	_single(false)
+{
+}
+
+bool DatagramReader::next(mavlink_message_t *msg)
+{
+	if (_pos == 0) {
+		if (decode_datagram(_buf, _len, msg)) {
+			_pos = _len;
+			_single = true;
+			return true;
+		}
+
+		// drop what is left of a truncated message in the previous datagram
+		mavlink_get_channel_status(MAVLINK_COMM_0)->parse_state = MAVLINK_PARSE_STATE_IDLE;
+	}
+
+	if (_single) {
+		return false;
+	}
+
+	mavlink_status_t status;
+
+	while (_pos < _len) {
+		if (mavlink_parse_char(MAVLINK_COMM_0, _buf[_pos++], msg, &status)) {
+			return true;
+		}
+	}
+
+	return false;
+}
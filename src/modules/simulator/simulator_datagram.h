@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file simulator_datagram.h
+ * MAVLink messages of the UDP datagrams sent by the simulator
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <v1.0/mavlink_types.h>
+#include <v1.0/common/mavlink.h>
+
+/**
+ * Decode a datagram holding exactly one MAVLink 1.0 message, which is how
+ * the simulators send HIL_SENSOR and the other HIL data.
+ *
+ * This takes the header and payload as a whole instead of running the byte
+ * by byte parser.
+ *
+ * @return true if msg holds the message of the datagram
+ */
+bool decode_datagram(const uint8_t *buf, int len, mavlink_message_t *msg);
+
+/**
+ * Splits a datagram into its MAVLink messages.
+ *
+ * A single message datagram is taken by decode_datagram(), anything else
+ * goes through mavlink_parse_char(). A message never spans two datagrams, so
+ * the parser starts over with each datagram and a truncated message does not
+ * swallow the start of the next datagram.
+ */
+class DatagramReader
+{
+public:
+	DatagramReader(const uint8_t *buf, int len);
+
+	/**
+	 * Get the next message of the datagram.
+	 *
+	 * @return true if msg holds the next message, false at the end of the datagram
+	 */
+	bool next(mavlink_message_t *msg);
+
+private:
+	const uint8_t *_buf;
+	int _len;
+	int _pos;
+	bool _single;
+};
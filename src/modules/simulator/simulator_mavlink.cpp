@@ -34,6 +34,7 @@
 #include <px4_log.h>
 #include <px4_time.h>
 #include "simulator.h"
+#include "simulator_datagram.h"
 #include "errno.h"
 #include <geo/geo.h>
 #include <drivers/drv_pwm_output.h>
@@ -44,6 +45,9 @@ extern "C" __EXPORT hrt_abstime hrt_reset(void);
 
 #define SEND_INTERVAL 	20
 #define UDP_PORT 	14560
+#define RECV_BATCH 	16		// datagrams taken from the socket at once
+#define RECV_BUF_SIZE 	512		// bytes per datagram, fits a few messages
+#define RECV_SOCKET_BUF	(256 * 1024)	// room for the data arriving while a batch is handled
 #define PIXHAWK_DEVICE "/dev/ttyACM0"
 
 #ifndef B460800
@@ -54,6 +58,11 @@ extern "C" __EXPORT hrt_abstime hrt_reset(void);
 #define B921600 921600
 #endif
 
+// HIL_SENSOR fields_updated bits
+#define MAG_FIELDS	(0x7 << 6)
+#define BARO_FIELDS	((1 << 9) | (1 << 11))
+#define ALL_FIELDS	0x1FFF
+
 #define PRESS_GROUND 101325.0f
 #define DENSITY 1.2041f
 #define GRAVITY 9.81f
@@ -65,9 +74,7 @@ static const float mg2ms2 = CONSTANTS_ONE_G / 1000.0f;
 static int openUart(const char *uart_name, int baud);
 
 static int _fd;
-static unsigned char _buf[200];
-sockaddr_in _srcaddr;
-static socklen_t _addrlen = sizeof(_srcaddr);
+static unsigned char _buf[RECV_BATCH][RECV_BUF_SIZE];
 
 using namespace simulator;
 
@@ -231,6 +238,18 @@ void Simulator::update_gps(mavlink_hil_gps_t *gps_sim)
 	write_gps_data((void *)&gps);
 }
 
+void Simulator::update_time(uint64_t time_usec)
+{
+	// the first sensor message starts the simulated clock at the current time,
+	// from then on the simulator sets the pace
+	if (!hrt_simulated_time_enabled()) {
+		hrt_start_simulated_time();
+		_time_offset = hrt_absolute_time() - time_usec;
+	}
+
+	hrt_set_simulated_time(time_usec + _time_offset);
+}
+
 void Simulator::handle_message(mavlink_message_t *msg, bool publish)
 {
 	switch (msg->msgid) {
@@ -238,6 +257,10 @@ void Simulator::handle_message(mavlink_message_t *msg, bool publish)
 		mavlink_hil_sensor_t imu;
 		mavlink_msg_hil_sensor_decode(msg, &imu);
 
+		if (_lockstep) {
+			update_time(imu.time_usec);
+		}
+
 		if (publish) {
 			publish_sensor_topics(&imu);
 		}
@@ -310,7 +333,7 @@ void Simulator::send_mavlink_message(const uint8_t msgid, const void *msg, uint8
 	buf[MAVLINK_NUM_HEADER_BYTES + payload_len] = (uint8_t)(checksum & 0xFF);
 	buf[MAVLINK_NUM_HEADER_BYTES + payload_len + 1] = (uint8_t)(checksum >> 8);
 
-	ssize_t len = sendto(_fd, buf, packet_len, 0, (struct sockaddr *)&_srcaddr, _addrlen);
+	ssize_t len = sendto(_fd, buf, packet_len, 0, (struct sockaddr *)&_srcaddr, sizeof(_srcaddr));
 
 	if (len <= 0) {
 		PX4_WARN("Failed sending mavlink message");
@@ -334,9 +357,11 @@ void Simulator::poll_topics()
 	}
 }
 
-void *Simulator::sending_trampoline(void *)
+void *Simulator::sending_trampoline(void *arg)
 {
-	_instance->send();
+	Simulator *sim = (Simulator *)arg;
+	px4_vehicle_set(sim->_vehicle);
+	sim->send();
 	return 0;	// why do I have to put this???
 }
 
@@ -406,7 +431,64 @@ void Simulator::initializeSensorData()
 	write_airspeed_data((void *)&airspeed);
 }
 
-void Simulator::pollForMAVLinkMessages(bool publish)
+void Simulator::handle_datagram(const uint8_t *buf, int len, const struct sockaddr_in &srcaddr)
+{
+	DatagramReader reader(buf, len);
+	mavlink_message_t msg;
+
+	while (reader.next(&msg)) {
+		// the simulator of vehicle n sends with system id n + 1, others go to the first vehicle
+		int vehicle = (msg.sysid > 0 && msg.sysid <= PX4_MAX_VEHICLES) ? msg.sysid - 1 : 0;
+		Simulator *sim = _instance.instance(vehicle);
+
+		// have a message, hand it to the simulator of its vehicle
+		if (sim != nullptr) {
+			px4_vehicle_set(vehicle);
+			sim->receive(&msg, srcaddr);
+		}
+	}
+}
+
+void Simulator::receive(mavlink_message_t *msg, const struct sockaddr_in &srcaddr)
+{
+	_srcaddr = srcaddr;
+
+	if (!_initialized) {
+		// respond to the first data with the first controls
+		// this is important for the UDP communication to work
+		PX4_INFO("Sending initial controls message to jMAVSim.");
+		send_controls();
+
+		// subscribe to topics
+		_actuator_outputs_sub = orb_subscribe_multi(ORB_ID(actuator_outputs), 0);
+		_vehicle_status_sub = orb_subscribe(ORB_ID(vehicle_status));
+
+		// create a thread for sending data to the simulator
+		pthread_t sender_thread;
+
+		// initialize threads
+		pthread_attr_t sender_thread_attr;
+		pthread_attr_init(&sender_thread_attr);
+		pthread_attr_setstacksize(&sender_thread_attr, 1000);
+
+		struct sched_param param;
+		(void)pthread_attr_getschedparam(&sender_thread_attr, &param);
+
+		/* low priority */
+		param.sched_priority = SCHED_PRIORITY_DEFAULT;
+		(void)pthread_attr_setschedparam(&sender_thread_attr, &param);
+
+		// got data from simulator, now activate the sending thread
+		pthread_create(&sender_thread, &sender_thread_attr, Simulator::sending_trampoline, this);
+		pthread_attr_destroy(&sender_thread_attr);
+
+		_initialized = true;
+	}
+
+	handle_message(msg, _publish);
+}
+
+void Simulator::pollForMAVLinkMessages()
 {
 	// udp socket data
 	struct sockaddr_in _myaddr;
@@ -428,20 +510,12 @@ void Simulator::pollForMAVLinkMessages(bool publish)
 		return;
 	}
 
-	// create a thread for sending data to the simulator
-	pthread_t sender_thread;
-
-	// initialize threads
-	pthread_attr_t sender_thread_attr;
-	pthread_attr_init(&sender_thread_attr);
-	pthread_attr_setstacksize(&sender_thread_attr, 1000);
-
-	struct sched_param param;
-	(void)pthread_attr_getschedparam(&sender_thread_attr, &param);
+	// keep the samples which arrive while a batch is being published
+	int rcvbuf = RECV_SOCKET_BUF;
 
-	/* low priority */
-	param.sched_priority = SCHED_PRIORITY_DEFAULT;
-	(void)pthread_attr_setschedparam(&sender_thread_attr, &param);
+	if (setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)) < 0) {
+		PX4_WARN("failed to set socket receive buffer size");
+	}
 
 	// setup serial connection to autopilot (used to get manual controls)
 	int serial_fd = openUart(PIXHAWK_DEVICE, 115200);
@@ -475,8 +549,24 @@ void Simulator::pollForMAVLinkMessages(bool publish)
 
 	int len = 0;
 
-	// wait for first data from simulator and respond with first controls
-	// this is important for the UDP communication to work
+	struct sockaddr_in srcaddr[RECV_BATCH];
+#ifdef __PX4_LINUX
+	// one recvmmsg call takes all datagrams which are waiting, up to a batch
+	struct iovec iov[RECV_BATCH];
+	struct mmsghdr msgs[RECV_BATCH];
+	memset(msgs, 0, sizeof(msgs));
+
+	for (int i = 0; i < RECV_BATCH; i++) {
+		iov[i].iov_base = _buf[i];
+		iov[i].iov_len = sizeof(_buf[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &srcaddr[i];
+	}
+
+#endif
+
+	// wait for first data from simulator
 	int pret = -1;
 	PX4_INFO("Waiting for initial data on UDP. Please start the flight simulator to proceed..");
 
@@ -485,24 +575,9 @@ void Simulator::pollForMAVLinkMessages(bool publish)
 	}
 
 	PX4_INFO("Found initial message, pret = %d", pret);
-	_initialized = true;
 	// reset system time
 	(void)hrt_reset();
 
-	if (fds[0].revents & POLLIN) {
-		len = recvfrom(_fd, _buf, sizeof(_buf), 0, (struct sockaddr *)&_srcaddr, &_addrlen);
-		PX4_INFO("Sending initial controls message to jMAVSim.");
-		send_controls();
-	}
-
-	// subscribe to topics
-	_actuator_outputs_sub = orb_subscribe_multi(ORB_ID(actuator_outputs), 0);
-	_vehicle_status_sub = orb_subscribe(ORB_ID(vehicle_status));
-
-	// got data from simulator, now activate the sending thread
-	pthread_create(&sender_thread, &sender_thread_attr, Simulator::sending_trampoline, NULL);
-	pthread_attr_destroy(&sender_thread_attr);
-
 	// wait for new mavlink messages to arrive
 	while (true) {
 
@@ -521,21 +596,34 @@ void Simulator::pollForMAVLinkMessages(bool publish)
 			continue;
 		}
 
-		// got data from simulator
+		// got data from simulator, handle everything which has queued up in order
 		if (fds[0].revents & POLLIN) {
-			len = recvfrom(_fd, _buf, sizeof(_buf), 0, (struct sockaddr *)&_srcaddr, &_addrlen);
+#ifdef __PX4_LINUX
 
-			if (len > 0) {
-				mavlink_message_t msg;
-				mavlink_status_t status;
+			for (int i = 0; i < RECV_BATCH; i++) {
+				msgs[i].msg_hdr.msg_namelen = sizeof(srcaddr[i]);
+			}
 
-				for (int i = 0; i < len; ++i) {
-					if (mavlink_parse_char(MAVLINK_COMM_0, _buf[i], &msg, &status)) {
-						// have a message, handle it
-						handle_message(&msg, publish);
-					}
+			int count = recvmmsg(_fd, msgs, RECV_BATCH, MSG_DONTWAIT, nullptr);
+
+			for (int i = 0; i < count; i++) {
+				handle_datagram(_buf[i], msgs[i].msg_len, srcaddr[i]);
+			}
+
+#else
+
+			for (int i = 0; i < RECV_BATCH; i++) {
+				socklen_t addrlen = sizeof(srcaddr[i]);
+				len = recvfrom(_fd, _buf[i], sizeof(_buf[i]), MSG_DONTWAIT, (struct sockaddr *)&srcaddr[i], &addrlen);
+
+				if (len <= 0) {
+					break;
 				}
+
+				handle_datagram(_buf[i], len, srcaddr[i]);
 			}
+
+#endif
 		}
 
 		// got data from PIXHAWK
@@ -546,6 +634,8 @@ void Simulator::pollForMAVLinkMessages(bool publish)
 				mavlink_message_t msg;
 				mavlink_status_t status;
 
+				px4_vehicle_set(_vehicle);
+
 				for (int i = 0; i < len; ++i) {
 					if (mavlink_parse_char(MAVLINK_COMM_0, serial_buf[i], &msg, &status)) {
 						// have a message, handle it
@@ -663,10 +753,13 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 {
 
 
-	//uint64_t timestamp = imu->time_usec;
+	// all topics of one sample carry the same timestamp, in lockstep the simulated one
 	uint64_t timestamp = hrt_absolute_time();
 
-	if ((imu->fields_updated & 0x1FFF) != 0x1FFF) {
+	// a simulator which leaves fields_updated empty updates everything
+	uint32_t updated = (imu->fields_updated != 0) ? imu->fields_updated : ALL_FIELDS;
+
+	if ((updated & ALL_FIELDS) != ALL_FIELDS) {
 		PX4_DEBUG("All sensor fields in mavlink HIL_SENSOR packet not updated.  Got %08x", imu->fields_updated);
 	}
 
@@ -684,50 +777,8 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 	}
 	last_timestamp = timestamp;
 	*/
-	/* gyro */
-	{
-		struct gyro_report gyro;
-		memset(&gyro, 0, sizeof(gyro));
-
-		gyro.timestamp = timestamp;
-		gyro.x_raw = imu->xgyro * 1000.0f;
-		gyro.y_raw = imu->ygyro * 1000.0f;
-		gyro.z_raw = imu->zgyro * 1000.0f;
-		gyro.x = imu->xgyro;
-		gyro.y = imu->ygyro;
-		gyro.z = imu->zgyro;
-
-		if (_gyro_pub == nullptr) {
-			_gyro_pub = orb_advertise(ORB_ID(sensor_gyro), &gyro);
-
-		} else {
-			orb_publish(ORB_ID(sensor_gyro), _gyro_pub, &gyro);
-		}
-	}
-
-	/* accelerometer */
-	{
-		struct accel_report accel;
-		memset(&accel, 0, sizeof(accel));
-
-		accel.timestamp = timestamp;
-		accel.x_raw = imu->xacc / mg2ms2;
-		accel.y_raw = imu->yacc / mg2ms2;
-		accel.z_raw = imu->zacc / mg2ms2;
-		accel.x = imu->xacc;
-		accel.y = imu->yacc;
-		accel.z = imu->zacc;
-
-		if (_accel_pub == nullptr) {
-			_accel_pub = orb_advertise(ORB_ID(sensor_accel), &accel);
-
-		} else {
-			orb_publish(ORB_ID(sensor_accel), _accel_pub, &accel);
-		}
-	}
-
 	/* magnetometer */
-	{
+	if (updated & MAG_FIELDS) {
 		struct mag_report mag;
 		memset(&mag, 0, sizeof(mag));
 
@@ -749,7 +800,7 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 	}
 
 	/* baro */
-	{
+	if (updated & BARO_FIELDS) {
 		struct baro_report baro;
 		memset(&baro, 0, sizeof(baro));
 
@@ -766,6 +817,48 @@ int Simulator::publish_sensor_topics(mavlink_hil_sensor_t *imu)
 		}
 	}
 
+	/* accelerometer */
+	{
+		struct accel_report accel;
+		memset(&accel, 0, sizeof(accel));
+
+		accel.timestamp = timestamp;
+		accel.x_raw = imu->xacc / mg2ms2;
+		accel.y_raw = imu->yacc / mg2ms2;
+		accel.z_raw = imu->zacc / mg2ms2;
+		accel.x = imu->xacc;
+		accel.y = imu->yacc;
+		accel.z = imu->zacc;
+
+		if (_accel_pub == nullptr) {
+			_accel_pub = orb_advertise(ORB_ID(sensor_accel), &accel);
+
+		} else {
+			orb_publish(ORB_ID(sensor_accel), _accel_pub, &accel);
+		}
+	}
+
+	/* gyro last, it wakes up the sensors module which then finds the rest of this sample */
+	{
+		struct gyro_report gyro;
+		memset(&gyro, 0, sizeof(gyro));
+
+		gyro.timestamp = timestamp;
+		gyro.x_raw = imu->xgyro * 1000.0f;
+		gyro.y_raw = imu->ygyro * 1000.0f;
+		gyro.z_raw = imu->zgyro * 1000.0f;
+		gyro.x = imu->xgyro;
+		gyro.y = imu->ygyro;
+		gyro.z = imu->zgyro;
+
+		if (_gyro_pub == nullptr) {
+			_gyro_pub = orb_advertise(ORB_ID(sensor_gyro), &gyro);
+
+		} else {
+			orb_publish(ORB_ID(sensor_gyro), _gyro_pub, &gyro);
+		}
+	}
+
 	return OK;
 }
 
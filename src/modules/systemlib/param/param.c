@@ -44,6 +44,7 @@
 //#include <debug.h>
 #include <px4_defines.h>
 #include <px4_posix.h>
+#include <px4_vehicle.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -129,8 +130,17 @@ get_param_info_count(void)
 	return param_info_count;
 }
 
+/*
+ * Every vehicle of the process has its own modified values, update topic
+ * and parameter file. The names below stand for the ones of the calling
+ * thread's vehicle.
+ */
+#define param_values	param_values_vehicle[px4_vehicle_id()]
+#define param_topic	param_topic_vehicle[px4_vehicle_id()]
+#define param_user_file	param_user_file_vehicle[px4_vehicle_id()]
+
 /** flexible array holding modified parameter values */
-UT_array	*param_values;
+static UT_array	*param_values_vehicle[PX4_MAX_VEHICLES];
 
 /** array info for the modified parameters array */
 const UT_icd	param_icd = {sizeof(struct param_wbuf_s), NULL, NULL, NULL};
@@ -139,7 +149,7 @@ const UT_icd	param_icd = {sizeof(struct param_wbuf_s), NULL, NULL, NULL};
 ORB_DEFINE(parameter_update, struct parameter_update_s);
 
 /** parameter update topic handle */
-static orb_advert_t param_topic = NULL;
+static orb_advert_t param_topic_vehicle[PX4_MAX_VEHICLES];
 
 static void param_set_used_internal(param_t param);
 
@@ -699,7 +709,7 @@ param_reset_excludes(const char *excludes[], int num_excludes)
 }
 
 static const char *param_default_file = PX4_ROOTFSDIR"/eeprom/parameters";
-static char *param_user_file = NULL;
+static char *param_user_file_vehicle[PX4_MAX_VEHICLES];
 
 int
 param_set_default_file(const char *filename)
@@ -35,14 +35,21 @@
  * @file perf_counter.c
  *
  * @brief Performance measuring tools.
+ *
+ * On POSIX every thread updates its own shard of a counter, so the counters
+ * can be used from several threads without locking. The shards are summed up
+ * when a counter is read.
  */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdbool.h>
 #include <sys/queue.h>
 #include <drivers/drv_hrt.h>
 #include <math.h>
+#include <px4_trace.h>
+#include <px4_vehicle.h>
 #include "perf_counter.h"
 
 #ifdef __PX4_QURT
@@ -52,6 +59,24 @@
 #define ddeclare(...) __VA_ARGS__
 #endif
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+#include <pthread.h>
+#define PERF_SHARDED
+/** threads updating counters at the same time */
+#define PERF_MAX_THREADS	(64 * PX4_MAX_VEHICLES)
+#else
+#define PERF_MAX_THREADS	1
+#endif
+
+/**
+ * PC_HISTOGRAM buckets: values below PERF_HISTOGRAM_SUB are counted exactly,
+ * above each power of two is split into PERF_HISTOGRAM_SUB buckets, which
+ * keeps the error of the percentiles below 1/PERF_HISTOGRAM_SUB up to 2^32us.
+ */
+#define PERF_HISTOGRAM_SUB_BITS	4
+#define PERF_HISTOGRAM_SUB	(1 << PERF_HISTOGRAM_SUB_BITS)
+#define PERF_HISTOGRAM_BUCKETS	((32 - PERF_HISTOGRAM_SUB_BITS + 1) * PERF_HISTOGRAM_SUB)
+
 /**
  * Header common to all counters.
  */
@@ -59,13 +84,13 @@ struct perf_ctr_header {
 	sq_entry_t		link;	/**< list linkage */
 	enum perf_counter_type	type;	/**< counter type */
 	const char		*name;	/**< counter name */
+	void			*shards[PERF_MAX_THREADS];	/**< counter data of each thread */
 };
 
 /**
  * PC_EVENT counter.
  */
 struct perf_ctr_count {
-	struct perf_ctr_header	hdr;
 	uint64_t		event_count;
 };
 
@@ -73,7 +98,6 @@ struct perf_ctr_count {
  * PC_ELAPSED counter.
  */
 struct perf_ctr_elapsed {
-	struct perf_ctr_header	hdr;
 	uint64_t		event_count;
 	uint64_t		event_overruns;
 	uint64_t		time_start;
@@ -88,7 +112,6 @@ struct perf_ctr_elapsed {
  * PC_INTERVAL counter.
  */
 struct perf_ctr_interval {
-	struct perf_ctr_header	hdr;
 	uint64_t		event_count;
 	uint64_t		time_event;
 	uint64_t		time_first;
@@ -99,39 +122,177 @@ struct perf_ctr_interval {
 	float			M2;
 };
 
+/**
+ * PC_HISTOGRAM counter.
+ */
+struct perf_ctr_histogram {
+	struct perf_ctr_elapsed	elapsed;
+	uint32_t		buckets[PERF_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * Sum of the shards of a counter, without the histogram buckets.
+ */
+union perf_ctr_sum {
+	struct perf_ctr_count		count;
+	struct perf_ctr_elapsed		elapsed;
+	struct perf_ctr_interval	interval;
+};
+
 /**
  * List of all known counters.
  */
 static sq_queue_t	perf_counters;
 
+#ifdef PERF_SHARDED
 
-perf_counter_t
-perf_alloc(enum perf_counter_type type, const char *name)
+static pthread_mutex_t	perf_counters_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define perf_lock()	pthread_mutex_lock(&perf_counters_mutex)
+#define perf_unlock()	pthread_mutex_unlock(&perf_counters_mutex)
+#define perf_shard_at(handle, i)	__atomic_load_n(&(handle)->shards[i], __ATOMIC_ACQUIRE)
+
+/**
+ * Shard index of each thread, taken when a thread first updates a counter
+ * and given back when it exits.
+ */
+static uint8_t		perf_thread_used[PERF_MAX_THREADS];
+static __thread int	perf_thread = -1;
+static pthread_key_t	perf_thread_key;
+static pthread_once_t	perf_thread_once = PTHREAD_ONCE_INIT;
+
+/** updates lost by threads beyond PERF_MAX_THREADS */
+static uint64_t		perf_dropped;
+
+static void
+perf_thread_exit(void *arg)
+{
+	__atomic_store_n(&perf_thread_used[(intptr_t)arg - 1], 0, __ATOMIC_RELEASE);
+}
+
+static void
+perf_thread_init(void)
 {
-	perf_counter_t ctr = NULL;
+	pthread_key_create(&perf_thread_key, perf_thread_exit);
+}
+
+static int
+perf_thread_index(void)
+{
+	if (perf_thread == -1) {
+		pthread_once(&perf_thread_once, perf_thread_init);
+
+		/* none left */
+		perf_thread = -2;
+
+		for (int i = 0; i < PERF_MAX_THREADS; i++) {
+			uint8_t unused = 0;
+
+			if (__atomic_compare_exchange_n(&perf_thread_used[i], &unused, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+				perf_thread = i;
+				pthread_setspecific(perf_thread_key, (void *)(intptr_t)(i + 1));
+				break;
+			}
+		}
+	}
+
+	return perf_thread;
+}
+
+#else
+
+#define perf_lock()
+#define perf_unlock()
+#define perf_shard_at(handle, i)	((handle)->shards[i])
 
+#endif
+
+static size_t
+perf_shard_size(enum perf_counter_type type)
+{
 	switch (type) {
 	case PC_COUNT:
-		ctr = (perf_counter_t)calloc(sizeof(struct perf_ctr_count), 1);
-		break;
+		return sizeof(struct perf_ctr_count);
 
 	case PC_ELAPSED:
-		ctr = (perf_counter_t)calloc(sizeof(struct perf_ctr_elapsed), 1);
-		break;
+		return sizeof(struct perf_ctr_elapsed);
 
 	case PC_INTERVAL:
-		ctr = (perf_counter_t)calloc(sizeof(struct perf_ctr_interval), 1);
+		return sizeof(struct perf_ctr_interval);
 
-		break;
+	case PC_HISTOGRAM:
+		return sizeof(struct perf_ctr_histogram);
 
 	default:
-		break;
+		return 0;
+	}
+}
+
+/**
+ * Counter data of the calling thread, NULL if there is none.
+ */
+static void *
+perf_shard(perf_counter_t handle)
+{
+#ifdef PERF_SHARDED
+	int index = perf_thread_index();
+
+	if (index < 0) {
+		__atomic_fetch_add(&perf_dropped, 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	/* only this thread writes its slot */
+	void *shard = handle->shards[index];
+
+	if (shard == NULL) {
+		shard = calloc(perf_shard_size(handle->type), 1);
+		__atomic_store_n(&handle->shards[index], shard, __ATOMIC_RELEASE);
+	}
+
+	return shard;
+#else
+	return handle->shards[0];
+#endif
+}
+
+static perf_counter_t
+perf_new(enum perf_counter_type type, const char *name)
+{
+	if (perf_shard_size(type) == 0) {
+		return NULL;
 	}
 
+	perf_counter_t ctr = (perf_counter_t)calloc(sizeof(struct perf_ctr_header), 1);
+
+	if (ctr == NULL) {
+		return NULL;
+	}
+
+#ifndef PERF_SHARDED
+	ctr->shards[0] = calloc(perf_shard_size(type), 1);
+
+	if (ctr->shards[0] == NULL) {
+		free(ctr);
+		return NULL;
+	}
+
+#endif
+
+	ctr->type = type;
+	ctr->name = name;
+
+	return ctr;
+}
+
+perf_counter_t
+perf_alloc(enum perf_counter_type type, const char *name)
+{
+	perf_counter_t ctr = perf_new(type, name);
+
 	if (ctr != NULL) {
-		ctr->type = type;
-		ctr->name = name;
+		perf_lock();
 		sq_addfirst(&ctr->link, &perf_counters);
+		perf_unlock();
 	}
 
 	return ctr;
@@ -140,25 +301,33 @@ perf_alloc(enum perf_counter_type type, const char *name)
 perf_counter_t
 perf_alloc_once(enum perf_counter_type type, const char *name)
 {
+	perf_lock();
 	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
 
 	while (handle != NULL) {
 		if (!strcmp(handle->name, name)) {
-			if (type == handle->type) {
-				/* they are the same counter */
-				return handle;
-
-			} else {
+			if (type != handle->type) {
 				/* same name but different type, assuming this is an error and not intended */
-				return NULL;
+				handle = NULL;
 			}
+
+			/* else they are the same counter */
+			perf_unlock();
+			return handle;
 		}
 
 		handle = (perf_counter_t)sq_next(&handle->link);
 	}
 
 	/* if the execution reaches here, no existing counter of that name was found */
-	return perf_alloc(type, name);
+	handle = perf_new(type, name);
+
+	if (handle != NULL) {
+		sq_addfirst(&handle->link, &perf_counters);
+	}
+
+	perf_unlock();
+	return handle;
 }
 
 void
@@ -168,7 +337,14 @@ perf_free(perf_counter_t handle)
 		return;
 	}
 
+	perf_lock();
 	sq_rem(&handle->link, &perf_counters);
+	perf_unlock();
+
+	for (int i = 0; i < PERF_MAX_THREADS; i++) {
+		free(handle->shards[i]);
+	}
+
 	free(handle);
 }
 
@@ -179,13 +355,19 @@ perf_count(perf_counter_t handle)
 		return;
 	}
 
+	void *shard = perf_shard(handle);
+
+	if (shard == NULL) {
+		return;
+	}
+
 	switch (handle->type) {
 	case PC_COUNT:
-		((struct perf_ctr_count *)handle)->event_count++;
+		((struct perf_ctr_count *)shard)->event_count++;
 		break;
 
 	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
+			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)shard;
 			hrt_abstime now = hrt_absolute_time();
 
 			switch (pci->event_count) {
@@ -231,6 +413,76 @@ perf_count(perf_counter_t handle)
 	}
 }
 
+static unsigned
+perf_histogram_bucket(uint64_t value)
+{
+	if (value < PERF_HISTOGRAM_SUB) {
+		return value;
+	}
+
+	unsigned msb = 63 - __builtin_clzll(value);
+	unsigned bucket = (msb - PERF_HISTOGRAM_SUB_BITS + 1) * PERF_HISTOGRAM_SUB
+			  + ((value >> (msb - PERF_HISTOGRAM_SUB_BITS)) & (PERF_HISTOGRAM_SUB - 1));
+
+	return (bucket < PERF_HISTOGRAM_BUCKETS) ? bucket : PERF_HISTOGRAM_BUCKETS - 1;
+}
+
+/**
+ * Highest value counted in a bucket.
+ */
+static uint64_t
+perf_histogram_value(unsigned bucket)
+{
+	if (bucket < PERF_HISTOGRAM_SUB) {
+		return bucket;
+	}
+
+	unsigned shift = bucket / PERF_HISTOGRAM_SUB - 1;
+	uint64_t lowest = (uint64_t)(PERF_HISTOGRAM_SUB + bucket % PERF_HISTOGRAM_SUB) << shift;
+
+	return lowest + (1ULL << shift) - 1;
+}
+
+static void
+perf_elapsed_add(struct perf_ctr_elapsed *pce, int64_t elapsed)
+{
+	if (elapsed < 0) {
+		pce->event_overruns++;
+
+	} else {
+
+		pce->event_count++;
+		pce->time_total += elapsed;
+
+		if ((pce->time_least > (uint64_t)elapsed) || (pce->time_least == 0)) {
+			pce->time_least = elapsed;
+		}
+
+		if (pce->time_most < (uint64_t)elapsed) {
+			pce->time_most = elapsed;
+		}
+
+		// maintain mean and variance of the elapsed time in seconds
+		// Knuth/Welford recursive mean and variance of update intervals (via Wikipedia)
+		float dt = elapsed / 1e6f;
+		float delta_intvl = dt - pce->mean;
+		pce->mean += delta_intvl / pce->event_count;
+		pce->M2 += delta_intvl * (dt - pce->mean);
+
+		pce->time_start = 0;
+	}
+}
+
+static void
+perf_histogram_add(struct perf_ctr_histogram *pch, int64_t elapsed)
+{
+	perf_elapsed_add(&pch->elapsed, elapsed);
+
+	if (elapsed >= 0) {
+		pch->buckets[perf_histogram_bucket(elapsed)]++;
+	}
+}
+
 void
 perf_begin(perf_counter_t handle)
 {
@@ -240,7 +492,15 @@ perf_begin(perf_counter_t handle)
 
 	switch (handle->type) {
 	case PC_ELAPSED:
-		((struct perf_ctr_elapsed *)handle)->time_start = hrt_absolute_time();
+	case PC_HISTOGRAM: {
+			/* the histogram starts with the elapsed counter */
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)perf_shard(handle);
+
+			if (pce != NULL) {
+				px4_trace_begin(PX4_TRACE_PERF, handle->name, 0);
+				pce->time_start = hrt_absolute_time();
+			}
+		}
 		break;
 
 	default:
@@ -256,36 +516,19 @@ perf_end(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)perf_shard(handle);
 
-			if (pce->time_start != 0) {
+			if (pce != NULL && pce->time_start != 0) {
 				int64_t elapsed = hrt_absolute_time() - pce->time_start;
+				px4_trace_end(PX4_TRACE_PERF, handle->name, 0);
 
-				if (elapsed < 0) {
-					pce->event_overruns++;
+				if (handle->type == PC_HISTOGRAM) {
+					perf_histogram_add((struct perf_ctr_histogram *)pce, elapsed);
 
 				} else {
-
-					pce->event_count++;
-					pce->time_total += elapsed;
-
-					if ((pce->time_least > (uint64_t)elapsed) || (pce->time_least == 0)) {
-						pce->time_least = elapsed;
-					}
-
-					if (pce->time_most < (uint64_t)elapsed) {
-						pce->time_most = elapsed;
-					}
-
-					// maintain mean and variance of the elapsed time in seconds
-					// Knuth/Welford recursive mean and variance of update intervals (via Wikipedia)
-					float dt = elapsed / 1e6f;
-					float delta_intvl = dt - pce->mean;
-					pce->mean += delta_intvl / pce->event_count;
-					pce->M2 += delta_intvl * (dt - pce->mean);
-
-					pce->time_start = 0;
+					perf_elapsed_add(pce, elapsed);
 				}
 			}
 		}
@@ -307,32 +550,19 @@ perf_set(perf_counter_t handle, int64_t elapsed)
 
 	switch (handle->type) {
 	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-
-			if (elapsed < 0) {
-				pce->event_overruns++;
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)perf_shard(handle);
 
-			} else {
-
-				pce->event_count++;
-				pce->time_total += elapsed;
-
-				if ((pce->time_least > (uint64_t)elapsed) || (pce->time_least == 0)) {
-					pce->time_least = elapsed;
-				}
-
-				if (pce->time_most < (uint64_t)elapsed) {
-					pce->time_most = elapsed;
-				}
+			if (pce != NULL) {
+				perf_elapsed_add(pce, elapsed);
+			}
+		}
+		break;
 
-				// maintain mean and variance of the elapsed time in seconds
-				// Knuth/Welford recursive mean and variance of update intervals (via Wikipedia)
-				float dt = elapsed / 1e6f;
-				float delta_intvl = dt - pce->mean;
-				pce->mean += delta_intvl / pce->event_count;
-				pce->M2 += delta_intvl * (dt - pce->mean);
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)perf_shard(handle);
 
-				pce->time_start = 0;
+			if (pch != NULL) {
+				perf_histogram_add(pch, elapsed);
 			}
 		}
 		break;
@@ -350,10 +580,14 @@ perf_cancel(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)perf_shard(handle);
 
-			pce->time_start = 0;
+			if (pce != NULL && pce->time_start != 0) {
+				px4_trace_end(PX4_TRACE_PERF, handle->name, 0);
+				pce->time_start = 0;
+			}
 		}
 		break;
 
@@ -371,34 +605,178 @@ perf_reset(perf_counter_t handle)
 		return;
 	}
 
-	switch (handle->type) {
-	case PC_COUNT:
-		((struct perf_ctr_count *)handle)->event_count = 0;
-		break;
+	for (int i = 0; i < PERF_MAX_THREADS; i++) {
+		void *shard = perf_shard_at(handle, i);
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			pce->event_count = 0;
-			pce->time_start = 0;
-			pce->time_total = 0;
-			pce->time_least = 0;
-			pce->time_most = 0;
-			break;
+		if (shard != NULL) {
+			memset(shard, 0, perf_shard_size(handle->type));
 		}
+	}
+}
 
-	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
-			pci->event_count = 0;
-			pci->time_event = 0;
-			pci->time_first = 0;
-			pci->time_last = 0;
-			pci->time_least = 0;
-			pci->time_most = 0;
+/**
+ * Merge the mean and the sum of squared deviations of n_b samples into the
+ * ones of n samples (Chan et al.).
+ */
+static void
+perf_merge_variance(float *mean, float *M2, uint64_t n, float mean_b, float M2_b, uint64_t n_b)
+{
+	if (n_b == 0) {
+		return;
+	}
+
+	if (n == 0) {
+		*mean = mean_b;
+		*M2 = M2_b;
+		return;
+	}
+
+	float delta = mean_b - *mean;
+	float total = (float)(n + n_b);
+	*mean += delta * n_b / total;
+	*M2 += M2_b + delta * delta * n * n_b / total;
+}
+
+static void
+perf_aggregate(perf_counter_t handle, union perf_ctr_sum *sum)
+{
+	memset(sum, 0, sizeof(*sum));
+
+	for (int i = 0; i < PERF_MAX_THREADS; i++) {
+		void *shard = perf_shard_at(handle, i);
+
+		if (shard == NULL) {
+			continue;
+		}
+
+		switch (handle->type) {
+		case PC_COUNT:
+			sum->count.event_count += ((struct perf_ctr_count *)shard)->event_count;
+			break;
+
+		case PC_ELAPSED:
+		case PC_HISTOGRAM: {
+				struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)shard;
+
+				if (pce->event_count > 0) {
+					if (sum->elapsed.time_least == 0 || pce->time_least < sum->elapsed.time_least) {
+						sum->elapsed.time_least = pce->time_least;
+					}
+
+					if (pce->time_most > sum->elapsed.time_most) {
+						sum->elapsed.time_most = pce->time_most;
+					}
+				}
+
+				perf_merge_variance(&sum->elapsed.mean, &sum->elapsed.M2, sum->elapsed.event_count,
+						    pce->mean, pce->M2, pce->event_count);
+				sum->elapsed.event_count += pce->event_count;
+				sum->elapsed.event_overruns += pce->event_overruns;
+				sum->elapsed.time_total += pce->time_total;
+				break;
+			}
+
+		case PC_INTERVAL: {
+				struct perf_ctr_interval *pci = (struct perf_ctr_interval *)shard;
+
+				if (pci->event_count == 0) {
+					break;
+				}
+
+				if (sum->interval.event_count == 0 || pci->time_first < sum->interval.time_first) {
+					sum->interval.time_first = pci->time_first;
+				}
+
+				if (pci->time_last > sum->interval.time_last) {
+					sum->interval.time_last = pci->time_last;
+				}
+
+				if (pci->event_count > 1) {
+					if (sum->interval.time_least == 0 || pci->time_least < sum->interval.time_least) {
+						sum->interval.time_least = pci->time_least;
+					}
+
+					if (pci->time_most > sum->interval.time_most) {
+						sum->interval.time_most = pci->time_most;
+					}
+
+					/* intervals, not events */
+					uint64_t n = (sum->interval.event_count > 0) ? sum->interval.event_count - 1 : 0;
+					perf_merge_variance(&sum->interval.mean, &sum->interval.M2, n,
+							    pci->mean, pci->M2, pci->event_count - 1);
+				}
+
+				sum->interval.event_count += pci->event_count;
+				break;
+			}
+
+		default:
 			break;
 		}
 	}
 }
 
+/**
+ * Percentiles of a PC_HISTOGRAM counter.
+ */
+static void
+perf_histogram_percentiles(perf_counter_t handle, const float *percentiles, uint64_t *values, int count)
+{
+	uint64_t total = 0;
+
+	for (int i = 0; i < PERF_MAX_THREADS; i++) {
+		struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)perf_shard_at(handle, i);
+
+		if (pch != NULL) {
+			for (unsigned b = 0; b < PERF_HISTOGRAM_BUCKETS; b++) {
+				total += pch->buckets[b];
+			}
+		}
+	}
+
+	for (int p = 0; p < count; p++) {
+		values[p] = 0;
+	}
+
+	if (total == 0) {
+		return;
+	}
+
+	/* walk up the buckets and take each percentile where its rank is reached */
+	uint64_t seen = 0;
+	int p = 0;
+
+	for (unsigned b = 0; b < PERF_HISTOGRAM_BUCKETS && p < count; b++) {
+		for (int i = 0; i < PERF_MAX_THREADS; i++) {
+			struct perf_ctr_histogram *pch = (struct perf_ctr_histogram *)perf_shard_at(handle, i);
+
+			if (pch != NULL) {
+				seen += pch->buckets[b];
+			}
+		}
+
+		while (p < count && seen > 0 && seen >= (uint64_t)ceilf(percentiles[p] / 100.0f * total)) {
+			values[p++] = perf_histogram_value(b);
+		}
+	}
+}
+
+uint64_t
+perf_percentile(perf_counter_t handle, float percentile)
+{
+	uint64_t value = 0;
+
+	if (handle != NULL && handle->type == PC_HISTOGRAM) {
+		perf_histogram_percentiles(handle, &percentile, &value, 1);
+	}
+
+	return value;
+}
+
+/** percentiles shown for PC_HISTOGRAM counters */
+static const float perf_percentiles[] = { 50.0f, 90.0f, 99.0f, 99.9f };
+#define PERF_PERCENTILES	(sizeof(perf_percentiles) / sizeof(perf_percentiles[0]))
+
 void
 perf_print_counter(perf_counter_t handle)
 {
@@ -412,68 +790,175 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 		return;
 	}
 
+	union perf_ctr_sum sum;
+	perf_aggregate(handle, &sum);
+
 	switch (handle->type) {
 	case PC_COUNT:
 		dprintf(fd, "%s: %llu events\n",
 			handle->name,
-			(unsigned long long)((struct perf_ctr_count *)handle)->event_count);
+			(unsigned long long)sum.count.event_count);
 		break;
 
 	case PC_ELAPSED: {
-			ddeclare(struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;)
-			ddeclare(float rms = sqrtf(pce->M2 / (pce->event_count - 1));)
+			ddeclare(float rms = sqrtf(sum.elapsed.M2 / (sum.elapsed.event_count - 1));)
 			dprintf(fd, "%s: %llu events, %llu overruns, %lluus elapsed, %lluus avg, min %lluus max %lluus %5.3fus rms\n",
 				handle->name,
-				(unsigned long long)pce->event_count,
-				(unsigned long long)pce->event_overruns,
-				(unsigned long long)pce->time_total,
-				pce->event_count == 0 ? 0 : (unsigned long long)pce->time_total / pce->event_count,
-				(unsigned long long)pce->time_least,
-				(unsigned long long)pce->time_most,
+				(unsigned long long)sum.elapsed.event_count,
+				(unsigned long long)sum.elapsed.event_overruns,
+				(unsigned long long)sum.elapsed.time_total,
+				sum.elapsed.event_count == 0 ? 0 : (unsigned long long)sum.elapsed.time_total / sum.elapsed.event_count,
+				(unsigned long long)sum.elapsed.time_least,
+				(unsigned long long)sum.elapsed.time_most,
 				(double)(1e6f * rms));
 			break;
 		}
 
 	case PC_INTERVAL: {
-			ddeclare(struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;)
-			ddeclare(float rms = sqrtf(pci->M2 / (pci->event_count - 1));)
+			ddeclare(float rms = sqrtf(sum.interval.M2 / (sum.interval.event_count - 1));)
 
 			dprintf(fd, "%s: %llu events, %lluus avg, min %lluus max %lluus %5.3fus rms\n",
 				handle->name,
-				(unsigned long long)pci->event_count,
-				(unsigned long long)(pci->time_last - pci->time_first) / pci->event_count,
-				(unsigned long long)pci->time_least,
-				(unsigned long long)pci->time_most,
+				(unsigned long long)sum.interval.event_count,
+				sum.interval.event_count == 0 ? 0 :
+				(unsigned long long)(sum.interval.time_last - sum.interval.time_first) / sum.interval.event_count,
+				(unsigned long long)sum.interval.time_least,
+				(unsigned long long)sum.interval.time_most,
 				(double)(1e6f * rms));
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			ddeclare(uint64_t p[PERF_PERCENTILES];)
+			ddeclare(perf_histogram_percentiles(handle, perf_percentiles, p, PERF_PERCENTILES);)
+			dprintf(fd, "%s: %llu events, %llu overruns, %lluus elapsed, %lluus avg, min %lluus max %lluus, "
+				"p50 %lluus p90 %lluus p99 %lluus p99.9 %lluus\n",
+				handle->name,
+				(unsigned long long)sum.elapsed.event_count,
+				(unsigned long long)sum.elapsed.event_overruns,
+				(unsigned long long)sum.elapsed.time_total,
+				sum.elapsed.event_count == 0 ? 0 : (unsigned long long)sum.elapsed.time_total / sum.elapsed.event_count,
+				(unsigned long long)sum.elapsed.time_least,
+				(unsigned long long)sum.elapsed.time_most,
+				(unsigned long long)p[0],
+				(unsigned long long)p[1],
+				(unsigned long long)p[2],
+				(unsigned long long)p[3]);
+			break;
+		}
+
 	default:
 		break;
 	}
 }
 
-uint64_t
-perf_event_count(perf_counter_t handle)
+/**
+ * Print the name of a counter as a JSON string.
+ */
+static void
+perf_print_json_name(int fd, const char *name)
+{
+	dprintf(fd, "\"");
+
+	for (const char *c = name; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') {
+			dprintf(fd, "\\%c", *c);
+
+		} else if ((unsigned char)*c >= 0x20) {
+			dprintf(fd, "%c", *c);
+		}
+	}
+
+	dprintf(fd, "\"");
+}
+
+void
+perf_print_counter_json(int fd, perf_counter_t handle)
 {
 	if (handle == NULL) {
-		return 0;
+		return;
 	}
 
+	union perf_ctr_sum sum;
+	perf_aggregate(handle, &sum);
+
+	dprintf(fd, "{\"name\": ");
+	perf_print_json_name(fd, handle->name);
+
 	switch (handle->type) {
 	case PC_COUNT:
-		return ((struct perf_ctr_count *)handle)->event_count;
+		dprintf(fd, ", \"type\": \"count\", \"events\": %llu}",
+			(unsigned long long)sum.count.event_count);
+		break;
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			return pce->event_count;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			ddeclare(float rms = (sum.elapsed.event_count > 1) ? sqrtf(sum.elapsed.M2 / (sum.elapsed.event_count - 1)) : 0.0f;)
+			dprintf(fd, ", \"type\": \"%s\", \"events\": %llu, \"overruns\": %llu, \"elapsed_us\": %llu, "
+				"\"avg_us\": %llu, \"min_us\": %llu, \"max_us\": %llu, \"rms_us\": %.3f",
+				(handle->type == PC_HISTOGRAM) ? "histogram" : "elapsed",
+				(unsigned long long)sum.elapsed.event_count,
+				(unsigned long long)sum.elapsed.event_overruns,
+				(unsigned long long)sum.elapsed.time_total,
+				sum.elapsed.event_count == 0 ? 0 : (unsigned long long)sum.elapsed.time_total / sum.elapsed.event_count,
+				(unsigned long long)sum.elapsed.time_least,
+				(unsigned long long)sum.elapsed.time_most,
+				(double)(1e6f * rms));
+
+			if (handle->type == PC_HISTOGRAM) {
+				ddeclare(uint64_t p[PERF_PERCENTILES];)
+				ddeclare(perf_histogram_percentiles(handle, perf_percentiles, p, PERF_PERCENTILES);)
+				dprintf(fd, ", \"p50_us\": %llu, \"p90_us\": %llu, \"p99_us\": %llu, \"p999_us\": %llu",
+					(unsigned long long)p[0],
+					(unsigned long long)p[1],
+					(unsigned long long)p[2],
+					(unsigned long long)p[3]);
+			}
+
+			dprintf(fd, "}");
+			break;
 		}
 
 	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
-			return pci->event_count;
+			ddeclare(float rms = (sum.interval.event_count > 1) ? sqrtf(sum.interval.M2 / (sum.interval.event_count - 1)) : 0.0f;)
+			dprintf(fd, ", \"type\": \"interval\", \"events\": %llu, \"avg_us\": %llu, \"min_us\": %llu, \"max_us\": %llu, "
+				"\"rms_us\": %.3f}",
+				(unsigned long long)sum.interval.event_count,
+				sum.interval.event_count == 0 ? 0 :
+				(unsigned long long)(sum.interval.time_last - sum.interval.time_first) / sum.interval.event_count,
+				(unsigned long long)sum.interval.time_least,
+				(unsigned long long)sum.interval.time_most,
+				(double)(1e6f * rms));
+			break;
 		}
 
+	default:
+		dprintf(fd, "}");
+		break;
+	}
+}
+
+uint64_t
+perf_event_count(perf_counter_t handle)
+{
+	if (handle == NULL) {
+		return 0;
+	}
+
+	union perf_ctr_sum sum;
+	perf_aggregate(handle, &sum);
+
+	switch (handle->type) {
+	case PC_COUNT:
+		return sum.count.event_count;
+
+	case PC_ELAPSED:
+	case PC_HISTOGRAM:
+		return sum.elapsed.event_count;
+
+	case PC_INTERVAL:
+		return sum.interval.event_count;
+
 	default:
 		break;
 	}
@@ -484,12 +969,42 @@ perf_event_count(perf_counter_t handle)
 void
 perf_print_all(int fd)
 {
+	perf_lock();
 	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
 
 	while (handle != NULL) {
 		perf_print_counter_fd(fd, handle);
 		handle = (perf_counter_t)sq_next(&handle->link);
 	}
+
+	perf_unlock();
+}
+
+void
+perf_print_all_json(int fd)
+{
+	perf_lock();
+	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
+
+	dprintf(fd, "{\"counters\": [");
+
+	while (handle != NULL) {
+		dprintf(fd, "\n  ");
+		perf_print_counter_json(fd, handle);
+		handle = (perf_counter_t)sq_next(&handle->link);
+
+		if (handle != NULL) {
+			dprintf(fd, ",");
+		}
+	}
+
+#ifdef PERF_SHARDED
+	dprintf(fd, "\n], \"dropped\": %llu}\n", (unsigned long long)__atomic_load_n(&perf_dropped, __ATOMIC_RELAXED));
+#else
+	dprintf(fd, "\n], \"dropped\": 0}\n");
+#endif
+
+	perf_unlock();
 }
 
 extern const uint16_t latency_bucket_count;
@@ -512,6 +1027,7 @@ perf_print_latency(int fd)
 void
 perf_reset_all(void)
 {
+	perf_lock();
 	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
 
 	while (handle != NULL) {
@@ -519,6 +1035,8 @@ perf_reset_all(void)
 		handle = (perf_counter_t)sq_next(&handle->link);
 	}
 
+	perf_unlock();
+
 	for (int i = 0; i <= latency_bucket_count; i++) {
 		latency_counters[i] = 0;
 	}
@@ -48,7 +48,8 @@
 enum perf_counter_type {
 	PC_COUNT,		/**< count the number of times an event occurs */
 	PC_ELAPSED,		/**< measure the time elapsed performing an event */
-	PC_INTERVAL		/**< measure the interval between instances of an event */
+	PC_INTERVAL,		/**< measure the interval between instances of an event */
+	PC_HISTOGRAM		/**< measure the distribution of the time elapsed performing an event */
 };
 
 struct perf_ctr_header;
@@ -158,6 +159,14 @@ __EXPORT extern void		perf_print_counter(perf_counter_t handle);
  */
 __EXPORT extern void		perf_print_counter_fd(int fd, perf_counter_t handle);
 
+/**
+ * Print one performance counter to a fd as a JSON object.
+ *
+ * @param fd			File descriptor to print to - e.g. 0 for stdout
+ * @param handle		The counter to print.
+ */
+__EXPORT extern void		perf_print_counter_json(int fd, perf_counter_t handle);
+
 /**
  * Print all of the performance counters.
  *
@@ -165,6 +174,13 @@ __EXPORT extern void		perf_print_counter_fd(int fd, perf_counter_t handle);
  */
 __EXPORT extern void		perf_print_all(int fd);
 
+/**
+ * Print all of the performance counters as a JSON document.
+ *
+ * @param fd			File descriptor to print to - e.g. 0 for stdout
+ */
+__EXPORT extern void		perf_print_all_json(int fd);
+
 /**
  * Print hrt latency counters.
  *
@@ -185,6 +201,17 @@ __EXPORT extern void		perf_reset_all(void);
  */
 __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
 
+/**
+ * Return a percentile of the times measured by a PC_HISTOGRAM counter
+ *
+ * The value is rounded up to the resolution of the histogram, about 6%.
+ *
+ * @param handle		The counter returned from perf_alloc.
+ * @param percentile		The percentile, e.g. 99.9
+ * @return			the time in microseconds, 0 if there are no events
+ */
+__EXPORT extern uint64_t	perf_percentile(perf_counter_t handle, float percentile);
+
 __END_DECLS
 
 #endif
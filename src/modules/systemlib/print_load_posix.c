@@ -42,6 +42,7 @@
 #include <string.h>
 #include <stdio.h>
 
+#include <px4_tasks.h>
 #include <systemlib/cpuload.h>
 #include <systemlib/printload.h>
 #include <drivers/drv_hrt.h>
@@ -63,12 +64,116 @@ void init_print_load_s(uint64_t t, struct print_load_s *s)
 
 	for (int i = 0; i < CONFIG_MAX_TASKS; i++) {
 		s->last_times[i] = 0;
+		s->last_ctx_voluntary[i] = 0;
+		s->last_ctx_involuntary[i] = 0;
 	}
 
 	s->interval_time_ms_inv = 0.f;
 }
 
-void print_load(uint64_t t, int fd, struct print_load_s *print_state)
+static const char *policy_name(int policy)
 {
+	switch (policy) {
+	case SCHED_FIFO:
+		return "FIFO";
+
+	case SCHED_RR:
+		return "RR";
+
+	case SCHED_OTHER:
+		return "OTHER";
+
+	default:
+		return "?";
+	}
 }
 
+void print_load(uint64_t t, int fd, struct print_load_s *print_state)
+{
+	px4_task_stats_t stats[CONFIG_MAX_TASKS];
+	const char *clear_line = "";
+	int count = px4_task_stats(stats, CONFIG_MAX_TASKS);
+
+	print_state->new_time = t;
+
+	/* print system information */
+	if (fd == 1) {
+		dprintf(fd, "\033[H"); /* move cursor home and clear screen */
+		clear_line = CL;
+	}
+
+	uint64_t interval_ms = (print_state->new_time - print_state->interval_start_time) / 1000;
+
+	/* no load in the first call */
+	print_state->interval_time_ms_inv = (interval_ms > 0) ? 1.f / (float)interval_ms : 0.f;
+
+	print_state->total_user_time = 0;
+
+	/* CPU time and context switches of the tasks in this interval */
+	unsigned long voluntary[CONFIG_MAX_TASKS];
+	unsigned long involuntary[CONFIG_MAX_TASKS];
+
+	for (int i = 0; i < count; i++) {
+		int id = stats[i].id % CONFIG_MAX_TASKS;
+		uint64_t interval_runtime = (print_state->last_times[id] > 0 && stats[i].cpu_time > print_state->last_times[id])
+					    ? (stats[i].cpu_time - print_state->last_times[id]) / 1000
+					    : 0;
+
+		voluntary[i] = stats[i].ctx_voluntary - print_state->last_ctx_voluntary[id];
+		involuntary[i] = stats[i].ctx_involuntary - print_state->last_ctx_involuntary[id];
+
+		/* a new task in the slot */
+		if (stats[i].ctx_voluntary < print_state->last_ctx_voluntary[id]
+		    || stats[i].ctx_involuntary < print_state->last_ctx_involuntary[id]) {
+			voluntary[i] = stats[i].ctx_voluntary;
+			involuntary[i] = stats[i].ctx_involuntary;
+		}
+
+		print_state->last_times[id] = stats[i].cpu_time;
+		print_state->last_ctx_voluntary[id] = stats[i].ctx_voluntary;
+		print_state->last_ctx_involuntary[id] = stats[i].ctx_involuntary;
+		print_state->curr_loads[id] = interval_runtime * print_state->interval_time_ms_inv;
+		print_state->total_user_time += interval_runtime;
+	}
+
+	dprintf(fd, "%sProcesses: %d tasks\n", clear_line, count);
+	dprintf(fd, "%sCPU usage: %.2f%% tasks (of one CPU)\n", clear_line,
+		(double)(print_state->total_user_time * print_state->interval_time_ms_inv * 100.f));
+	dprintf(fd, "%sUptime: %.3fs total\n%s\n", clear_line, (double)t / 1000000.0, clear_line);
+
+	/* header for task list */
+	dprintf(fd, "%s%4s %-20s %8s %6s %3s %3s %-5s %4s %11s %13s\n",
+		clear_line,
+		"ID",
+		"COMMAND",
+		"CPU(ms)",
+		"CPU(%)",
+		"CPU",
+		"PIN",
+		"SCHED",
+		"PRIO",
+		"SWITCHES",
+		"USED/STACK");
+
+	for (int i = 0; i < count; i++) {
+		float load = print_state->curr_loads[stats[i].id % CONFIG_MAX_TASKS];
+
+		dprintf(fd, "%s%4d %-20s %8llu %2d.%03d %3d %3d %-5s %4d %5lu/%5lu %6u/%6u\n",
+			clear_line,
+			stats[i].id,
+			stats[i].name,
+			(unsigned long long)(stats[i].cpu_time / 1000),
+			(int)(load * 100.0f),
+			(int)((load * 100.0f - (int)(load * 100.0f)) * 1000),
+			stats[i].cpu,
+			stats[i].affinity,
+			policy_name(stats[i].policy),
+			stats[i].priority,
+			voluntary[i],
+			involuntary[i],
+			(unsigned)stats[i].stack_used,
+			(unsigned)stats[i].stack_size);
+	}
+
+	print_state->interval_start_time = print_state->new_time;
+}
@@ -61,6 +61,10 @@ struct print_load_s {
 	uint64_t last_times[CONFIG_MAX_TASKS];
 	float curr_loads[CONFIG_MAX_TASKS];
 	float interval_time_ms_inv;
+#ifdef __PX4_POSIX
+	unsigned long last_ctx_voluntary[CONFIG_MAX_TASKS];
+	unsigned long last_ctx_involuntary[CONFIG_MAX_TASKS];
+#endif
 };
 
 __EXPORT void init_print_load_s(uint64_t t, struct print_load_s *s);
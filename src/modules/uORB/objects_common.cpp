@@ -263,3 +263,6 @@ ORB_DEFINE(distance_sensor, struct distance_sensor_s);
 
 #include "topics/camera_trigger.h"
 ORB_DEFINE(camera_trigger, struct camera_trigger_s);
+
+#include "topics/pipeline_latency.h"
+ORB_DEFINE(pipeline_latency, struct pipeline_latency_s);
@@ -46,14 +46,36 @@
 // Hack until everything is using this header
 #include <systemlib/visibility.h>
 
+// Topic ids generated from the msg files
+#include <uORB/topics/uORBTopics.h>
+
 /**
  * Object metadata.
  */
 struct orb_metadata {
 	const char *o_name;		/**< unique object name */
 	const size_t o_size;		/**< object size */
+	const uint16_t o_id;		/**< topic id, ORB_TOPIC_ID_<name> or ORB_TOPIC_ID_UNLISTED */
 };
 
+/**
+ * Topic id of topics which are not listed in a msg file, like the ones
+ * defined by tests. They are numbered after the generated ids on first use,
+ * up to ORB_UNLISTED_TOPICS_MAX of them.
+ */
+#define ORB_TOPIC_ID_UNLISTED	0xffff
+#define ORB_UNLISTED_TOPICS_MAX	16
+
+/**
+ * Topic id of a topic, ORB_TOPIC_ID_UNLISTED if it has none.
+ *
+ * ORB_TOPIC_LISTED_<name> expands to "~, ORB_TOPIC_ID_<name>" for every
+ * generated topic, which moves the id into the second argument.
+ */
+#define __ORB_SECOND_ARG(_a, _b, ...)	_b
+#define __ORB_SELECT_ID(...)		__ORB_SECOND_ARG(__VA_ARGS__)
+#define ORB_TOPIC_ID(_name)		__ORB_SELECT_ID(ORB_TOPIC_LISTED_##_name, ORB_TOPIC_ID_UNLISTED, ~)
+
 typedef const struct orb_metadata *orb_id_t;
 
 /**
@@ -114,7 +136,8 @@ enum ORB_PRIO {
 #define ORB_DEFINE(_name, _struct)			\
 	const struct orb_metadata __orb_##_name = {	\
 		#_name,					\
-		sizeof(_struct)				\
+		sizeof(_struct),			\
+		ORB_TOPIC_ID(_name)			\
 	}; struct hack
 
 __BEGIN_DECLS
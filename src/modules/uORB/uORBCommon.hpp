@@ -45,6 +45,9 @@ namespace uORB
 {
 static const unsigned orb_maxpath = 64;
 
+/* generated topic ids followed by the ones of unlisted topics */
+static const unsigned orb_max_topics = ORB_TOPICS_COUNT + ORB_UNLISTED_TOPICS_MAX;
+
 #ifdef ERROR
 # undef ERROR
 #endif
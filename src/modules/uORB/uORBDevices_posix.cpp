@@ -36,6 +36,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <algorithm>
+#include <px4_trace.h>
 
 #include "uORBDevices_posix.hpp"
 #include "uORBUtils.hpp"
@@ -43,7 +44,7 @@
 #include "uORBCommunicator.hpp"
 #include <stdlib.h>
 
-std::map<std::string, uORB::DeviceNode *> uORB::DeviceMaster::_node_map;
+uORB::DeviceNode *uORB::DeviceMaster::_node_table[PX4_MAX_VEHICLES][orb_max_topics][ORB_MULTI_MAX_INSTANCES];
 
 
 uORB::DeviceNode::SubscriberData  *uORB::DeviceNode::filp_to_sd(device::file_t *filp)
@@ -69,7 +70,9 @@ uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const char *name,
 	_publisher(0),
 	_priority(priority),
 	_published(false),
-	_subscriber_count(0)
+	_subscriber_count(0),
+	_unlimited_subscribers(0),
+	_min_interval(0)
 {
 	// enable debug() calls
 	//_debug_enabled = true;
@@ -167,6 +170,11 @@ uORB::DeviceNode::close(device::file_t *filp)
 
 		if (sd != nullptr) {
 			hrt_cancel(&sd->update_call);
+
+			if (sd->update_interval == 0) {
+				_unlimited_subscribers--;
+			}
+
 			remove_internal_subscriber();
 			delete sd;
 			sd = nullptr;
@@ -286,6 +294,7 @@ uORB::DeviceNode::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 		return PX4_OK;
 
 	case ORBIOCSETINTERVAL:
+		update_subscriber_interval(sd->update_interval, arg);
 		sd->update_interval = arg;
 		return PX4_OK;
 
@@ -335,6 +344,8 @@ uORB::DeviceNode::publish(const orb_metadata *meta, orb_advert_t handle, const v
 		return ERROR;
 	}
 
+	px4_trace_instant(PX4_TRACE_ORB, meta->o_name, devnode->_generation);
+
 	/*
 	 * if the write is successful, send the data over the Multi-ORB link
 	 */
@@ -478,11 +489,13 @@ uORB::DeviceNode::update_deferred_trampoline(void *arg)
 //-----------------------------------------------------------------------------
 void uORB::DeviceNode::add_internal_subscriber()
 {
+	// new subscribers start without update interval
 	_subscriber_count++;
+	_unlimited_subscribers++;
 	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
 
 	if (ch != nullptr && _subscriber_count > 0) {
-		ch->add_subscription(_meta->o_name, 1);
+		ch->add_subscription(_meta->o_name, subscription_rate());
 	}
 }
 
@@ -491,6 +504,11 @@ void uORB::DeviceNode::add_internal_subscriber()
 void uORB::DeviceNode::remove_internal_subscriber()
 {
 	_subscriber_count--;
+
+	if (_subscriber_count == 0) {
+		_min_interval = 0;
+	}
+
 	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
 
 	if (ch != nullptr && _subscriber_count == 0) {
@@ -498,6 +516,43 @@ void uORB::DeviceNode::remove_internal_subscriber()
 	}
 }
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+int32_t uORB::DeviceNode::subscription_rate()
+{
+	if (_unlimited_subscribers > 0 || _min_interval == 0) {
+		return 0;
+	}
+
+	// intervals above a second still ask for 1 Hz
+	int32_t rate = 1000000 / _min_interval;
+	return (rate > 0) ? rate : 1;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+void uORB::DeviceNode::update_subscriber_interval(unsigned old_interval, unsigned new_interval)
+{
+	int32_t rate = subscription_rate();
+
+	if (old_interval == 0) {
+		_unlimited_subscribers--;
+	}
+
+	if (new_interval == 0) {
+		_unlimited_subscribers++;
+
+	} else if (_min_interval == 0 || new_interval < _min_interval) {
+		_min_interval = new_interval;
+	}
+
+	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
+
+	if (ch != nullptr && subscription_rate() != rate) {
+		ch->add_subscription(_meta->o_name, subscription_rate());
+	}
+}
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -590,6 +645,13 @@ uORB::DeviceMaster::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 				*(adv->instance) = 0;
 			}
 
+			/* the node table only has room for a few topics without a generated id */
+			const int topic_id = uORB::Utils::topic_id(meta);
+
+			if (topic_id < 0) {
+				return -EINVAL;
+			}
+
 			/* construct a path to the node - this also checks the node name */
 			ret = uORB::Utils::node_mkpath(nodepath, _flavor, meta, adv->instance);
 
@@ -650,7 +712,7 @@ uORB::DeviceMaster::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 					if (ret == -EEXIST) {
 						/* if the node exists already, get the existing one and check if
 						 * something has been published yet. */
-						uORB::DeviceNode *existing_node = GetDeviceNode(devpath);
+						uORB::DeviceNode *existing_node = GetDeviceNode(meta, group_tries);
 
 						if ((existing_node != nullptr) && !(existing_node->is_published())) {
 							/* nothing has been published yet, lets claim it */
@@ -666,8 +728,8 @@ uORB::DeviceMaster::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 					free((void *)devpath);
 
 				} else {
-					// add to the node map;.
-					_node_map[std::string(nodepath)] = node;
+					// add to the node table
+					_node_table[px4_vehicle_id()][topic_id][group_tries] = node;
 				}
 
 
@@ -690,15 +752,3 @@ uORB::DeviceMaster::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 		return VDev::ioctl(filp, cmd, arg);
 	}
 }
-
-uORB::DeviceNode *uORB::DeviceMaster::GetDeviceNode(const char *nodepath)
-{
-	uORB::DeviceNode *rc = nullptr;
-	std::string np(nodepath);
-
-	if (_node_map.find(np) != _node_map.end()) {
-		rc = _node_map[np];
-	}
-
-	return rc;
-}
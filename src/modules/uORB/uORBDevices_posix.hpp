@@ -36,8 +36,9 @@
 
 #include <stdint.h>
 #include <string>
-#include <map>
+#include <px4_vehicle.h>
 #include "uORBCommon.hpp"
+#include "uORBUtils.hpp"
 
 namespace uORB
 {
@@ -96,6 +97,14 @@ public:
 	 */
 	void remove_internal_subscriber();
 
+	/**
+	 * Rate at which the local subscribers want updates, 0 for no limit.
+	 *
+	 * This is the rate of the fastest subscriber which set an interval
+	 * since the last one closed, so it might be higher than needed.
+	 */
+	int32_t subscription_rate();
+
 	/**
 	 * Return true if this topic has been published.
 	 *
@@ -128,6 +137,14 @@ private:
 	SubscriberData    *filp_to_sd(device::file_t *filp);
 
 	int32_t _subscriber_count;
+	int32_t _unlimited_subscribers; /**< subscribers without update interval */
+	unsigned _min_interval; /**< shortest update interval set since the last subscriber closed */
+
+	/**
+	 * Account for the change of a subscriber's interval and pass the new
+	 * rate on to the remote side.
+	 */
+	void update_subscriber_interval(unsigned old_interval, unsigned new_interval);
 
 	/**
 	 * Perform a deferred update for a rate-limited subscriber.
@@ -167,12 +184,34 @@ public:
 	DeviceMaster(Flavor f);
 	~DeviceMaster();
 
-	static uORB::DeviceNode *GetDeviceNode(const char *node_name);
+	/**
+	 * Node of an advertised topic instance.
+	 *
+	 * @return the node, or nullptr if it has not been advertised yet.
+	 */
+	static uORB::DeviceNode *GetDeviceNode(const struct orb_metadata *meta, unsigned instance = 0)
+	{
+		return GetDeviceNode(uORB::Utils::topic_id(meta), instance);
+	}
+
+	/**
+	 * Same as above, for the topic id looked up by Utils::topic_id().
+	 */
+	static uORB::DeviceNode *GetDeviceNode(int topic_id, unsigned instance = 0)
+	{
+		return (topic_id >= 0 && topic_id < (int)orb_max_topics && instance < ORB_MULTI_MAX_INSTANCES) ?
+		       _node_table[px4_vehicle_id()][topic_id][instance] : nullptr;
+	}
 
 	virtual int   ioctl(device::file_t *filp, int cmd, unsigned long arg);
 private:
 	Flavor      _flavor;
-	static std::map<std::string, uORB::DeviceNode *> _node_map;
+
+	/**
+	 * Advertised nodes by vehicle, topic id and instance. Entries are only
+	 * ever set with the master locked, and nodes are never deleted.
+	 */
+	static uORB::DeviceNode *_node_table[PX4_MAX_VEHICLES][orb_max_topics][ORB_MULTI_MAX_INSTANCES];
 };
 
 #endif /* _uORBDeviceNode_posix.hpp */
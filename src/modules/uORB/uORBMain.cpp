@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include <string.h>
+#include <px4_vehicle.h>
 #include "uORBDevices.hpp"
 #include "uORB.h"
 #include "uORBCommon.hpp"
@@ -42,7 +43,7 @@
 
 extern "C" { __EXPORT int uorb_main(int argc, char *argv[]); }
 
-static uORB::DeviceMaster *g_dev = nullptr;
+static px4::VehicleInstance<uORB::DeviceMaster> g_dev;
 static void usage()
 {
 	warnx("Usage: uorb 'start', 'test', 'latency_test' or 'status'");
@@ -106,13 +107,13 @@ uorb_main(int argc, char *argv[])
 		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
 
 		if (argc > 2 && !strcmp(argv[2], "medium")) {
-			return t.latency_test<struct orb_test_medium>(ORB_ID(orb_test_medium), true);
+			return t.latency_test<struct orb_test_medium_s>(ORB_ID(orb_test_medium), true);
 
 		} else if (argc > 2 && !strcmp(argv[2], "large")) {
-			return t.latency_test<struct orb_test_large>(ORB_ID(orb_test_large), true);
+			return t.latency_test<struct orb_test_large_s>(ORB_ID(orb_test_large), true);
 
 		} else {
-			return t.latency_test<struct orb_test>(ORB_ID(orb_test), true);
+			return t.latency_test<struct orb_test_s>(ORB_ID(orb_test), true);
 		}
 	}
 
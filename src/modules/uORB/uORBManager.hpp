@@ -39,10 +39,6 @@
 #include <stdint.h>
 #ifdef __PX4_NUTTX
 #include "ORBSet.hpp"
-#else
-#include <string>
-#include <set>
-#define ORBSet std::set<std::string>
 #endif
 
 #include "uORBCommunicator.hpp"
@@ -349,7 +345,11 @@ private: // data members
 	static Manager *_Instance;
 	// the communicator channel instance.
 	uORBCommunicator::IChannel *_comm_channel;
+#ifdef __PX4_NUTTX
 	ORBSet _remote_subscriber_topics;
+#else
+	bool _remote_subscriber_topics[orb_max_topics]; /**< by topic id */
+#endif
 
 private: //class methods
 	Manager();
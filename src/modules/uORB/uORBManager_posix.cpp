@@ -35,6 +35,7 @@
 #include <stdarg.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <string.h>
 #include <px4_config.h>
 #include <px4_posix.h>
 #include "uORBUtils.hpp"
@@ -62,23 +63,17 @@ uORB::Manager *uORB::Manager::get_instance()
 uORB::Manager::Manager()
 	: _comm_channel(nullptr)
 {
+	memset(_remote_subscriber_topics, 0, sizeof(_remote_subscriber_topics));
 }
 
 int uORB::Manager::orb_exists(const struct orb_metadata *meta, int instance)
 {
-	/*
-	 * Generate the path to the node and try to open it.
-	 */
-	char path[orb_maxpath];
-	int inst = instance;
-	int ret = uORB::Utils::node_mkpath(path, PUBSUB, meta, &inst);
-
-	if (ret != OK) {
-		errno = -ret;
+	if (instance < 0 || uORB::DeviceMaster::GetDeviceNode(meta, instance) == nullptr) {
+		errno = ENOENT;
 		return ERROR;
 	}
 
-	return px4_access(path, F_OK);
+	return OK;
 }
 
 orb_advert_t uORB::Manager::orb_advertise(const struct orb_metadata *meta, const void *data)
@@ -230,8 +225,7 @@ int uORB::Manager::node_open
 	int priority
 )
 {
-	char path[orb_maxpath];
-	int fd, ret;
+	int fd;
 
 	/*
 	 * If meta is null, the object was not defined, i.e. it is not
@@ -251,52 +245,27 @@ int uORB::Manager::node_open
 	}
 
 	/*
-	 * Generate the path to the node and try to open it.
+	 * Look up the node by topic id and open it. An advertiser of a
+	 * multi-topic always goes for a new instance.
 	 */
+	uORB::DeviceNode *node = nullptr;
 
-	// FIXME - if *instance is uninitialized, why is this being called? Seems risky and
-	// its definiately a waste. This is the case in muli-topic test.
-	ret = uORB::Utils::node_mkpath(path, f, meta, instance);
-
-	if (ret != PX4_OK) {
-		errno = -ret;
-		return ERROR;
-	}
-
-	/* open the path as either the advertiser or the subscriber */
-	fd = px4_open(path, (advertiser) ? PX4_F_WRONLY : PX4_F_RDONLY);
-
-	/* if we want to advertise and the node existed, we have to re-try again */
-	if ((fd >= 0) && (instance != nullptr) && (advertiser)) {
-		/* close the fd, we want a new one */
-		px4_close(fd);
-
-		/* the node_advertise call will automatically go for the next free entry */
-		fd = -1;
+	if (!advertiser || instance == nullptr) {
+		node = uORB::DeviceMaster::GetDeviceNode(meta, (instance != nullptr) ? *instance : 0);
 	}
 
 	/* we may need to advertise the node... */
-	if (fd < 0) {
-
-		/* try to create the node */
-		ret = node_advertise(meta, instance, priority);
+	if (node == nullptr) {
 
-		if (ret == PX4_OK) {
-			/* update the path, as it might have been updated during the node_advertise call */
-			ret = uORB::Utils::node_mkpath(path, f, meta, instance);
-
-			if (ret != PX4_OK) {
-				errno = -ret;
-				return ERROR;
-			}
-		}
-
-		/* on success, try the open again */
-		if (ret == PX4_OK) {
-			fd = px4_open(path, (advertiser) ? PX4_F_WRONLY : PX4_F_RDONLY);
+		/* try to create the node, this updates the instance to the one created */
+		if (node_advertise(meta, instance, priority) == PX4_OK) {
+			node = uORB::DeviceMaster::GetDeviceNode(meta, (instance != nullptr) ? *instance : 0);
 		}
 	}
 
+	/* open the node as either the advertiser or the subscriber */
+	fd = (node != nullptr) ? device::VDev::openDev(node, (advertiser) ? PX4_F_WRONLY : PX4_F_RDONLY) : -1;
+
 	if (fd < 0) {
 		errno = EIO;
 		return ERROR;
@@ -329,29 +298,25 @@ int16_t uORB::Manager::process_add_subscription(const char *messageName,
 {
 	warnx("[posix-uORB::Manager::process_add_subscription(%d)] entering Manager_process_add_subscription: name: %s",
 	      __LINE__, messageName);
-	int16_t rc = 0;
-	_remote_subscriber_topics.insert(messageName);
-	char nodepath[orb_maxpath];
-	int ret = uORB::Utils::node_mkpath(nodepath, PUBSUB, messageName);
-
-	if (ret == OK) {
-		// get the node name.
-		uORB::DeviceNode *node = uORB::DeviceMaster::GetDeviceNode(nodepath);
-
-		if (node == nullptr) {
-			warnx("[posix-uORB::Manager::process_add_subscription(%d)]DeviceNode(%s) not created yet",
-			      __LINE__, messageName);
-
-		} else {
-			// node is present.
-			node->process_add_subscription(msgRateInHz);
-		}
+	int topic_id = uORB::Utils::add_topic(messageName);
+
+	if (topic_id < 0) {
+		return -1;
+	}
+
+	_remote_subscriber_topics[topic_id] = true;
+	uORB::DeviceNode *node = uORB::DeviceMaster::GetDeviceNode(topic_id);
+
+	if (node == nullptr) {
+		warnx("[posix-uORB::Manager::process_add_subscription(%d)]DeviceNode(%s) not created yet",
+		      __LINE__, messageName);
 
 	} else {
-		rc = -1;
+		// node is present.
+		node->process_add_subscription(msgRateInHz);
 	}
 
-	return rc;
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -361,27 +326,24 @@ int16_t uORB::Manager::process_remove_subscription(
 {
 	warnx("[posix-uORB::Manager::process_remove_subscription(%d)] Enter: name: %s",
 	      __LINE__, messageName);
-	int16_t rc = -1;
-	_remote_subscriber_topics.erase(messageName);
-	char nodepath[orb_maxpath];
-	int ret = uORB::Utils::node_mkpath(nodepath, PUBSUB, messageName);
-
-	if (ret == OK) {
-		uORB::DeviceNode *node = uORB::DeviceMaster::GetDeviceNode(nodepath);
-
-		// get the node name.
-		if (node == nullptr) {
-			warnx("[posix-uORB::Manager::process_remove_subscription(%d)]Error No existing subscriber found for message: [%s]",
-			      __LINE__, messageName);
-
-		} else {
-			// node is present.
-			node->process_remove_subscription();
-			rc = 0;
-		}
+	int topic_id = uORB::Utils::topic_id(messageName);
+
+	if (topic_id < 0) {
+		return -1;
+	}
+
+	_remote_subscriber_topics[topic_id] = false;
+	uORB::DeviceNode *node = uORB::DeviceMaster::GetDeviceNode(topic_id);
+
+	if (node == nullptr) {
+		warnx("[posix-uORB::Manager::process_remove_subscription(%d)]Error No existing subscriber found for message: [%s]",
+		      __LINE__, messageName);
+		return -1;
 	}
 
-	return rc;
+	// node is present.
+	node->process_remove_subscription();
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -391,29 +353,21 @@ int16_t uORB::Manager::process_received_message(const char *messageName,
 {
 	//warnx("[uORB::Manager::process_received_message(%d)] Enter name: %s", __LINE__, messageName );
 
-	int16_t rc = -1;
-	char nodepath[orb_maxpath];
-	int ret = uORB::Utils::node_mkpath(nodepath, PUBSUB, messageName);
+	uORB::DeviceNode *node = uORB::DeviceMaster::GetDeviceNode(uORB::Utils::topic_id(messageName));
 
-	if (ret == OK) {
-		uORB::DeviceNode *node = uORB::DeviceMaster::GetDeviceNode(nodepath);
-
-		// get the node name.
-		if (node == nullptr) {
-			warnx("[uORB::Manager::process_received_message(%d)]Error No existing subscriber found for message: [%s] nodepath:[%s]",
-			      __LINE__, messageName, nodepath);
-
-		} else {
-			// node is present.
-			node->process_received_message(length, data);
-			rc = 0;
-		}
+	if (node == nullptr) {
+		warnx("[uORB::Manager::process_received_message(%d)]Error No existing subscriber found for message: [%s]",
+		      __LINE__, messageName);
+		return -1;
 	}
 
-	return rc;
+	// node is present.
+	node->process_received_message(length, data);
+	return 0;
 }
 
 bool uORB::Manager::is_remote_subscriber_present(const char *messageName)
 {
-	return (_remote_subscriber_topics.find(messageName) != _remote_subscriber_topics.end());
+	int topic_id = uORB::Utils::topic_id(messageName);
+	return (topic_id >= 0) && _remote_subscriber_topics[topic_id];
 }
@@ -55,7 +55,7 @@ int uORBTest::UnitTest::pubsublatency_main(void)
 	int test_multi_sub_medium = orb_subscribe_multi(ORB_ID(orb_test_medium), 0);
 	int test_multi_sub_large = orb_subscribe_multi(ORB_ID(orb_test_large), 0);
 
-	struct orb_test_large t;
+	struct orb_test_large_s t;
 
 	/* clear all ready flags */
 	orb_copy(ORB_ID(orb_test), test_multi_sub, &t);
@@ -171,7 +171,7 @@ int uORBTest::UnitTest::test_single()
 {
 	test_note("try single-topic support");
 
-	struct orb_test t, u;
+	struct orb_test_s t, u;
 	int sfd;
 	orb_advert_t ptopic;
 	bool updated;
@@ -242,7 +242,7 @@ int uORBTest::UnitTest::test_multi()
 	/* this routine tests the multi-topic support */
 	test_note("try multi-topic support");
 
-	struct orb_test t, u;
+	struct orb_test_s t, u;
 	t.val = 0;
 	int instance0;
 	orb_advert_t pfd0 = orb_advertise_multi(ORB_ID(orb_multitest), &t, &instance0, ORB_PRIO_MAX);
@@ -314,7 +314,7 @@ int uORBTest::UnitTest::test_multi()
 		return test_fail("prio: %d", prio);
 	}
 
-	if (PX4_OK != latency_test<struct orb_test>(ORB_ID(orb_test), false)) {
+	if (PX4_OK != latency_test<struct orb_test_s>(ORB_ID(orb_test), false)) {
 		return test_fail("latency test failed");
 	}
 
@@ -334,7 +334,7 @@ int uORBTest::UnitTest::test_multi_reversed()
 		return test_fail("sub. id2: ret: %d", sfd2);
 	}
 
-	struct orb_test t, u;
+	struct orb_test_s t, u;
 
 	t.val = 0;
 
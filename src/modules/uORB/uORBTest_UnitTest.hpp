@@ -37,26 +37,14 @@
 #include "uORB.h"
 #include <px4_time.h>
 
-struct orb_test {
-	int val;
-	hrt_abstime time;
-};
-ORB_DEFINE(orb_test, struct orb_test);
-ORB_DEFINE(orb_multitest, struct orb_test);
-
-struct orb_test_medium {
-	int val;
-	hrt_abstime time;
-	char junk[64];
-};
-ORB_DEFINE(orb_test_medium, struct orb_test_medium);
-
-struct orb_test_large {
-	int val;
-	hrt_abstime time;
-	char junk[512];
-};
-ORB_DEFINE(orb_test_large, struct orb_test_large);
+#include <uORB/topics/orb_test.h>
+#include <uORB/topics/orb_test_medium.h>
+#include <uORB/topics/orb_test_large.h>
+
+ORB_DEFINE(orb_test, struct orb_test_s);
+ORB_DEFINE(orb_multitest, struct orb_test_s);
+ORB_DEFINE(orb_test_medium, struct orb_test_medium_s);
+ORB_DEFINE(orb_test_large, struct orb_test_large_s);
 
 
 namespace uORBTest
@@ -33,6 +33,8 @@
 
 #include "uORBUtils.hpp"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 int uORB::Utils::node_mkpath
@@ -80,3 +82,101 @@ int uORB::Utils::node_mkpath(char *buf, Flavor f,
 
 	return OK;
 }
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+static const char *const topic_names[ORB_TOPICS_COUNT] = { ORB_TOPIC_NAMES };
+
+/* names of the topics without a generated id, slots are taken in order and never freed */
+static const char *unlisted_names[ORB_UNLISTED_TOPICS_MAX];
+
+static int generated_topic_id(const char *orbMsgName)
+{
+	/* the generated names are in the order of the ids, which is sorted */
+	int low = 0;
+	int high = ORB_TOPICS_COUNT - 1;
+
+	while (low <= high) {
+		int mid = (low + high) / 2;
+		int cmp = strcmp(orbMsgName, topic_names[mid]);
+
+		if (cmp == 0) {
+			return mid;
+
+		} else if (cmp < 0) {
+			high = mid - 1;
+
+		} else {
+			low = mid + 1;
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * Look up an unlisted topic, adding it if name is given. Racing adders of the
+ * same name end up in the same slot, as a failed CAS compares the winner.
+ */
+static int unlisted_topic_id(const char *orbMsgName, const char *name)
+{
+	for (unsigned i = 0; i < ORB_UNLISTED_TOPICS_MAX; i++) {
+		const char *slot = __atomic_load_n(&unlisted_names[i], __ATOMIC_ACQUIRE);
+
+		if (slot == nullptr) {
+			if (name == nullptr) {
+				return -1;
+			}
+
+			if (__atomic_compare_exchange_n(&unlisted_names[i], &slot, name, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+				return ORB_TOPICS_COUNT + i;
+			}
+		}
+
+		if (strcmp(slot, orbMsgName) == 0) {
+			return ORB_TOPICS_COUNT + i;
+		}
+	}
+
+	return -1;
+}
+
+int uORB::Utils::topic_id(const char *orbMsgName)
+{
+	int id = generated_topic_id(orbMsgName);
+	return (id >= 0) ? id : unlisted_topic_id(orbMsgName, nullptr);
+}
+
+int uORB::Utils::topic_id(const struct orb_metadata *meta)
+{
+	if (meta->o_id != ORB_TOPIC_ID_UNLISTED) {
+		return meta->o_id;
+	}
+
+	/* the metadata name is static */
+	return unlisted_topic_id(meta->o_name, meta->o_name);
+}
+
+int uORB::Utils::add_topic(const char *orbMsgName)
+{
+	int id = topic_id(orbMsgName);
+
+	if (id >= 0) {
+		return id;
+	}
+
+	/* the name comes from a message buffer, keep a copy unless another thread added it first */
+	char *name = strdup(orbMsgName);
+
+	if (name == nullptr) {
+		return -1;
+	}
+
+	id = unlisted_topic_id(orbMsgName, name);
+
+	if (id < 0 || __atomic_load_n(&unlisted_names[id - ORB_TOPICS_COUNT], __ATOMIC_RELAXED) != name) {
+		free(name);
+	}
+
+	return id;
+}
@@ -57,6 +57,26 @@ public:
 	 */
 	static int node_mkpath(char *buf, Flavor f, const char *orbMsgName);
 
+	/**
+	 * Topic id for a topic name, for the remote channels which pass names.
+	 *
+	 * @return the id, or -1 if the topic is not known to this build.
+	 */
+	static int topic_id(const char *orbMsgName);
+
+	/**
+	 * Topic id of a topic, topics without a generated id get one after
+	 * ORB_TOPICS_COUNT on first use.
+	 *
+	 * @return the id, or -1 if there are too many unlisted topics.
+	 */
+	static int topic_id(const struct orb_metadata *meta);
+
+	/**
+	 * Same as above, for a topic name passed by a remote channel.
+	 */
+	static int add_topic(const char *orbMsgName);
+
 };
 
 #endif // _uORBUtils_hpp_
@@ -933,6 +933,7 @@ int UavcanNode::run()
 
 			// Output to the bus
 			_outputs.timestamp = hrt_absolute_time();
+			_outputs.timestamp_sample = _controls[0].timestamp_sample;
 			perf_begin(_perfcnt_esc_mixer_output_elapsed);
 			_esc_controller.update_outputs(_outputs.output, _outputs.noutputs);
 			perf_end(_perfcnt_esc_mixer_output_elapsed);
@@ -603,6 +603,11 @@ void VtolAttitudeControl::task_main()
 
 		_vtol_type->fill_actuator_outputs();
 
+		/* sensor sample of the newest controller output that went in */
+		_actuators_out_0.timestamp_sample = (_actuators_mc_in.timestamp_sample > _actuators_fw_in.timestamp_sample) ?
+						    _actuators_mc_in.timestamp_sample : _actuators_fw_in.timestamp_sample;
+		_actuators_out_1.timestamp_sample = _actuators_out_0.timestamp_sample;
+
 		/* Only publish if the proper mode(s) are enabled */
 		if (_v_control_mode.flag_control_attitude_enabled ||
 		    _v_control_mode.flag_control_rates_enabled ||
@@ -48,6 +48,7 @@
 #include <math.h>
 #include <unistd.h>
 #include <px4_getopt.h>
+#include <px4_vehicle.h>
 
 #include <simulator/simulator.h>
 
@@ -119,6 +120,7 @@ private:
 
 	struct hrt_call		_accel_call;
 	struct hrt_call		_mag_call;
+	bool			_sim_notify;	/**< measuring on fresh data from the simulator */
 
 	unsigned		_call_accel_interval;
 	unsigned		_call_mag_interval;
@@ -189,7 +191,8 @@ private:
 	 * generic hrt wrapper yet.
 	 *
 	 * Called by the HRT in interrupt context at the specified rate if
-	 * automatic polling is enabled.
+	 * automatic polling is enabled, or by the simulator thread when it
+	 * has fresh data.
 	 *
 	 * @param arg		Instance pointer for the driver that is polling.
 	 */
@@ -303,6 +306,7 @@ ACCELSIM::ACCELSIM(const char *path, enum Rotation rotation) :
 	_mag(new ACCELSIM_mag(this)),
 	_accel_call{},
 	_mag_call{},
+	_sim_notify(false),
 	_call_accel_interval(0),
 	_call_mag_interval(0),
 	_accel_reports(nullptr),
@@ -617,8 +621,8 @@ ACCELSIM::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 					/* XXX this is a bit shady, but no other way to adjust... */
 					_accel_call.period = _call_accel_interval = period;
 
-					/* if we need to start the poll state machine, do it */
-					if (want_start) {
+					/* if we need to start the poll state machine, or pass the interval to the simulator, do it */
+					if (want_start || _sim_notify) {
 						start();
 					}
 
@@ -746,8 +750,8 @@ ACCELSIM::mag_ioctl(device::file_t *filp, int cmd, unsigned long arg)
 
 					//PX4_INFO("SET _call_mag_interval=%u", _call_mag_interval);
 
-					/* if we need to start the poll state machine, do it */
-					if (want_start) {
+					/* if we need to start the poll state machine, or pass the interval to the simulator, do it */
+					if (want_start || _sim_notify) {
 						start();
 					}
 
@@ -878,16 +882,29 @@ ACCELSIM::start()
 	_accel_reports->flush();
 	_mag_reports->flush();
 
-	/* start polling at the specified rate */
-	//PX4_INFO("ACCELSIM::start accel %u", _call_accel_interval);
-	hrt_call_every(&_accel_call, 1000, _call_accel_interval, (hrt_callout)&ACCELSIM::measure_trampoline, this);
-
 	// There is a race here where SENSORIOCSPOLLRATE on the accel starts polling of mag but _call_mag_interval is 0
 	if (_call_mag_interval == 0) {
 		//PX4_INFO("_call_mag_interval uninitilized - would have set period delay of 0");
 		_call_mag_interval = 10000; // Max 100Hz
 	}
 
+	/* measure when the simulator has fresh data */
+	Simulator *sim = Simulator::getInstance();
+
+	if (sim != nullptr &&
+	    sim->addNotify(Simulator::SIM_ACCEL, &ACCELSIM::measure_trampoline, this, _call_accel_interval)) {
+		if (sim->addNotify(Simulator::SIM_MAG, &ACCELSIM::mag_measure_trampoline, this, _call_mag_interval)) {
+			_sim_notify = true;
+			return;
+		}
+
+		sim->removeNotify(Simulator::SIM_ACCEL, &ACCELSIM::measure_trampoline, this);
+	}
+
+	/* else start polling at the specified rate */
+	//PX4_INFO("ACCELSIM::start accel %u", _call_accel_interval);
+	hrt_call_every(&_accel_call, 1000, _call_accel_interval, (hrt_callout)&ACCELSIM::measure_trampoline, this);
+
 	//PX4_INFO("ACCELSIM::start mag %u", _call_mag_interval);
 	hrt_call_every(&_mag_call, 1000, _call_mag_interval, (hrt_callout)&ACCELSIM::mag_measure_trampoline, this);
 }
@@ -897,6 +914,12 @@ ACCELSIM::stop()
 {
 	hrt_cancel(&_accel_call);
 	hrt_cancel(&_mag_call);
+
+	if (_sim_notify) {
+		Simulator::getInstance()->removeNotify(Simulator::SIM_ACCEL, &ACCELSIM::measure_trampoline, this);
+		Simulator::getInstance()->removeNotify(Simulator::SIM_MAG, &ACCELSIM::mag_measure_trampoline, this);
+		_sim_notify = false;
+	}
 }
 
 void
@@ -1161,7 +1184,7 @@ ACCELSIM_mag::measure_trampoline(void *arg)
 namespace accelsim
 {
 
-ACCELSIM	*g_dev;
+px4::VehicleInstance<ACCELSIM> g_dev;
 
 int	start(enum Rotation rotation);
 int	info();
@@ -1248,7 +1271,7 @@ info()
 		return 1;
 	}
 
-	PX4_DEBUG("state @ %p", g_dev);
+	PX4_DEBUG("state @ %p", (ACCELSIM *)g_dev);
 
 	return 0;
 }
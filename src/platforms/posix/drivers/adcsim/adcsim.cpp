@@ -43,6 +43,7 @@
 #include <px4_config.h>
 #include <px4_time.h>
 #include <px4_adc.h>
+#include <px4_vehicle.h>
 #include <board_config.h>
 #include <drivers/device/device.h>
 
@@ -239,7 +240,7 @@ extern "C" __EXPORT int adcsim_main(int argc, char *argv[]);
 
 namespace
 {
-ADCSIM	*g_adc;
+px4::VehicleInstance<ADCSIM> g_adc;
 
 int
 test(void)
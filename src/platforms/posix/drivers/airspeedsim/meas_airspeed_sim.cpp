@@ -45,6 +45,7 @@
 
 
 #include <px4_config.h>
+#include <px4_vehicle.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -354,7 +355,7 @@ MEASAirspeedSim::voltage_correction(float &diff_press_pa, float &temperature)
 namespace meas_airspeed_sim
 {
 
-MEASAirspeedSim	*g_dev = nullptr;
+px4::VehicleInstance<MEASAirspeedSim> g_dev;
 
 int	start(int i2c_bus);
 int	stop();
@@ -549,7 +550,7 @@ info()
 		PX4_WARN("driver not running");
 	}
 
-	printf("state @ %p\n", g_dev);
+	printf("state @ %p\n", (MEASAirspeedSim *)g_dev);
 	g_dev->print_info();
 
 	return 0;
@@ -40,6 +40,7 @@
 #include <px4_defines.h>
 #include <px4_time.h>
 #include <px4_getopt.h>
+#include <px4_vehicle.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -65,6 +66,7 @@
 
 #include <systemlib/perf_counter.h>
 #include <systemlib/err.h>
+#include <simulator/simulator.h>
 
 #include "barosim.h"
 
@@ -114,6 +116,7 @@ protected:
 
 	bool			_collect_phase;
 	unsigned		_measure_phase;
+	bool			_sim_notify;	/**< sampling on fresh data from the simulator */
 
 	/* intermediate temperature values per BAROSIM datasheet */
 	int32_t			_TEMP;
@@ -177,6 +180,13 @@ protected:
 	 */
 	static void		cycle_trampoline(void *arg);
 
+	/**
+	 * Static trampoline from the simulator thread when it has a fresh sample.
+	 *
+	 * @param arg		Instance pointer for the driver that is polling.
+	 */
+	static void		sample_trampoline(void *arg);
+
 	/**
 	 * Issue a measurement command for the current state.
 	 *
@@ -203,6 +213,7 @@ BAROSIM::BAROSIM(device::Device *interface, barosim::prom_u &prom_buf, const cha
 	_reports(nullptr),
 	_collect_phase(false),
 	_measure_phase(0),
+	_sim_notify(false),
 	_TEMP(0),
 	_OFF(0),
 	_SENS(0),
@@ -426,8 +437,8 @@ BAROSIM::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 				/* set interval for next measurement to minimum legal value */
 				_measure_ticks = USEC2TICK(BAROSIM_CONVERSION_INTERVAL);
 
-				/* if we need to start the poll state machine, do it */
-				if (want_start) {
+				/* if we need to start the poll state machine, or pass the interval to the simulator, do it */
+				if (want_start || _sim_notify) {
 					start_cycle();
 				}
 
@@ -450,8 +461,8 @@ BAROSIM::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 				/* update interval for next measurement */
 				_measure_ticks = ticks;
 
-				/* if we need to start the poll state machine, do it */
-				if (want_start) {
+				/* if we need to start the poll state machine, or pass the interval to the simulator, do it */
+				if (want_start || _sim_notify) {
 					start_cycle();
 				}
 
@@ -514,13 +525,23 @@ BAROSIM::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 void
 BAROSIM::start_cycle()
 {
+	stop_cycle();
 
 	/* reset the report ring and state machine */
 	_collect_phase = false;
 	_measure_phase = 0;
 	_reports->flush();
 
-	/* schedule a cycle to start things */
+	/* sample when the simulator has fresh data */
+	Simulator *sim = Simulator::getInstance();
+
+	if (sim != nullptr &&
+	    sim->addNotify(Simulator::SIM_BARO, &BAROSIM::sample_trampoline, this, _measure_ticks * USEC_PER_TICK)) {
+		_sim_notify = true;
+		return;
+	}
+
+	/* else schedule a cycle to start things */
 	work_queue(HPWORK, &_work, (worker_t)&BAROSIM::cycle_trampoline, this, 1);
 }
 
@@ -528,6 +549,11 @@ void
 BAROSIM::stop_cycle()
 {
 	work_cancel(HPWORK, &_work);
+
+	if (_sim_notify) {
+		Simulator::getInstance()->removeNotify(Simulator::SIM_BARO, &BAROSIM::sample_trampoline, this);
+		_sim_notify = false;
+	}
 }
 
 void
@@ -538,6 +564,19 @@ BAROSIM::cycle_trampoline(void *arg)
 	dev->cycle();
 }
 
+void
+BAROSIM::sample_trampoline(void *arg)
+{
+	BAROSIM *dev = reinterpret_cast<BAROSIM *>(arg);
+
+	/* the simulator has pressure and temperature at once, so every sample is a pressure measurement */
+	dev->_measure_phase = 1;
+
+	if (dev->measure() == OK) {
+		dev->collect();
+	}
+}
+
 void
 BAROSIM::cycle()
 {
@@ -737,9 +776,9 @@ struct barosim_bus_option {
 	const char *devpath;
 	BAROSIM_constructor interface_constructor;
 	uint8_t busnum;
-	BAROSIM *dev;
+	px4::VehicleInstance<BAROSIM> dev;
 } bus_options[] = {
-	{ BAROSIM_BUS_SIM_EXTERNAL, "/dev/baro_sim", &BAROSIM_sim_interface, PX4_SIM_BUS_TEST, NULL },
+	{ BAROSIM_BUS_SIM_EXTERNAL, "/dev/baro_sim", &BAROSIM_sim_interface, PX4_SIM_BUS_TEST },
 };
 #define NUM_BUS_OPTIONS (sizeof(bus_options)/sizeof(bus_options[0]))
 
@@ -823,7 +862,7 @@ start_bus(struct barosim_bus_option &bus)
 	if (bus.dev != nullptr && OK != bus.dev->init()) {
 		delete bus.dev;
 		bus.dev = NULL;
-		PX4_ERR("bus init failed %p", bus.dev);
+		PX4_ERR("bus init failed %p", (BAROSIM *)bus.dev);
 		return false;
 	}
 
@@ -52,6 +52,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <px4_config.h>
+#include <px4_vehicle.h>
 #include <drivers/drv_hrt.h>
 #include <drivers/device/device.h>
 #include <systemlib/systemlib.h>
@@ -154,7 +155,7 @@ extern "C" __EXPORT int gpssim_main(int argc, char *argv[]);
 namespace
 {
 
-GPSSIM	*g_dev = nullptr;
+px4::VehicleInstance<GPSSIM> g_dev;
 
 }
 
@@ -426,7 +427,7 @@ GPSSIM::print_info()
 namespace gpssim
 {
 
-GPSSIM	*g_dev = nullptr;
+px4::VehicleInstance<GPSSIM> g_dev;
 
 void	start(const char *uart_path, bool fake_gps, bool enable_sat_info);
 void	stop();
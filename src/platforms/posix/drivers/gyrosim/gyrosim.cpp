@@ -46,6 +46,7 @@
 
 #include <px4_config.h>
 #include <px4_getopt.h>
+#include <px4_vehicle.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -145,6 +146,7 @@ private:
 
 	struct hrt_call		_call;
 	unsigned		_call_interval;
+	bool			_sim_notify;	/**< measuring on fresh data from the simulator */
 
 	ringbuffer::RingBuffer	*_accel_reports;
 
@@ -197,7 +199,8 @@ private:
 	 * generic hrt wrapper yet.
 	 *
 	 * Called by the HRT in interrupt context at the specified rate if
-	 * automatic polling is enabled.
+	 * automatic polling is enabled, or by the simulator thread when it
+	 * has fresh data.
 	 *
 	 * @param arg		Instance pointer for the driver that is polling.
 	 */
@@ -327,6 +330,7 @@ GYROSIM::GYROSIM(const char *path_accel, const char *path_gyro, enum Rotation ro
 	_product(GYROSIMES_REV_C4),
 	_call{},
 	_call_interval(0),
+	_sim_notify(false),
 	_accel_reports(nullptr),
 	_accel_scale{},
 	_accel_range_scale(0.0f),
@@ -572,8 +576,8 @@ GYROSIM::_set_sample_rate(unsigned desired_sample_rate_hz)
 	_sample_rate = 1000 / div;
 	PX4_INFO("GYROSIM: Changed sample rate to %uHz", _sample_rate);
 	_call_interval = 1000000 / _sample_rate;
-	hrt_cancel(&_call);
-	hrt_call_every(&_call, _call_interval, _call_interval, (hrt_callout)&GYROSIM::measure_trampoline, this);
+	stop();
+	start();
 }
 
 ssize_t
@@ -1030,8 +1034,17 @@ GYROSIM::start()
 	_accel_reports->flush();
 	_gyro_reports->flush();
 
-	/* start polling at the specified rate */
-	if (_call_interval > 0) {
+	if (_call_interval == 0) {
+		return;
+	}
+
+	/* measure when the simulator has fresh data, else poll at the specified rate */
+	Simulator *sim = Simulator::getInstance();
+
+	if (sim != nullptr && sim->addNotify(Simulator::SIM_GYRO, &GYROSIM::measure_trampoline, this, _call_interval)) {
+		_sim_notify = true;
+
+	} else {
 		hrt_call_every(&_call, _call_interval, _call_interval, (hrt_callout)&GYROSIM::measure_trampoline, this);
 	}
 }
@@ -1040,6 +1053,11 @@ void
 GYROSIM::stop()
 {
 	hrt_cancel(&_call);
+
+	if (_sim_notify) {
+		Simulator::getInstance()->removeNotify(Simulator::SIM_GYRO, &GYROSIM::measure_trampoline, this);
+		_sim_notify = false;
+	}
 }
 
 void
@@ -1277,7 +1295,7 @@ GYROSIM_gyro::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 namespace gyrosim
 {
 
-GYROSIM	*g_dev_sim; // on simulated bus
+px4::VehicleInstance<GYROSIM> g_dev_sim; // on simulated bus
 
 int	start(enum Rotation);
 int	stop();
@@ -1297,7 +1315,7 @@ int
 start(enum Rotation rotation)
 {
 	int fd;
-	GYROSIM **g_dev_ptr = &g_dev_sim;
+	GYROSIM **g_dev_ptr = &g_dev_sim.instance();
 	const char *path_accel = MPU_DEVICE_PATH_ACCEL;
 	const char *path_gyro  = MPU_DEVICE_PATH_GYRO;
 
@@ -1346,7 +1364,7 @@ fail:
 int
 stop()
 {
-	GYROSIM **g_dev_ptr = &g_dev_sim;
+	GYROSIM **g_dev_ptr = &g_dev_sim.instance();
 
 	if (*g_dev_ptr != nullptr) {
 		delete *g_dev_ptr;
@@ -1487,7 +1505,7 @@ reset_fail:
 int
 info()
 {
-	GYROSIM **g_dev_ptr = &g_dev_sim;
+	GYROSIM **g_dev_ptr = &g_dev_sim.instance();
 
 	if (*g_dev_ptr == nullptr) {
 		PX4_ERR("driver not running");
@@ -1506,7 +1524,7 @@ info()
 int
 regdump()
 {
-	GYROSIM **g_dev_ptr = &g_dev_sim;
+	GYROSIM **g_dev_ptr = &g_dev_sim.instance();
 
 	if (*g_dev_ptr == nullptr) {
 		PX4_ERR("driver not running");
@@ -88,6 +88,7 @@
 
 #include <px4_config.h>
 #include <px4_posix.h>
+#include <px4_vehicle.h>
 
 #include <drivers/device/device.h>
 #include <drivers/drv_tone_alarm.h>
@@ -750,7 +751,7 @@ ToneAlarm::write(device::file_t *filp, const char *buffer, size_t len)
 namespace
 {
 
-ToneAlarm	*g_dev;
+px4::VehicleInstance<ToneAlarm> g_dev;
 
 int
 play_tune(unsigned tune)
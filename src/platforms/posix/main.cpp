@@ -43,6 +43,9 @@
 #include <sstream>
 #include <vector>
 #include <signal.h>
+#include <stdlib.h>
+
+#include <px4_vehicle.h>
 
 namespace px4
 {
@@ -109,6 +112,21 @@ static void run_cmd(const vector<string> &appargs, bool exit_on_fail)
 	} else if (command.compare("help") == 0) {
 		list_builtins();
 
+	} else if (command.compare("vehicle") == 0) {
+		// commands which follow start and talk to the modules of this vehicle
+		if (appargs.size() > 1 && appargs[1] != "") {
+			int vehicle = atoi(appargs[1].c_str());
+
+			if (vehicle < 0 || vehicle >= PX4_MAX_VEHICLES) {
+				cout << "vehicle must be 0 to " << PX4_MAX_VEHICLES - 1 << endl;
+
+			} else {
+				px4_vehicle_set(vehicle);
+			}
+		}
+
+		cout << "vehicle " << px4_vehicle_id() << endl;
+
 	} else if (command.length() == 0) {
 		// Do nothing
 
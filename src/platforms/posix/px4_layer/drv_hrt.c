@@ -39,6 +39,7 @@
 
 #include <px4_time.h>
 #include <px4_workqueue.h>
+#include <px4_vehicle.h>
 #include <drivers/drv_hrt.h>
 #include <semaphore.h>
 #include <time.h>
@@ -128,6 +129,10 @@ hrt_abstime hrt_absolute_time(void)
 {
 	struct timespec ts;
 
+	if (hrt_simulated_time_enabled()) {
+		return hrt_simulated_time();
+	}
+
 	if (!px4_timestart) {
 		px4_clock_gettime(CLOCK_MONOTONIC, &ts);
 		px4_timestart = ts_to_abstime(&ts);
@@ -376,6 +381,7 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 	entry->period = interval;
 	entry->callout = callout;
 	entry->arg = arg;
+	entry->vehicle = px4_vehicle_id();
 
 	hrt_call_enter(entry);
 	hrt_unlock();
@@ -464,6 +470,7 @@ hrt_call_invoke(void)
 			hrt_unlock();
 
 			//PX4_INFO("call %p: %p(%p)", call, call->callout, call->arg);
+			px4_vehicle_set(call->vehicle);
 			call->callout(call->arg);
 
 			hrt_lock();
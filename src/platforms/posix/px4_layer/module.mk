@@ -40,6 +40,7 @@ SRCS		 = 	\
 			px4_posix_tasks.cpp  \
 			lib_crc32.c \
 			drv_hrt.c \
+			px4_sim_time.c \
 			px4_log.c
 
 MAXOPTIMIZATION	 = -Os
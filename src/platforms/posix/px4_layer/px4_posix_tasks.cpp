@@ -49,41 +49,135 @@
 #include <unistd.h>
 #include <string.h>
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <string>
 
+#ifdef __PX4_LINUX
+#include <sys/syscall.h>
+#endif
+
 #include <px4_tasks.h>
 #include <px4_posix.h>
+#include <px4_vehicle.h>
 
 #define MAX_CMD_LEN 100
 
-#define PX4_MAX_TASKS 50
+#define PX4_MAX_TASKS (50 * PX4_MAX_VEHICLES)
+#define PX4_MAX_TASK_SCHED 32
 #define SHELL_TASK_ID (PX4_MAX_TASKS+1)
 
+// stack sizes given to the spawn are what a task needs on NuttX, leave room for libc and 64 bit
+#define PX4_STACK_OVERHEAD (64 * 1024)
+#define PX4_STACK_ADJUSTED(size) ((((size) + PX4_STACK_OVERHEAD) + 4095) & ~4095)
+
+// the unused part of a stack is painted with this, as on NuttX
+#define STACK_PAINT 0xff
+
 pthread_t _shell_task_id = 0;
 
 struct task_entry {
 	pthread_t pid;
+	pid_t tid;
 	std::string name;
+	int vehicle;
+	int affinity;
+	uint8_t *stack_low;
+	uint8_t *stack_top;
 	bool isused;
-	task_entry() : isused(false) {}
+	task_entry() : pid(0), tid(0), vehicle(0), affinity(-1), stack_low(nullptr), stack_top(nullptr), isused(false) {}
 };
 
 static task_entry taskmap[PX4_MAX_TASKS];
 
+// scheduling of tasks by name, set by the startup script
+struct task_sched {
+	std::string name;
+	int cpu;
+	int policy;
+	int priority;
+	task_sched() : cpu(-1), policy(-1), priority(-1) {}
+};
+
+static task_sched taskscheds[PX4_MAX_TASK_SCHED];
+static bool _memory_locked = false;
+
+// guards taskmap and taskscheds
+static pthread_mutex_t task_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 typedef struct {
 	px4_main_t entry;
+	int id;
+	int vehicle;
 	int argc;
 	char *argv[];
 	// strings are allocated after the
 } pthdata_t;
 
+/**
+ * Record the thread of a task and its stack, and prefault the stack by
+ * painting all of it which is not in use yet.
+ */
+static void task_start(int id)
+{
+	uint8_t *low = nullptr;
+	uint8_t *top = nullptr;
+	pid_t tid = 0;
+
+	// thread name for the trace, gdb and top -H, the entry is set up before the thread is created
+	std::string name = taskmap[id].name.substr(0, 15);
+
+#if defined(__PX4_LINUX)
+	tid = syscall(SYS_gettid);
+	pthread_setname_np(pthread_self(), name.c_str());
+
+	pthread_attr_t attr;
+
+	if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+		void *addr;
+		size_t size;
+		size_t guard = 0;
+		pthread_attr_getstack(&attr, &addr, &size);
+		pthread_attr_getguardsize(&attr, &guard);
+		pthread_attr_destroy(&attr);
+		top = (uint8_t *)addr + size;
+		low = (uint8_t *)addr + guard;
+	}
+
+#elif defined(__PX4_DARWIN)
+	pthread_setname_np(name.c_str());
+
+	top = (uint8_t *)pthread_get_stackaddr_np(pthread_self());
+	low = top - pthread_get_stacksize_np(pthread_self());
+#endif
+
+	if (low != nullptr) {
+		// everything from a bit below this frame down is free
+		volatile uint8_t *p = low;
+		uint8_t *end = (uint8_t *)__builtin_frame_address(0) - 1024;
+
+		while (p < end) {
+			*p++ = STACK_PAINT;
+		}
+	}
+
+	// px4_task_stats() only looks at the stack once it is painted, the spawn has set the pid
+	pthread_mutex_lock(&task_mutex);
+	task_entry &task = taskmap[id];
+	task.tid = tid;
+	task.stack_low = low;
+	task.stack_top = top;
+	pthread_mutex_unlock(&task_mutex);
+}
+
 static void *entry_adapter(void *ptr)
 {
 	pthdata_t *data;
 	data = (pthdata_t *) ptr;
 
+	task_start(data->id);
+	px4_vehicle_set(data->vehicle);
 	data->entry(data->argc, data->argv);
 	free(ptr);
 	PX4_DEBUG("Before px4_task_exit");
@@ -135,6 +229,7 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 	offset = ((unsigned long)taskdata) + structsize;
 
 	taskdata->entry = entry;
+	taskdata->vehicle = px4_vehicle_id();
 	taskdata->argc = argc;
 
 	for (i = 0; i < argc; i++) {
@@ -153,61 +248,105 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 
 	if (rv != 0) {
 		PX4_WARN("px4_task_spawn_cmd: failed to init thread attrs");
+		free(taskdata);
 		return (rv < 0) ? rv : -rv;
 	}
 
-	rv = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_mutex_lock(&task_mutex);
 
-	if (rv != 0) {
-		PX4_WARN("px4_task_spawn_cmd: failed to set inherit sched");
-		return (rv < 0) ? rv : -rv;
+	// scheduling set by the startup script for this task
+	int cpu = -1;
+
+	for (i = 0; i < PX4_MAX_TASK_SCHED; ++i) {
+		if (taskscheds[i].name == name) {
+			scheduler = (taskscheds[i].policy >= 0) ? taskscheds[i].policy : scheduler;
+			priority = (taskscheds[i].priority >= 0) ? taskscheds[i].priority : priority;
+			cpu = taskscheds[i].cpu;
+			break;
+		}
 	}
 
+	// the task gets its entry before it runs, so that it can always find itself
+	for (i = 0; i < PX4_MAX_TASKS; ++i) {
+		if (taskmap[i].isused == false) {
+			taskmap[i] = task_entry();
+			taskmap[i].name = name;
+			taskmap[i].vehicle = px4_vehicle_id();
+			taskmap[i].affinity = cpu;
+			taskmap[i].isused = true;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+	if (i >= PX4_MAX_TASKS) {
+		pthread_attr_destroy(&attr);
+		free(taskdata);
+		return -ENOSPC;
+	}
+
+	taskdata->id = i;
+
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setstacksize(&attr, PX4_STACK_ADJUSTED(stack_size));
+
 	rv = pthread_attr_setschedpolicy(&attr, scheduler);
 
 	if (rv != 0) {
 		PX4_WARN("px4_task_spawn_cmd: failed to set sched policy");
-		return (rv < 0) ? rv : -rv;
 	}
 
-	param.sched_priority = priority;
+	param.sched_priority = (scheduler == SCHED_OTHER) ? 0 : priority;
 
 	rv = pthread_attr_setschedparam(&attr, &param);
 
 	if (rv != 0) {
 		PX4_WARN("px4_task_spawn_cmd: failed to set sched param");
-		return (rv < 0) ? rv : -rv;
 	}
 
-	rv = pthread_create(&task, &attr, &entry_adapter, (void *) taskdata);
+#ifdef __PX4_LINUX
 
-	if (rv != 0) {
+	if (cpu >= 0) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(cpu, &cpuset);
 
-		if (rv == EPERM) {
-			//printf("WARNING: NOT RUNING AS ROOT, UNABLE TO RUN REALTIME THREADS\n");
-			rv = pthread_create(&task, NULL, &entry_adapter, (void *) taskdata);
+		if (pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset) != 0) {
+			PX4_WARN("px4_task_spawn_cmd: failed to pin %s to CPU %d", name, cpu);
+		}
+	}
 
-			if (rv != 0) {
-				PX4_ERR("px4_task_spawn_cmd: failed to create thread %d %d\n", rv, errno);
-				return (rv < 0) ? rv : -rv;
-			}
+#endif
 
-		} else {
-			return (rv < 0) ? rv : -rv;
-		}
+	// the new thread waits in task_start() until its thread is recorded here, so that it can be
+	// deleted or killed as soon as the spawn returns, and can not exit before
+	pthread_mutex_lock(&task_mutex);
+
+	rv = pthread_create(&task, &attr, &entry_adapter, (void *) taskdata);
+
+	if (rv == EPERM) {
+		//printf("WARNING: NOT RUNING AS ROOT, UNABLE TO RUN REALTIME THREADS\n");
+		// keep the stack and affinity, only the real-time scheduling is not allowed
+		pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+		rv = pthread_create(&task, &attr, &entry_adapter, (void *) taskdata);
 	}
 
-	for (i = 0; i < PX4_MAX_TASKS; ++i) {
-		if (taskmap[i].isused == false) {
-			taskmap[i].pid = task;
-			taskmap[i].name = name;
-			taskmap[i].isused = true;
-			break;
-		}
+	if (rv == 0) {
+		taskmap[i].pid = task;
+
+	} else {
+		taskmap[i].isused = false;
 	}
 
-	if (i >= PX4_MAX_TASKS) {
-		return -ENOSPC;
+	pthread_mutex_unlock(&task_mutex);
+
+	pthread_attr_destroy(&attr);
+
+	if (rv != 0) {
+		PX4_ERR("px4_task_spawn_cmd: failed to create thread %d %d\n", rv, errno);
+		free(taskdata);
+		return (rv < 0) ? rv : -rv;
 	}
 
 	return i;
@@ -219,24 +358,28 @@ int px4_task_delete(px4_task_t id)
 	pthread_t pid;
 	PX4_DEBUG("Called px4_task_delete");
 
-	if (id < PX4_MAX_TASKS && taskmap[id].isused) {
+	pthread_mutex_lock(&task_mutex);
+
+	// the spawn records the thread before it returns the id
+	if (id >= 0 && id < PX4_MAX_TASKS && taskmap[id].isused && taskmap[id].pid != 0) {
 		pid = taskmap[id].pid;
+		taskmap[id].isused = false;
 
 	} else {
+		pthread_mutex_unlock(&task_mutex);
 		return -EINVAL;
 	}
 
+	pthread_mutex_unlock(&task_mutex);
+
 	// If current thread then exit, otherwise cancel
 	if (pthread_self() == pid) {
-		taskmap[id].isused = false;
 		pthread_exit(0);
 
 	} else {
 		rv = pthread_cancel(pid);
 	}
 
-	taskmap[id].isused = false;
-
 	return rv;
 }
 
@@ -246,13 +389,17 @@ void px4_task_exit(int ret)
 	pthread_t pid = pthread_self();
 
 	// Get pthread ID from the opaque ID
+	pthread_mutex_lock(&task_mutex);
+
 	for (i = 0; i < PX4_MAX_TASKS; ++i) {
-		if (taskmap[i].pid == pid) {
+		if (taskmap[i].isused && taskmap[i].pid == pid) {
 			taskmap[i].isused = false;
 			break;
 		}
 	}
 
+	pthread_mutex_unlock(&task_mutex);
+
 	if (i >= PX4_MAX_TASKS)  {
 		PX4_ERR("px4_task_exit: self task not found!");
 
@@ -269,13 +416,18 @@ int px4_task_kill(px4_task_t id, int sig)
 	pthread_t pid;
 	PX4_DEBUG("Called px4_task_kill %d", sig);
 
-	if (id < PX4_MAX_TASKS && taskmap[id].isused && taskmap[id].pid != 0) {
+	pthread_mutex_lock(&task_mutex);
+
+	if (id >= 0 && id < PX4_MAX_TASKS && taskmap[id].isused && taskmap[id].pid != 0) {
 		pid = taskmap[id].pid;
 
 	} else {
+		pthread_mutex_unlock(&task_mutex);
 		return -EINVAL;
 	}
 
+	pthread_mutex_unlock(&task_mutex);
+
 	// If current thread then exit, otherwise cancel
 	rv = pthread_kill(pid, sig);
 
@@ -291,7 +443,12 @@ void px4_show_tasks()
 
 	for (idx = 0; idx < PX4_MAX_TASKS; idx++) {
 		if (taskmap[idx].isused) {
+#if PX4_MAX_VEHICLES > 1
+			PX4_INFO("   %-10s %lu vehicle %d", taskmap[idx].name.c_str(), (unsigned long)taskmap[idx].pid,
+				 taskmap[idx].vehicle);
+#else
 			PX4_INFO("   %-10s %lu", taskmap[idx].name.c_str(), (unsigned long)taskmap[idx].pid);
+#endif
 			count++;
 		}
 	}
@@ -314,8 +471,263 @@ bool px4_task_is_running(const char *taskname)
 
 	return false;
 }
+
+static void apply_sched(task_entry &task, int cpu, int policy, int priority)
+{
+	if (policy >= 0 || priority >= 0) {
+		int current_policy;
+		struct sched_param param;
+		pthread_getschedparam(task.pid, &current_policy, &param);
+
+		current_policy = (policy >= 0) ? policy : current_policy;
+		param.sched_priority = (current_policy == SCHED_OTHER) ? 0 : ((priority >= 0) ? priority : param.sched_priority);
+
+		if (pthread_setschedparam(task.pid, current_policy, &param) != 0) {
+			PX4_WARN("failed to set the scheduling of %s", task.name.c_str());
+		}
+	}
+
+#ifdef __PX4_LINUX
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+
+	if (cpu >= 0) {
+		CPU_SET(cpu, &cpuset);
+
+	} else if (task.affinity >= 0) {
+		// unpin, back to the CPUs of the process
+		sched_getaffinity(0, sizeof(cpuset), &cpuset);
+
+	} else {
+		return;
+	}
+
+	if (pthread_setaffinity_np(task.pid, sizeof(cpuset), &cpuset) != 0) {
+		PX4_WARN("failed to pin %s to CPU %d", task.name.c_str(), cpu);
+		return;
+	}
+
+	task.affinity = cpu;
+#endif
+}
+
+int px4_task_set_sched(const char *name, int cpu, int policy, int priority)
+{
+	int i;
+
+#ifdef __PX4_LINUX
+
+	if (cpu >= CPU_SETSIZE) {
+		return -EINVAL;
+	}
+
+#else
+
+	if (cpu >= 0) {
+		PX4_WARN("pinning tasks to a CPU is not supported");
+	}
+
+#endif
+
+	pthread_mutex_lock(&task_mutex);
+
+	// the entry of this name, else a free one
+	for (i = 0; i < PX4_MAX_TASK_SCHED; ++i) {
+		if (taskscheds[i].name == name) {
+			break;
+		}
+	}
+
+	if (i >= PX4_MAX_TASK_SCHED) {
+		for (i = 0; i < PX4_MAX_TASK_SCHED; ++i) {
+			if (taskscheds[i].name.empty()) {
+				break;
+			}
+		}
+	}
+
+	if (i >= PX4_MAX_TASK_SCHED) {
+		pthread_mutex_unlock(&task_mutex);
+		return -ENOSPC;
+	}
+
+	taskscheds[i].name = name;
+	taskscheds[i].cpu = cpu;
+	taskscheds[i].policy = policy;
+	taskscheds[i].priority = priority;
+
+	for (i = 0; i < PX4_MAX_TASKS; ++i) {
+		if (taskmap[i].isused && taskmap[i].pid != 0 && taskmap[i].name == name) {
+			apply_sched(taskmap[i], cpu, policy, priority);
+		}
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+	return 0;
+}
+
+int px4_task_lock_memory()
+{
+	// the stacks of tasks are prefaulted when they start, the heap and the rest are faulted in here
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+		PX4_WARN("failed to lock memory: %s", strerror(errno));
+		return -errno;
+	}
+
+	_memory_locked = true;
+	return 0;
+}
+
+static const char *policy_name(int policy)
+{
+	switch (policy) {
+	case SCHED_FIFO:
+		return "fifo";
+
+	case SCHED_RR:
+		return "rr";
+
+	case SCHED_OTHER:
+		return "other";
+
+	default:
+		return "-";
+	}
+}
+
+void px4_show_task_sched()
+{
+	PX4_INFO("Memory %slocked", _memory_locked ? "" : "not ");
+
+	for (int i = 0; i < PX4_MAX_TASK_SCHED; ++i) {
+		if (!taskscheds[i].name.empty()) {
+			PX4_INFO("   %-20s cpu %2d policy %-5s priority %d", taskscheds[i].name.c_str(), taskscheds[i].cpu,
+				 policy_name(taskscheds[i].policy), taskscheds[i].priority);
+		}
+	}
+}
+
+#ifdef __PX4_LINUX
+/* last CPU and context switches of a thread from procfs */
+static void read_proc_stats(pid_t tid, px4_task_stats_t *stats)
+{
+	char path[64];
+	char buf[512];
+
+	snprintf(path, sizeof(path), "/proc/self/task/%d/stat", (int)tid);
+	FILE *f = fopen(path, "r");
+
+	if (f != nullptr) {
+		if (fgets(buf, sizeof(buf), f) != nullptr) {
+			// the CPU is field 39, counted from the end of the name in field 2
+			char *p = strrchr(buf, ')');
+
+			for (int field = 2; p != nullptr && field < 39; field++) {
+				p = strchr(p + 1, ' ');
+			}
+
+			if (p != nullptr) {
+				stats->cpu = atoi(p + 1);
+			}
+		}
+
+		fclose(f);
+	}
+
+	snprintf(path, sizeof(path), "/proc/self/task/%d/status", (int)tid);
+	f = fopen(path, "r");
+
+	if (f != nullptr) {
+		while (fgets(buf, sizeof(buf), f) != nullptr) {
+			sscanf(buf, "voluntary_ctxt_switches: %lu", &stats->ctx_voluntary);
+			sscanf(buf, "nonvoluntary_ctxt_switches: %lu", &stats->ctx_involuntary);
+		}
+
+		fclose(f);
+	}
+}
+#endif
+
+int px4_task_stats(px4_task_stats_t *stats, int max_count)
+{
+	int count = 0;
+
+	pthread_mutex_lock(&task_mutex);
+
+	for (int i = 0; i < PX4_MAX_TASKS && count < max_count; ++i) {
+		task_entry &task = taskmap[i];
+
+		if (!task.isused || task.pid == 0) {
+			continue;
+		}
+
+		px4_task_stats_t *s = &stats[count++];
+		memset(s, 0, sizeof(*s));
+		s->id = i;
+		strncpy(s->name, task.name.c_str(), sizeof(s->name) - 1);
+		s->vehicle = task.vehicle;
+		s->affinity = task.affinity;
+		s->cpu = -1;
+
+		struct sched_param param;
+
+		if (pthread_getschedparam(task.pid, &s->policy, &param) == 0) {
+			s->priority = param.sched_priority;
+		}
+
+#ifdef __PX4_LINUX
+		clockid_t clock;
+		struct timespec ts;
+
+		if (pthread_getcpuclockid(task.pid, &clock) == 0 && clock_gettime(clock, &ts) == 0) {
+			s->cpu_time = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+		}
+
+		if (task.tid != 0) {
+			read_proc_stats(task.tid, s);
+		}
+
+#endif
+
+		// the deepest use is where the paint is gone
+		if (task.stack_low != nullptr) {
+			const uint8_t *p = task.stack_low;
+
+			while (p < task.stack_top && *p == STACK_PAINT) {
+				p++;
+			}
+
+			s->stack_size = task.stack_top - task.stack_low;
+			s->stack_used = task.stack_top - p;
+		}
+	}
+
+	pthread_mutex_unlock(&task_mutex);
+
+	return count;
+}
+
 __BEGIN_DECLS
 
+#if PX4_MAX_VEHICLES > 1
+
+static __thread int _vehicle_id = 0;
+
+int px4_vehicle_id()
+{
+	return _vehicle_id;
+}
+
+void px4_vehicle_set(int vehicle)
+{
+	if (vehicle >= 0 && vehicle < PX4_MAX_VEHICLES) {
+		_vehicle_id = vehicle;
+	}
+}
+
+#endif
+
 unsigned long px4_getpid()
 {
 	return (unsigned long)pthread_self();
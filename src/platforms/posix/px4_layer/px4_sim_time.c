@@ -0,0 +1,375 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2012, 2013 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file px4_sim_time.c
+ *
+ * Simulated time for SITL.
+ *
+ * Once started, hrt_absolute_time() returns the simulated time, which only
+ * advances when the simulation says so. Threads waiting for a time in the
+ * HRT clock, or in px4_poll(), are kept in a list of waiters and woken by the
+ * time update or the event they wait for.
+ *
+ * A woken thread counts as busy until it waits again, so the task advancing
+ * the clock can wait for the work of each step to be done before it takes
+ * the next one, see hrt_wait_sleepers().
+ */
+
+#include <px4_time.h>
+#include <px4_posix.h>
+#include <drivers/drv_hrt.h>
+#include <pthread.h>
+#include <errno.h>
+#include <unistd.h>
+
+/*
+ * simulated time, only advanced by hrt_advance_simulated_time() once started
+ *
+ * Both are written with px4_sim_lock held and read without it, with atomic stores and loads so a
+ * 64 bit time does not tear on 32 bit hosts. Reads with the lock held need no atomics.
+ */
+static bool px4_sim_time_enabled = false;
+static hrt_abstime px4_sim_time = 0;
+
+/* a thread waiting in simulated time */
+struct px4_sim_waiter {
+	hrt_abstime deadline;
+	px4_sem_t *sem;			/**< posted on wakeup, NULL for hrt_sleep_until() */
+	bool woken;
+	bool interrupted;		/**< woken by hrt_wake_sleepers() */
+	unsigned generation;		/**< busy generation the wakeup was counted in */
+	struct px4_sim_waiter *next;
+};
+
+/* waiters and wakeups are protected by px4_sim_lock, hrt_sleep_until() waits for px4_sim_cond */
+static pthread_mutex_t px4_sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t px4_sim_cond = PTHREAD_COND_INITIALIZER;
+static struct px4_sim_waiter *px4_sim_waiters = NULL;
+
+/* threads woken and not waiting again yet, counted per generation, signalled by px4_sim_idle */
+static pthread_cond_t px4_sim_idle = PTHREAD_COND_INITIALIZER;
+static unsigned px4_sim_busy = 0;
+static unsigned px4_sim_generation = 1;
+
+/* generation in which the calling thread was woken, 0 if it is not counted as busy */
+static __thread unsigned px4_sim_thread_busy = 0;
+
+/* count the wakeup of a waiter, with px4_sim_lock held */
+static void wake(struct px4_sim_waiter *waiter, bool interrupted)
+{
+	if (waiter->woken) {
+		return;
+	}
+
+	waiter->woken = true;
+	waiter->interrupted = interrupted;
+	waiter->generation = px4_sim_generation;
+	px4_sim_busy++;
+
+	if (waiter->sem != NULL) {
+		px4_sem_post(waiter->sem);
+	}
+}
+
+/* wake the waiters whose deadline has passed, with px4_sim_lock held */
+static void wake_due(void)
+{
+	for (struct px4_sim_waiter *waiter = px4_sim_waiters; waiter != NULL; waiter = waiter->next) {
+		if (waiter->deadline <= px4_sim_time) {
+			wake(waiter, false);
+		}
+	}
+
+	pthread_cond_broadcast(&px4_sim_cond);
+}
+
+/* the calling thread starts waiting, with px4_sim_lock held */
+static void wait_begin(struct px4_sim_waiter *waiter, hrt_abstime deadline, px4_sem_t *sem)
+{
+	if (px4_sim_thread_busy == px4_sim_generation && --px4_sim_busy == 0) {
+		pthread_cond_broadcast(&px4_sim_idle);
+	}
+
+	px4_sim_thread_busy = 0;
+
+	waiter->deadline = deadline;
+	waiter->sem = sem;
+	waiter->woken = false;
+	waiter->interrupted = false;
+	waiter->generation = 0;
+	waiter->next = px4_sim_waiters;
+	px4_sim_waiters = waiter;
+}
+
+/* the calling thread is done waiting, with px4_sim_lock held */
+static void wait_end(struct px4_sim_waiter *waiter)
+{
+	for (struct px4_sim_waiter **w = &px4_sim_waiters; *w != NULL; w = &(*w)->next) {
+		if (*w == waiter) {
+			*w = waiter->next;
+			break;
+		}
+	}
+
+	/* busy until it waits again */
+	if (waiter->woken) {
+		px4_sim_thread_busy = waiter->generation;
+	}
+}
+
+/*
+ * Switch to simulated time, continuing from the current time.
+ */
+void hrt_start_simulated_time(void)
+{
+	pthread_mutex_lock(&px4_sim_lock);
+
+	if (!px4_sim_time_enabled) {
+		__atomic_store_n(&px4_sim_time, hrt_absolute_time(), __ATOMIC_RELEASE);
+		__atomic_store_n(&px4_sim_time_enabled, true, __ATOMIC_RELEASE);
+	}
+
+	pthread_mutex_unlock(&px4_sim_lock);
+}
+
+/*
+ * Advance the simulated time.
+ */
+void hrt_advance_simulated_time(hrt_abstime delta)
+{
+	pthread_mutex_lock(&px4_sim_lock);
+
+	if (px4_sim_time_enabled) {
+		__atomic_store_n(&px4_sim_time, px4_sim_time + delta, __ATOMIC_RELEASE);
+		wake_due();
+	}
+
+	pthread_mutex_unlock(&px4_sim_lock);
+}
+
+/*
+ * Set the simulated time, ignoring steps back.
+ */
+void hrt_set_simulated_time(hrt_abstime now)
+{
+	pthread_mutex_lock(&px4_sim_lock);
+
+	if (px4_sim_time_enabled && now > px4_sim_time) {
+		__atomic_store_n(&px4_sim_time, now, __ATOMIC_RELEASE);
+		wake_due();
+	}
+
+	pthread_mutex_unlock(&px4_sim_lock);
+}
+
+bool hrt_simulated_time_enabled(void)
+{
+	return __atomic_load_n(&px4_sim_time_enabled, __ATOMIC_ACQUIRE);
+}
+
+hrt_abstime hrt_simulated_time(void)
+{
+	return __atomic_load_n(&px4_sim_time, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Sleep until deadline, in simulated time until woken by a time update or hrt_wake_sleepers().
+ */
+int hrt_sleep_until(hrt_abstime deadline)
+{
+	if (!hrt_simulated_time_enabled()) {
+		hrt_abstime now = hrt_absolute_time();
+		return (deadline > now) ? usleep(deadline - now) : 0;
+	}
+
+	struct px4_sim_waiter waiter;
+	int ret = 0;
+
+	pthread_mutex_lock(&px4_sim_lock);
+
+	if (px4_sim_time < deadline) {
+		wait_begin(&waiter, deadline, NULL);
+
+		while (!waiter.woken) {
+			pthread_cond_wait(&px4_sim_cond, &px4_sim_lock);
+		}
+
+		wait_end(&waiter);
+		ret = waiter.interrupted ? -1 : 0;
+	}
+
+	pthread_mutex_unlock(&px4_sim_lock);
+
+	return ret;
+}
+
+void hrt_wake_sleepers(void)
+{
+	if (hrt_simulated_time_enabled()) {
+		pthread_mutex_lock(&px4_sim_lock);
+
+		for (struct px4_sim_waiter *waiter = px4_sim_waiters; waiter != NULL; waiter = waiter->next) {
+			if (waiter->sem == NULL) {
+				wake(waiter, true);
+			}
+		}
+
+		pthread_cond_broadcast(&px4_sim_cond);
+		pthread_mutex_unlock(&px4_sim_lock);
+	}
+}
+
+/*
+ * Wait for the busy threads to wait again, in wall clock time.
+ */
+int hrt_wait_sleepers(unsigned timeout_us)
+{
+	if (!hrt_simulated_time_enabled()) {
+		return 0;
+	}
+
+	struct timespec abstime;
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_sec += timeout_us / 1000000;
+	abstime.tv_nsec += (timeout_us % 1000000) * 1000;
+
+	if (abstime.tv_nsec >= 1000000000) {
+		abstime.tv_sec++;
+		abstime.tv_nsec -= 1000000000;
+	}
+
+	int ret = 0;
+
+	pthread_mutex_lock(&px4_sim_lock);
+
+	/* the caller itself does not wait */
+	if (px4_sim_thread_busy == px4_sim_generation) {
+		px4_sim_busy--;
+	}
+
+	px4_sim_thread_busy = 0;
+
+	while (px4_sim_busy > 0) {
+		if (pthread_cond_timedwait(&px4_sim_idle, &px4_sim_lock, &abstime) == ETIMEDOUT) {
+			/* forget the threads which did not make it, e.g. blocked in a wall clock wait */
+			px4_sim_generation++;
+			px4_sim_busy = 0;
+			ret = -1;
+		}
+	}
+
+	pthread_mutex_unlock(&px4_sim_lock);
+
+	return ret;
+}
+
+/*
+ * Wait for a semaphore posted with px4_sim_sem_post() or until deadline in simulated time.
+ */
+int px4_sim_sem_wait(px4_sem_t *sem, hrt_abstime deadline)
+{
+	struct px4_sim_waiter waiter;
+
+	pthread_mutex_lock(&px4_sim_lock);
+	wait_begin(&waiter, deadline, sem);
+
+	if (px4_sim_time >= deadline) {
+		wake(&waiter, false);
+	}
+
+	pthread_mutex_unlock(&px4_sim_lock);
+
+	px4_sem_wait(sem);
+
+	pthread_mutex_lock(&px4_sim_lock);
+	wait_end(&waiter);
+	pthread_mutex_unlock(&px4_sim_lock);
+
+	return 0;
+}
+
+/*
+ * Post a semaphore, counting the wakeup of a thread in px4_sim_sem_wait().
+ */
+int px4_sim_sem_post(px4_sem_t *sem)
+{
+	if (hrt_simulated_time_enabled()) {
+		pthread_mutex_lock(&px4_sim_lock);
+
+		for (struct px4_sim_waiter *waiter = px4_sim_waiters; waiter != NULL; waiter = waiter->next) {
+			if (waiter->sem == sem) {
+				/* posts the semaphore */
+				wake(waiter, false);
+				pthread_mutex_unlock(&px4_sim_lock);
+				return 0;
+			}
+		}
+
+		pthread_mutex_unlock(&px4_sim_lock);
+	}
+
+	return px4_sem_post(sem);
+}
+
+/*
+ * Sleep in HRT time, which is simulated time once started.
+ */
+int px4_usleep(unsigned int usec)
+{
+	if (!hrt_simulated_time_enabled()) {
+		return usleep(usec);
+	}
+
+	hrt_abstime deadline = hrt_absolute_time() + usec;
+
+	/* unlike usleep() not interrupted by wakeups of the work queues */
+	while (hrt_sleep_until(deadline) != 0) {
+	}
+
+	return 0;
+}
+
+unsigned int px4_sleep(unsigned int seconds)
+{
+	if (!hrt_simulated_time_enabled()) {
+		return sleep(seconds);
+	}
+
+	hrt_abstime deadline = hrt_absolute_time() + (hrt_abstime)seconds * 1000000;
+
+	while (hrt_sleep_until(deadline) != 0) {
+	}
+
+	return 0;
+}
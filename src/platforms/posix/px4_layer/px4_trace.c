@@ -0,0 +1,385 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file px4_trace.c
+ *
+ * Trace rings of the threads and their export in the Chrome trace format.
+ *
+ * A thread takes a ring with its first event and gives it back when it
+ * exits; the next thread reuses the ring, or replaces it when the ring size
+ * was changed meanwhile. Only the owner writes a ring, it
+ * publishes each event by advancing the head. The dump copies a ring and
+ * then drops what the owner may have overwritten meanwhile, like a seqlock.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE	/* pthread_getname_np */
+#endif
+
+#include <px4_trace.h>
+#include <px4_log.h>
+#include <px4_vehicle.h>
+#include <drivers/drv_hrt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** events kept per thread unless px4_trace_start() says otherwise, 128 KiB */
+#define TRACE_DEFAULT_RING_SIZE	4096
+
+/** threads tracing at the same time */
+#define TRACE_MAX_THREADS	(64 * PX4_MAX_VEHICLES)
+
+struct trace_event {
+	hrt_abstime	time;
+	const char	*name;
+	uintptr_t	arg;
+	char		phase;
+	uint8_t		category;
+	uint8_t		vehicle;
+};
+
+struct trace_ring {
+	uint64_t	head;		/**< events written, only advanced by the owner */
+	uint64_t	tail;		/**< first event of the current owner */
+	unsigned	mask;		/**< ring size - 1 */
+	int		used;
+	char		thread_name[16];
+	struct trace_event events[];
+};
+
+int px4_trace_enabled = 0;
+
+static unsigned trace_ring_size = TRACE_DEFAULT_RING_SIZE;
+
+/* taking and giving back a ring */
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct trace_ring *trace_rings[TRACE_MAX_THREADS];
+static pthread_key_t trace_key;
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+
+static __thread struct trace_ring *trace_thread_ring;
+static __thread bool trace_thread_none;
+
+/** events lost by threads beyond TRACE_MAX_THREADS */
+static uint64_t trace_dropped;
+
+static const char *const trace_categories[] = { "perf", "work", "hrt", "orb", "poll", "user" };
+
+static void trace_thread_exit(void *arg)
+{
+	struct trace_ring *ring = (struct trace_ring *)arg;
+	__atomic_store_n(&ring->used, 0, __ATOMIC_RELEASE);
+}
+
+static void trace_init(void)
+{
+	pthread_key_create(&trace_key, trace_thread_exit);
+}
+
+static struct trace_ring *trace_ring_take(void)
+{
+	struct trace_ring *ring = NULL;
+
+	pthread_once(&trace_once, trace_init);
+	pthread_mutex_lock(&trace_lock);
+
+	for (int i = 0; i < TRACE_MAX_THREADS; i++) {
+		if (trace_rings[i] != NULL && __atomic_load_n(&trace_rings[i]->used, __ATOMIC_ACQUIRE)) {
+			continue;
+		}
+
+		if (trace_rings[i] != NULL && trace_rings[i]->mask + 1 == trace_ring_size) {
+			/* the events of the previous owner are not shown under this thread */
+			ring = trace_rings[i];
+			ring->tail = ring->head;
+			break;
+		}
+
+		/* a new ring, or one of another size */
+		ring = (struct trace_ring *)calloc(1, sizeof(struct trace_ring) + trace_ring_size * sizeof(struct trace_event));
+
+		if (ring != NULL) {
+			ring->mask = trace_ring_size - 1;
+			free(trace_rings[i]);
+			trace_rings[i] = ring;
+		}
+
+		break;
+	}
+
+	if (ring != NULL) {
+		ring->used = 1;
+		strcpy(ring->thread_name, "?");
+#if defined(__PX4_LINUX) || defined(__PX4_DARWIN)
+		pthread_getname_np(pthread_self(), ring->thread_name, sizeof(ring->thread_name));
+#endif
+		pthread_setspecific(trace_key, ring);
+	}
+
+	pthread_mutex_unlock(&trace_lock);
+
+	return ring;
+}
+
+void px4_trace_event(char phase, enum px4_trace_category category, const char *name, uintptr_t arg)
+{
+	struct trace_ring *ring = trace_thread_ring;
+
+	if (ring == NULL) {
+		if (trace_thread_none) {
+			__atomic_fetch_add(&trace_dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+
+		ring = trace_thread_ring = trace_ring_take();
+
+		if (ring == NULL) {
+			trace_thread_none = true;
+			return;
+		}
+	}
+
+	uint64_t head = ring->head;
+	struct trace_event *e = &ring->events[head & ring->mask];
+
+	e->time = hrt_absolute_time();
+	e->name = name;
+	e->arg = arg;
+	e->phase = phase;
+	e->category = category;
+	e->vehicle = px4_vehicle_id();
+
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+int px4_trace_start(unsigned ring_size)
+{
+	if (ring_size > 0) {
+		unsigned size = 1;
+
+		while (size < ring_size && size < (1u << 24)) {
+			size <<= 1;
+		}
+
+		pthread_mutex_lock(&trace_lock);
+		trace_ring_size = size;
+		pthread_mutex_unlock(&trace_lock);
+	}
+
+	__atomic_store_n(&px4_trace_enabled, 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+void px4_trace_stop(void)
+{
+	__atomic_store_n(&px4_trace_enabled, 0, __ATOMIC_RELAXED);
+}
+
+void px4_trace_status(void)
+{
+	PX4_INFO("tracing %s, %u events per new thread, %llu events dropped",
+		 px4_trace_enabled ? "on" : "off", trace_ring_size,
+		 (unsigned long long)__atomic_load_n(&trace_dropped, __ATOMIC_RELAXED));
+
+	pthread_mutex_lock(&trace_lock);
+
+	for (int i = 0; i < TRACE_MAX_THREADS; i++) {
+		struct trace_ring *ring = trace_rings[i];
+
+		if (ring == NULL) {
+			break;
+		}
+
+		PX4_INFO("  %-16s %10llu events, %u kept%s", ring->thread_name,
+			 (unsigned long long)(__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - ring->tail),
+			 ring->mask + 1, ring->used ? "" : ", exited");
+	}
+
+	pthread_mutex_unlock(&trace_lock);
+}
+
+static void trace_print_string(FILE *out, const char *s)
+{
+	fputc('"', out);
+
+	for (; *s != '\0'; s++) {
+		if (*s == '"' || *s == '\\') {
+			fputc('\\', out);
+			fputc(*s, out);
+
+		} else if ((unsigned char)*s >= 0x20) {
+			fputc(*s, out);
+		}
+	}
+
+	fputc('"', out);
+}
+
+/**
+ * Write the events of one ring newer than since, leaving out ends without
+ * their begin.
+ */
+static int trace_dump_ring(FILE *out, struct trace_ring *ring, int tid, hrt_abstime since, bool *first)
+{
+	uint64_t size = ring->mask + 1;
+	struct trace_event *copy = (struct trace_event *)malloc(size * sizeof(struct trace_event));
+
+	if (copy == NULL) {
+		return 0;
+	}
+
+	uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	uint64_t tail = ring->tail;
+	uint64_t start = (head > size) ? head - size : 0;
+
+	if (start < tail) {
+		start = tail;
+	}
+
+	for (uint64_t i = start; i < head; i++) {
+		copy[i - start] = ring->events[i & ring->mask];
+	}
+
+	/* the events overwritten while copying, and the one being written now */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	uint64_t now_head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	uint64_t valid = (now_head + 1 > size) ? now_head + 1 - size : 0;
+
+	int count = 0;
+	int depth = 0;
+
+	for (uint64_t i = (valid > start) ? valid : start; i < head; i++) {
+		struct trace_event *e = &copy[i - start];
+
+		if (e->time < since) {
+			continue;
+		}
+
+		if (e->phase == 'E') {
+			if (depth == 0) {
+				continue;
+			}
+
+			depth--;
+
+		} else if (e->phase == 'B') {
+			depth++;
+		}
+
+		fprintf(out, "%s\n{\"name\": ", *first ? "" : ",");
+		trace_print_string(out, e->name != NULL ? e->name : "?");
+		fprintf(out, ", \"cat\": \"%s\", \"ph\": \"%c\", \"ts\": %llu, \"pid\": %d, \"tid\": %d",
+			(e->category <= PX4_TRACE_USER) ? trace_categories[e->category] : "?", e->phase,
+			(unsigned long long)e->time, e->vehicle, tid);
+
+		if (e->phase == 'i') {
+			fprintf(out, ", \"s\": \"t\"");
+		}
+
+		if (e->category == PX4_TRACE_WORK || e->category == PX4_TRACE_HRT) {
+			/* the worker function, for addr2line */
+			fprintf(out, ", \"args\": {\"worker\": \"%p\"}}", (void *)e->arg);
+
+		} else {
+			fprintf(out, ", \"args\": {\"arg\": %llu}}", (unsigned long long)e->arg);
+		}
+
+		*first = false;
+		count++;
+	}
+
+	free(copy);
+
+	return count;
+}
+
+int px4_trace_dump(int fd, unsigned seconds)
+{
+	int out_fd = dup(fd);
+	FILE *out = (out_fd >= 0) ? fdopen(out_fd, "w") : NULL;
+
+	if (out == NULL) {
+		if (out_fd >= 0) {
+			close(out_fd);
+		}
+
+		return -1;
+	}
+
+	hrt_abstime now = hrt_absolute_time();
+	hrt_abstime since = (seconds > 0 && now > seconds * 1000000ULL) ? now - seconds * 1000000ULL : 0;
+	bool first = true;
+	int count = 0;
+
+	fprintf(out, "{\"traceEvents\": [");
+
+	/* no ring is replaced meanwhile */
+	pthread_mutex_lock(&trace_lock);
+
+	for (int i = 0; i < TRACE_MAX_THREADS; i++) {
+		struct trace_ring *ring = trace_rings[i];
+
+		if (ring == NULL) {
+			break;
+		}
+
+		count += trace_dump_ring(out, ring, i + 1, since, &first);
+
+		/* the thread shows up on every vehicle it worked for */
+		for (int vehicle = 0; vehicle < PX4_MAX_VEHICLES; vehicle++) {
+			fprintf(out, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": ",
+				first ? "" : ",", vehicle, i + 1);
+			trace_print_string(out, ring->thread_name);
+			fprintf(out, "}}");
+			first = false;
+		}
+	}
+
+	pthread_mutex_unlock(&trace_lock);
+
+	for (int vehicle = 0; vehicle < PX4_MAX_VEHICLES; vehicle++) {
+		fprintf(out, "%s\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"vehicle %d\"}}",
+			first ? "" : ",", vehicle, vehicle);
+		first = false;
+	}
+
+	fprintf(out, "\n], \"displayTimeUnit\": \"ms\"}\n");
+	fclose(out);
+
+	return count;
+}
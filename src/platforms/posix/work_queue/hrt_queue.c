@@ -47,6 +47,7 @@
 #include <semaphore.h>
 #include <drivers/drv_hrt.h>
 #include <px4_workqueue.h>
+#include <px4_vehicle.h>
 #include "hrt_work.h"
 
 /****************************************************************************
@@ -110,6 +111,7 @@ int hrt_work_queue(struct work_s *work, worker_t worker, void *arg, uint32_t del
 	work->worker = worker;           /* Work callback */
 	work->arg    = arg;              /* Callback argument */
 	work->delay  = delay;            /* Delay until work performed */
+	work->vehicle = px4_vehicle_id(); /* Run it for the vehicle of the caller */
 
 	/* Now, time-tag that entry and put it in the work queue.  This must be
 	 * done with interrupts disabled.  This permits this function to be called
@@ -125,6 +127,7 @@ int hrt_work_queue(struct work_s *work, worker_t worker, void *arg, uint32_t del
 	px4_task_kill(wqueue->pid, SIGALRM);      /* Wake up the worker thread */
 #else
 	px4_task_kill(wqueue->pid, SIGCONT);      /* Wake up the worker thread */
+	hrt_wake_sleepers();                      /* signals do not interrupt simulated time */
 #endif
 
 	hrt_work_unlock();
@@ -47,6 +47,8 @@
 #include <unistd.h>
 #include <queue.h>
 #include <px4_workqueue.h>
+#include <px4_trace.h>
+#include <px4_vehicle.h>
 #include <drivers/drv_hrt.h>
 #include "hrt_work.h"
 
@@ -152,6 +154,7 @@ static void hrt_work_process()
 
 			worker = work->worker;
 			arg    = work->arg;
+			px4_vehicle_set(work->vehicle);
 
 			/* Mark the work as no longer being queued */
 
@@ -168,7 +171,9 @@ static void hrt_work_process()
 				PX4_BACKTRACE();
 
 			} else {
+				px4_trace_begin(PX4_TRACE_HRT, "hrt", (uintptr_t)worker);
 				worker(arg);
+				px4_trace_end(PX4_TRACE_HRT, "hrt", (uintptr_t)worker);
 			}
 
 			/* Now, unfortunately, since we re-enabled interrupts we don't
@@ -208,7 +213,12 @@ static void hrt_work_process()
 
 	/* might sleep less if a signal received and new item was queued */
 	//PX4_INFO("Sleeping for %u usec", next);
+#ifdef __PX4_QURT
 	usleep(next);
+#else
+	/* in HRT time, which may be simulated */
+	hrt_sleep_until(hrt_absolute_time() + next);
+#endif
 }
 
 /****************************************************************************
@@ -46,6 +46,8 @@
 #include <stdio.h>
 #include <semaphore.h>
 #include <px4_workqueue.h>
+#include <px4_vehicle.h>
+#include <drivers/drv_hrt.h>
 #include "work_lock.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -114,6 +116,7 @@ int work_queue(int qid, struct work_s *work, worker_t worker, void *arg, uint32_
 	work->worker = worker;           /* Work callback */
 	work->arg    = arg;              /* Callback argument */
 	work->delay  = delay;            /* Delay until work performed */
+	work->vehicle = px4_vehicle_id(); /* Run it for the vehicle of the caller */
 
 	/* Now, time-tag that entry and put it in the work queue.  This must be
 	 * done with interrupts disabled.  This permits this function to be called
@@ -128,6 +131,7 @@ int work_queue(int qid, struct work_s *work, worker_t worker, void *arg, uint32_
 	px4_task_kill(wqueue->pid, SIGALRM);      /* Wake up the worker thread */
 #else
 	px4_task_kill(wqueue->pid, SIGCONT);      /* Wake up the worker thread */
+	hrt_wake_sleepers();                      /* signals do not interrupt simulated time */
 #endif
 
 	work_unlock(qid);
@@ -46,6 +46,8 @@
 #include <unistd.h>
 #include <queue.h>
 #include <px4_workqueue.h>
+#include <px4_trace.h>
+#include <px4_vehicle.h>
 #include <drivers/drv_hrt.h>
 #include "work_lock.h"
 
@@ -129,6 +131,7 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 
 			worker = work->worker;
 			arg    = work->arg;
+			px4_vehicle_set(work->vehicle);
 
 			/* Mark the work as no longer being queued */
 
@@ -144,7 +147,9 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 				PX4_WARN("MESSED UP: worker = 0\n");
 
 			} else {
+				px4_trace_begin(PX4_TRACE_WORK, "work", (uintptr_t)worker);
 				worker(arg);
+				px4_trace_end(PX4_TRACE_WORK, "work", (uintptr_t)worker);
 			}
 
 			/* Now, unfortunately, since we re-enabled interrupts we don't
@@ -180,7 +185,12 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 	 */
 	work_unlock(lock_id);
 
+#ifdef __PX4_QURT
 	usleep(next);
+#else
+	/* in HRT time, which may be simulated */
+	hrt_sleep_until(hrt_absolute_time() + next);
+#endif
 }
 
 /****************************************************************************
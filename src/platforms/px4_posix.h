@@ -135,6 +135,11 @@ __EXPORT ssize_t	px4_read(int fd, void *buffer, size_t buflen);
 __EXPORT ssize_t	px4_write(int fd, const void *buffer, size_t buflen);
 __EXPORT int		px4_ioctl(int fd, int cmd, unsigned long arg);
 __EXPORT int		px4_poll(px4_pollfd_struct_t *fds, nfds_t nfds, int timeout);
+#ifndef __PX4_QURT
+/* px4_poll() waits in simulated time, see hrt_wait_sleepers() */
+__EXPORT int		px4_sim_sem_wait(px4_sem_t *s, uint64_t deadline);
+__EXPORT int		px4_sim_sem_post(px4_sem_t *s);
+#endif
 __EXPORT int		px4_fsync(int fd);
 __EXPORT int		px4_access(const char *pathname, int mode);
 __EXPORT unsigned long	px4_getpid(void);
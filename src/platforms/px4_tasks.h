@@ -41,6 +41,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #ifdef __PX4_ROS
 
@@ -126,5 +128,48 @@ __EXPORT void px4_show_tasks(void);
 /** See if a task is running **/
 __EXPORT bool px4_task_is_running(const char *taskname);
 
+#ifdef __PX4_POSIX
+
+/**
+ * Scheduling of the tasks with a name, used when they are spawned and applied
+ * right away to the ones already running.
+ *
+ * @param cpu		CPU the task is pinned to, -1 to run on all
+ * @param policy	SCHED_FIFO, SCHED_RR or SCHED_OTHER, -1 for the one of the spawn
+ * @param priority	priority, -1 for the one of the spawn
+ */
+__EXPORT int px4_task_set_sched(const char *name, int cpu, int policy, int priority);
+
+/** Lock all current and future memory of the process, stacks included, in RAM **/
+__EXPORT int px4_task_lock_memory(void);
+
+/** Show the scheduling set with px4_task_set_sched **/
+__EXPORT void px4_show_task_sched(void);
+
+/** Accounting of a running task */
+typedef struct {
+	px4_task_t id;
+	char name[24];
+	int vehicle;
+	int policy;
+	int priority;
+	int cpu;			/**< CPU the task ran on last, -1 if unknown */
+	int affinity;			/**< CPU the task is pinned to, -1 if none */
+	uint64_t cpu_time;		/**< CPU time used in microseconds */
+	unsigned long ctx_voluntary;	/**< context switches when blocking */
+	unsigned long ctx_involuntary;	/**< context switches by preemption */
+	size_t stack_size;
+	size_t stack_used;		/**< deepest use of the stack so far */
+} px4_task_stats_t;
+
+/**
+ * Accounting of the running tasks.
+ *
+ * @return number of tasks filled into stats
+ */
+__EXPORT int px4_task_stats(px4_task_stats_t *stats, int max_count);
+
+#endif
+
 __END_DECLS
 
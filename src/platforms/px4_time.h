@@ -43,3 +43,20 @@ __EXPORT unsigned int sleep(unsigned int sec);
 
 __END_DECLS
 #endif
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+__BEGIN_DECLS
+
+/* like usleep() and sleep(), but following the simulated time if it is enabled */
+__EXPORT int px4_usleep(unsigned int usec);
+__EXPORT unsigned int px4_sleep(unsigned int seconds);
+
+__END_DECLS
+
+#else
+
+#define px4_usleep usleep
+#define px4_sleep sleep
+
+#endif
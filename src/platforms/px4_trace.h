@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file px4_trace.h
+ * Tracing of what runs when, for finding the cause of missed deadlines on
+ * POSIX.
+ *
+ * Every thread writes begin, end and instant events into its own ring
+ * buffer, without locking. px4_trace_dump() writes the last seconds of all
+ * rings in the Chrome trace format (chrome://tracing). Tracing is off until
+ * px4_trace_start() is called, until then an event costs a load and a
+ * branch. On NuttX and QuRT the events compile to nothing.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** What emitted an event */
+enum px4_trace_category {
+	PX4_TRACE_PERF,		/**< perf_begin/perf_end of a PC_ELAPSED or PC_HISTOGRAM counter */
+	PX4_TRACE_WORK,		/**< work queue item */
+	PX4_TRACE_HRT,		/**< HRT callout */
+	PX4_TRACE_ORB,		/**< orb_publish */
+	PX4_TRACE_POLL,		/**< px4_poll wakeup */
+	PX4_TRACE_USER		/**< anything else */
+};
+
+__BEGIN_DECLS
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+extern int px4_trace_enabled;
+
+/**
+ * Write an event into the ring of the calling thread.
+ *
+ * @param phase		'B' begin, 'E' end or 'i' instant
+ * @param name		name of the event, it has to outlive the trace
+ * @param arg		value shown with the event
+ */
+__EXPORT void px4_trace_event(char phase, enum px4_trace_category category, const char *name, uintptr_t arg);
+
+static inline void px4_trace_begin(enum px4_trace_category category, const char *name, uintptr_t arg)
+{
+	if (__atomic_load_n(&px4_trace_enabled, __ATOMIC_RELAXED)) {
+		px4_trace_event('B', category, name, arg);
+	}
+}
+
+static inline void px4_trace_end(enum px4_trace_category category, const char *name, uintptr_t arg)
+{
+	if (__atomic_load_n(&px4_trace_enabled, __ATOMIC_RELAXED)) {
+		px4_trace_event('E', category, name, arg);
+	}
+}
+
+static inline void px4_trace_instant(enum px4_trace_category category, const char *name, uintptr_t arg)
+{
+	if (__atomic_load_n(&px4_trace_enabled, __ATOMIC_RELAXED)) {
+		px4_trace_event('i', category, name, arg);
+	}
+}
+
+/**
+ * Start tracing.
+ *
+ * @param ring_size	events kept per thread, rounded up to a power of two,
+ *			0 for the default. The rings of running threads keep
+ *			their size.
+ */
+__EXPORT int px4_trace_start(unsigned ring_size);
+
+/** Stop tracing, the rings keep their events for px4_trace_dump() */
+__EXPORT void px4_trace_stop(void);
+
+/** Show whether tracing is on and how many events the threads wrote */
+__EXPORT void px4_trace_status(void);
+
+/**
+ * Write the events of the last seconds as Chrome trace JSON.
+ *
+ * @param fd		file descriptor to write to
+ * @param seconds	how far back to go, 0 for all events in the rings
+ * @return		number of events written
+ */
+__EXPORT int px4_trace_dump(int fd, unsigned seconds);
+
+#else
+
+static inline void px4_trace_begin(enum px4_trace_category category, const char *name, uintptr_t arg) {}
+static inline void px4_trace_end(enum px4_trace_category category, const char *name, uintptr_t arg) {}
+static inline void px4_trace_instant(enum px4_trace_category category, const char *name, uintptr_t arg) {}
+
+#endif
+
+__END_DECLS
@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file px4_vehicle.h
+ * Vehicle context of a task, for running several simulated vehicles in one
+ * process on POSIX.
+ *
+ * Every thread works for one vehicle. Tasks inherit the vehicle of the task
+ * which spawned them, work queue items and HRT calls the one of the task
+ * which queued them. Device nodes, uORB topics, parameters and the module
+ * instances held in a px4::VehicleInstance are looked up for the vehicle of
+ * the calling thread.
+ *
+ * This is groundwork only, no SITL config sets PX4_MAX_VEHICLES yet.
+ * commander, navigator, dataman and sdlog2 still keep process wide state,
+ * and muorb only bridges the topics of vehicle 0, so a vehicle other than 0
+ * could not arm or fly a mission. Swarms run a process per vehicle until
+ * these are per vehicle too.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+/** Number of vehicles one process can run, set by the build config */
+#ifndef PX4_MAX_VEHICLES
+#define PX4_MAX_VEHICLES 1
+#endif
+
+__BEGIN_DECLS
+
+#if PX4_MAX_VEHICLES > 1
+
+/** Vehicle of the calling thread, 0 to PX4_MAX_VEHICLES - 1 */
+__EXPORT int px4_vehicle_id(void);
+
+/** Switch the calling thread to another vehicle */
+__EXPORT void px4_vehicle_set(int vehicle);
+
+#else
+
+static inline int px4_vehicle_id(void)
+{
+	return 0;
+}
+
+static inline void px4_vehicle_set(int vehicle)
+{
+	(void)vehicle;
+}
+
+#endif
+
+__END_DECLS
+
+#ifdef __cplusplus
+
+namespace px4
+{
+
+/**
+ * Pointer to the instance of a module, one for each vehicle.
+ *
+ * Replaces the usual singleton pointer of a module, it converts to and is
+ * assigned the instance of the calling thread's vehicle.
+ */
+template <class T>
+class VehicleInstance
+{
+public:
+	constexpr VehicleInstance() : _instance{} {}
+
+	VehicleInstance &operator=(T *instance)
+	{
+		_instance[px4_vehicle_id()] = instance;
+		return *this;
+	}
+
+	operator T *() const { return _instance[px4_vehicle_id()]; }
+
+	T *operator->() const { return _instance[px4_vehicle_id()]; }
+
+	/**
+	 * Instance of the calling thread's vehicle, as a reference.
+	 */
+	T *&instance() { return _instance[px4_vehicle_id()]; }
+
+	/**
+	 * Instance of any vehicle.
+	 */
+	T *instance(int vehicle) const
+	{
+		return (vehicle >= 0 && vehicle < PX4_MAX_VEHICLES) ? _instance[vehicle] : nullptr;
+	}
+
+private:
+	T *_instance[PX4_MAX_VEHICLES];
+
+	/* no copies of the instances */
+	VehicleInstance(const VehicleInstance &);
+	VehicleInstance &operator=(const VehicleInstance &);
+};
+
+}
+
+#endif
@@ -172,3 +172,25 @@ uint64_t	perf_event_count(perf_counter_t handle)
 {
 	return 0;
 }
+
+/**
+ * Return a percentile of the times measured by a PC_HISTOGRAM counter
+ *
+ * @param handle		The counter returned from perf_alloc.
+ * @param percentile		The percentile, e.g. 99.9
+ * @return			the time in microseconds, 0 if there are no events
+ */
+uint64_t	perf_percentile(perf_counter_t handle, float percentile)
+{
+	return 0;
+}
+
+/**
+ * Print all of the performance counters as a JSON document.
+ *
+ * @param fd			File descriptor to print to - e.g. 0 for stdout
+ */
+void		perf_print_all_json(int fd)
+{
+
+}
@@ -73,9 +73,19 @@ int perf_main(int argc, char *argv[])
 			perf_print_latency(0 /* stdout */);
 			fflush(stdout);
 			return 0;
+
+		} else if (strcmp(argv[1], "dump") == 0) {
+			if (argc > 2 && strcmp(argv[2], "--json") == 0) {
+				perf_print_all_json(1 /* stdout */);
+
+			} else {
+				perf_print_all(1 /* stdout */);
+			}
+
+			return 0;
 		}
 
-		printf("Usage: perf [reset | latency]\n");
+		printf("Usage: perf [reset | latency | dump [--json]]\n");
 		return -1;
 	}
 
@@ -146,6 +146,217 @@ fail:
 	return -1;
 }
 
+/* items per second for a number of accesses that took the given time */
+static unsigned
+rate(unsigned count, hrt_abstime start, hrt_abstime end)
+{
+	return (unsigned)((uint64_t)count * 1000000 / (end - start + 1));
+}
+
+/* mission items per range request */
+#define RANGE_BLOCK 16
+
+/* result checks of block wise mission item access */
+static int
+range_checks(void)
+{
+	struct mission_item_s items[8];
+	struct mission_item_s check[8];
+	const unsigned len = sizeof(struct mission_item_s);
+	ssize_t ret;
+
+	dm_clear(DM_KEY_WAYPOINTS_OFFBOARD_1);
+
+	for (unsigned i = 0; i < 8; i++) {
+		memset(&items[i], 0x10 + i, len);
+	}
+
+	if (dm_write_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 10, DM_PERSIST_IN_FLIGHT_RESET, items, 4, len) != 4) {
+		warnx("Range write failed");
+		return -1;
+	}
+
+	/* stops at the empty slot after the written items */
+	memset(check, 0, sizeof(check));
+	ret = dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 10, check, 8, len);
+
+	if (ret != 4 || memcmp(items, check, 4 * len) != 0) {
+		warnx("Range read over an empty slot returned %d", (int)ret);
+		return -1;
+	}
+
+	/* a partial range starting in the middle */
+	ret = dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 12, check, 8, len);
+
+	if (ret != 2 || memcmp(&items[2], check, 2 * len) != 0) {
+		warnx("Partial range read returned %d", (int)ret);
+		return -1;
+	}
+
+	/* nothing to read at an empty slot */
+	ret = dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 20, check, 4, len);
+
+	if (ret != 0) {
+		warnx("Range read of empty slots returned %d", (int)ret);
+		return -1;
+	}
+
+	/* an item stored with another length ends the range, and is not read as one */
+	if (dm_write(DM_KEY_WAYPOINTS_OFFBOARD_1, 12, DM_PERSIST_IN_FLIGHT_RESET, items, len - 1) != (ssize_t)(len - 1)) {
+		warnx("Write of a short item failed");
+		return -1;
+	}
+
+	ret = dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 10, check, 4, len);
+
+	if (ret != 2) {
+		warnx("Range read over a length mismatch returned %d", (int)ret);
+		return -1;
+	}
+
+	ret = dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 12, check, 1, len);
+
+	if (ret != 0) {
+		warnx("Range read of a mismatched length returned %d", (int)ret);
+		return -1;
+	}
+
+	/* out of bounds index and count, and invalid lengths */
+	if (dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, NUM_MISSIONS_SUPPORTED - 2, check, 4, len) >= 0 ||
+	    dm_write_range(DM_KEY_WAYPOINTS_OFFBOARD_1, NUM_MISSIONS_SUPPORTED - 2, DM_PERSIST_IN_FLIGHT_RESET, items, 4,
+			   len) >= 0 ||
+	    dm_read_range(DM_KEY_SAFE_POINTS, DM_KEY_SAFE_POINTS_MAX, check, 1, len) >= 0 ||
+	    dm_read_range(DM_KEY_NUM_KEYS, 0, check, 1, len) >= 0 ||
+	    dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 10, check, 4, 0) >= 0 ||
+	    dm_write_range(DM_KEY_WAYPOINTS_OFFBOARD_1, 10, DM_PERSIST_IN_FLIGHT_RESET, items, 1, DM_MAX_DATA_SIZE + 1) >= 0) {
+		warnx("Out of bounds range access not rejected");
+		return -1;
+	}
+
+	/* the last slots are still in range */
+	if (dm_write_range(DM_KEY_WAYPOINTS_OFFBOARD_1, NUM_MISSIONS_SUPPORTED - 2, DM_PERSIST_IN_FLIGHT_RESET, items, 2,
+			   len) != 2 ||
+	    dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, NUM_MISSIONS_SUPPORTED - 2, check, 2, len) != 2 ||
+	    memcmp(items, check, 2 * len) != 0) {
+		warnx("Range access of the last slots failed");
+		return -1;
+	}
+
+	dm_clear(DM_KEY_WAYPOINTS_OFFBOARD_1);
+	return 0;
+}
+
+/* throughput of block wise mission item access */
+static int
+range_throughput(void)
+{
+	static struct mission_item_s items[RANGE_BLOCK];
+	static struct mission_item_s expected[RANGE_BLOCK];
+	const unsigned len = sizeof(struct mission_item_s);
+	const unsigned rounds = 8;
+	const unsigned count = rounds * NUM_MISSIONS_SUPPORTED;
+	hrt_abstime t0, t1, t2;
+
+	t0 = hrt_absolute_time();
+
+	for (unsigned r = 0; r < rounds; r++) {
+		for (unsigned i = 0; i < NUM_MISSIONS_SUPPORTED; i += RANGE_BLOCK) {
+			memset(items, i / RANGE_BLOCK, sizeof(items));
+
+			if (dm_write_range(DM_KEY_WAYPOINTS_OFFBOARD_1, i, DM_PERSIST_IN_FLIGHT_RESET, items, RANGE_BLOCK,
+					   len) != RANGE_BLOCK) {
+				warnx("Throughput range write failed");
+				return -1;
+			}
+		}
+	}
+
+	t1 = hrt_absolute_time();
+
+	for (unsigned r = 0; r < rounds; r++) {
+		for (unsigned i = 0; i < NUM_MISSIONS_SUPPORTED; i += RANGE_BLOCK) {
+			memset(expected, i / RANGE_BLOCK, sizeof(expected));
+
+			if (dm_read_range(DM_KEY_WAYPOINTS_OFFBOARD_1, i, items, RANGE_BLOCK, len) != RANGE_BLOCK ||
+			    memcmp(items, expected, sizeof(items)) != 0) {
+				warnx("Throughput range read failed");
+				return -1;
+			}
+		}
+	}
+
+	t2 = hrt_absolute_time();
+
+	warnx("Range of %u: write %u items/s, read %u items/s", RANGE_BLOCK, rate(count, t0, t1), rate(count, t1, t2));
+	return 0;
+}
+
+/* throughput of sequential and random mission item access */
+static int
+throughput(void)
+{
+	char buffer[DM_MAX_DATA_SIZE];
+	const unsigned len = sizeof(struct mission_item_s);
+	const unsigned rounds = 8;
+	const unsigned count = rounds * NUM_MISSIONS_SUPPORTED;
+	hrt_abstime t0, t1, t2, t3, t4;
+
+	memset(buffer, 0x55, sizeof(buffer));
+	srand(1);
+	t0 = hrt_absolute_time();
+
+	for (unsigned r = 0; r < rounds; r++) {
+		for (unsigned i = 0; i < NUM_MISSIONS_SUPPORTED; i++) {
+			if (dm_write(DM_KEY_WAYPOINTS_OFFBOARD_1, i, DM_PERSIST_IN_FLIGHT_RESET, buffer, len) != len) {
+				warnx("Throughput sequential write failed");
+				return -1;
+			}
+		}
+	}
+
+	t1 = hrt_absolute_time();
+
+	for (unsigned r = 0; r < rounds; r++) {
+		for (unsigned i = 0; i < NUM_MISSIONS_SUPPORTED; i++) {
+			if (dm_read(DM_KEY_WAYPOINTS_OFFBOARD_1, i, buffer, sizeof(buffer)) != len) {
+				warnx("Throughput sequential read failed");
+				return -1;
+			}
+		}
+	}
+
+	t2 = hrt_absolute_time();
+
+	for (unsigned k = 0; k < count; k++) {
+		if (dm_write(DM_KEY_WAYPOINTS_OFFBOARD_1, rand() % NUM_MISSIONS_SUPPORTED, DM_PERSIST_IN_FLIGHT_RESET, buffer,
+			     len) != len) {
+			warnx("Throughput random write failed");
+			return -1;
+		}
+	}
+
+	t3 = hrt_absolute_time();
+
+	for (unsigned k = 0; k < count; k++) {
+		if (dm_read(DM_KEY_WAYPOINTS_OFFBOARD_1, rand() % NUM_MISSIONS_SUPPORTED, buffer, sizeof(buffer)) != len) {
+			warnx("Throughput random read failed");
+			return -1;
+		}
+	}
+
+	t4 = hrt_absolute_time();
+
+	warnx("Sequential: write %u items/s, read %u items/s", rate(count, t0, t1), rate(count, t1, t2));
+	warnx("Random: write %u items/s, read %u items/s", rate(count, t2, t3), rate(count, t3, t4));
+
+	if (range_checks() != 0 || range_throughput() != 0) {
+		return -1;
+	}
+
+	dm_clear(DM_KEY_WAYPOINTS_OFFBOARD_1);
+	return 0;
+}
+
 int test_dataman(int argc, char *argv[])
 {
 	int i, num_tasks = 4;
@@ -202,5 +413,5 @@ int test_dataman(int argc, char *argv[])
 		}
 	}
 
-	return 0;
+	return throughput();
 }
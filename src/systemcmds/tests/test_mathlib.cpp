@@ -158,6 +158,138 @@ int test_mathlib(int argc, char *argv[])
 		TEST_OP("Matrix<10, 10> * Matrix<10, 10>", m1 * m2);
 	}
 
+	{
+		Matrix<3, 3> R;
+		R.from_euler(0.1f, 0.2f, 0.3f);
+		Matrix<3, 3> R_sp;
+		R_sp.from_euler(-0.2f, 0.1f, 0.5f);
+		Vector<3> a(1.0f, 2.0f, 3.0f);
+		Vector<3> b(0.5f, -1.0f, 0.2f);
+		Matrix<4, 4> m1;
+		m1.identity();
+		Matrix<4, 4> m2;
+		m2.identity();
+		Vector<4> v1(1.0f, 2.0f, 3.0f, 4.0f);
+		TEST_OP("Matrix<3, 3>' * Vector<3>", R.transposed() * a);
+		TEST_OP("Matrix<3, 3>' * (Vector<3> - Vector<3>)", R.transposed() * (a - b));
+		TEST_OP("Matrix<3, 3>' * Matrix<3, 3>", R.transposed() * R_sp);
+		TEST_OP("Matrix<3, 3> * Matrix<3, 3>'", R * R_sp.transposed());
+		TEST_OP("Matrix<3, 3> = Matrix<3, 3>'", R_sp = R.transposed());
+		TEST_OP("Matrix<4, 4> * Vector<4>", m1 * v1);
+		TEST_OP("Matrix<4, 4>' * Vector<4>", m1.transposed() * v1);
+		TEST_OP("Matrix<4, 4> * Matrix<4, 4>", m1 * m2);
+	}
+
+	{
+		PX4_INFO("Matrix product kernels test");
+		// compare the products of all kernel shapes against plain loops
+
+		float data3[3][3] = {{0.1f, -2.0f, 3.0f}, {4.0f, 0.5f, -6.0f}, {7.0f, 8.0f, 0.9f}};
+		float data4[4][4] = {{1, -2, 3, 4}, {5, 6, -7, 8}, {9, 10, 11, -12}, {-13, 14, 15, 16}};
+		float data34[3][4] = {{1, 2, 3, 4}, {-5, 6, 7, 8}, {9, -10, 11, 12}};
+		Matrix<3, 3> m3(data3);
+		Matrix<4, 4> m4(data4);
+		Matrix<3, 4> m34(data34);
+		Vector<3> v3(1.0f, -2.0f, 0.5f);
+		Vector<4> v4(1.0f, -2.0f, 0.5f, 3.0f);
+
+		Matrix<3, 3> p33 = m3 * m3;
+		Matrix<3, 3> pt33 = m3.transposed() * m3;
+		Matrix<3, 3> ptt33 = m3 * m3.transposed();
+		Matrix<4, 4> p44 = m4 * m4;
+		Matrix<4, 4> pt44 = m4.transposed() * m4;
+		Matrix<3, 4> p34 = m3 * m34;
+		Matrix<4, 4> pt34 = m34.transposed() * m34;
+		Vector<3> pv3 = m3 * v3;
+		Vector<3> ptv3 = m3.transposed() * v3;
+		Vector<4> pv4 = m4 * v4;
+		Vector<4> ptv4 = m4.transposed() * v4;
+		Vector<3> pv34 = m34 * v4;
+		Vector<4> ptv34 = m34.transposed() * v3;
+		Matrix<4, 3> t34 = m34.transposed();
+		float tol = 1e-4f;
+
+		for (unsigned i = 0; i < 4; i++) {
+			float sum3 = 0.0f;
+			float sumt3 = 0.0f;
+			float sum4 = 0.0f;
+			float sumt4 = 0.0f;
+			float sum34 = 0.0f;
+			float sumt34 = 0.0f;
+
+			for (unsigned j = 0; j < 4; j++) {
+				float s33 = 0.0f;
+				float st33 = 0.0f;
+				float stt33 = 0.0f;
+				float s44 = 0.0f;
+				float st44 = 0.0f;
+				float s34 = 0.0f;
+				float st34 = 0.0f;
+
+				for (unsigned k = 0; k < 4; k++) {
+					if (i < 3 && j < 3 && k < 3) {
+						s33 += data3[i][k] * data3[k][j];
+						st33 += data3[k][i] * data3[k][j];
+						stt33 += data3[i][k] * data3[j][k];
+					}
+
+					if (i < 3 && k < 3) {
+						s34 += data3[i][k] * data34[k][j];
+					}
+
+					if (k < 3) {
+						st34 += data34[k][i] * data34[k][j];
+					}
+
+					s44 += data4[i][k] * data4[k][j];
+					st44 += data4[k][i] * data4[k][j];
+				}
+
+				if (i < 3 && j < 3) {
+					sum3 += data3[i][j] * v3(j);
+					sumt3 += data3[j][i] * v3(j);
+
+					if (fabsf(p33(i, j) - s33) > tol || fabsf(pt33(i, j) - st33) > tol ||
+					    fabsf(ptt33(i, j) - stt33) > tol) {
+						PX4_ERR("Matrix<3, 3> product failed at %u, %u", i, j);
+						rc = 1;
+					}
+				}
+
+				if (i < 3) {
+					sum34 += data34[i][j] * v4(j);
+
+					if (fabsf(p34(i, j) - s34) > tol || fabsf(t34(j, i) - data34[i][j]) > tol) {
+						PX4_ERR("Matrix<3, 4> product failed at %u, %u", i, j);
+						rc = 1;
+					}
+				}
+
+				if (j < 3) {
+					sumt34 += data34[j][i] * v3(j);
+				}
+
+				sum4 += data4[i][j] * v4(j);
+				sumt4 += data4[j][i] * v4(j);
+
+				if (fabsf(p44(i, j) - s44) > tol || fabsf(pt44(i, j) - st44) > tol || fabsf(pt34(i, j) - st34) > tol) {
+					PX4_ERR("Matrix<4, 4> product failed at %u, %u", i, j);
+					rc = 1;
+				}
+			}
+
+			if (i < 3 && (fabsf(pv3(i) - sum3) > tol || fabsf(ptv3(i) - sumt3) > tol || fabsf(pv34(i) - sum34) > tol)) {
+				PX4_ERR("Matrix<3, N> * Vector failed at %u", i);
+				rc = 1;
+			}
+
+			if (fabsf(pv4(i) - sum4) > tol || fabsf(ptv4(i) - sumt4) > tol || fabsf(ptv34(i) - sumt34) > tol) {
+				PX4_ERR("Matrix<4, N> * Vector failed at %u", i);
+				rc = 1;
+			}
+		}
+	}
+
 	{
 		PX4_INFO("Nonsymmetric matrix operations test");
 		// test nonsymmetric +, -, +=, -=
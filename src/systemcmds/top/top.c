@@ -40,6 +40,8 @@
  */
 
 #include <px4_config.h>
+#include <px4_defines.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <fcntl.h>
 #include <stdbool.h>
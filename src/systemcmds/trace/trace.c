@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2015 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file trace.c
+ *
+ * Control of the trace rings and their export for chrome://tracing, POSIX
+ * only.
+ */
+
+#include <px4_config.h>
+#include <px4_log.h>
+#include <px4_trace.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+__EXPORT int trace_main(int argc, char *argv[]);
+
+static void usage(void)
+{
+	PX4_INFO("usage: trace {start [-n <events per thread>] | stop | status | dump [-t <seconds>] [<file>]}");
+}
+
+int trace_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		unsigned ring_size = 0;
+
+		if (argc == 4 && !strcmp(argv[2], "-n")) {
+			ring_size = strtoul(argv[3], NULL, 10);
+
+		} else if (argc != 2) {
+			usage();
+			return 1;
+		}
+
+		return px4_trace_start(ring_size) == 0 ? 0 : 1;
+
+	} else if (!strcmp(argv[1], "stop")) {
+		px4_trace_stop();
+		return 0;
+
+	} else if (!strcmp(argv[1], "status")) {
+		px4_trace_status();
+		return 0;
+
+	} else if (!strcmp(argv[1], "dump")) {
+		unsigned seconds = 0;
+		const char *path = NULL;
+
+		for (int i = 2; i < argc; i++) {
+			if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+				seconds = strtoul(argv[++i], NULL, 10);
+
+			} else if (argv[i][0] != '-' && path == NULL) {
+				path = argv[i];
+
+			} else {
+				usage();
+				return 1;
+			}
+		}
+
+		int fd = 1;
+
+		if (path != NULL) {
+			fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+			if (fd < 0) {
+				PX4_ERR("can't open %s", path);
+				return 1;
+			}
+		}
+
+		int count = px4_trace_dump(fd, seconds);
+
+		if (path != NULL) {
+			close(fd);
+			PX4_INFO("%d events written to %s", count, path);
+		}
+
+		return count >= 0 ? 0 : 1;
+	}
+
+	usage();
+	return 1;
+}
@@ -14,5 +14,86 @@
 
 TEST(AutoDeclinationTest, AutoDeclination)
 {
-	ASSERT_NEAR(get_mag_declination(47.0, 8.0), 0.6, 0.5) << "declination differs more than 1 degree";
+	ASSERT_NEAR(get_mag_declination(47.0, 8.0), 2.0, 0.5) << "declination differs more than 0.5 degree";
+}
+
+TEST(AutoDeclinationTest, FieldReference)
+{
+	/* World Magnetic Model 2015 for 2016.0 at Sydney, Boulder and the North Cape */
+	EXPECT_NEAR(12.6f, get_mag_declination(-33.9f, 151.2f), 0.5f);
+	EXPECT_NEAR(-64.3f, get_mag_inclination(-33.9f, 151.2f), 0.5f);
+	EXPECT_NEAR(0.571f, get_mag_strength(-33.9f, 151.2f), 0.01f);
+	EXPECT_NEAR(8.5f, get_mag_declination(40.0f, -105.0f), 0.5f);
+	EXPECT_NEAR(66.6f, get_mag_inclination(40.0f, -105.0f), 0.5f);
+	EXPECT_NEAR(0.525f, get_mag_strength(40.0f, -105.0f), 0.01f);
+	EXPECT_NEAR(12.9f, get_mag_declination(71.2f, 25.8f), 0.5f);
+	EXPECT_NEAR(79.2f, get_mag_inclination(71.2f, 25.8f), 0.5f);
+
+	/* invalid positions */
+	EXPECT_EQ(0.0f, get_mag_declination(91.0f, 0.0f));
+	EXPECT_EQ(0.0f, get_mag_strength(0.0f, -181.0f));
+}
+
+TEST(AutoDeclinationTest, FullGlobe)
+{
+	for (float lat = -90.0f; lat <= 90.0f; lat += 0.5f) {
+		for (float lon = -180.0f; lon <= 180.0f; lon += 0.5f) {
+			float declination = get_mag_declination(lat, lon);
+			ASSERT_TRUE(declination >= -180.0f && declination <= 180.0f) << lat << " " << lon;
+			ASSERT_TRUE(fabsf(get_mag_inclination(lat, lon)) <= 90.0f) << lat << " " << lon;
+			ASSERT_TRUE(get_mag_strength(lat, lon) > 0.2f) << lat << " " << lon;
+		}
+	}
+
+	/* the date line is no edge */
+	EXPECT_NEAR(get_mag_declination(-45.0f, 180.0f), get_mag_declination(-45.0f, -180.0f), 0.01f);
+	EXPECT_NEAR(get_mag_strength(-45.0f, 179.99f), get_mag_strength(-45.0f, -179.99f), 0.001f);
+}
+
+TEST(AutoDeclinationTest, Cache)
+{
+	struct geo_mag_cache_s cache;
+	geo_mag_cache_init(&cache);
+	srand(1);
+
+	for (unsigned i = 0; i < 10000; i++) {
+		/* a flight inside one cell now and then jumping to another one */
+		float lat = (i % 100 == 0) ? -90.0f + 180.0f * rand() / RAND_MAX : 47.0f + 0.01f * (i % 100);
+		float lon = (i % 100 == 0) ? -180.0f + 360.0f * rand() / RAND_MAX : 8.0f + 0.01f * (i % 100);
+
+		float declination, inclination, strength;
+		ASSERT_EQ(0, get_mag_field_cached(&cache, lat, lon, &declination, &inclination, &strength));
+		ASSERT_FLOAT_EQ(get_mag_declination(lat, lon), declination);
+		ASSERT_FLOAT_EQ(get_mag_inclination(lat, lon), inclination);
+		ASSERT_FLOAT_EQ(get_mag_strength(lat, lon), strength);
+	}
+
+	EXPECT_EQ(-1, get_mag_field_cached(&cache, 0.0f, 200.0f, NULL, NULL, NULL));
+}
+
+TEST(AutoDeclinationTest, Benchmark)
+{
+	const unsigned n = 100000;
+	struct geo_mag_cache_s cache;
+	geo_mag_cache_init(&cache);
+	float sum = 0.0f;
+
+	hrt_abstime t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		sum += get_mag_declination(47.0f + 1e-5f * i, 8.0f);
+	}
+
+	hrt_abstime t1 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		float declination;
+		get_mag_field_cached(&cache, 47.0f + 1e-5f * i, 8.0f, &declination, NULL, NULL);
+		sum += declination;
+	}
+
+	hrt_abstime t2 = hrt_absolute_time();
+
+	printf("declination lookup %.1f ns, cached %.1f ns (%.0f)\n", (t1 - t0) * 1000.0 / n, (t2 - t1) * 1000.0 / n,
+	       (double)sum);
 }
@@ -0,0 +1,145 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <drivers/drv_hrt.h>
+
+#include "ekf_legacy_covariance.h"
+#include "ekf_replay.h"
+
+#include "gtest/gtest.h"
+
+uint64_t ekf_replay_time_us = 0;
+
+uint64_t getMicros()
+{
+	return ekf_replay_time_us;
+}
+
+uint32_t millis()
+{
+	return getMicros() / 1000;
+}
+
+static float max_relative_error(const AttPosEKF &a, const AttPosEKF &b)
+{
+	float max_err = 0.0f;
+
+	for (size_t i = 0; i < EKF_STATE_ESTIMATES; i++) {
+		for (size_t j = 0; j < EKF_STATE_ESTIMATES; j++) {
+			float scale = sqrtf(fabsf(a.P[i][i] * a.P[j][j])) + 1e-12f;
+			float err = fabsf(a.P[i][j] - b.P[i][j]) / scale;
+
+			if (err > max_err) {
+				max_err = err;
+			}
+		}
+	}
+
+	return max_err;
+}
+
+TEST(EkfCovarianceTest, MatchesLegacyPrediction)
+{
+	AttPosEKF ekf;
+	AttPosEKF reference;
+	EkfReplay replay(ekf);
+	replay.init();
+
+	unsigned predictions = 0;
+
+	for (unsigned i = 0; i < 10000; i++) {
+		float cov_dt = replay.propagate();
+
+		if (cov_dt > 0.0f) {
+			reference = ekf;
+			legacy_covariance_prediction(reference, cov_dt, false);
+			ekf.CovariancePrediction(cov_dt);
+			replay.predicted();
+			predictions++;
+
+			ASSERT_LT(max_relative_error(reference, ekf), 1e-4f) << "prediction " << predictions;
+
+			for (size_t r = 0; r < EKF_STATE_ESTIMATES; r++) {
+				for (size_t c = 0; c < r; c++) {
+					ASSERT_EQ(ekf.P[r][c], ekf.P[c][r]) << "asymmetric at " << r << "," << c;
+				}
+			}
+		}
+
+		replay.fuse();
+	}
+
+	EXPECT_GT(predictions, 100u);
+	EXPECT_FALSE(ekf.StatesNaN());
+	EXPECT_LT(fabsf(ekf.states[4] - ekf.velNED[0]), 2.0f);
+	EXPECT_LT(fabsf(ekf.states[5] - ekf.velNED[1]), 2.0f);
+}
+
+TEST(EkfCovarianceTest, Benchmark)
+{
+	AttPosEKF ekf;
+	EkfReplay replay(ekf);
+	replay.init();
+
+	/* settle the filter on the replayed data first */
+	for (unsigned i = 0; i < 2000; i++) {
+		replay.step();
+	}
+
+	const unsigned n = 2000;
+	AttPosEKF work;
+	hrt_abstime t0, t1;
+
+	work = ekf;
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		legacy_covariance_prediction(work, 0.02f, false);
+	}
+
+	t1 = hrt_absolute_time();
+	float legacy_us = (float)(t1 - t0) / n;
+
+	work = ekf;
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		work.CovariancePrediction(0.02f);
+	}
+
+	t1 = hrt_absolute_time();
+	float packed_us = (float)(t1 - t0) / n;
+
+	work = ekf;
+	work.fuseVelData = true;
+	work.fusePosData = true;
+	work.fuseHgtData = true;
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		work.FuseVelposNED();
+	}
+
+	t1 = hrt_absolute_time();
+	float velpos_us = (float)(t1 - t0) / n;
+
+	work = ekf;
+	work.fuseMagData = true;
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		work.magstate.obsIndex = 0;
+		work.FuseMagnetometer();
+		work.FuseMagnetometer();
+		work.FuseMagnetometer();
+	}
+
+	t1 = hrt_absolute_time();
+	float mag_us = (float)(t1 - t0) / n;
+
+	printf("covariance prediction: legacy %.2f us, packed %.2f us\n", (double)legacy_us, (double)packed_us);
+	printf("fusion: velpos %.2f us, mag (3 axes) %.2f us\n", (double)velpos_us, (double)mag_us);
+
+	EXPECT_FALSE(work.StatesNaN());
+}
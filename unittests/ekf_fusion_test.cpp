@@ -0,0 +1,300 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <drivers/drv_hrt.h>
+#include <ecl/ekf/ecl_scalar_fusion.h>
+
+#include "ekf_replay.h"
+
+#include "gtest/gtest.h"
+
+static const size_t N = EKF_STATE_ESTIMATES;
+typedef ECL_ScalarFusion<EKF_STATE_ESTIMATES> ScalarFusion;
+
+uint64_t ekf_replay_time_us = 0;
+
+uint64_t getMicros()
+{
+	return ekf_replay_time_us;
+}
+
+uint32_t millis()
+{
+	return getMicros() / 1000;
+}
+
+static float random_float()
+{
+	return (float)rand() / (float)RAND_MAX - 0.5f;
+}
+
+/* random symmetric positive definite matrix A * A' + I */
+static void random_covariance(float (&P)[N][N])
+{
+	float A[N][N];
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			A[i][j] = random_float();
+		}
+	}
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			float sum = (i == j) ? 1.0f : 0.0f;
+
+			for (size_t k = 0; k < N; k++) {
+				sum += A[i][k] * A[j][k];
+			}
+
+			P[i][j] = sum;
+		}
+	}
+}
+
+/* dense Joseph form (I - K*H) * P * (I - K*H)' + K*R*K' */
+static void dense_joseph(float (&P)[N][N], const float (&K)[N], const float (&H)[N], float R)
+{
+	float IKH[N][N];
+	float T[N][N];
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			IKH[i][j] = ((i == j) ? 1.0f : 0.0f) - K[i] * H[j];
+		}
+	}
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			float sum = 0.0f;
+
+			for (size_t k = 0; k < N; k++) {
+				sum += IKH[i][k] * P[k][j];
+			}
+
+			T[i][j] = sum;
+		}
+	}
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			float sum = K[i] * R * K[j];
+
+			for (size_t k = 0; k < N; k++) {
+				sum += T[i][k] * IKH[j][k];
+			}
+
+			P[i][j] = sum;
+		}
+	}
+}
+
+/* the previous update P = P - K*H*P using the non-zero columns of H */
+static void dense_update(float (&P)[N][N], float (&KH)[N][N], float (&KHP)[N][N], const float (&K)[N],
+			 const float (&H)[N], const uint8_t *observed, unsigned nnz)
+{
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			KH[i][j] = K[i] * H[j];
+		}
+	}
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			KHP[i][j] = 0.0f;
+
+			for (unsigned k = 0; k < nnz; k++) {
+				KHP[i][j] += KH[i][observed[k]] * P[observed[k]][j];
+			}
+		}
+	}
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			P[i][j] -= KHP[i][j];
+		}
+	}
+}
+
+static float max_difference(const float (&a)[N][N], const float (&b)[N][N])
+{
+	float max_err = 0.0f;
+
+	for (size_t i = 0; i < N; i++) {
+		for (size_t j = 0; j < N; j++) {
+			float err = fabsf(a[i][j] - b[i][j]) / (fabsf(b[i][j]) + 1.0f);
+
+			if (err > max_err) {
+				max_err = err;
+			}
+		}
+	}
+
+	return max_err;
+}
+
+/* magnetometer style observation row */
+static const uint8_t mag_observed[] = {0, 1, 2, 3, 16, 17, 18, 19};
+
+static void mag_observation(ScalarFusion &fusion, float (&H)[N])
+{
+	memset(H, 0, sizeof(H));
+	fusion.reset();
+
+	for (unsigned k = 0; k < sizeof(mag_observed); k++) {
+		H[mag_observed[k]] = random_float();
+		ASSERT_TRUE(fusion.add(mag_observed[k], H[mag_observed[k]]));
+	}
+}
+
+TEST(EkfFusionTest, MatchesDenseUpdate)
+{
+	float P[N][N];
+	float reference[N][N];
+	float KH[N][N];
+	float KHP[N][N];
+	float H[N];
+	float K[N];
+	const float R = 0.05f;
+	srand(1);
+
+	for (unsigned round = 0; round < 50; round++) {
+		random_covariance(P);
+		ScalarFusion fusion;
+		mag_observation(fusion, H);
+
+		float S = fusion.innovationVariance(&P[0][0], R);
+		fusion.gain(K);
+
+		float HPHT = 0.0f;
+
+		for (size_t i = 0; i < N; i++) {
+			for (size_t j = 0; j < N; j++) {
+				HPHT += H[i] * P[i][j] * H[j];
+			}
+		}
+
+		ASSERT_NEAR(S, HPHT + R, 1e-4f * S);
+
+		/* with the optimal gain the Joseph form equals the standard form */
+		memcpy(reference, P, sizeof(P));
+		dense_update(reference, KH, KHP, K, H, mag_observed, sizeof(mag_observed));
+		fusion.updateCovariance(&P[0][0], K);
+		ASSERT_LT(max_difference(P, reference), 1e-4f);
+	}
+}
+
+TEST(EkfFusionTest, InhibitedStatesMatchDenseJoseph)
+{
+	float P[N][N];
+	float reference[N][N];
+	float H[N];
+	float K[N];
+	const float R = 0.05f;
+	srand(2);
+
+	for (unsigned round = 0; round < 50; round++) {
+		random_covariance(P);
+		ScalarFusion fusion;
+		mag_observation(fusion, H);
+
+		fusion.innovationVariance(&P[0][0], R);
+		fusion.gain(K);
+
+		/* zero the gains like the estimator does for inhibited states */
+		K[13] = 0.0f;
+
+		for (size_t i = 16; i < N; i++) {
+			K[i] = 0.0f;
+		}
+
+		memcpy(reference, P, sizeof(P));
+		dense_joseph(reference, K, H, R);
+		fusion.updateCovariance(&P[0][0], K);
+		ASSERT_LT(max_difference(P, reference), 1e-4f);
+
+		for (size_t i = 0; i < N; i++) {
+			ASSERT_GT(P[i][i], 0.0f);
+
+			for (size_t j = 0; j < i; j++) {
+				ASSERT_NEAR(P[i][j], P[j][i], 1e-5f * (fabsf(P[i][j]) + 1.0f));
+			}
+		}
+	}
+}
+
+TEST(EkfFusionTest, Replay)
+{
+	AttPosEKF ekf;
+	EkfReplay replay(ekf);
+	replay.init();
+
+	for (unsigned i = 0; i < 10000; i++) {
+		replay.step();
+
+		for (size_t r = 0; r < N; r++) {
+			ASSERT_GE(ekf.P[r][r], 0.0f) << "negative variance " << r << " at step " << i;
+		}
+	}
+
+	EXPECT_FALSE(ekf.StatesNaN());
+	EXPECT_LT(fabsf(ekf.states[4] - ekf.velNED[0]), 2.0f);
+	EXPECT_LT(fabsf(ekf.states[5] - ekf.velNED[1]), 2.0f);
+	EXPECT_LT(fabsf(ekf.states[7] - ekf.posNE[0]), 5.0f);
+	EXPECT_LT(fabsf(ekf.states[8] - ekf.posNE[1]), 5.0f);
+}
+
+TEST(EkfFusionTest, Benchmark)
+{
+	AttPosEKF ekf;
+	EkfReplay replay(ekf);
+	replay.init();
+
+	/* use a covariance matrix from the replayed flight */
+	for (unsigned i = 0; i < 2000; i++) {
+		replay.step();
+	}
+
+	float P[N][N];
+	float KH[N][N];
+	float KHP[N][N];
+	float H[N];
+	float K[N];
+	const unsigned n = 20000;
+	hrt_abstime t0, t1;
+
+	srand(3);
+	ScalarFusion fusion;
+	mag_observation(fusion, H);
+	memcpy(P, ekf.P, sizeof(P));
+	fusion.innovationVariance(&P[0][0], 0.05f);
+	fusion.gain(K);
+
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		memcpy(P, ekf.P, sizeof(P));
+		dense_update(P, KH, KHP, K, H, mag_observed, sizeof(mag_observed));
+	}
+
+	t1 = hrt_absolute_time();
+	float dense_us = (float)(t1 - t0) / n;
+
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		memcpy(P, ekf.P, sizeof(P));
+		fusion.innovationVariance(&P[0][0], 0.05f);
+		fusion.updateCovariance(&P[0][0], K);
+	}
+
+	t1 = hrt_absolute_time();
+	float sparse_us = (float)(t1 - t0) / n;
+
+	printf("scalar covariance update (nnz %u): dense KHP %.2f us, sparse Joseph %.2f us\n",
+	       fusion.nnz(), (double)dense_us, (double)sparse_us);
+
+	EXPECT_GT(P[0][0], 0.0f);
+}
@@ -0,0 +1,14 @@
+/**
+ * @file ekf_legacy_covariance.h
+ *
+ * Reference implementation of the AttPosEKF covariance prediction.
+ */
+
+#pragma once
+
+#include <ekf_att_pos_estimator/estimator_22states.h>
+
+/**
+ * Predict the covariance of ekf with the original fully expanded equations.
+ */
+void legacy_covariance_prediction(AttPosEKF &ekf, float dt, bool onGround);
@@ -0,0 +1,205 @@
+/**
+ * @file ekf_replay.h
+ *
+ * Deterministic sensor replay for AttPosEKF tests and benchmarks.
+ *
+ * Replays a level, constant speed circle at 250 Hz IMU rate with
+ * 5 Hz GPS, 25 Hz baro and 50 Hz magnetometer data, sequencing the
+ * filter calls the same way AttitudePositionEstimatorEKF does.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <ekf_att_pos_estimator/estimator_22states.h>
+
+/* simulated time, the test provides millis() and getMicros() from it */
+extern uint64_t ekf_replay_time_us;
+
+class EkfReplay
+{
+public:
+	static constexpr float dt = 0.004f;
+	static constexpr float radius = 100.0f;
+	static constexpr float speed = 15.0f;
+	static constexpr unsigned gps_interval = 50;
+	static constexpr unsigned baro_interval = 10;
+	static constexpr unsigned mag_interval = 5;
+	static constexpr unsigned vel_delay_ms = 230;
+	static constexpr unsigned pos_delay_ms = 210;
+	static constexpr unsigned height_delay_ms = 350;
+	static constexpr unsigned mag_delay_ms = 30;
+
+	explicit EkfReplay(AttPosEKF &ekf) :
+		_ekf(ekf),
+		_step(0),
+		_seed(12345u),
+		_cov_dt(0.0f)
+	{}
+
+	/**
+	 * Initialise the filter at the start of the circle.
+	 */
+	void init()
+	{
+		ekf_replay_time_us = 1000000;
+		sample();
+		_ekf.baroHgt = 0.0f;
+		_ekf.hgtMea = 0.0f;
+
+		float initvel[3] = {_vel[0], _vel[1], _vel[2]};
+		_ekf.InitialiseFilter(initvel, 0.82, 0.15, 0.0f, 0.0f);
+		_ekf.useGPS = true;
+		_ekf.useCompass = true;
+		_ekf.GPSstatus = GPS_FIX_3D;
+		_ekf.staticMode = false;
+		_ekf.setOnGround(false);
+	}
+
+	/**
+	 * Advance one IMU sample and run the strapdown equations.
+	 *
+	 * @return the covariance prediction interval if a prediction is due, zero otherwise
+	 */
+	float propagate()
+	{
+		_step++;
+		ekf_replay_time_us += (uint64_t)(dt * 1e6f);
+		sample();
+
+		_ekf.dtIMU = dt;
+		_ekf.UpdateStrapdownEquationsNED();
+		_ekf.StoreStates(millis());
+		_ekf.summedDelAng = _ekf.summedDelAng + _ekf.correctedDelAng;
+		_ekf.summedDelVel = _ekf.summedDelVel + _ekf.dVelIMU;
+		_cov_dt += dt;
+
+		if ((_cov_dt >= (_ekf.covTimeStepMax - _ekf.dtIMU))
+		    || (_ekf.summedDelAng.length() > _ekf.covDelAngMax)) {
+			return _cov_dt;
+		}
+
+		return 0.0f;
+	}
+
+	/**
+	 * Reset the accumulated deltas after a covariance prediction.
+	 */
+	void predicted()
+	{
+		_ekf.summedDelAng.zero();
+		_ekf.summedDelVel.zero();
+		_cov_dt = 0.0f;
+	}
+
+	bool gps_due() const { return (_step % gps_interval) == 0; }
+	bool baro_due() const { return (_step % baro_interval) == 0; }
+	bool mag_due() const { return (_step % mag_interval) == 0; }
+
+	/**
+	 * Run the measurement fusion steps that are due at this sample.
+	 */
+	void fuse()
+	{
+		uint64_t now = millis();
+
+		if (gps_due()) {
+			_ekf.fuseVelData = true;
+			_ekf.fusePosData = true;
+			_ekf.RecallStates(_ekf.statesAtVelTime, now - vel_delay_ms);
+			_ekf.RecallStates(_ekf.statesAtPosTime, now - pos_delay_ms);
+			_ekf.FuseVelposNED();
+			_ekf.fuseVelData = false;
+			_ekf.fusePosData = false;
+		}
+
+		if (baro_due()) {
+			_ekf.hgtMea = _ekf.baroHgt;
+			_ekf.fuseHgtData = true;
+			_ekf.RecallStates(_ekf.statesAtHgtTime, now - height_delay_ms);
+			_ekf.FuseVelposNED();
+			_ekf.fuseHgtData = false;
+		}
+
+		if (mag_due()) {
+			_ekf.fuseMagData = true;
+			_ekf.RecallStates(_ekf.statesAtMagMeasTime, now - mag_delay_ms);
+			_ekf.magstate.obsIndex = 0;
+			_ekf.FuseMagnetometer();
+			_ekf.FuseMagnetometer();
+			_ekf.FuseMagnetometer();
+			_ekf.fuseMagData = false;
+		}
+	}
+
+	/**
+	 * Run one full filter cycle with the filter's own covariance prediction.
+	 */
+	void step()
+	{
+		float cov_dt = propagate();
+
+		if (cov_dt > 0.0f) {
+			_ekf.CovariancePrediction(cov_dt);
+			predicted();
+		}
+
+		fuse();
+	}
+
+	unsigned steps() const { return _step; }
+
+private:
+	AttPosEKF &_ekf;
+	unsigned _step;
+	uint32_t _seed;
+	float _cov_dt;
+	float _vel[3];
+
+	/* small deterministic sensor noise */
+	float noise(float amplitude)
+	{
+		_seed = _seed * 1664525u + 1013904223u;
+		return amplitude * ((float)(_seed >> 8) / (float)(1 << 24) - 0.5f);
+	}
+
+	/* generate the truth and sensor data for the current time */
+	void sample()
+	{
+		const float omega = speed / radius;
+		const float t = _step * dt;
+		const float phase = omega * t;
+		const float yaw = phase + 0.5f * (float)M_PI;
+		const float cy = cosf(yaw);
+		const float sy = sinf(yaw);
+
+		const float pos[2] = {radius * cosf(phase), radius * sinf(phase)};
+		_vel[0] = -speed * sinf(phase);
+		_vel[1] = speed * cosf(phase);
+		_vel[2] = 0.0f;
+
+		/* specific force in NED is the centripetal acceleration minus gravity */
+		const float fN = -omega * omega * pos[0];
+		const float fE = -omega * omega * pos[1];
+		const float fD = -GRAVITY_MSS;
+
+		_ekf.angRate = Vector3f(noise(0.002f), noise(0.002f), omega + noise(0.002f));
+		_ekf.accel = Vector3f(cy * fN + sy * fE + noise(0.05f), -sy * fN + cy * fE + noise(0.05f), fD + noise(0.05f));
+		_ekf.dAngIMU = _ekf.angRate * dt;
+		_ekf.dVelIMU = _ekf.accel * dt;
+
+		const float magN = 0.21f;
+		const float magE = 0.01f;
+		const float magD = 0.42f;
+		_ekf.magData = Vector3f(cy * magN + sy * magE + noise(0.002f), -sy * magN + cy * magE + noise(0.002f), magD + noise(0.002f));
+
+		_ekf.velNED[0] = _vel[0] + noise(0.1f);
+		_ekf.velNED[1] = _vel[1] + noise(0.1f);
+		_ekf.velNED[2] = _vel[2] + noise(0.1f);
+		_ekf.posNE[0] = pos[0] + noise(0.5f);
+		_ekf.posNE[1] = pos[1] + noise(0.5f);
+		_ekf.baroHgt = noise(0.2f);
+	}
+};
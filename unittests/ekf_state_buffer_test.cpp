@@ -0,0 +1,134 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <drivers/drv_hrt.h>
+#include <ekf_att_pos_estimator/estimator_state_buffer.h>
+
+#include "gtest/gtest.h"
+
+typedef EstimatorStateBuffer<22, 50> StateBuffer;
+
+/* the previous lookup: scan every slot for the smallest time difference */
+static int linear_scan(const StateBuffer &buf, uint64_t time_ms)
+{
+	uint64_t best = UINT64_MAX;
+	int best_age = -1;
+
+	for (unsigned age = 0; age < buf.size(); age++) {
+		uint64_t d = buf.distance(age, time_ms);
+
+		if (d < best) {
+			best = d;
+			best_age = age;
+		}
+	}
+
+	return best_age;
+}
+
+static void fill(StateBuffer &buf, unsigned n, uint32_t &t)
+{
+	float states[22] = {};
+	Vector3f omega;
+
+	for (unsigned i = 0; i < n; i++) {
+		/* 4 ms nominal with jitter and the occasional dropout */
+		t += 3 + rand() % 3 + ((rand() % 50 == 0) ? 20 : 0);
+
+		for (unsigned k = 0; k < 22; k++) {
+			states[k] = t * 0.01f + k;
+		}
+
+		buf.push(t, states, omega);
+	}
+}
+
+TEST(EkfStateBufferTest, NearestMatchesLinearScan)
+{
+	StateBuffer buf;
+	uint32_t t = 1000;
+	srand(42);
+
+	EXPECT_EQ(buf.find(1000), -1);
+
+	for (unsigned round = 0; round < 200; round++) {
+		fill(buf, 1 + rand() % 10, t);
+
+		uint32_t oldest = buf.get(buf.size() - 1).time_ms;
+
+		for (unsigned q = 0; q < 50; q++) {
+			uint64_t query = oldest + (rand() % (t - oldest + 100)) - 50;
+			int age = buf.find(query);
+			int ref = linear_scan(buf, query);
+
+			ASSERT_GE(age, 0);
+			ASSERT_EQ(buf.distance(age, query), buf.distance(ref, query)) << "query " << query;
+		}
+	}
+}
+
+TEST(EkfStateBufferTest, Interpolation)
+{
+	StateBuffer buf;
+	uint32_t t = 1000;
+	srand(7);
+	fill(buf, 80, t);
+
+	float out[22];
+
+	for (unsigned age = 1; age < buf.size(); age++) {
+		const StateBuffer::Sample &older = buf.get(age);
+		const StateBuffer::Sample &newer = buf.get(age - 1);
+
+		if (newer.time_ms - older.time_ms < 2) {
+			continue;
+		}
+
+		uint64_t query = older.time_ms + 1;
+		int nearest = buf.find(query);
+		ASSERT_TRUE(buf.interpolate(query, nearest, out));
+
+		for (unsigned k = 0; k < 22; k++) {
+			EXPECT_NEAR(out[k], query * 0.01f + k, 1e-3f);
+		}
+	}
+
+	/* exact hits and times outside the buffer are not interpolated */
+	EXPECT_FALSE(buf.interpolate(buf.get(3).time_ms, 3, out));
+	EXPECT_FALSE(buf.interpolate(t + 10, 0, out));
+}
+
+TEST(EkfStateBufferTest, Benchmark)
+{
+	StateBuffer buf;
+	uint32_t t = 1000;
+	srand(3);
+	fill(buf, 200, t);
+
+	const unsigned n = 100000;
+	const unsigned delays[] = {30, 100, 210, 230, 350};
+	volatile int sink = 0;
+	hrt_abstime t0, t1;
+
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		sink += linear_scan(buf, t - delays[i % 5]);
+	}
+
+	t1 = hrt_absolute_time();
+	float scan_us = (float)(t1 - t0) / n;
+
+	t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		sink += buf.find(t - delays[i % 5]);
+	}
+
+	t1 = hrt_absolute_time();
+	float find_us = (float)(t1 - t0) / n;
+
+	printf("state recall lookup: linear scan %.3f us, ring index %.3f us\n", (double)scan_us, (double)find_us);
+	(void)sink;
+}
@@ -0,0 +1,165 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <drivers/drv_hrt.h>
+#include <geo/geo.h>
+
+#include "gtest/gtest.h"
+
+/* rounding of the float results on top of the truncation error */
+static const float max_error = MAP_PROJECTION_FAST_MAX_ERROR + 0.005f;
+
+static double uniform(double min, double max)
+{
+	return min + (max - min) * (double)rand() / RAND_MAX;
+}
+
+/* random point at most max_distance away from (lat_0, lon_0) */
+static void sample(double lat_0, double lon_0, double max_distance, double *lat, double *lon)
+{
+	double d = uniform(0.0, max_distance);
+	double theta = uniform(-M_PI, M_PI);
+	*lat = lat_0 + d * cos(theta) / CONSTANTS_RADIUS_OF_EARTH * 180.0 / M_PI;
+	*lon = lon_0 + d * sin(theta) / (CONSTANTS_RADIUS_OF_EARTH * cos(lat_0 * M_PI / 180.0)) * 180.0 / M_PI;
+
+	if (*lon > 180.0) {
+		*lon -= 360.0;
+
+	} else if (*lon < -180.0) {
+		*lon += 360.0;
+	}
+}
+
+TEST(GeoProjectionTest, Project)
+{
+	srand(1);
+
+	for (unsigned i = 0; i < 20000; i++) {
+		double lat_0 = uniform(-89.0, 89.0);
+		double lon_0 = uniform(-180.0, 180.0);
+		struct map_projection_reference_s ref;
+		map_projection_init(&ref, lat_0, lon_0);
+
+		double lat, lon;
+		sample(lat_0, lon_0, (i % 4 == 0) ? 100000.0 : 15000.0, &lat, &lon);
+
+		float x, y, x_fast, y_fast;
+		map_projection_project(&ref, lat, lon, &x, &y);
+		ASSERT_EQ(0, map_projection_project_fast(&ref, lat, lon, &x_fast, &y_fast));
+		ASSERT_LT(hypotf(x - x_fast, y - y_fast), max_error) << lat_0 << " " << lon_0 << " " << lat << " " << lon;
+
+		/* back to the sample */
+		double lat_back, lon_back;
+		ASSERT_EQ(0, map_projection_reproject_fast(&ref, x, y, &lat_back, &lon_back));
+		ASSERT_LT(get_distance_to_next_waypoint(lat, lon, lat_back, lon_back), max_error);
+	}
+
+	struct map_projection_reference_s ref = {};
+	float x, y;
+	double lat, lon;
+	EXPECT_EQ(-1, map_projection_project_fast(&ref, 47.0, 8.0, &x, &y));
+	EXPECT_EQ(-1, map_projection_reproject_fast(&ref, 0.0f, 0.0f, &lat, &lon));
+}
+
+TEST(GeoProjectionTest, Waypoint)
+{
+	srand(2);
+
+	for (unsigned i = 0; i < 20000; i++) {
+		double lat_now = uniform(-89.0, 89.0);
+		double lon_now = uniform(-180.0, 180.0);
+		double lat_next, lon_next;
+		sample(lat_now, lon_now, (i % 4 == 0) ? 100000.0 : 15000.0, &lat_next, &lon_next);
+
+		float d = get_distance_to_next_waypoint(lat_now, lon_now, lat_next, lon_next);
+		float bearing = get_bearing_to_next_waypoint(lat_now, lon_now, lat_next, lon_next);
+		float d_fast = get_distance_to_next_waypoint_fast(lat_now, lon_now, lat_next, lon_next);
+		float bearing_fast = get_bearing_to_next_waypoint_fast(lat_now, lon_now, lat_next, lon_next);
+
+		ASSERT_LT(fabsf(d - d_fast), max_error);
+		/* lateral offset of the waypoint */
+		ASSERT_LT(fabsf(_wrap_pi(bearing - bearing_fast)) * d, max_error);
+	}
+}
+
+TEST(GeoProjectionTest, Batch)
+{
+	static const unsigned n = 1024;
+	static double lat[n], lon[n];
+	static float x[n], y[n];
+
+	struct map_projection_reference_s ref;
+	map_projection_init(&ref, -33.9, 151.2);
+	srand(3);
+
+	for (unsigned i = 0; i < n; i++) {
+		sample(-33.9, 151.2, (i == 500) ? 50000.0 : 10000.0, &lat[i], &lon[i]);
+	}
+
+	ASSERT_EQ(0, map_projection_project_batch(&ref, lat, lon, x, y, n));
+
+	for (unsigned i = 0; i < n; i++) {
+		float x_fast, y_fast;
+		map_projection_project_fast(&ref, lat[i], lon[i], &x_fast, &y_fast);
+		ASSERT_FLOAT_EQ(x_fast, x[i]);
+		ASSERT_FLOAT_EQ(y_fast, y[i]);
+	}
+
+	/* across the date line */
+	map_projection_init(&ref, 0.0, 180.0);
+	lat[0] = 0.0;
+	lon[0] = -179.99;
+	map_projection_project_batch(&ref, lat, lon, x, y, 1);
+	EXPECT_NEAR(1111.9f, y[0], 0.1f);
+}
+
+TEST(GeoProjectionTest, Benchmark)
+{
+	static const unsigned n = 4096;
+	static double lat[n], lon[n];
+	static float x[n], y[n];
+
+	struct map_projection_reference_s ref;
+	map_projection_init(&ref, 47.4, 8.5);
+	srand(4);
+
+	for (unsigned i = 0; i < n; i++) {
+		sample(47.4, 8.5, 5000.0, &lat[i], &lon[i]);
+	}
+
+	hrt_abstime t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		map_projection_project(&ref, lat[i], lon[i], &x[i], &y[i]);
+	}
+
+	hrt_abstime t1 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		map_projection_project_fast(&ref, lat[i], lon[i], &x[i], &y[i]);
+	}
+
+	hrt_abstime t2 = hrt_absolute_time();
+
+	map_projection_project_batch(&ref, lat, lon, x, y, n);
+
+	hrt_abstime t3 = hrt_absolute_time();
+
+	float d = 0.0f;
+
+	for (unsigned i = 1; i < n; i++) {
+		d += get_distance_to_next_waypoint(lat[i - 1], lon[i - 1], lat[i], lon[i]);
+	}
+
+	hrt_abstime t4 = hrt_absolute_time();
+
+	for (unsigned i = 1; i < n; i++) {
+		d += get_distance_to_next_waypoint_fast(lat[i - 1], lon[i - 1], lat[i], lon[i]);
+	}
+
+	hrt_abstime t5 = hrt_absolute_time();
+
+	printf("%u points: project %.1f us, fast %.1f us, batch %.1f us, distance %.1f us, fast %.1f us (%.0f)\n", n,
+	       (double)(t1 - t0), (double)(t2 - t1), (double)(t3 - t2), (double)(t4 - t3), (double)(t5 - t4), (double)d);
+}
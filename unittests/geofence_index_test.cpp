@@ -0,0 +1,207 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <drivers/drv_hrt.h>
+#include <navigator/geofence_index.h>
+
+#include "gtest/gtest.h"
+
+/* the previous point test: PNPOLY over all vertices in lat/lon */
+static bool pnpoly(const float *lat, const float *lon, unsigned n, double x, double y)
+{
+	bool c = false;
+
+	for (unsigned i = 0, j = n - 1; i < n; j = i++) {
+		if (((double)lon[i] >= y) != ((double)lon[j] >= y) &&
+		    (x <= (double)(lat[j] - lat[i]) * (y - (double)lon[i]) /
+		     (double)(lon[j] - lon[i]) + (double)lat[i])) {
+			c = !c;
+		}
+	}
+
+	return c;
+}
+
+/* closed star shaped polygon around 47.4N 8.5E, about 1 km across */
+static void star(float *lat, float *lon, unsigned n)
+{
+	for (unsigned i = 0; i < n - 1; i++) {
+		float a = 2.0f * (float)M_PI * i / (n - 1);
+		float r = 0.004f * (1.0f + 0.5f * sinf(5.0f * a) + 0.2f * ((rand() % 100) / 100.0f));
+		lat[i] = 47.4f + r * cosf(a);
+		lon[i] = 8.5f + 1.5f * r * sinf(a);
+	}
+
+	lat[n - 1] = lat[0];
+	lon[n - 1] = lon[0];
+}
+
+static double random_lat()
+{
+	return 47.4 + 0.008 * ((rand() % 20001) / 10000.0 - 1.0);
+}
+
+static double random_lon()
+{
+	return 8.5 + 0.012 * ((rand() % 20001) / 10000.0 - 1.0);
+}
+
+static void square(GeofenceIndex &index, bool inclusion, float lat, float lon, float half)
+{
+	index.addPolygon(inclusion);
+	index.addVertex(lat - half, lon - half);
+	index.addVertex(lat - half, lon + half);
+	index.addVertex(lat + half, lon + half);
+	index.addVertex(lat + half, lon - half);
+	index.addVertex(lat - half, lon - half);
+}
+
+TEST(GeofenceIndexTest, MatchesPnpoly)
+{
+	srand(1);
+
+	for (unsigned n = GeofenceIndex::MIN_POLYGON_VERTICES; n <= GeofenceIndex::MAX_VERTICES; n += 5) {
+		float lat[GeofenceIndex::MAX_VERTICES];
+		float lon[GeofenceIndex::MAX_VERTICES];
+		star(lat, lon, n);
+
+		GeofenceIndex index;
+
+		for (unsigned i = 0; i < n; i++) {
+			ASSERT_TRUE(index.addVertex(lat[i], lon[i]));
+		}
+
+		ASSERT_TRUE(index.build());
+		ASSERT_EQ(index.polygonCount(), 1u);
+
+		unsigned inside = 0;
+
+		for (unsigned k = 0; k < 2000; k++) {
+			double x = random_lat();
+			double y = random_lon();
+			bool ref = pnpoly(lat, lon, n, x, y);
+			ASSERT_EQ(index.inside(x, y), ref) << n << " vertices, point " << x << " " << y;
+			inside += ref;
+		}
+
+		EXPECT_GT(inside, 0u);
+	}
+}
+
+TEST(GeofenceIndexTest, InclusionExclusion)
+{
+	GeofenceIndex index;
+
+	/* empty fence accepts all points */
+	ASSERT_TRUE(index.build());
+	EXPECT_TRUE(index.inside(47.4, 8.5));
+
+	/* two fields, the first with a no fly zone in the middle */
+	square(index, true, 47.40f, 8.50f, 0.01f);
+	square(index, true, 47.40f, 8.53f, 0.005f);
+	square(index, false, 47.40f, 8.50f, 0.002f);
+	ASSERT_TRUE(index.build());
+	EXPECT_EQ(index.polygonCount(), 3u);
+	EXPECT_EQ(index.vertexCount(), 15u);
+
+	EXPECT_TRUE(index.inside(47.405, 8.505));
+	EXPECT_FALSE(index.inside(47.400, 8.500));
+	EXPECT_FALSE(index.inside(47.401, 8.499));
+	EXPECT_TRUE(index.inside(47.400, 8.530));
+	EXPECT_FALSE(index.inside(47.400, 8.515));
+	EXPECT_FALSE(index.inside(47.420, 8.500));
+
+	/* only exclusion polygons: everything but the zone is allowed */
+	index.reset();
+	square(index, false, 47.40f, 8.50f, 0.002f);
+	ASSERT_TRUE(index.build());
+	EXPECT_FALSE(index.inside(47.400, 8.500));
+	EXPECT_TRUE(index.inside(47.410, 8.500));
+	EXPECT_TRUE(index.inside(46.000, 9.000));
+}
+
+TEST(GeofenceIndexTest, Invalid)
+{
+	GeofenceIndex index;
+
+	/* a triangle needs its first vertex repeated */
+	index.addVertex(47.40f, 8.50f);
+	index.addVertex(47.41f, 8.50f);
+	index.addVertex(47.41f, 8.51f);
+	EXPECT_FALSE(index.build());
+	EXPECT_FALSE(index.valid());
+	EXPECT_TRUE(index.inside(0.0, 0.0));
+
+	index.addVertex(47.40f, 8.50f);
+	EXPECT_TRUE(index.build());
+	EXPECT_TRUE(index.valid());
+
+	/* capacity */
+	index.reset();
+
+	for (unsigned i = 0; i < GeofenceIndex::MAX_VERTICES; i++) {
+		ASSERT_TRUE(index.addVertex(47.4f + 0.001f * i, 8.5f));
+	}
+
+	EXPECT_FALSE(index.addVertex(47.4f, 8.5f));
+
+	index.reset();
+
+	for (unsigned i = 0; i < GeofenceIndex::MAX_POLYGONS; i++) {
+		ASSERT_TRUE(index.addPolygon(false));
+	}
+
+	EXPECT_FALSE(index.addPolygon(true));
+}
+
+TEST(GeofenceIndexTest, Benchmark)
+{
+	srand(2);
+	const unsigned counts[] = {16, 32, 64, 128};
+	const unsigned n_points = 200000;
+	static double points[2 * 1024];
+
+	for (unsigned k = 0; k < 1024; k++) {
+		points[2 * k] = random_lat();
+		points[2 * k + 1] = random_lon();
+	}
+
+	for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		const unsigned n = counts[c];
+		float lat[GeofenceIndex::MAX_VERTICES];
+		float lon[GeofenceIndex::MAX_VERTICES];
+		star(lat, lon, n);
+
+		GeofenceIndex index;
+
+		for (unsigned i = 0; i < n; i++) {
+			index.addVertex(lat[i], lon[i]);
+		}
+
+		ASSERT_TRUE(index.build());
+
+		volatile unsigned sink = 0;
+		hrt_abstime t0 = hrt_absolute_time();
+
+		for (unsigned k = 0; k < n_points; k++) {
+			sink += pnpoly(lat, lon, n, points[2 * (k % 1024)], points[2 * (k % 1024) + 1]);
+		}
+
+		hrt_abstime t1 = hrt_absolute_time();
+		float pnpoly_us = (float)(t1 - t0) / n_points;
+
+		t0 = hrt_absolute_time();
+
+		for (unsigned k = 0; k < n_points; k++) {
+			sink += index.inside(points[2 * (k % 1024)], points[2 * (k % 1024) + 1]);
+		}
+
+		t1 = hrt_absolute_time();
+		float index_us = (float)(t1 - t0) / n_points;
+
+		printf("geofence %3u vertices: pnpoly %.3f us (%.0f checks/s), index %.3f us (%.0f checks/s)\n",
+		       n, (double)pnpoly_us, 1e6 / (double)pnpoly_us, (double)index_us, 1e6 / (double)index_us);
+		(void)sink;
+	}
+}
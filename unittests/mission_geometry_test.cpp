@@ -0,0 +1,213 @@
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <drivers/drv_hrt.h>
+#include <navigator/mission_geometry.h>
+
+#include "gtest/gtest.h"
+
+static struct mission_item_s g_items[NUM_MISSIONS_SUPPORTED];
+static unsigned g_reads;
+static unsigned g_readable = NUM_MISSIONS_SUPPORTED;
+
+/* in memory datamanager, items beyond g_readable can't be read */
+extern "C" ssize_t dm_read_range(dm_item_t, unsigned char index, void *buffer, unsigned count, size_t buflen)
+{
+	g_reads++;
+
+	if (buflen != sizeof(struct mission_item_s) || index + count > NUM_MISSIONS_SUPPORTED) {
+		return -1;
+	}
+
+	unsigned n = 0;
+
+	while (n < count && index + n < g_readable) {
+		memcpy((struct mission_item_s *)buffer + n, &g_items[index + n], buflen);
+		n++;
+	}
+
+	return n;
+}
+
+/* lawnmower survey around 47.4N 8.5E with a camera trigger every 16 items */
+static void survey(unsigned count)
+{
+	memset(g_items, 0, sizeof(g_items));
+
+	for (unsigned i = 0; i < count; i++) {
+		struct mission_item_s &item = g_items[i];
+
+		if (i % 16 == 15) {
+			item.nav_cmd = NAV_CMD_DO_SET_SERVO;
+			item.actuator_num = 2;
+			item.actuator_value = 1500;
+			continue;
+		}
+
+		unsigned row = i / 8;
+		unsigned col = (row % 2) ? 7 - i % 8 : i % 8;
+		item.nav_cmd = (i == 0) ? NAV_CMD_TAKEOFF : NAV_CMD_WAYPOINT;
+		item.lat = 47.4 + 0.0005 * row;
+		item.lon = 8.5 + 0.001 * col;
+		item.altitude = 50.0f;
+		item.altitude_is_relative = true;
+		item.autocontinue = true;
+	}
+
+	g_readable = NUM_MISSIONS_SUPPORTED;
+}
+
+TEST(MissionGeometryTest, Legs)
+{
+	static MissionGeometry geometry;
+	const unsigned count = NUM_MISSIONS_SUPPORTED;
+	survey(count);
+
+	ASSERT_EQ((int)count, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+	ASSERT_EQ(count, geometry.count());
+	EXPECT_EQ(-1, geometry.firstUnsupported());
+	EXPECT_EQ(-1, geometry.firstActuatorError());
+
+	int previous = -1;
+
+	for (unsigned i = 0; i < count; i++) {
+		const MissionGeometry::Entry &e = geometry.entry(i);
+		bool position = MissionGeometry::hasPosition(g_items[i].nav_cmd);
+		EXPECT_EQ(position, (e.flags & MissionGeometry::ITEM_POSITION) != 0);
+		EXPECT_EQ(g_items[i].altitude_is_relative, (e.flags & MissionGeometry::ITEM_ALT_RELATIVE) != 0);
+		EXPECT_EQ(g_items[i].lat, e.lat);
+		EXPECT_EQ(g_items[i].lon, e.lon);
+		EXPECT_EQ(g_items[i].altitude, e.altitude);
+
+		if (!position) {
+			EXPECT_FALSE(e.flags & MissionGeometry::ITEM_LEG);
+			continue;
+		}
+
+		if (previous >= 0) {
+			ASSERT_TRUE(geometry.hasLeg(previous, i));
+			EXPECT_FLOAT_EQ(get_distance_to_next_waypoint(g_items[previous].lat, g_items[previous].lon,
+					g_items[i].lat, g_items[i].lon), e.leg_distance);
+
+		} else {
+			EXPECT_FALSE(e.flags & MissionGeometry::ITEM_LEG);
+		}
+
+		previous = i;
+	}
+
+	/* the leg after a camera trigger starts at the waypoint before it */
+	EXPECT_TRUE(geometry.hasLeg(14, 16));
+	EXPECT_FALSE(geometry.hasLeg(15, 16));
+}
+
+TEST(MissionGeometryTest, Incremental)
+{
+	static MissionGeometry geometry;
+	const unsigned count = NUM_MISSIONS_SUPPORTED;
+	survey(count);
+
+	ASSERT_EQ((int)count, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+
+	/* same mission uploaded again, to the other storage */
+	EXPECT_EQ(0, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_1, count));
+
+	/* counting DO_JUMP repetitions does not change the mission */
+	g_items[40].do_jump_current_count = 3;
+	EXPECT_EQ(0, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+
+	/* neither does the padding after a field, which not every writer clears */
+	((uint8_t *)&g_items[41])[offsetof(struct mission_item_s, altitude_is_relative) + 1] = 0xab;
+	EXPECT_EQ(0, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+
+	/* a moved waypoint changes its own entry and the leg leaving it */
+	g_items[100].lat += 0.0001;
+	EXPECT_EQ(2, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+	EXPECT_FLOAT_EQ(get_distance_to_next_waypoint(g_items[100].lat, g_items[100].lon,
+			g_items[101].lat, g_items[101].lon), geometry.entry(101).leg_distance);
+
+	/* a removed waypoint moves the start of the following leg */
+	g_items[101].nav_cmd = NAV_CMD_ROI;
+	EXPECT_EQ(2, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+	EXPECT_TRUE(geometry.hasLeg(100, 102));
+
+	/* a changed altitude is picked up for the feasibility checks */
+	g_items[0].altitude += 10.0f;
+	EXPECT_EQ(2, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+	EXPECT_FLOAT_EQ(g_items[0].altitude, geometry.entry(0).altitude);
+
+	/* a shorter mission only drops entries */
+	EXPECT_EQ(0, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, 64));
+	EXPECT_EQ(64u, geometry.count());
+
+	/* growing again computes the new items */
+	EXPECT_EQ((int)(count - 64), geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count));
+}
+
+TEST(MissionGeometryTest, Checks)
+{
+	static MissionGeometry geometry;
+	survey(32);
+
+	g_items[20].nav_cmd = NAV_CMD_DO_REPEAT_SERVO;
+	g_items[31].actuator_num = 6;
+	geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, 32);
+	EXPECT_EQ(20, geometry.firstUnsupported());
+	EXPECT_EQ(31, geometry.firstActuatorError());
+
+	g_items[20].nav_cmd = NAV_CMD_WAYPOINT;
+	g_items[31].actuator_num = 5;
+	geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, 32);
+	EXPECT_EQ(-1, geometry.firstUnsupported());
+	EXPECT_EQ(-1, geometry.firstActuatorError());
+}
+
+TEST(MissionGeometryTest, ReadError)
+{
+	static MissionGeometry geometry;
+	survey(64);
+
+	ASSERT_EQ(64, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, 64));
+
+	/* storage failure in the middle of the mission */
+	g_readable = 40;
+	EXPECT_EQ(-1, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, 64));
+	EXPECT_EQ(0u, geometry.count());
+
+	/* everything is recomputed once the storage is back */
+	g_readable = NUM_MISSIONS_SUPPORTED;
+	EXPECT_EQ(64, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, 64));
+
+	EXPECT_EQ(-1, geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, NUM_MISSIONS_SUPPORTED + 1));
+}
+
+TEST(MissionGeometryTest, Benchmark)
+{
+	static MissionGeometry geometry;
+	const unsigned count = NUM_MISSIONS_SUPPORTED;
+	const unsigned rounds = 100;
+	survey(count);
+
+	hrt_abstime t0 = hrt_absolute_time();
+
+	for (unsigned r = 0; r < rounds; r++) {
+		geometry.reset();
+		geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count);
+	}
+
+	hrt_abstime t1 = hrt_absolute_time();
+
+	g_reads = 0;
+
+	for (unsigned r = 0; r < rounds; r++) {
+		g_items[r + 1].altitude += 1.0f;
+		geometry.update(DM_KEY_WAYPOINTS_OFFBOARD_0, count);
+	}
+
+	hrt_abstime t2 = hrt_absolute_time();
+
+	printf("%u items: full %.1f us, one item changed %.1f us, %u reads per update\n", count,
+	       (double)(t1 - t0) / rounds, (double)(t2 - t1) / rounds, g_reads / rounds);
+}
@@ -0,0 +1,419 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include <px4_defines.h>
+#include <px4_tasks.h>
+#include <px4_vehicle.h>
+#include <px4_workqueue.h>
+#include <drivers/drv_hrt.h>
+#include <uORB/uORB.h>
+#include <uORB/topics/orb_test.h>
+#include <uORBDevices.hpp>
+#include <uORBManager.hpp>
+
+#include "gtest/gtest.h"
+
+ORB_DEFINE(orb_test, struct orb_test_s);
+
+/* traffic of the scaling benchmark */
+ORB_DEFINE(orb_scaling_test, struct orb_test_s);
+
+namespace px4
+{
+void init_once(void);
+}
+
+/* vehicles seen by tasks, work items and HRT calls */
+static volatile int g_task_vehicle = -1;
+static volatile int g_work_vehicle = -1;
+static volatile int g_hrt_vehicle = -1;
+
+static int task_main(int argc, char *argv[])
+{
+	g_task_vehicle = px4_vehicle_id();
+
+	/* not gone before the spawn has recorded the task */
+	usleep(10000);
+	return 0;
+}
+
+static void work_callback(void *arg)
+{
+	g_work_vehicle = px4_vehicle_id();
+}
+
+static void hrt_callback(void *arg)
+{
+	g_hrt_vehicle = px4_vehicle_id();
+}
+
+static void wait_for(volatile int *value)
+{
+	for (unsigned i = 0; i < 100 && *value < 0; i++) {
+		usleep(10000);
+	}
+}
+
+/* load of one vehicle in the scaling benchmark: a topic at 250 Hz with two readers */
+static volatile bool g_vehicles_run;
+static volatile int g_vehicles_running;
+
+static int vehicle_main(int argc, char *argv[])
+{
+	struct orb_test_s t = {};
+	orb_advert_t pub = orb_advertise(ORB_ID(orb_scaling_test), &t);
+	int estimator = orb_subscribe(ORB_ID(orb_scaling_test));
+	int logger = orb_subscribe(ORB_ID(orb_scaling_test));
+	__atomic_fetch_add(&g_vehicles_running, 1, __ATOMIC_RELAXED);
+
+	while (g_vehicles_run) {
+		bool updated;
+		t.val++;
+		orb_publish(ORB_ID(orb_scaling_test), pub, &t);
+		orb_check(estimator, &updated);
+		orb_copy(ORB_ID(orb_scaling_test), estimator, &t);
+		orb_check(logger, &updated);
+		orb_copy(ORB_ID(orb_scaling_test), logger, &t);
+		usleep(4000);
+	}
+
+	orb_unsubscribe(estimator);
+	orb_unsubscribe(logger);
+	__atomic_fetch_sub(&g_vehicles_running, 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+static long resident_kb()
+{
+	long size = 0, resident = 0;
+	FILE *f = fopen("/proc/self/statm", "r");
+
+	if (f != nullptr) {
+		if (fscanf(f, "%ld %ld", &size, &resident) != 2) {
+			resident = 0;
+		}
+
+		fclose(f);
+	}
+
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* proportional set size, shared pages split between the processes mapping them */
+static long proportional_kb()
+{
+	char line[128];
+	long pss = -1;
+	FILE *f = fopen("/proc/self/smaps_rollup", "r");
+
+	if (f != nullptr) {
+		while (pss < 0 && fgets(line, sizeof(line), f) != nullptr) {
+			if (sscanf(line, "Pss: %ld", &pss) != 1) {
+				pss = -1;
+			}
+		}
+
+		fclose(f);
+	}
+
+	return (pss < 0) ? resident_kb() : pss;
+}
+
+static uint64_t process_cpu_us()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* what `vehicle n` and `uorb start` do */
+static void start_uorb(int vehicle)
+{
+	static px4::VehicleInstance<uORB::DeviceMaster> master;
+	px4_vehicle_set(vehicle);
+
+	if (master == nullptr) {
+		master = new uORB::DeviceMaster(uORB::PUBSUB);
+		ASSERT_EQ(PX4_OK, master->init());
+	}
+}
+
+class MultiVehicleTest : public ::testing::Test
+{
+protected:
+	static void SetUpTestCase()
+	{
+		px4::init_once();
+	}
+
+	virtual void TearDown()
+	{
+		px4_vehicle_set(0);
+	}
+};
+
+TEST_F(MultiVehicleTest, Instance)
+{
+	px4::VehicleInstance<int> instance;
+	int a = 1, b = 2;
+
+	instance = &a;
+	EXPECT_EQ(&a, (int *)instance);
+
+	px4_vehicle_set(1);
+	EXPECT_TRUE(instance == nullptr);
+	instance = &b;
+	EXPECT_EQ(2, *instance);
+	EXPECT_EQ(&a, instance.instance(0));
+	EXPECT_EQ(&b, instance.instance(1));
+	EXPECT_TRUE(instance.instance(PX4_MAX_VEHICLES) == nullptr);
+
+	/* invalid vehicles are ignored */
+	px4_vehicle_set(PX4_MAX_VEHICLES);
+	EXPECT_EQ(1, px4_vehicle_id());
+	px4_vehicle_set(-1);
+	EXPECT_EQ(1, px4_vehicle_id());
+}
+
+TEST_F(MultiVehicleTest, Inherit)
+{
+	px4_vehicle_set(2);
+
+	ASSERT_GE(px4_task_spawn_cmd("multi_vehicle_test", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 2000, task_main, nullptr), 0);
+	wait_for(&g_task_vehicle);
+	EXPECT_EQ(2, g_task_vehicle);
+
+	struct work_s work = {};
+	ASSERT_EQ(0, work_queue(LPWORK, &work, work_callback, nullptr, 0));
+	px4_vehicle_set(0);
+	wait_for(&g_work_vehicle);
+	EXPECT_EQ(2, g_work_vehicle);
+
+	px4_vehicle_set(3);
+	struct hrt_call call = {};
+	hrt_call_after(&call, 1000, hrt_callback, nullptr);
+	px4_vehicle_set(0);
+	wait_for(&g_hrt_vehicle);
+	EXPECT_EQ(3, g_hrt_vehicle);
+
+	/* the calling thread keeps its own vehicle */
+	EXPECT_EQ(0, px4_vehicle_id());
+}
+
+TEST_F(MultiVehicleTest, Topics)
+{
+	struct orb_test_s t = {};
+	struct orb_test_s u = {};
+
+	for (int vehicle = 0; vehicle < 2; vehicle++) {
+		start_uorb(vehicle);
+		t.val = 100 + vehicle;
+		ASSERT_TRUE(orb_advertise(ORB_ID(orb_test), &t) != nullptr);
+	}
+
+	/* every vehicle only sees its own data */
+	for (int vehicle = 0; vehicle < 2; vehicle++) {
+		px4_vehicle_set(vehicle);
+		int sub = orb_subscribe(ORB_ID(orb_test));
+		ASSERT_GE(sub, 0);
+		ASSERT_EQ(PX4_OK, orb_copy(ORB_ID(orb_test), sub, &u));
+		EXPECT_EQ(100 + vehicle, u.val);
+		orb_unsubscribe(sub);
+	}
+
+	start_uorb(2);
+	EXPECT_EQ(PX4_ERROR, orb_exists(ORB_ID(orb_test), 0));
+}
+
+TEST_F(MultiVehicleTest, Benchmark)
+{
+	const unsigned n = 10000;
+	struct orb_test_s t = {};
+	orb_advert_t pub[PX4_MAX_VEHICLES];
+	int sub[PX4_MAX_VEHICLES];
+
+	for (int vehicle = 0; vehicle < PX4_MAX_VEHICLES; vehicle++) {
+		start_uorb(vehicle);
+		pub[vehicle] = orb_advertise(ORB_ID(orb_test), &t);
+		sub[vehicle] = orb_subscribe(ORB_ID(orb_test));
+		ASSERT_TRUE(pub[vehicle] != nullptr);
+		ASSERT_GE(sub[vehicle], 0);
+	}
+
+	/* cost of a publish and copy with one and with all vehicles busy */
+	for (int vehicles = 1; vehicles <= PX4_MAX_VEHICLES; vehicles *= 2) {
+		hrt_abstime t0 = hrt_absolute_time();
+
+		for (unsigned i = 0; i < n; i++) {
+			int vehicle = i % vehicles;
+			px4_vehicle_set(vehicle);
+			t.val = i;
+			orb_publish(ORB_ID(orb_test), pub[vehicle], &t);
+			orb_copy(ORB_ID(orb_test), sub[vehicle], &t);
+		}
+
+		hrt_abstime t1 = hrt_absolute_time();
+		printf("%d vehicles: publish and copy %.2f us\n", vehicles, (double)(t1 - t0) / n);
+	}
+
+	printf("uORB node table %zu bytes per vehicle\n", sizeof(uORB::DeviceNode *) * uORB::orb_max_topics *
+	       ORB_MULTI_MAX_INSTANCES);
+
+	for (int vehicle = 0; vehicle < PX4_MAX_VEHICLES; vehicle++) {
+		px4_vehicle_set(vehicle);
+		orb_unsubscribe(sub[vehicle]);
+	}
+}
+
+/* measurement time of the scaling benchmark */
+static const hrt_abstime scaling_duration = 500000;
+
+/* environment variable passing the result pipe to a process of the scaling benchmark */
+#define SCALING_RESULT_FD "MULTI_VEHICLE_RESULT_FD"
+
+/*
+ * Memory and CPU time per vehicle with 1 to PX4_MAX_VEHICLES vehicles,
+ * each one a task with the uORB load of vehicle_main(), first in this
+ * process, then with a process per vehicle. This covers the shared
+ * platform layer only, not the flight stack modules.
+ */
+TEST_F(MultiVehicleTest, Scaling)
+{
+	const hrt_abstime duration = scaling_duration;
+	int running = 0;
+	g_vehicles_run = true;
+
+	for (int vehicles = 1; vehicles <= PX4_MAX_VEHICLES; vehicles *= 2) {
+		long rss0 = resident_kb();
+
+		/* the vehicles of the previous round keep running */
+		for (int vehicle = running; vehicle < vehicles; vehicle++) {
+			start_uorb(vehicle);
+			ASSERT_GE(px4_task_spawn_cmd("vehicle", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 2000, vehicle_main, nullptr), 0);
+		}
+
+		for (unsigned i = 0; i < 100 && g_vehicles_running < vehicles; i++) {
+			usleep(10000);
+		}
+
+		ASSERT_EQ(vehicles, g_vehicles_running);
+		long rss1 = resident_kb();
+
+		uint64_t cpu0 = process_cpu_us();
+		usleep(duration);
+		uint64_t cpu1 = process_cpu_us();
+
+		printf("%2d vehicles, one process: %ld kB per added vehicle, %.2f%% CPU per vehicle\n", vehicles,
+		       (rss1 - rss0) / (vehicles - running), 100.0 * (cpu1 - cpu0) / duration / vehicles);
+		running = vehicles;
+	}
+
+	g_vehicles_run = false;
+
+	for (unsigned i = 0; i < 100 && g_vehicles_running > 0; i++) {
+		usleep(10000);
+	}
+
+	px4_vehicle_set(0);
+	EXPECT_EQ(0, g_vehicles_running);
+
+	/* the same load with a process per vehicle, each one running ScalingProcess */
+	char *argv[] = {(char *)"multi_vehicle_test", (char *)"--gtest_filter=MultiVehicleTest.ScalingProcess", nullptr};
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+	posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+	for (int vehicles = 1; vehicles <= PX4_MAX_VEHICLES; vehicles *= 2) {
+		int result[2];
+		ASSERT_EQ(0, pipe(result));
+		fcntl(result[0], F_SETFD, FD_CLOEXEC);
+
+		/* the environment of this process plus the result pipe */
+		char result_fd[32];
+		snprintf(result_fd, sizeof(result_fd), SCALING_RESULT_FD "=%d", result[1]);
+		char *envp[256];
+		unsigned envc = 0;
+
+		for (char **env = environ; *env != nullptr && envc < 254; env++) {
+			envp[envc++] = *env;
+		}
+
+		envp[envc++] = result_fd;
+		envp[envc] = nullptr;
+
+		for (int vehicle = 0; vehicle < vehicles; vehicle++) {
+			pid_t pid;
+			ASSERT_EQ(0, posix_spawn(&pid, "/proc/self/exe", &actions, nullptr, argv, envp));
+		}
+
+		close(result[1]);
+
+		/* every process writes one line with its memory and CPU time */
+		FILE *f = fdopen(result[0], "r");
+		ASSERT_TRUE(f != nullptr);
+		long pss, pss_sum = 0;
+		unsigned long long cpu, cpu_sum = 0;
+		int reported = 0;
+
+		while (fscanf(f, "%ld %llu", &pss, &cpu) == 2) {
+			pss_sum += pss;
+			cpu_sum += cpu;
+			reported++;
+		}
+
+		fclose(f);
+
+		for (int vehicle = 0; vehicle < vehicles; vehicle++) {
+			int status;
+			wait(&status);
+			EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+		}
+
+		ASSERT_EQ(vehicles, reported);
+		printf("%2d vehicles, process per vehicle: %ld kB per vehicle, %.2f%% CPU per vehicle\n", vehicles,
+		       pss_sum / vehicles, 100.0 * cpu_sum / duration / vehicles);
+	}
+
+	posix_spawn_file_actions_destroy(&actions);
+}
+
+/*
+ * One vehicle of the process per vehicle part of Scaling. It only runs
+ * when started by Scaling, which passes the result pipe in the environment.
+ */
+TEST_F(MultiVehicleTest, ScalingProcess)
+{
+	const char *result = getenv(SCALING_RESULT_FD);
+
+	if (result == nullptr) {
+		return;
+	}
+
+	start_uorb(0);
+	g_vehicles_run = true;
+	ASSERT_GE(px4_task_spawn_cmd("vehicle", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 2000, vehicle_main, nullptr), 0);
+
+	for (unsigned i = 0; i < 100 && g_vehicles_running < 1; i++) {
+		usleep(10000);
+	}
+
+	ASSERT_EQ(1, g_vehicles_running);
+
+	uint64_t cpu0 = process_cpu_us();
+	usleep(scaling_duration);
+	uint64_t cpu1 = process_cpu_us();
+
+	dprintf(atoi(result), "%ld %llu\n", proportional_kb(), (unsigned long long)(cpu1 - cpu0));
+	g_vehicles_run = false;
+
+	for (unsigned i = 0; i < 100 && g_vehicles_running > 0; i++) {
+		usleep(10000);
+	}
+}
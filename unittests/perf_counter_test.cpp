@@ -0,0 +1,162 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <drivers/drv_hrt.h>
+#include <systemlib/perf_counter.h>
+
+#include "gtest/gtest.h"
+
+static const unsigned THREADS = 8;
+static const unsigned EVENTS = 100000;
+
+static perf_counter_t g_count;
+static perf_counter_t g_elapsed;
+
+static void *count_main(void *arg)
+{
+	for (unsigned i = 0; i < EVENTS; i++) {
+		perf_count(g_count);
+		perf_set(g_elapsed, 10 + i % 10);
+	}
+
+	return nullptr;
+}
+
+/* everything printed by print(fd) */
+static std::string print_to_string(void (*print)(int fd))
+{
+	FILE *f = tmpfile();
+	print(fileno(f));
+	fflush(f);
+
+	std::string s(ftell(f), '\0');
+	rewind(f);
+	EXPECT_EQ(s.size(), fread(&s[0], 1, s.size(), f));
+	fclose(f);
+	return s;
+}
+
+TEST(PerfCounterTest, Threads)
+{
+	g_count = perf_alloc(PC_COUNT, "test_count");
+	g_elapsed = perf_alloc(PC_ELAPSED, "test_elapsed");
+	pthread_t threads[THREADS];
+
+	for (unsigned i = 0; i < THREADS; i++) {
+		ASSERT_EQ(0, pthread_create(&threads[i], nullptr, count_main, nullptr));
+	}
+
+	for (unsigned i = 0; i < THREADS; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	/* no update is lost */
+	EXPECT_EQ(THREADS * EVENTS, perf_event_count(g_count));
+	EXPECT_EQ(THREADS * EVENTS, perf_event_count(g_elapsed));
+
+	perf_reset(g_count);
+	EXPECT_EQ(0u, perf_event_count(g_count));
+
+	perf_free(g_count);
+	perf_free(g_elapsed);
+}
+
+TEST(PerfCounterTest, Histogram)
+{
+	perf_counter_t h = perf_alloc(PC_HISTOGRAM, "test_histogram");
+	EXPECT_EQ(0u, perf_percentile(h, 50.0f));
+
+	for (int i = 1; i <= 10000; i++) {
+		perf_set(h, i);
+	}
+
+	perf_set(h, -1);
+	EXPECT_EQ(10000u, perf_event_count(h));
+
+	/* not below the exact value and at most one bucket above */
+	const float percentiles[] = { 1.0f, 50.0f, 90.0f, 99.0f, 99.9f, 100.0f };
+
+	for (float p : percentiles) {
+		uint64_t exact = (uint64_t)(p * 100.0f);
+		EXPECT_GE(perf_percentile(h, p), exact) << p;
+		EXPECT_LE(perf_percentile(h, p), exact + exact / 16 + 1) << p;
+	}
+
+	/* small values are exact */
+	perf_reset(h);
+
+	for (int i = 0; i < 100; i++) {
+		perf_set(h, i % 10);
+	}
+
+	EXPECT_EQ(4u, perf_percentile(h, 50.0f));
+	EXPECT_EQ(9u, perf_percentile(h, 99.9f));
+
+	/* far out values land in the last bucket */
+	perf_set(h, 1ULL << 40);
+	EXPECT_GE(perf_percentile(h, 100.0f), 1ULL << 31);
+
+	perf_free(h);
+}
+
+TEST(PerfCounterTest, Json)
+{
+	perf_counter_t c = perf_alloc(PC_COUNT, "test_\"json\"");
+	perf_counter_t h = perf_alloc(PC_HISTOGRAM, "test_json_histogram");
+	perf_count(c);
+	perf_set(h, 100);
+
+	std::string json = print_to_string(perf_print_all_json);
+	EXPECT_NE(std::string::npos, json.find("{\"name\": \"test_\\\"json\\\"\", \"type\": \"count\", \"events\": 1}"));
+	EXPECT_NE(std::string::npos, json.find("\"type\": \"histogram\", \"events\": 1"));
+	/* the top of the bucket of 100us */
+	EXPECT_NE(std::string::npos, json.find("\"p999_us\": 103"));
+	EXPECT_NE(std::string::npos, json.find("\"dropped\": 0}"));
+
+	perf_free(c);
+	perf_free(h);
+}
+
+static void *begin_end_main(void *arg)
+{
+	perf_counter_t h = (perf_counter_t)arg;
+
+	for (unsigned i = 0; i < EVENTS; i++) {
+		perf_begin(h);
+		perf_end(h);
+	}
+
+	return nullptr;
+}
+
+TEST(PerfCounterTest, Benchmark)
+{
+	perf_counter_t e = perf_alloc(PC_ELAPSED, "bench_elapsed");
+	perf_counter_t h = perf_alloc(PC_HISTOGRAM, "bench_histogram");
+
+	for (unsigned threads = 1; threads <= 4; threads *= 2) {
+		for (perf_counter_t c : { e, h }) {
+			pthread_t t[4];
+			hrt_abstime t0 = hrt_absolute_time();
+
+			for (unsigned i = 0; i < threads; i++) {
+				pthread_create(&t[i], nullptr, begin_end_main, c);
+			}
+
+			for (unsigned i = 0; i < threads; i++) {
+				pthread_join(t[i], nullptr);
+			}
+
+			hrt_abstime t1 = hrt_absolute_time();
+			printf("%u threads: perf_begin/perf_end on %s %.1f ns\n", threads, c == e ? "elapsed" : "histogram",
+			       (t1 - t0) * 1000.0 / (EVENTS * threads));
+		}
+	}
+
+	perf_print_counter(h);
+
+	perf_free(e);
+	perf_free(h);
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <px4_defines.h>
+#include <px4_tasks.h>
+
+#include "gtest/gtest.h"
+
+static volatile bool g_stop;
+
+static int waiting_main(int argc, char *argv[])
+{
+	while (!g_stop) {
+		usleep(1000);
+	}
+
+	return 0;
+}
+
+/* the libc formatting most tasks use, and a buffer the size a NuttX task could not afford */
+static int busy_main(int argc, char *argv[])
+{
+	volatile char buf[16 * 1024];
+	memset((char *)buf, 1, sizeof(buf));
+
+	char text[64];
+	snprintf(text, sizeof(text), "%f %e %s", 3.14159, 2.5e-7, argv[1]);
+
+	while (!g_stop) {
+		usleep(1000);
+	}
+
+	return buf[0] + text[0];
+}
+
+static bool task_stats(px4_task_t id, px4_task_stats_t *stats)
+{
+	px4_task_stats_t all[64];
+	int n = px4_task_stats(all, 64);
+
+	for (int i = 0; i < n; i++) {
+		if (all[i].id == id) {
+			*stats = all[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TEST(TasksTest, DeleteAfterSpawn)
+{
+	g_stop = false;
+
+	/* the task can be signalled and deleted before it got to run */
+	for (unsigned i = 0; i < 100; i++) {
+		px4_task_t id = px4_task_spawn_cmd("tasks_test", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 2000, waiting_main, nullptr);
+		ASSERT_GE(id, 0);
+		EXPECT_EQ(0, px4_task_kill(id, 0));
+		EXPECT_EQ(0, px4_task_delete(id));
+		EXPECT_EQ(-EINVAL, px4_task_kill(id, 0));
+	}
+}
+
+TEST(TasksTest, Stack)
+{
+	g_stop = false;
+	char *const argv[] = {(char *)"stack", nullptr};
+	px4_task_t id = px4_task_spawn_cmd("tasks_test", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 2000, busy_main, argv);
+	ASSERT_GE(id, 0);
+	usleep(50000);
+
+	/* what the task asked for, plus the room for libc and 64 bit */
+	px4_task_stats_t stats;
+	ASSERT_TRUE(task_stats(id, &stats));
+	printf("stack %zu bytes, %zu used\n", stats.stack_size, stats.stack_used);
+	EXPECT_GE(stats.stack_size, 2000u + 60 * 1024u);
+	EXPECT_GT(stats.stack_used, 16 * 1024u);
+	EXPECT_LT(stats.stack_used, 16 * 1024u + 16 * 1024u);
+
+	g_stop = true;
+	usleep(50000);
+	EXPECT_FALSE(task_stats(id, &stats));
+}
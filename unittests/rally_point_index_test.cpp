@@ -0,0 +1,149 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <drivers/drv_hrt.h>
+#include <navigator/rally_point_index.h>
+
+#include "gtest/gtest.h"
+
+static const unsigned MAX_POINTS = 4096;
+static RallyPointIndex::Point g_points[MAX_POINTS];
+static double g_lat[MAX_POINTS];
+static double g_lon[MAX_POINTS];
+
+static double uniform(double min, double max)
+{
+	return min + (max - min) * (double)rand() / RAND_MAX;
+}
+
+/* rally points spread over about 50 x 50 km around 47.4N 8.5E */
+static void scatter(RallyPointIndex &index, unsigned count)
+{
+	index.reset();
+
+	for (unsigned i = 0; i < count; i++) {
+		g_lat[i] = uniform(47.2, 47.6);
+		g_lon[i] = uniform(8.2, 8.8);
+		ASSERT_TRUE(index.add(g_lat[i], g_lon[i], 400.0f, i));
+	}
+
+	index.build();
+}
+
+/* closest point by checking all of them */
+static int linear_nearest(unsigned count, double lat, double lon, float max_distance)
+{
+	int best = -1;
+	float best_distance = max_distance;
+
+	for (unsigned i = 0; i < count; i++) {
+		float d = get_distance_to_next_waypoint(lat, lon, g_lat[i], g_lon[i]);
+
+		if (d < best_distance) {
+			best_distance = d;
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+TEST(RallyPointIndexTest, Nearest)
+{
+	RallyPointIndex index(g_points, MAX_POINTS);
+	srand(1);
+
+	for (unsigned count = 1; count <= MAX_POINTS; count *= 4) {
+		scatter(index, count);
+		ASSERT_EQ(count, index.count());
+
+		for (unsigned i = 0; i < 1000; i++) {
+			double lat = uniform(47.1, 47.7);
+			double lon = uniform(8.1, 8.9);
+			float max_distance = (i % 2) ? INFINITY : 2000.0f;
+			int expected = linear_nearest(count, lat, lon, max_distance);
+
+			float distance;
+			int found = index.nearest(lat, lon, max_distance, &distance);
+
+			if (expected < 0) {
+				ASSERT_EQ(-1, found);
+				continue;
+			}
+
+			ASSERT_GE(found, 0);
+
+			/* the same point, or one as close within the distortion of the local projection */
+			float d_expected = get_distance_to_next_waypoint(lat, lon, g_lat[expected], g_lon[expected]);
+			unsigned id = index.point(found).id;
+			ASSERT_NEAR(d_expected, get_distance_to_next_waypoint(lat, lon, g_lat[id], g_lon[id]), 0.5f);
+			ASSERT_NEAR(d_expected, distance, 0.5f);
+		}
+	}
+}
+
+TEST(RallyPointIndexTest, Position)
+{
+	RallyPointIndex index(g_points, MAX_POINTS);
+	srand(2);
+	scatter(index, 256);
+
+	for (unsigned i = 0; i < index.count(); i++) {
+		double lat, lon;
+		index.position(i, &lat, &lon);
+		unsigned id = index.point(i).id;
+		EXPECT_LT(get_distance_to_next_waypoint(lat, lon, g_lat[id], g_lon[id]), 0.05f);
+	}
+}
+
+TEST(RallyPointIndexTest, Limits)
+{
+	RallyPointIndex::Point points[2];
+	RallyPointIndex index(points, 2);
+
+	/* nothing to find */
+	index.build();
+	EXPECT_EQ(-1, index.nearest(47.4, 8.5, INFINITY));
+
+	EXPECT_TRUE(index.add(47.4, 8.5, 400.0f, 1));
+	EXPECT_TRUE(index.add(47.4, 8.5, 420.0f, 2));
+	EXPECT_FALSE(index.add(47.5, 8.5, 400.0f, 3));
+
+	/* not built after adding points */
+	EXPECT_EQ(-1, index.nearest(47.4, 8.5, INFINITY));
+	index.build();
+	EXPECT_GE(index.nearest(47.4, 8.5, INFINITY), 0);
+	EXPECT_EQ(-1, index.nearest(47.5, 8.5, 1000.0f));
+
+	index.reset();
+	EXPECT_TRUE(index.empty());
+}
+
+TEST(RallyPointIndexTest, Benchmark)
+{
+	RallyPointIndex index(g_points, MAX_POINTS);
+	const unsigned queries = 10000;
+	srand(3);
+
+	hrt_abstime t0 = hrt_absolute_time();
+	scatter(index, MAX_POINTS);
+	hrt_abstime t1 = hrt_absolute_time();
+
+	int sum = 0;
+
+	for (unsigned i = 0; i < queries; i++) {
+		sum += index.nearest(uniform(47.2, 47.6), uniform(8.2, 8.8), INFINITY);
+	}
+
+	hrt_abstime t2 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < queries / 100; i++) {
+		sum += linear_nearest(MAX_POINTS, uniform(47.2, 47.6), uniform(8.2, 8.8), INFINITY);
+	}
+
+	hrt_abstime t3 = hrt_absolute_time();
+
+	printf("%u points: build %.1f us, nearest %.2f us, linear scan %.2f us (%d)\n", MAX_POINTS,
+	       (double)(t1 - t0), (double)(t2 - t1) / queries, (double)(t3 - t2) / (queries / 100), sum);
+}
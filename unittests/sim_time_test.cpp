@@ -0,0 +1,146 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <drivers/drv_hrt.h>
+#include <px4_time.h>
+#include <px4_posix.h>
+
+#include "gtest/gtest.h"
+
+static volatile hrt_abstime g_woke;
+static volatile int g_ret;
+
+static void *sleeper(void *arg)
+{
+	px4_usleep(10000);
+	g_woke = hrt_absolute_time();
+	return nullptr;
+}
+
+static void *interruptible_sleeper(void *arg)
+{
+	g_ret = hrt_sleep_until(hrt_absolute_time() + 1000000);
+	return nullptr;
+}
+
+/* all cases share the simulated clock, which can not be switched off */
+TEST(SimTimeTest, Lockstep)
+{
+	hrt_start_simulated_time();
+	ASSERT_TRUE(hrt_simulated_time_enabled());
+
+	/* time stands still */
+	hrt_abstime t0 = hrt_absolute_time();
+	usleep(10000);
+	EXPECT_EQ(t0, hrt_absolute_time());
+
+	hrt_advance_simulated_time(1000);
+	EXPECT_EQ(t0 + 1000, hrt_absolute_time());
+
+	/* and never goes back */
+	hrt_set_simulated_time(t0);
+	EXPECT_EQ(t0 + 1000, hrt_absolute_time());
+	hrt_set_simulated_time(t0 + 2000);
+	EXPECT_EQ(t0 + 2000, hrt_absolute_time());
+
+	/* sleeping in simulated time */
+	g_woke = 0;
+	g_ret = 1;
+	pthread_t sleep_thread, interrupt_thread;
+	pthread_create(&sleep_thread, nullptr, sleeper, nullptr);
+	pthread_create(&interrupt_thread, nullptr, interruptible_sleeper, nullptr);
+	usleep(20000);
+	EXPECT_EQ(0u, g_woke);
+
+	for (unsigned i = 0; i < 9; i++) {
+		hrt_advance_simulated_time(1000);
+		usleep(1000);
+	}
+
+	/* the work queue wakeup interrupts hrt_sleep_until() only */
+	hrt_wake_sleepers();
+	pthread_join(interrupt_thread, nullptr);
+	EXPECT_EQ(-1, g_ret);
+	EXPECT_EQ(0u, g_woke);
+
+	hrt_advance_simulated_time(5000);
+	pthread_join(sleep_thread, nullptr);
+	EXPECT_EQ(t0 + 16000, g_woke);
+}
+
+static volatile bool g_stop;
+
+static void *stepping_sleeper(void *arg)
+{
+	/* a periodic task: sleep until the next period, then some work */
+	while (!g_stop) {
+		px4_usleep(1000);
+		usleep(2000);
+		g_woke = hrt_absolute_time();
+	}
+
+	return nullptr;
+}
+
+static px4_sem_t g_sem;
+
+static void *sem_waiter(void *arg)
+{
+	px4_sim_sem_wait(&g_sem, hrt_absolute_time() + 100000);
+	usleep(2000);
+	g_woke = hrt_absolute_time();
+	g_ret = px4_sim_sem_wait(&g_sem, hrt_absolute_time() + 3000);
+	return nullptr;
+}
+
+TEST(SimTimeTest, WaitSleepers)
+{
+	hrt_start_simulated_time();
+	pthread_t thread;
+
+	/* forget the threads of the previous case, which exited after their wakeup */
+	hrt_wait_sleepers(1000);
+	EXPECT_EQ(0, hrt_wait_sleepers(1000));
+
+	/* each step waits for the work of the sleeper, despite the wall clock time it takes */
+	g_stop = false;
+	g_woke = 0;
+	pthread_create(&thread, nullptr, stepping_sleeper, nullptr);
+	usleep(20000);
+
+	for (unsigned i = 0; i < 10; i++) {
+		hrt_advance_simulated_time(1000);
+		EXPECT_EQ(0, hrt_wait_sleepers(1000000));
+		EXPECT_EQ(hrt_absolute_time(), g_woke);
+	}
+
+	/* a thread exiting after its wakeup times the wait out, then it is no longer waited for */
+	g_stop = true;
+	hrt_advance_simulated_time(1000);
+	pthread_join(thread, nullptr);
+	EXPECT_EQ(-1, hrt_wait_sleepers(1000));
+	EXPECT_EQ(0, hrt_wait_sleepers(1000));
+
+	/* a semaphore wait is woken by the post, or by the deadline */
+	px4_sem_init(&g_sem, 0, 0);
+	g_woke = 0;
+	g_ret = 1;
+	pthread_create(&thread, nullptr, sem_waiter, nullptr);
+	usleep(20000);
+
+	px4_sim_sem_post(&g_sem);
+	EXPECT_EQ(0, hrt_wait_sleepers(1000000));
+	EXPECT_EQ(hrt_absolute_time(), g_woke);
+
+	for (unsigned i = 0; i < 2; i++) {
+		hrt_advance_simulated_time(1000);
+		EXPECT_EQ(0, hrt_wait_sleepers(1000000));
+		EXPECT_EQ(1, g_ret);
+	}
+
+	hrt_advance_simulated_time(1000);
+	pthread_join(thread, nullptr);
+	EXPECT_EQ(0, g_ret);
+	px4_sem_destroy(&g_sem);
+}
@@ -0,0 +1,99 @@
+#include <math.h>
+#include <stdio.h>
+
+#include <px4_defines.h>
+
+#include <sim_scenario/vehicle_model.h>
+
+#include "gtest/gtest.h"
+
+static const float dt = 0.004f;
+
+static void run(VehicleModel &model, float seconds, float vx, float vy, float vz, float yaw)
+{
+	for (float t = 0.0f; t < seconds; t += dt) {
+		model.update(dt, vx, vy, vz, yaw);
+	}
+}
+
+TEST(SimVehicleModelTest, Ground)
+{
+	VehicleModel model;
+	model.reset(0.0f);
+	EXPECT_TRUE(model.state().landed);
+
+	/* pushed down, stays on the ground */
+	run(model, 2.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+	EXPECT_FLOAT_EQ(0.0f, model.state().z);
+	EXPECT_FLOAT_EQ(0.0f, model.state().vz);
+	EXPECT_TRUE(model.state().landed);
+
+	/* climb */
+	run(model, 2.0f, 0.0f, 0.0f, -2.0f, 0.0f);
+	EXPECT_LT(model.state().z, -2.0f);
+	EXPECT_NEAR(-2.0f, model.state().vz, 0.05f);
+	EXPECT_FALSE(model.state().landed);
+
+	/* descend back to the ground */
+	run(model, 10.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+	EXPECT_FLOAT_EQ(0.0f, model.state().z);
+	EXPECT_TRUE(model.state().landed);
+}
+
+TEST(SimVehicleModelTest, Velocity)
+{
+	VehicleModel model;
+	model.reset(0.0f);
+	run(model, 1.0f, 0.0f, 0.0f, -1.0f, 0.0f);
+
+	/* limited acceleration: 5 m/s need more than 0.8 s */
+	run(model, 0.5f, 5.0f, -3.0f, 0.0f, 0.0f);
+	EXPECT_LT(model.state().vx, 4.0f);
+
+	run(model, 3.0f, 5.0f, -3.0f, 0.0f, 0.0f);
+	EXPECT_NEAR(5.0f, model.state().vx, 0.05f);
+	EXPECT_NEAR(-3.0f, model.state().vy, 0.05f);
+	EXPECT_NEAR(0.0f, model.state().vz, 0.05f);
+
+	/* comes to rest without setpoint */
+	float x = model.state().x;
+
+	for (unsigned i = 0; i < 1000; i++) {
+		model.hold(dt);
+	}
+
+	EXPECT_NEAR(0.0f, model.state().vx, 0.01f);
+	EXPECT_GT(model.state().x, x);
+
+	/* invalid setpoints are ignored */
+	run(model, 1.0f, NAN, 1.0f, 0.0f, NAN);
+	EXPECT_TRUE(isfinite(model.state().x));
+	EXPECT_NEAR(0.0f, model.state().vy, 0.01f);
+}
+
+TEST(SimVehicleModelTest, Yaw)
+{
+	VehicleModel model;
+	model.reset(3.0f);
+
+	/* no turning on the ground */
+	run(model, 1.0f, 0.0f, 0.0f, 0.0f, -3.0f);
+	EXPECT_FLOAT_EQ(3.0f, model.state().yaw);
+	run(model, 1.0f, 0.0f, 0.0f, -1.0f, 3.0f);
+
+	/* the short way across +-PI */
+	run(model, 0.05f, 0.0f, 0.0f, 0.0f, -3.0f);
+	EXPECT_GT(model.state().yaw, 3.0f);
+
+	run(model, 1.0f, 0.0f, 0.0f, 0.0f, -3.0f);
+	EXPECT_NEAR(-3.0f, model.state().yaw, 0.01f);
+
+	/* rate limited */
+	run(model, 0.5f, 0.0f, 0.0f, 0.0f, -1.0f);
+	EXPECT_LT(model.state().yaw, -2.0f);
+
+	for (unsigned i = 0; i < 10000; i++) {
+		model.update(dt, 0.0f, 0.0f, -0.1f, (i % 2) ? 3.1f : -3.1f);
+		ASSERT_TRUE(model.state().yaw >= -M_PI_F && model.state().yaw <= M_PI_F);
+	}
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <simulator/simulator_datagram.h>
+
+#include "gtest/gtest.h"
+
+static const uint8_t message_lengths[256] = MAVLINK_MESSAGE_LENGTHS;
+static const uint8_t message_crcs[256] = MAVLINK_MESSAGE_CRCS;
+
+/* a MAVLink 1.0 frame as sent by the simulators, returns its length */
+static int frame(uint8_t *buf, uint8_t msgid, const void *payload, uint8_t seq)
+{
+	uint8_t payload_len = message_lengths[msgid];
+
+	buf[0] = MAVLINK_STX;
+	buf[1] = payload_len;
+	buf[2] = seq;
+	buf[3] = 1;
+	buf[4] = 200;
+	buf[5] = msgid;
+	memcpy(&buf[MAVLINK_NUM_HEADER_BYTES], payload, payload_len);
+
+	uint16_t checksum;
+	crc_init(&checksum);
+	crc_accumulate_buffer(&checksum, (const char *)&buf[1], MAVLINK_CORE_HEADER_LEN + payload_len);
+	crc_accumulate(message_crcs[msgid], &checksum);
+
+	buf[MAVLINK_NUM_HEADER_BYTES + payload_len] = (uint8_t)(checksum & 0xFF);
+	buf[MAVLINK_NUM_HEADER_BYTES + payload_len + 1] = (uint8_t)(checksum >> 8);
+
+	return payload_len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+}
+
+static mavlink_hil_sensor_t sensor_sample(void)
+{
+	mavlink_hil_sensor_t sensor = {};
+	sensor.time_usec = 123456789;
+	sensor.xacc = 0.1f;
+	sensor.zacc = -9.81f;
+	sensor.xgyro = 0.01f;
+	sensor.abs_pressure = 1013.25f;
+	sensor.fields_updated = 0x1FFF;
+	return sensor;
+}
+
+static int sensor_frame(uint8_t *buf, uint8_t seq)
+{
+	mavlink_hil_sensor_t sensor = sensor_sample();
+	return frame(buf, MAVLINK_MSG_ID_HIL_SENSOR, &sensor, seq);
+}
+
+static int heartbeat_frame(uint8_t *buf, uint8_t seq)
+{
+	mavlink_heartbeat_t heartbeat = {};
+	heartbeat.custom_mode = 42;
+	heartbeat.type = 2;
+	return frame(buf, MAVLINK_MSG_ID_HEARTBEAT, &heartbeat, seq);
+}
+
+static void expect_sensor(const mavlink_message_t &msg, uint8_t seq)
+{
+	EXPECT_EQ(MAVLINK_MSG_ID_HIL_SENSOR, msg.msgid);
+	EXPECT_EQ(MAVLINK_MSG_ID_HIL_SENSOR_LEN, msg.len);
+	EXPECT_EQ(seq, msg.seq);
+	EXPECT_EQ(1, msg.sysid);
+	EXPECT_EQ(200, msg.compid);
+
+	mavlink_hil_sensor_t decoded;
+	mavlink_msg_hil_sensor_decode(&msg, &decoded);
+	mavlink_hil_sensor_t sent = sensor_sample();
+	EXPECT_EQ(0, memcmp(&sent, &decoded, sizeof(sent)));
+}
+
+/* messages the reader takes from a datagram */
+static int read_all(const uint8_t *buf, int len, mavlink_message_t *msgs, int max)
+{
+	DatagramReader reader(buf, len);
+	int n = 0;
+
+	while (n < max && reader.next(&msgs[n])) {
+		n++;
+	}
+
+	return n;
+}
+
+TEST(SimulatorDatagramTest, ValidFrame)
+{
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+	int len = sensor_frame(buf, 7);
+	mavlink_message_t msg;
+
+	ASSERT_TRUE(decode_datagram(buf, len, &msg));
+	expect_sensor(msg, 7);
+
+	/* the same message again, then nothing */
+	mavlink_message_t msgs[2];
+	ASSERT_EQ(1, read_all(buf, len, msgs, 2));
+	expect_sensor(msgs[0], 7);
+}
+
+TEST(SimulatorDatagramTest, BadCrc)
+{
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+	mavlink_message_t msgs[2];
+
+	int len = sensor_frame(buf, 1);
+	buf[len - 1] ^= 0x01;
+	EXPECT_FALSE(decode_datagram(buf, len, &msgs[0]));
+	EXPECT_EQ(0, read_all(buf, len, msgs, 2));
+
+	/* a corrupted payload byte */
+	len = sensor_frame(buf, 1);
+	buf[MAVLINK_NUM_HEADER_BYTES + 3] ^= 0x80;
+	EXPECT_FALSE(decode_datagram(buf, len, &msgs[0]));
+	EXPECT_EQ(0, read_all(buf, len, msgs, 2));
+}
+
+TEST(SimulatorDatagramTest, WrongPayloadLength)
+{
+	uint8_t buf[MAVLINK_MAX_PACKET_LEN + 1];
+	mavlink_message_t msgs[2];
+
+	/* the length byte does not match the message id, even with a matching CRC */
+	int len = sensor_frame(buf, 2);
+	buf[1] = MAVLINK_MSG_ID_HIL_SENSOR_LEN - 4;
+	len -= 4;
+	uint16_t checksum;
+	crc_init(&checksum);
+	crc_accumulate_buffer(&checksum, (const char *)&buf[1], MAVLINK_CORE_HEADER_LEN + buf[1]);
+	crc_accumulate(message_crcs[MAVLINK_MSG_ID_HIL_SENSOR], &checksum);
+	buf[len - 2] = (uint8_t)(checksum & 0xFF);
+	buf[len - 1] = (uint8_t)(checksum >> 8);
+	EXPECT_FALSE(decode_datagram(buf, len, &msgs[0]));
+
+	/* the datagram is longer than the message, the parser still finds it */
+	len = sensor_frame(buf, 3);
+	buf[len++] = 0;
+	EXPECT_FALSE(decode_datagram(buf, len, &msgs[0]));
+	ASSERT_EQ(1, read_all(buf, len, msgs, 2));
+	expect_sensor(msgs[0], 3);
+}
+
+TEST(SimulatorDatagramTest, TruncatedFrame)
+{
+	uint8_t buf[2 * MAVLINK_MAX_PACKET_LEN];
+	mavlink_message_t msgs[3];
+
+	int len = sensor_frame(buf, 4);
+	EXPECT_FALSE(decode_datagram(buf, len - 10, &msgs[0]));
+	EXPECT_EQ(0, read_all(buf, len - 10, msgs, 3));
+
+	/* the rest of the truncated message does not swallow the next datagram */
+	len = heartbeat_frame(buf, 5);
+	len += sensor_frame(&buf[len], 6);
+	ASSERT_EQ(2, read_all(buf, len, msgs, 3));
+	EXPECT_EQ(MAVLINK_MSG_ID_HEARTBEAT, msgs[0].msgid);
+	expect_sensor(msgs[1], 6);
+
+	/* nor does a truncated header */
+	EXPECT_EQ(0, read_all(buf, 3, msgs, 3));
+	len = sensor_frame(buf, 8);
+	ASSERT_EQ(1, read_all(buf, len, msgs, 3));
+	expect_sensor(msgs[0], 8);
+}
+
+TEST(SimulatorDatagramTest, TwoMessages)
+{
+	uint8_t buf[2 * MAVLINK_MAX_PACKET_LEN];
+	mavlink_message_t msgs[3];
+
+	int len = sensor_frame(buf, 10);
+	len += heartbeat_frame(&buf[len], 11);
+	EXPECT_FALSE(decode_datagram(buf, len, &msgs[0]));
+
+	ASSERT_EQ(2, read_all(buf, len, msgs, 3));
+	expect_sensor(msgs[0], 10);
+	EXPECT_EQ(MAVLINK_MSG_ID_HEARTBEAT, msgs[1].msgid);
+	EXPECT_EQ(11, msgs[1].seq);
+
+	mavlink_heartbeat_t heartbeat;
+	mavlink_msg_heartbeat_decode(&msgs[1], &heartbeat);
+	EXPECT_EQ(42u, heartbeat.custom_mode);
+	EXPECT_EQ(2, heartbeat.type);
+}
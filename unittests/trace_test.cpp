@@ -0,0 +1,123 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <px4_trace.h>
+#include <drivers/drv_hrt.h>
+
+#include "gtest/gtest.h"
+
+/* the trace of the last seconds as a string */
+static std::string dump(unsigned seconds)
+{
+	FILE *f = tmpfile();
+	px4_trace_dump(fileno(f), seconds);
+	fflush(f);
+
+	std::string s(ftell(f), '\0');
+	rewind(f);
+	EXPECT_EQ(s.size(), fread(&s[0], 1, s.size(), f));
+	fclose(f);
+	return s;
+}
+
+static unsigned count(const std::string &s, const std::string &what)
+{
+	unsigned n = 0;
+
+	for (size_t pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + 1)) {
+		n++;
+	}
+
+	return n;
+}
+
+static void *thread_main(void *arg)
+{
+	pthread_setname_np(pthread_self(), "trace_thread");
+
+	for (unsigned i = 0; i < 100; i++) {
+		px4_trace_begin(PX4_TRACE_USER, "outer", i);
+		px4_trace_instant(PX4_TRACE_ORB, "topic", i);
+		px4_trace_end(PX4_TRACE_USER, "outer", i);
+	}
+
+	return nullptr;
+}
+
+TEST(TraceTest, Events)
+{
+	/* nothing while tracing is off */
+	px4_trace_instant(PX4_TRACE_USER, "before_start", 0);
+
+	ASSERT_EQ(0, px4_trace_start(1024));
+	pthread_t thread;
+	ASSERT_EQ(0, pthread_create(&thread, nullptr, thread_main, nullptr));
+	pthread_join(thread, nullptr);
+
+	std::string s = dump(0);
+	EXPECT_EQ(0u, count(s, "before_start"));
+	EXPECT_EQ(100u, count(s, "\"name\": \"outer\", \"cat\": \"user\", \"ph\": \"B\""));
+	EXPECT_EQ(100u, count(s, "\"name\": \"outer\", \"cat\": \"user\", \"ph\": \"E\""));
+	EXPECT_EQ(100u, count(s, "\"name\": \"topic\", \"cat\": \"orb\", \"ph\": \"i\""));
+	EXPECT_NE(std::string::npos, s.find("\"args\": {\"name\": \"trace_thread\"}"));
+	EXPECT_EQ(0u, s.find("{\"traceEvents\": ["));
+	EXPECT_NE(std::string::npos, s.find("], \"displayTimeUnit\": \"ms\"}"));
+
+	px4_trace_stop();
+}
+
+TEST(TraceTest, Overflow)
+{
+	ASSERT_EQ(0, px4_trace_start(256));
+
+	/* an end without its begin is left out */
+	px4_trace_begin(PX4_TRACE_USER, "dropped", 0);
+
+	for (unsigned i = 0; i < 1000; i++) {
+		px4_trace_instant(PX4_TRACE_USER, "overflow", i);
+	}
+
+	px4_trace_end(PX4_TRACE_USER, "dropped", 0);
+
+	std::string s = dump(0);
+	EXPECT_EQ(0u, count(s, "\"dropped\""));
+	EXPECT_GE(count(s, "\"overflow\""), 250u);
+	EXPECT_LE(count(s, "\"overflow\""), 255u);
+	EXPECT_NE(std::string::npos, s.find("\"arg\": 999}"));
+
+	/* only the last seconds */
+	usleep(1100000);
+	px4_trace_instant(PX4_TRACE_USER, "recent", 0);
+	s = dump(1);
+	EXPECT_EQ(0u, count(s, "\"overflow\""));
+	EXPECT_EQ(1u, count(s, "\"recent\""));
+
+	px4_trace_stop();
+}
+
+TEST(TraceTest, Benchmark)
+{
+	const unsigned n = 1000000;
+
+	hrt_abstime t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		px4_trace_instant(PX4_TRACE_USER, "off", i);
+	}
+
+	px4_trace_start(0);
+	hrt_abstime t1 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		px4_trace_instant(PX4_TRACE_USER, "on", i);
+	}
+
+	hrt_abstime t2 = hrt_absolute_time();
+	std::string s = dump(0);
+	hrt_abstime t3 = hrt_absolute_time();
+	px4_trace_stop();
+
+	printf("trace event off %.1f ns, on %.1f ns, dump of %zu bytes %.1f ms\n", (t1 - t0) * 1000.0 / n,
+	       (t2 - t1) * 1000.0 / n, s.size(), (t3 - t2) / 1000.0);
+}
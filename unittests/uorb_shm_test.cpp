@@ -0,0 +1,334 @@
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <drivers/drv_hrt.h>
+#include <muorb/shm/uORBShmSegment.hpp>
+
+#include "gtest/gtest.h"
+
+struct Message {
+	uint64_t timestamp;
+	uint32_t counter;
+	uint8_t payload[116];
+};
+
+static char g_name[64];
+
+class ShmSegmentTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		snprintf(g_name, sizeof(g_name), "/px4_uorb_test_%d", (int)getpid());
+		uORB::ShmSegment::unlink(g_name);
+	}
+
+	virtual void TearDown()
+	{
+		uORB::ShmSegment::unlink(g_name);
+	}
+};
+
+TEST_F(ShmSegmentTest, Topics)
+{
+	uORB::ShmSegment a, b;
+	ASSERT_EQ(0, a.attach(g_name));
+	ASSERT_EQ(0, b.attach(g_name));
+	EXPECT_NE(a.peer(), b.peer());
+	EXPECT_EQ(2u, a.peer_count());
+
+	/* the subscriber comes first and does not know the size */
+	int topic = b.topic("sensor_combined", 0);
+	ASSERT_GE(topic, 0);
+	EXPECT_EQ(0u, b.topic_size(topic));
+	EXPECT_EQ(topic, a.topic("sensor_combined", sizeof(Message)));
+	EXPECT_EQ(sizeof(Message), b.topic_size(topic));
+	EXPECT_EQ(-1, a.topic("sensor_combined", sizeof(Message) + 1));
+	EXPECT_EQ(-1, a.topic("a_topic_name_which_is_much_longer_than_anything_uorb_would_use_0123", 4));
+
+	uint32_t generation = a.subscription_generation();
+	EXPECT_FALSE(a.remote_subscribers(topic));
+	b.subscribe(topic, true);
+	EXPECT_TRUE(a.remote_subscribers(topic));
+	EXPECT_FALSE(b.remote_subscribers(topic));
+	EXPECT_NE(generation, a.subscription_generation());
+
+	/* the subscriber is woken up and gets the latest message once */
+	Message in = {}, out = {};
+	in.counter = 42;
+	uint32_t wakeups = b.wakeups();
+	ASSERT_EQ(0, a.write(topic, &in, sizeof(in)));
+	EXPECT_NE(wakeups, b.wakeups());
+	EXPECT_EQ(-1, a.write(topic, &in, sizeof(in) - 1));
+
+	uint32_t last = 0;
+	EXPECT_EQ((int)sizeof(out), b.read(topic, &out, sizeof(out), &last));
+	EXPECT_EQ(42u, out.counter);
+	EXPECT_EQ(0, b.read(topic, &out, sizeof(out), &last));
+	EXPECT_EQ(-1, b.read(topic, &out, sizeof(out) - 1, &last));
+
+	/* a peer which leaves takes its subscriptions along */
+	b.detach();
+	EXPECT_FALSE(a.remote_subscribers(topic));
+	EXPECT_EQ(1u, a.peer_count());
+
+	uORB::ShmSegment c;
+	ASSERT_EQ(0, c.attach(g_name));
+	EXPECT_EQ(topic, c.topic("sensor_combined", 0));
+}
+
+struct SeqlockState {
+	uORB::ShmSegment *segment;
+	int topic;
+	volatile bool done;
+	unsigned torn;
+	unsigned reads;
+};
+
+static void *seqlock_reader(void *arg)
+{
+	SeqlockState *state = (SeqlockState *)arg;
+	uint32_t last = 0;
+
+	while (!state->done) {
+		uint32_t wakeups = state->segment->wakeups();
+		Message m;
+
+		while (state->segment->read(state->topic, &m, sizeof(m), &last) > 0) {
+			state->reads++;
+
+			/* every byte was written with the same counter */
+			for (unsigned i = 0; i < sizeof(m.payload); i++) {
+				if (m.payload[i] != (uint8_t)m.counter) {
+					state->torn++;
+					break;
+				}
+			}
+		}
+
+		state->segment->wait(wakeups, 10);
+	}
+
+	return nullptr;
+}
+
+TEST_F(ShmSegmentTest, Seqlock)
+{
+	uORB::ShmSegment writer, reader;
+	ASSERT_EQ(0, writer.attach(g_name));
+	ASSERT_EQ(0, reader.attach(g_name));
+
+	SeqlockState state = {};
+	state.segment = &reader;
+	state.topic = reader.topic("actuator_controls", sizeof(Message));
+	ASSERT_GE(state.topic, 0);
+	reader.subscribe(state.topic, true);
+
+	pthread_t thread;
+	ASSERT_EQ(0, pthread_create(&thread, nullptr, seqlock_reader, &state));
+
+	Message m = {};
+
+	for (unsigned i = 0; i < 200000; i++) {
+		m.counter = i;
+		memset(m.payload, (uint8_t)i, sizeof(m.payload));
+		ASSERT_EQ(0, writer.write(state.topic, &m, sizeof(m)));
+	}
+
+	state.done = true;
+	writer.wake(reader.peer());
+	pthread_join(thread, nullptr);
+
+	EXPECT_EQ(0u, state.torn);
+	EXPECT_GT(state.reads, 0u);
+}
+
+TEST_F(ShmSegmentTest, DeadWriter)
+{
+	uORB::ShmSegment segment;
+	ASSERT_EQ(0, segment.attach(g_name));
+	int topic = segment.topic("vehicle_status", sizeof(Message));
+	ASSERT_GE(topic, 0);
+
+	Message in = {}, out = {};
+	in.counter = 1;
+	ASSERT_EQ(0, segment.write(topic, &in, sizeof(in)));
+	uint32_t last = 0;
+	ASSERT_EQ((int)sizeof(out), segment.read(topic, &out, sizeof(out), &last));
+
+	/* the child faults in the middle of the copy, leaving the slot odd and owned by a dead process */
+	pid_t child = fork();
+	ASSERT_GE(child, 0);
+
+	if (child == 0) {
+		uORB::ShmSegment writer;
+
+		if (writer.attach(g_name) != 0) {
+			_exit(1);
+		}
+
+		void *page = mmap(nullptr, 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		writer.write(topic, page, sizeof(Message));
+		_exit(2);
+	}
+
+	int status;
+	waitpid(child, &status, 0);
+	ASSERT_TRUE(WIFSIGNALED(status));
+
+	/* readers give up on the torn message, the next writer takes the slot over */
+	EXPECT_EQ(0, segment.read(topic, &out, sizeof(out), &last));
+	in.counter = 2;
+	ASSERT_EQ(0, segment.write(topic, &in, sizeof(in)));
+	ASSERT_EQ((int)sizeof(out), segment.read(topic, &out, sizeof(out), &last));
+	EXPECT_EQ(2u, out.counter);
+
+	/* the segment is not open to other users */
+	char path[80];
+	snprintf(path, sizeof(path), "/dev/shm%s", g_name);
+	struct stat st;
+
+	if (stat(path, &st) == 0) {
+		EXPECT_EQ(0u, st.st_mode & S_IRWXO);
+	}
+}
+
+/* echoes ping to pong until a message with counter 0 comes */
+static void echo()
+{
+	uORB::ShmSegment segment;
+
+	if (segment.attach(g_name) != 0) {
+		_exit(1);
+	}
+
+	int ping = segment.topic("ping", sizeof(Message));
+	int pong = segment.topic("pong", sizeof(Message));
+	int stream = segment.topic("stream", sizeof(Message));
+	segment.subscribe(ping, true);
+	segment.subscribe(stream, true);
+
+	uint32_t last_ping = 0;
+	uint32_t last_stream = 0;
+	uint32_t received = 0;
+
+	for (;;) {
+		uint32_t wakeups = segment.wakeups();
+		Message m;
+
+		while (segment.read(stream, &m, sizeof(m), &last_stream) > 0) {
+			received++;
+		}
+
+		if (segment.read(ping, &m, sizeof(m), &last_ping) > 0) {
+			if (m.counter == 0) {
+				break;
+			}
+
+			/* report the stream count on request */
+			if (m.counter == UINT32_MAX) {
+				m.timestamp = received;
+			}
+
+			segment.write(pong, &m, sizeof(m));
+			continue;
+		}
+
+		segment.wait(wakeups, 1000);
+	}
+
+	_exit(0);
+}
+
+static bool roundtrip(uORB::ShmSegment &segment, int ping, int pong, uint32_t *last, Message *m)
+{
+	segment.write(ping, m, sizeof(*m));
+	uint32_t counter = m->counter;
+
+	for (unsigned timeout = 0; timeout < 1000; timeout++) {
+		uint32_t wakeups = segment.wakeups();
+
+		if (segment.read(pong, m, sizeof(*m), last) > 0 && m->counter == counter) {
+			return true;
+		}
+
+		segment.wait(wakeups, 1);
+	}
+
+	return false;
+}
+
+TEST_F(ShmSegmentTest, Benchmark)
+{
+	uORB::ShmSegment segment;
+	ASSERT_EQ(0, segment.attach(g_name));
+	int ping = segment.topic("ping", sizeof(Message));
+	int pong = segment.topic("pong", sizeof(Message));
+	int stream = segment.topic("stream", sizeof(Message));
+	ASSERT_GE(stream, 0);
+	segment.subscribe(pong, true);
+
+	pid_t child = fork();
+	ASSERT_GE(child, 0);
+
+	if (child == 0) {
+		echo();
+	}
+
+	for (unsigned i = 0; i < 1000 && !segment.remote_subscribers(ping); i++) {
+		usleep(1000);
+	}
+
+	ASSERT_TRUE(segment.remote_subscribers(ping));
+
+	/* latency: one way is half the round trip through the other process */
+	const unsigned rounds = 20000;
+	uint32_t last = 0;
+	hrt_abstime min = UINT64_MAX, max = 0;
+	hrt_abstime t0 = hrt_absolute_time();
+
+	for (unsigned i = 1; i <= rounds; i++) {
+		Message m = {};
+		m.counter = i;
+		hrt_abstime t = hrt_absolute_time();
+		ASSERT_TRUE(roundtrip(segment, ping, pong, &last, &m));
+		t = hrt_absolute_time() - t;
+		min = t < min ? t : min;
+		max = t > max ? t : max;
+	}
+
+	hrt_abstime t1 = hrt_absolute_time();
+
+	/* throughput: the subscriber gets the latest message, so it may skip some */
+	const unsigned messages = 1000000;
+	Message m = {};
+
+	for (unsigned i = 1; i <= messages; i++) {
+		m.counter = i;
+		segment.write(stream, &m, sizeof(m));
+	}
+
+	hrt_abstime t2 = hrt_absolute_time();
+
+	m.counter = UINT32_MAX;
+	ASSERT_TRUE(roundtrip(segment, ping, pong, &last, &m));
+	uint64_t received = m.timestamp;
+
+	m.counter = 0;
+	segment.write(ping, &m, sizeof(m));
+
+	int status;
+	waitpid(child, &status, 0);
+	EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+	EXPECT_GT(received, 0u);
+
+	printf("one way %.2f us, round trip min %llu us, max %llu us, %.0f messages/s of %u bytes, %.0f%% received\n",
+	       (double)(t1 - t0) / rounds / 2, (unsigned long long)min, (unsigned long long)max,
+	       messages * 1e6 / (t2 - t1), (unsigned)sizeof(Message), 100.0 * received / messages);
+}
@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <px4_defines.h>
+#include <drivers/drv_hrt.h>
+#include <uORB/uORB.h>
+#include <uORB/topics/orb_test.h>
+#include <uORBDevices.hpp>
+#include <uORBManager.hpp>
+#include <uORBUtils.hpp>
+
+#include "gtest/gtest.h"
+
+ORB_DEFINE(orb_test, struct orb_test_s);
+ORB_DEFINE(orb_multitest, struct orb_test_s);
+
+/* not listed in any msg file */
+ORB_DEFINE(orb_unlisted_test, struct orb_test_s);
+
+namespace px4
+{
+void init_once(void);
+}
+
+class uORBTopicsTest : public ::testing::Test
+{
+protected:
+	/* the HRT lock is used when closing nodes */
+	static void SetUpTestCase()
+	{
+		px4::init_once();
+	}
+};
+
+/* what `uorb start` does */
+static void start_uorb()
+{
+	static uORB::DeviceMaster *master = nullptr;
+
+	if (master == nullptr) {
+		master = new uORB::DeviceMaster(uORB::PUBSUB);
+		ASSERT_EQ(PX4_OK, master->init());
+	}
+}
+
+TEST_F(uORBTopicsTest, TopicId)
+{
+	EXPECT_EQ(ORB_TOPIC_ID_orb_test, (ORB_ID(orb_test))->o_id);
+	EXPECT_EQ(ORB_TOPIC_ID_orb_test, uORB::Utils::topic_id("orb_test"));
+	EXPECT_EQ(ORB_TOPIC_ID_orb_multitest, uORB::Utils::topic_id("orb_multitest"));
+	EXPECT_EQ(ORB_TOPIC_ID_actuator_armed, uORB::Utils::topic_id("actuator_armed"));
+	EXPECT_EQ(ORB_TOPIC_ID_wind_estimate, uORB::Utils::topic_id("wind_estimate"));
+	EXPECT_EQ(-1, uORB::Utils::topic_id("orb_tes"));
+	EXPECT_EQ(-1, uORB::Utils::topic_id(""));
+
+	/* topics listed in a msg file next to its own name */
+	EXPECT_GE(uORB::Utils::topic_id("offboard_mission"), 0);
+	EXPECT_GE(uORB::Utils::topic_id("mc_virtual_attitude_setpoint"), 0);
+}
+
+TEST_F(uORBTopicsTest, PubSub)
+{
+	struct orb_test_s t = {};
+	struct orb_test_s u = {};
+	start_uorb();
+
+	EXPECT_EQ(PX4_ERROR, orb_exists(ORB_ID(orb_test), 0));
+	int sub = orb_subscribe(ORB_ID(orb_test));
+	ASSERT_GE(sub, 0);
+
+	/* subscribing creates the node, but nothing is published yet */
+	EXPECT_EQ(PX4_OK, orb_exists(ORB_ID(orb_test), 0));
+	bool updated = true;
+	orb_check(sub, &updated);
+	EXPECT_FALSE(updated);
+
+	t.val = 1;
+	orb_advert_t pub = orb_advertise(ORB_ID(orb_test), &t);
+	ASSERT_TRUE(pub != nullptr);
+	orb_check(sub, &updated);
+	EXPECT_TRUE(updated);
+	ASSERT_EQ(PX4_OK, orb_copy(ORB_ID(orb_test), sub, &u));
+	EXPECT_EQ(1, u.val);
+
+	t.val = 2;
+	orb_publish(ORB_ID(orb_test), pub, &t);
+	ASSERT_EQ(PX4_OK, orb_copy(ORB_ID(orb_test), sub, &u));
+	EXPECT_EQ(2, u.val);
+
+	/* data from a remote side is dispatched by name */
+	uORBCommunicator::IChannelRxHandler *rx = uORB::Manager::get_instance();
+	t.val = 3;
+	EXPECT_EQ(0, rx->process_received_message("orb_test", sizeof(t), (uint8_t *)&t));
+	EXPECT_EQ(-1, rx->process_received_message("orb_test_unknown", sizeof(t), (uint8_t *)&t));
+	ASSERT_EQ(PX4_OK, orb_copy(ORB_ID(orb_test), sub, &u));
+	EXPECT_EQ(3, u.val);
+
+	EXPECT_FALSE(uORB::Manager::get_instance()->is_remote_subscriber_present("orb_test"));
+	rx->process_add_subscription("orb_test", 10);
+	EXPECT_TRUE(uORB::Manager::get_instance()->is_remote_subscriber_present("orb_test"));
+	rx->process_remove_subscription("orb_test");
+	EXPECT_FALSE(uORB::Manager::get_instance()->is_remote_subscriber_present("orb_test"));
+
+	orb_unsubscribe(sub);
+}
+
+TEST_F(uORBTopicsTest, Multi)
+{
+	struct orb_test_s t = {};
+	struct orb_test_s u = {};
+	orb_advert_t pubs[ORB_MULTI_MAX_INSTANCES];
+	start_uorb();
+
+	for (int i = 0; i < ORB_MULTI_MAX_INSTANCES; i++) {
+		int instance = -1;
+		t.val = 100 + i;
+		pubs[i] = orb_advertise_multi(ORB_ID(orb_multitest), &t, &instance, ORB_PRIO_DEFAULT);
+		ASSERT_TRUE(pubs[i] != nullptr);
+		EXPECT_EQ(i, instance);
+		EXPECT_EQ(PX4_OK, orb_exists(ORB_ID(orb_multitest), i));
+	}
+
+	/* no more instances */
+	int instance = -1;
+	EXPECT_TRUE(orb_advertise_multi(ORB_ID(orb_multitest), &t, &instance, ORB_PRIO_DEFAULT) == nullptr);
+
+	for (int i = 0; i < ORB_MULTI_MAX_INSTANCES; i++) {
+		int sub = orb_subscribe_multi(ORB_ID(orb_multitest), i);
+		ASSERT_GE(sub, 0);
+		ASSERT_EQ(PX4_OK, orb_copy(ORB_ID(orb_multitest), sub, &u));
+		EXPECT_EQ(100 + i, u.val);
+		orb_unsubscribe(sub);
+	}
+}
+
+TEST_F(uORBTopicsTest, Unlisted)
+{
+	struct orb_test_s t = {};
+	struct orb_test_s u = {};
+	start_uorb();
+
+	/* numbered after the generated topics on first use */
+	EXPECT_EQ(ORB_TOPIC_ID_UNLISTED, (ORB_ID(orb_unlisted_test))->o_id);
+	EXPECT_EQ(-1, uORB::Utils::topic_id("orb_unlisted_test"));
+	int id = uORB::Utils::topic_id(ORB_ID(orb_unlisted_test));
+	EXPECT_GE(id, ORB_TOPICS_COUNT);
+	EXPECT_EQ(id, uORB::Utils::topic_id("orb_unlisted_test"));
+	EXPECT_EQ(id, uORB::Utils::add_topic("orb_unlisted_test"));
+
+	t.val = 7;
+	orb_advert_t pub = orb_advertise(ORB_ID(orb_unlisted_test), &t);
+	ASSERT_TRUE(pub != nullptr);
+	int sub = orb_subscribe(ORB_ID(orb_unlisted_test));
+	ASSERT_GE(sub, 0);
+	ASSERT_EQ(PX4_OK, orb_copy(ORB_ID(orb_unlisted_test), sub, &u));
+	EXPECT_EQ(7, u.val);
+	orb_unsubscribe(sub);
+
+	/* names from a remote side take the remaining slots */
+	char name[32];
+	int added = 0;
+
+	for (int i = 0; i < ORB_UNLISTED_TOPICS_MAX; i++) {
+		snprintf(name, sizeof(name), "orb_remote_%d", i);
+		added += (uORB::Utils::add_topic(name) >= 0) ? 1 : 0;
+	}
+
+	EXPECT_EQ(ORB_UNLISTED_TOPICS_MAX - 1, added);
+	EXPECT_EQ(ORB_TOPICS_COUNT + 1, uORB::Utils::topic_id("orb_remote_0"));
+}
+
+TEST_F(uORBTopicsTest, Benchmark)
+{
+	const unsigned n = 10000;
+	struct orb_test_s t = {};
+	start_uorb();
+
+	if (orb_exists(ORB_ID(orb_test), 0) != PX4_OK) {
+		orb_advertise(ORB_ID(orb_test), &t);
+	}
+
+	hrt_abstime t0 = hrt_absolute_time();
+
+	for (unsigned i = 0; i < n; i++) {
+		int sub = orb_subscribe(ORB_ID(orb_test));
+		ASSERT_GE(sub, 0);
+		orb_unsubscribe(sub);
+	}
+
+	hrt_abstime t1 = hrt_absolute_time();
+	uORBCommunicator::IChannelRxHandler *rx = uORB::Manager::get_instance();
+
+	for (unsigned i = 0; i < n; i++) {
+		t.val = i;
+		rx->process_received_message("orb_test", sizeof(t), (uint8_t *)&t);
+	}
+
+	hrt_abstime t2 = hrt_absolute_time();
+
+	printf("subscribe and unsubscribe %.2f us, remote dispatch %.2f us\n", (double)(t1 - t0) / n,
+	       (double)(t2 - t1) / n);
+}
@@ -0,0 +1,236 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+
+#include <drivers/drv_hrt.h>
+#include <muorb/udp/uORBUdpChannel.hpp>
+
+#include "gtest/gtest.h"
+
+using namespace uORB::UdpProtocol;
+
+TEST(UdpPacketTest, Records)
+{
+	uint8_t buffer[256];
+	uORB::UdpPacketWriter writer(buffer, sizeof(buffer));
+	writer.begin();
+	EXPECT_TRUE(writer.empty());
+
+	int32_t rate = 50;
+	uint8_t data[100];
+	memset(data, 0xa5, sizeof(data));
+	ASSERT_TRUE(writer.add(ADD_SUBSCRIPTION, "vehicle_attitude", &rate, sizeof(rate)));
+	ASSERT_TRUE(writer.add(DATA, "sensor_combined", data, sizeof(data)));
+	ASSERT_TRUE(writer.add(REMOVE_SUBSCRIPTION, "vehicle_status", nullptr, 0));
+	writer.set_sequence(7);
+
+	/* nothing changes if a record does not fit */
+	unsigned size = writer.size();
+	EXPECT_FALSE(writer.add(DATA, "sensor_combined", data, sizeof(data)));
+	EXPECT_EQ(size, writer.size());
+	EXPECT_EQ(3u, writer.count());
+
+	uORB::UdpPacketReader reader;
+	ASSERT_TRUE(reader.open(writer.data(), writer.size()));
+	EXPECT_EQ(7, reader.sequence());
+
+	Record record;
+	ASSERT_TRUE(reader.next(&record));
+	EXPECT_EQ(ADD_SUBSCRIPTION, record.type);
+	EXPECT_STREQ("vehicle_attitude", record.name);
+	ASSERT_EQ(sizeof(rate), record.length);
+	EXPECT_EQ(0, memcmp(&rate, record.payload, sizeof(rate)));
+
+	ASSERT_TRUE(reader.next(&record));
+	EXPECT_EQ(DATA, record.type);
+	EXPECT_STREQ("sensor_combined", record.name);
+	ASSERT_EQ(sizeof(data), record.length);
+	EXPECT_EQ(0, memcmp(data, record.payload, sizeof(data)));
+
+	ASSERT_TRUE(reader.next(&record));
+	EXPECT_EQ(REMOVE_SUBSCRIPTION, record.type);
+	EXPECT_EQ(0u, record.length);
+	EXPECT_FALSE(reader.next(&record));
+
+	/* truncated or foreign datagrams */
+	ASSERT_TRUE(reader.open(writer.data(), size - 20));
+	EXPECT_TRUE(reader.next(&record));
+	EXPECT_FALSE(reader.next(&record));
+	EXPECT_FALSE(reader.open(writer.data(), 4));
+	buffer[0] ^= 0xff;
+	EXPECT_FALSE(reader.open(writer.data(), writer.size()));
+}
+
+TEST(UdpTimeSyncTest, Offset)
+{
+	uORB::UdpTimeSync sync;
+	EXPECT_FALSE(sync.valid());
+	srand(1);
+
+	const int64_t offset = -123456789;
+	hrt_abstime t = 1000000000;
+
+	for (unsigned i = 0; i < 100; i++) {
+		/* 200 us round trip with up to 100 us of queueing on either way, now and then much longer */
+		hrt_abstime out = 100 + rand() % 100;
+		hrt_abstime back = 100 + rand() % 100;
+
+		if (i % 10 == 5) {
+			out += 20000;
+		}
+
+		sync.update(t, t + out + offset, t + out + back);
+		t += 1000000;
+	}
+
+	ASSERT_TRUE(sync.valid());
+	EXPECT_NEAR(offset, sync.offset(), 60);
+	EXPECT_NEAR(5000000000ll, (double)sync.to_local(5000000000ll + offset), 60);
+	EXPECT_LT(sync.round_trip(), 400u);
+}
+
+class Handler : public uORBCommunicator::IChannelRxHandler
+{
+public:
+	Handler() { pthread_mutex_init(&_mutex, nullptr); }
+
+	virtual int16_t process_add_subscription(const char *messageName, int32_t msgRateInHz)
+	{
+		pthread_mutex_lock(&_mutex);
+		_subscriptions[messageName] = msgRateInHz;
+		pthread_mutex_unlock(&_mutex);
+		return 0;
+	}
+
+	virtual int16_t process_remove_subscription(const char *messageName)
+	{
+		pthread_mutex_lock(&_mutex);
+		_subscriptions.erase(messageName);
+		pthread_mutex_unlock(&_mutex);
+		return 0;
+	}
+
+	virtual int16_t process_received_message(const char *messageName, int32_t length, uint8_t *data)
+	{
+		pthread_mutex_lock(&_mutex);
+		_received[messageName]++;
+
+		if (length == sizeof(uint64_t)) {
+			memcpy(&_last[messageName], data, sizeof(uint64_t));
+		}
+
+		pthread_mutex_unlock(&_mutex);
+		return 0;
+	}
+
+	bool subscribed(const char *name)
+	{
+		pthread_mutex_lock(&_mutex);
+		bool found = _subscriptions.find(name) != _subscriptions.end();
+		pthread_mutex_unlock(&_mutex);
+		return found;
+	}
+
+	unsigned received(const char *name)
+	{
+		pthread_mutex_lock(&_mutex);
+		unsigned count = _received[name];
+		pthread_mutex_unlock(&_mutex);
+		return count;
+	}
+
+	uint64_t last(const char *name)
+	{
+		pthread_mutex_lock(&_mutex);
+		uint64_t value = _last[name];
+		pthread_mutex_unlock(&_mutex);
+		return value;
+	}
+
+private:
+	pthread_mutex_t _mutex;
+	std::map<std::string, int32_t> _subscriptions;
+	std::map<std::string, unsigned> _received;
+	std::map<std::string, uint64_t> _last;
+};
+
+static bool wait_for(Handler &handler, const char *name, unsigned timeout_ms)
+{
+	for (unsigned i = 0; i < timeout_ms && !handler.subscribed(name); i++) {
+		usleep(1000);
+	}
+
+	return handler.subscribed(name);
+}
+
+TEST(UdpChannelTest, Loopback)
+{
+	Handler handler_a, handler_b;
+	uORB::UdpChannel a, b;
+	a.register_handler(&handler_a);
+	b.register_handler(&handler_b);
+
+	/* a subscribes before b is there, the subscription is announced again */
+	ASSERT_EQ(0, a.Start(14581, "127.0.0.1", 14582, 1000));
+	a.add_subscription("sensor_combined", 0);
+	a.add_subscription("vehicle_status", 10);
+	usleep(10000);
+	ASSERT_EQ(0, b.Start(14582, "127.0.0.1", 14581, 1000));
+
+	ASSERT_TRUE(wait_for(handler_b, "sensor_combined", 2000));
+	ASSERT_TRUE(wait_for(handler_b, "vehicle_status", 100));
+	EXPECT_EQ(2u, b.RemoteSubscriptions());
+
+	/* b publishes at 1 kHz, unsubscribed topics do not cross */
+	hrt_abstime start = hrt_absolute_time();
+
+	for (uint64_t i = 1; i <= 500; i++) {
+		b.send_message("sensor_combined", sizeof(i), (uint8_t *)&i);
+		b.send_message("vehicle_status", sizeof(i), (uint8_t *)&i);
+		b.send_message("actuator_outputs", sizeof(i), (uint8_t *)&i);
+		usleep(1000);
+	}
+
+	double seconds = (hrt_absolute_time() - start) / 1e6;
+	usleep(200000);
+
+	/* batched at 1 kHz at most, the latest update always arrives */
+	EXPECT_GT(handler_a.received("sensor_combined"), 50u);
+	EXPECT_EQ(500u, handler_a.last("sensor_combined"));
+	EXPECT_EQ(0u, handler_a.received("actuator_outputs"));
+
+	/* rate limited to 10 Hz */
+	EXPECT_LE(handler_a.received("vehicle_status"), (unsigned)(seconds * 10) + 2);
+	EXPECT_GE(handler_a.received("vehicle_status"), 3u);
+	EXPECT_EQ(500u, handler_a.last("vehicle_status"));
+
+	/* both sides run on the same clock */
+	int64_t offset;
+	ASSERT_TRUE(a.TimeOffset(&offset));
+	EXPECT_LT(llabs(offset), 1000);
+	ASSERT_TRUE(b.TimeOffset(&offset));
+	EXPECT_LT(llabs(offset), 1000);
+
+	a.remove_subscription("vehicle_status");
+
+	for (unsigned i = 0; i < 100 && handler_b.subscribed("vehicle_status"); i++) {
+		usleep(1000);
+	}
+
+	EXPECT_FALSE(handler_b.subscribed("vehicle_status"));
+	EXPECT_EQ(1u, b.RemoteSubscriptions());
+
+	/* subscriptions of a side which went away expire */
+	a.Stop();
+
+	for (unsigned i = 0; i < 5000 && handler_b.subscribed("sensor_combined"); i++) {
+		usleep(1000);
+	}
+
+	EXPECT_FALSE(handler_b.subscribed("sensor_combined"));
+	b.Stop();
+}